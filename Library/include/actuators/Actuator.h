@@ -31,7 +31,7 @@
 
 namespace sf
 {
-    struct Renderable;
+    class DrawingQueue;
     
     //! An enum designating a type of the actuator.
     enum class ActuatorType {MOTOR, SERVO, PROPELLER, THRUSTER, VBS, LIGHT};
@@ -56,7 +56,10 @@ namespace sf
         virtual void Update(Scalar dt) = 0;
         
         //! A method implementing the rendering of the actuator.
-        virtual std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        virtual void Render(DrawingQueue& queue);
         
         //! A method used to set display mode used for the actuator.
         /*!
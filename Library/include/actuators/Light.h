@@ -87,7 +87,10 @@ namespace sf
         void UpdateTransform();
         
         //! A method implementing the rendering of the light dummy.
-        std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        void Render(DrawingQueue& queue);
         
 		//! A method returning actuator frame in the world frame.
 		Transform getActuatorFrame();
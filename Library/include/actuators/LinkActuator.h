@@ -51,7 +51,10 @@ namespace sf
         virtual void AttachToSolid(SolidEntity* body, const Transform& origin);
         
 		//! A method implementing the rendering of the actuator.
-        virtual std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        virtual void Render(DrawingQueue& queue);
 		
         //! A method returning actuator frame in the world frame.
         virtual Transform getActuatorFrame();
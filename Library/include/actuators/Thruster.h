@@ -57,7 +57,10 @@ namespace sf
         void Update(Scalar dt);
         
         //! A method implementing the rendering of the thruster.
-        std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        void Render(DrawingQueue& queue);
         
         //! A method setting the new value of the thruster speed setpoint.
         /*!
@@ -50,7 +50,10 @@ namespace sf
         void Update(Scalar dt);
         
         //! A method implementing the rendering of the VBS.
-        std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        void Render(DrawingQueue& queue);
         
         //! A method used to set the desired flow rate setpoint.
         /*!
@@ -27,16 +27,31 @@
 #define __Stonefish_AcousticModem__
 
 #include <map>
+#include <vector>
 #include "comms/Comm.h"
 
 namespace sf
 {
+    class AcousticModem;
+    
     struct AcousticDataFrame : public CommDataFrame
     {
         Vector3 txPosition;
+        Vector3 rxPosition; //Position of the receiver when the message was transmitted
+        Scalar arrivalTime; //Simulation time at which the message reaches the receiver [s]
         Scalar travelled;
     };
     
+    //! A structure holding the acoustic modems and the messages in flight of one simulation world.
+    struct AcousticNetwork
+    {
+        std::map<uint64_t, AcousticModem*> nodes;
+        std::vector<AcousticDataFrame*> propagating; //Messages in flight, ordered by arrival time (heap)
+        
+        //! A destructor.
+        ~AcousticNetwork();
+    };
+    
     //! An abstract class representing an acoustic modem.
     class AcousticModem : public Comm
     {
@@ -75,7 +90,10 @@ namespace sf
         void UpdatePosition(Vector3 pos, bool absolute, std::string referenceFrame = std::string(""));
         
         //! A method implementing the rendering of the comm device.
-        std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        void Render(DrawingQueue& queue);
         
         //! A method to retrieve the position of the device in the designated reference frame.
         /*!
@@ -90,22 +108,23 @@ namespace sf
     protected:
         virtual void ProcessMessages();
         
-        static AcousticModem* getNode(uint64_t deviceId);
+        AcousticModem* getNode(uint64_t deviceId);
         
     private:
         bool isReceptionPossible(Vector3 dir, Scalar distance);
         
-        std::map<AcousticDataFrame*, Vector3> propagating;
         Scalar range;
         Scalar hFov2, vFov2;
         Vector3 position;
         std::string frame;
+        AcousticNetwork* network;
         
-        static void addNode(AcousticModem* node);
-        static void removeNode(uint64_t deviceId);
-        static bool mutualContact(uint64_t device1Id, uint64_t device2Id);
-        
-        static std::map<uint64_t, AcousticModem*> nodes;
+        void addNode();
+        void removeNode();
+        bool mutualContact(uint64_t device1Id, uint64_t device2Id);
+        void transmit(AcousticDataFrame* msg);
+        void deliverMessages(Scalar now);
+        static bool laterArrival(const AcousticDataFrame* msg1, const AcousticDataFrame* msg2);
     };
 }
     
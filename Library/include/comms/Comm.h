@@ -35,7 +35,7 @@ namespace sf
     //! An enum defining types of comms.
     enum class CommType {RADIO, ACOUSTIC, VLC};
     
-    struct Renderable;
+    class DrawingQueue;
     class Entity;
     class StaticEntity;
     class SolidEntity;
@@ -102,7 +102,10 @@ namespace sf
         void AttachToSolid(SolidEntity* body, const Transform& origin);
         
         //! A method implementing the rendering of the comm device.
-        virtual std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        virtual void Render(DrawingQueue& queue);
         
         //! A method that updates the comm state.
         /*!
@@ -86,8 +86,8 @@ namespace sf
         std::normal_distribution<Scalar> noiseDepth;
         std::normal_distribution<Scalar> noiseNED;
         
-        static std::random_device randomDevice;
-        static std::mt19937 randomGenerator;
+        static thread_local std::random_device randomDevice;
+        static thread_local std::mt19937 randomGenerator;
     };
 }
     
@@ -27,6 +27,9 @@
 #define __Stonefish_Console__
 
 #include <SDL2/SDL_thread.h>
+#include <cstdarg>
+#include <atomic>
+#include <deque>
 #include "StonefishCommon.h"
 #include "core/SimulationApp.h"
 
@@ -46,6 +49,10 @@ namespace sf
     };
     
     //! A class implementing a text console.
+    /*!
+     Messages are formatted directly into a preallocated ring buffer and written out by a background thread,
+     so that printing never blocks or allocates memory on the calling thread. Messages are dropped when the ring is full.
+     */
     class Console
     {
     public:
@@ -58,7 +65,15 @@ namespace sf
         //! A method used to pring a message on the console.
         /*!
          \param messageType a type of message to be printed
-         \param format a format string
+         \param format a format string (its address identifies the call site for rate limiting)
+         \param ... a set of variables refering to the format string (like printf() from standard library)
+        */
+        void Print(int messageType, const char* format, ...);
+        
+        //! A method used to pring a message on the console, with a dynamically created format string.
+        /*!
+         \param messageType a type of message to be printed
+         \param format a format string (its content identifies the call site for rate limiting)
          \param ... a set of variables refering to the format string (like printf() from standard library)
         */
         void Print(int messageType, std::string format, ...);
@@ -71,6 +86,42 @@ namespace sf
         
         //! A method that clears the console.
         void Clear();
+        
+        //! A method that waits until all queued messages are written out.
+        void Flush();
+        
+        //! A method to set the minimum type of messages that are printed.
+        /*!
+         \param messageType the minimum type of message (0-info, 1-warning, 2-error; critical messages are always printed)
+         */
+        void setMinimumSeverity(int messageType);
+        
+        //! A method to set the maximum number of messages printed from a single call site per second.
+        /*!
+         \param messagesPerSecond the maximum number of messages (0 disables the limit)
+         */
+        void setRateLimit(unsigned int messagesPerSecond);
+        
+        //! A method to set the maximum number of lines kept by the console.
+        /*!
+         \param maxLines the maximum number of retained lines (0 means no limit)
+         */
+        void setRetention(size_t maxLines);
+        
+        //! A method returning the minimum type of messages that are printed.
+        int getMinimumSeverity();
+        
+        //! A method returning the maximum number of messages printed from a single call site per second.
+        unsigned int getRateLimit();
+        
+        //! A method returning the maximum number of lines kept by the console.
+        size_t getRetention();
+        
+        //! A method returning the number of messages dropped because the queue was full.
+        uint64_t getDroppedMessages();
+        
+        //! A method returning the number of messages suppressed by the rate limit.
+        uint64_t getSuppressedMessages();
     
         //! A method that returns a pointer to the console data mutex.
         SDL_mutex* getLinesMutex();
@@ -79,8 +130,36 @@ namespace sf
         std::vector<ConsoleMessage> getLines();
         
     protected:
-        std::vector<ConsoleMessage> lines;
+        std::deque<ConsoleMessage> lines;
         SDL_mutex* linesMutex;
+        
+    private:
+        struct Slot
+        {
+            std::atomic<size_t> sequence;
+            int type;
+            char text[4096];
+        };
+        
+        void Enqueue(int messageType, size_t site, const char* format, va_list args);
+        bool Admit(size_t site);
+        bool Drain();
+        void Output(int messageType, const char* text);
+        static int WriterLoop(void* data);
+        
+        Slot* queue;
+        std::atomic<size_t> enqueuePos;
+        std::atomic<size_t> dequeuePos;
+        std::atomic<uint64_t>* rates;
+        std::atomic<int> minSeverity;
+        std::atomic<unsigned int> rateLimit;
+        std::atomic<uint64_t> dropped;
+        std::atomic<uint64_t> suppressed;
+        uint64_t droppedReported;
+        uint64_t suppressedReported;
+        size_t retention;
+        SDL_Thread* writer;
+        std::atomic<bool> running;
     };
 }
 
@@ -0,0 +1,142 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  DatasetWriter.h
+//  Stonefish
+//
+
+#ifndef __Stonefish_DatasetWriter__
+#define __Stonefish_DatasetWriter__
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <SDL2/SDL_thread.h>
+#include <SDL2/SDL_mutex.h>
+#include "StonefishCommon.h"
+
+namespace sf
+{
+    //! An enum defining what happens to a frame when all buffers of a sensor are in use.
+    enum class DatasetDropPolicy {DROP_NEWEST, DROP_OLDEST};
+    
+    //! An enum defining the file format used to store depth and range images.
+    enum class DatasetDepthFormat {FLOAT_PFM, UINT16_PNG};
+    
+    class VisionSensor;
+    struct VisionSensorFrame;
+    
+    //! A class implementing an asynchronous writer of vision sensor frames, used to generate perception datasets.
+    /*!
+     Frames are copied into preallocated buffers, on the thread producing them, and encoded and written to disk by a pool of worker threads.
+     Each sensor has a fixed number of buffers. When all of them are in use, the frame is dropped according to the drop policy, so that the simulation is never blocked.
+     Colour images and sonar images are written as 8-bit PNG files. Depth and range images are written as 32-bit floating point PFM files
+     or as 16-bit PNG files storing the distance in millimetres.
+     The frames of each sensor are written to a separate directory, together with a metadata file containing the intrinsic parameters of the sensor
+     and the timestamp and pose of each frame.
+     */
+    class DatasetWriter
+    {
+    public:
+        //! A constructor.
+        /*!
+         \param directory a path to the output directory (has to exist)
+         \param workers the number of worker threads
+         \param buffersPerSensor the number of frame buffers of each sensor
+         \param policy the policy used to drop frames when all buffers are in use
+         */
+        DatasetWriter(const std::string& directory, unsigned int workers = 2, unsigned int buffersPerSensor = 4,
+                      DatasetDropPolicy policy = DatasetDropPolicy::DROP_OLDEST);
+        
+        //! A destructor (waits until all queued frames are written).
+        ~DatasetWriter();
+        
+        //! A method adding a vision sensor to the dataset.
+        /*!
+         \param sens a pointer to the vision sensor
+         \param depthFormat the format used to store depth and range images
+         \return true if the sensor was added, false otherwise
+         */
+        bool AddSensor(VisionSensor* sens, DatasetDepthFormat depthFormat = DatasetDepthFormat::UINT16_PNG);
+        
+        //! A method that blocks until all queued frames are written.
+        void Flush();
+        
+        //! A method returning the number of frames written to disk.
+        uint64_t getWrittenFrames();
+        
+        //! A method returning the number of frames dropped because all buffers were in use.
+        uint64_t getDroppedFrames();
+        
+        //! A method returning the path of the output directory.
+        std::string getDirectory();
+    
+    private:
+        struct Stream;
+        
+        struct Job
+        {
+            Stream* stream;
+            std::vector<uint8_t>* buffer;
+            uint64_t frameId;
+            Scalar timestamp;
+            Transform pose;
+        };
+        
+        struct Stream
+        {
+            DatasetWriter* writer;
+            SDL_mutex* mutex;
+            std::string name;
+            std::string directory;
+            unsigned int width;
+            unsigned int height;
+            unsigned int channels;
+            bool floatingPoint;
+            DatasetDepthFormat depthFormat;
+            std::vector<std::vector<uint8_t>> buffers;
+            std::vector<std::vector<uint8_t>*> freeBuffers;
+            uint64_t frames;
+            FILE* metadata;
+            
+            ~Stream();
+        };
+        
+        void Enqueue(Stream* s, const VisionSensorFrame& frame);
+        void WriteFrame(const Job& job);
+        bool WritePNG16(const std::string& path, const std::vector<uint8_t>& data, unsigned int width, unsigned int height);
+        bool WritePFM(const std::string& path, const std::vector<uint8_t>& data, unsigned int width, unsigned int height);
+        static int WorkerLoop(void* data);
+        
+        std::string directory;
+        unsigned int nBuffers;
+        DatasetDropPolicy dropPolicy;
+        std::vector<std::shared_ptr<Stream>> streams;
+        std::vector<SDL_Thread*> workers;
+        std::deque<Job> queue;
+        unsigned int pending;
+        SDL_mutex* queueMutex;
+        SDL_cond* queueCond;
+        SDL_cond* idleCond;
+        bool running;
+        std::atomic<uint64_t> written;
+        std::atomic<uint64_t> dropped;
+    };
+}
+
+#endif
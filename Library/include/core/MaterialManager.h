@@ -35,6 +35,7 @@ namespace sf
     struct Material
     {
         std::string name;
+        int id;
         Scalar density;
         Scalar restitution;
     };
@@ -26,6 +26,8 @@
 #ifndef __Stonefish_NameManager__
 #define __Stonefish_NameManager__
 
+#include <unordered_set>
+#include <unordered_map>
 #include "StonefishCommon.h"
 
 namespace sf
@@ -57,7 +59,8 @@ namespace sf
         void ClearNames();
         
     private:
-        std::vector<std::string> names;
+        std::unordered_set<std::string> names;
+        std::unordered_map<std::string, unsigned int> nextSuffix; //Next number to try for each proposed name
     };
 }
     
@@ -0,0 +1,177 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  Recorder.h
+//  Stonefish
+//
+
+#ifndef __Stonefish_Recorder__
+#define __Stonefish_Recorder__
+
+#include <atomic>
+#include <SDL2/SDL_thread.h>
+#include "StonefishCommon.h"
+
+//Recording file format (native byte order):
+//header: magic[8] "SFREC01", uint32 number of streams, for each stream: string name, float64 rate, uint32 number of channels, string channel names
+//chunk: uint32 magic, uint32 stream id, uint32 number of samples, uint32 number of channels, float64 first time, float64 last time, float64 times[n], float64 values[n] for each channel
+//index: uint32 magic, uint32 number of entries, for each entry: uint32 stream id, uint32 number of samples, float64 first time, float64 last time, uint64 chunk offset
+//footer: uint64 index offset, magic[8] "SFRECEND"
+//strings are stored as uint32 length followed by characters
+#define RECORDING_FILE_MAGIC "SFREC01"
+#define RECORDING_END_MAGIC "SFRECEND"
+#define RECORDING_CHUNK_MAGIC 0x4B4E4843
+#define RECORDING_INDEX_MAGIC 0x58444E49
+
+namespace sf
+{
+    class ScalarSensor;
+    class Actuator;
+    class MovingEntity;
+    
+    //! A structure representing an entry of the recording index.
+    struct RecordingIndexEntry
+    {
+        uint32_t stream;
+        uint32_t nSamples;
+        double tStart;
+        double tEnd;
+        uint64_t offset;
+    };
+    
+    //! A class implementing a background recorder, streaming measurements and states to a binary log.
+    /*!
+     Samples are passed from the simulation thread to the writer thread through lock-free single-producer queues.
+     The writer thread assembles them into columnar chunks, which are appended to the file together with an index used for time-range seeks.
+     Chunks which are not full are flushed periodically, so that a crash of the simulation loses at most the last second of data.
+     The recording can be read and converted to the text and Octave formats with the RecordingReader class.
+     */
+    class Recorder
+    {
+    public:
+        //! A constructor.
+        /*!
+         \param path a path to the output file
+         \param chunkLength the maximum number of samples in a single chunk
+         \param queueLength the capacity of the queue of each stream [samples]
+         */
+        Recorder(const std::string& path, unsigned int chunkLength = 1024, unsigned int queueLength = 8192);
+        
+        //! A destructor.
+        ~Recorder();
+        
+        //! A method adding a scalar sensor to the recording (every generated sample is recorded).
+        /*!
+         \param sens a pointer to the sensor
+         \return the id of the stream or -1 if the stream could not be added
+         */
+        int AddSensor(ScalarSensor* sens);
+        
+        //! A method adding an actuator to the recording.
+        /*!
+         \param act a pointer to the actuator
+         \param frequency the recording rate [Hz] (0 if recorded every simulation step)
+         \return the id of the stream or -1 if the stream could not be added
+         */
+        int AddActuator(Actuator* act, Scalar frequency = Scalar(0));
+        
+        //! A method adding the pose and velocity of a body to the recording.
+        /*!
+         \param ent a pointer to the body
+         \param frequency the recording rate [Hz] (0 if recorded every simulation step)
+         \return the id of the stream or -1 if the stream could not be added
+         */
+        int AddEntity(MovingEntity* ent, Scalar frequency = Scalar(0));
+        
+        //! A method that opens the output file and starts the writer thread.
+        /*!
+         \return true if recording started, false otherwise
+         */
+        bool Start();
+        
+        //! A method that stops the writer thread, flushes all data and closes the file.
+        void Stop();
+        
+        //! A method that records the state of actuators and bodies (called by the simulation manager after each step).
+        /*!
+         \param time the current simulation time [s]
+         */
+        void Record(Scalar time);
+        
+        //! A method that puts a sample in the queue of a stream (never blocks, one producer thread per stream).
+        /*!
+         \param streamId the id of the stream
+         \param time the timestamp of the sample [s]
+         \param values a pointer to the channel values
+         \return true if the sample was queued, false if it was dropped
+         */
+        bool Push(unsigned int streamId, Scalar time, const Scalar* values);
+        
+        //! A method informing if the recorder is running.
+        bool isRecording();
+        
+        //! A method returning the number of samples dropped because the queues were full.
+        uint64_t getDroppedSamples();
+        
+        //! A method returning the path of the output file.
+        std::string getPath();
+    
+    private:
+        struct Stream
+        {
+            std::string name;
+            std::vector<std::string> channels;
+            Scalar rate;
+            Scalar nextTime;
+            ScalarSensor* sensor;
+            Actuator* actuator;
+            MovingEntity* entity;
+            
+            //Queue (rows of time and channel values)
+            std::vector<double> queue;
+            std::atomic<unsigned int> head;
+            std::atomic<unsigned int> tail;
+            
+            //Chunk assembled by the writer (columns of time and channel values)
+            std::vector<double> chunk;
+            unsigned int chunkSize;
+            uint32_t lastFlush;
+        };
+        
+        int AddStream(const std::string& name, const std::vector<std::string>& channels, Scalar rate);
+        void SampleStream(unsigned int streamId, Scalar time);
+        bool Drain(bool flush);
+        void WriteChunk(unsigned int streamId);
+        void WriteString(const std::string& str);
+        void Write(const void* data, size_t size);
+        static int WriterLoop(void* data);
+        
+        std::string path;
+        unsigned int chunkLen;
+        unsigned int queueLen;
+        std::vector<Stream*> streams;
+        std::vector<RecordingIndexEntry> index;
+        FILE* file;
+        uint64_t fileOffset;
+        SDL_Thread* writer;
+        std::atomic<bool> running;
+        std::atomic<uint64_t> dropped;
+    };
+}
+
+#endif
@@ -0,0 +1,129 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  RecordingReader.h
+//  Stonefish
+//
+
+#ifndef __Stonefish_RecordingReader__
+#define __Stonefish_RecordingReader__
+
+#include "core/Recorder.h"
+
+namespace sf
+{
+    //! A class used to read recordings written by the Recorder and convert them to the text and Octave formats.
+    /*!
+     If the recording was not closed properly (e.g. the simulation crashed), the index is rebuilt by scanning the complete chunks.
+     */
+    class RecordingReader
+    {
+    public:
+        //! A constructor.
+        /*!
+         \param path a path to the recording file
+         */
+        RecordingReader(const std::string& path);
+        
+        //! A destructor.
+        ~RecordingReader();
+        
+        //! A method reading the samples of a stream within a time range.
+        /*!
+         \param streamId the id of the stream
+         \param tStart the start of the time range [s]
+         \param tEnd the end of the time range [s]
+         \param time a reference to a vector that will be filled with timestamps
+         \param values a reference to a vector that will be filled with the values of each channel
+         \return true if the stream was read successfully, false otherwise
+         */
+        bool ReadStream(unsigned int streamId, Scalar tStart, Scalar tEnd, std::vector<Scalar>& time, std::vector<std::vector<Scalar>>& values);
+        
+        //! A method used to save a stream to a text file, in the format used by the scalar sensors.
+        /*!
+         \param streamId the id of the stream
+         \param path a path to the output file
+         \param includeTime a flag specifying if the timestamp should be written
+         \param fixedPrecision number of decimal places to write
+         \return true if the file was written, false otherwise
+         */
+        bool SaveStreamToTextFile(unsigned int streamId, const std::string& path, bool includeTime = true, unsigned int fixedPrecision = 6);
+        
+        //! A method used to save all streams to an Octave file, as one matrix per stream.
+        /*!
+         \param path a path to the output file
+         \param includeTime a flag specifying if the timestamp should be written
+         \return true if the file was written, false otherwise
+         */
+        bool SaveToOctaveFile(const std::string& path, bool includeTime = true);
+        
+        //! A method informing if the recording was opened successfully.
+        bool isValid();
+        
+        //! A method informing if the recording was closed properly.
+        bool isComplete();
+        
+        //! A method returning the number of streams in the recording.
+        unsigned int getNumOfStreams();
+        
+        //! A method returning the id of a stream.
+        /*!
+         \param name the name of the stream
+         \return the id of the stream or -1 if not found
+         */
+        int getStreamId(const std::string& name);
+        
+        //! A method returning the name of a stream.
+        /*!
+         \param streamId the id of the stream
+         \return the name of the stream
+         */
+        std::string getStreamName(unsigned int streamId);
+        
+        //! A method returning the names of the channels of a stream.
+        /*!
+         \param streamId the id of the stream
+         \return a vector of channel names
+         */
+        std::vector<std::string> getChannelNames(unsigned int streamId);
+    
+    private:
+        struct StreamInfo
+        {
+            std::string name;
+            Scalar rate;
+            std::vector<std::string> channels;
+        };
+        
+        bool ReadHeader();
+        bool ReadIndex();
+        void ScanChunks();
+        bool ReadString(std::string& str);
+        bool Seek(uint64_t offset);
+        
+        FILE* file;
+        uint64_t fileSize;
+        uint64_t dataOffset;
+        bool valid;
+        bool complete;
+        std::vector<StreamInfo> streams;
+        std::vector<RecordingIndexEntry> index;
+    };
+}
+
+#endif
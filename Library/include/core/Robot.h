@@ -27,6 +27,7 @@
 #define __Stonefish_Robot__
 
 #include <utility>
+#include <unordered_map>
 #include "StonefishCommon.h"
 
 namespace sf
@@ -244,6 +245,10 @@ namespace sf
         std::vector<Sensor*> sensors;
         std::vector<Actuator*> actuators;
         std::vector<Comm*> comms;
+        std::unordered_map<std::string, SolidEntity*> linksByName;
+        std::unordered_map<std::string, Sensor*> sensorsByName;
+        std::unordered_map<std::string, Actuator*> actuatorsByName;
+        std::unordered_map<std::string, Comm*> commsByName;
         std::string name;
     };
 }
@@ -0,0 +1,152 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  SharedMemoryTransport.h
+//  Stonefish
+//
+
+#ifndef __Stonefish_SharedMemoryTransport__
+#define __Stonefish_SharedMemoryTransport__
+
+#include <atomic>
+#include <memory>
+#include "StonefishCommon.h"
+
+#define SHM_STREAM_MAGIC 0x4D534653
+#define SHM_COMMAND_MAGIC 0x43534653
+#define SHM_VERSION 1
+#define SHM_ALIGNMENT 64
+
+namespace sf
+{
+    class Sensor;
+    class ScalarSensor;
+    class VisionSensor;
+    struct VisionSensorFrame;
+    class Actuator;
+    
+    //! A structure placed at the beginning of a shared memory segment of a sensor.
+    /*!
+     The header is followed by a ring of slots, each made of a SharedMemorySlot and the frame data.
+     A reader takes the slot (frames-1) % slots, reads its sequence number, which has to be even, copies or processes the data
+     in place and accepts it only if the sequence number did not change in the meantime.
+     */
+    struct SharedMemoryStreamHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t slots;
+        uint32_t slotSize; //Size of a slot including its header [B]
+        uint32_t width;
+        uint32_t height;
+        uint32_t channels;
+        uint32_t bytesPerChannel; //1 -> uint8, 4 -> float32, 8 -> float64
+        std::atomic<uint64_t> frames; //Number of frames published
+    };
+    
+    //! A structure placed at the beginning of each slot of the sensor ring.
+    struct SharedMemorySlot
+    {
+        std::atomic<uint64_t> seq; //Odd while the slot is written
+        double timestamp;
+    };
+    
+    //! A structure of the shared memory segment used to pass commands to an actuator.
+    /*!
+     A single external writer increments the sequence number to an odd value, writes the values and increments it again.
+     The simulation applies the values once per simulation step, if the sequence number changed and is even.
+     */
+    struct SharedMemoryCommand
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t nValues;
+        uint32_t reserved;
+        std::atomic<uint64_t> seq;
+        double values[4];
+    };
+    
+    //! A class implementing an inter-process transport of sensor data and actuator commands, based on POSIX shared memory.
+    /*!
+     Each sensor and actuator gets its own shared memory segment, named "/<transport name>.<object name>" (with '/' replaced by '.').
+     The list of segments and the layout of their data is published as a JSON manifest in the segment "/<transport name>.manifest".
+     Frames are written once to the shared memory by the producing thread and can be read by local processes without any serialization.
+     */
+    class SharedMemoryTransport
+    {
+    public:
+        //! A constructor.
+        /*!
+         \param name the name of the transport, used as prefix of all segment names
+         \param slots the number of slots in the ring of each sensor
+         */
+        SharedMemoryTransport(const std::string& name, unsigned int slots = 3);
+        
+        //! A destructor.
+        ~SharedMemoryTransport();
+        
+        //! A method publishing the data of a sensor (scalar or vision) in shared memory.
+        /*!
+         \param sens a pointer to the sensor
+         \return true if the segment was created, false otherwise
+         */
+        bool AddSensor(Sensor* sens);
+        
+        //! A method exposing the setpoint of an actuator in shared memory.
+        /*!
+         \param act a pointer to the actuator
+         \return true if the segment was created, false otherwise
+         */
+        bool AddActuator(Actuator* act);
+        
+        //! A method publishing new samples of scalar sensors and applying actuator commands (called by the simulation manager after each step).
+        void Update();
+        
+        //! A method returning the name of the transport.
+        std::string getName();
+    
+    private:
+        struct Segment
+        {
+            std::string name;
+            void* memory;
+            size_t size;
+            ScalarSensor* sensor;
+            Actuator* actuator;
+            uint64_t frames;
+            uint64_t lastSeq;
+            Scalar lastTime;
+            std::string layout;
+            
+            ~Segment();
+        };
+        
+        std::shared_ptr<Segment> CreateSegment(const std::string& objectName, size_t size);
+        std::shared_ptr<Segment> CreateStream(const std::string& objectName, unsigned int width, unsigned int height, unsigned int channels, unsigned int bytesPerChannel);
+        void WriteManifest();
+        static void WriteFrame(Segment* seg, const void* data, size_t size, Scalar time);
+        static void ApplyCommand(Actuator* act, const double* values);
+        
+        std::string name;
+        unsigned int nSlots;
+        std::vector<std::shared_ptr<Segment>> segments;
+        std::shared_ptr<Segment> manifest;
+    };
+}
+
+#endif
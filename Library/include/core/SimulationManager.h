@@ -27,6 +27,9 @@
 #define __Stonefish_SimulationManager__
 
 #include <SDL2/SDL_mutex.h>
+#include <unordered_map>
+#include <queue>
+#include <atomic>
 #include "StonefishCommon.h"
 #include "entities/forcefields/Ocean.h"
 #include "entities/forcefields/Atmosphere.h"
@@ -48,7 +51,10 @@ namespace sf
     class Actuator;
     class Sensor;
     class Comm;
+    struct AcousticNetwork;
     class Contact;
+    class Recorder;
+    class SharedMemoryTransport;
     class OpenGLTrackball;
     class OpenGLDebugDrawer;
     
@@ -65,6 +71,20 @@ namespace sf
         Entity* B;
     };
     
+    //! A structure holding the time spent in each phase of the simulation step [ns].
+    struct TickProfile
+    {
+        uint64_t forces; //Actuators, joint damping, gravity and triggers
+        uint64_t fluids; //Aerodynamic and hydrodynamic forces
+        uint64_t solver; //Collision detection, constraint solving and integration
+        uint64_t kinematics; //Update of motion data
+        uint64_t sensors; //Sensors, recorder and shared memory transport
+        uint64_t comms;
+        uint64_t contacts;
+        uint64_t callback; //SimulationStepCompleted
+        uint64_t ticks; //Number of measured steps
+    };
+    
     //! An abstract class managing the simulation world, the solver settings and implementing custom physics callbacks.
     class SimulationManager
     {
@@ -117,12 +137,25 @@ namespace sf
         //! A method which restarts the simulation.
         void RestartScenario();
         
-        //! A method computing the next simulation step.
+        //! A method computing the next simulation step, keeping pace with real time.
         void AdvanceSimulation();
         
-        //! A method updating the drawing queue (thread safe)
+        //! A method computing exactly one simulation step, as fast as possible (e.g. for batched simulation of many worlds).
+        void StepSimulation();
+        
+        //! A method that binds the simulation world to the calling thread.
+        /*!
+         All objects created or updated by the calling thread use the bound world as their context.
+         The world binds itself when it is built, destroyed or stepped, so that multiple worlds can run concurrently on separate threads.
+         */
+        void MakeCurrent();
+        
+        //! A method building and publishing a new drawing queue (thread safe, never waits for the rendering thread)
         void UpdateDrawingQueue();
         
+        //! A method that forces rebuilding of the sensor update schedule (e.g. after the sensor rate was changed).
+        void InvalidateSensorSchedule();
+        
         //! A method that adds any type of entity to the simulation world.
         /*!
          \param ent a pointer to the entity
@@ -187,6 +220,18 @@ namespace sf
          */
         void AddComm(Comm* comm);
         
+        //! A method that sets the recorder used to stream the simulation data to a file.
+        /*!
+         \param rec a pointer to the recorder (the previous recorder is stopped and destroyed)
+         */
+        void setRecorder(Recorder* rec);
+        
+        //! A method that sets the transport used to exchange sensor data and actuator commands with other processes through shared memory.
+        /*!
+         \param t a pointer to the transport (the previous transport is destroyed)
+         */
+        void setSharedMemoryTransport(SharedMemoryTransport* t);
+        
         //! A method that adds contact monitoring between two entities.
         /*!
           \param a pointer to the contact object
@@ -257,6 +302,24 @@ namespace sf
         void setICSolverParams(bool useGravity, Scalar timeStep = Scalar(0.001), unsigned int maxIterations = 100000,
                                Scalar maxTime = BT_LARGE_FLOAT, Scalar linearTolerance = Scalar(1e-6), Scalar angularTolerance = Scalar(1e-6));
         
+        //! A method that sets the tolerances deciding when the fluid forces acting on a body are recomputed.
+        /*!
+         \param tol a structure holding the tolerances (all zero to recompute the forces in every step)
+         */
+        void setFluidDynamicsTolerances(const FluidDynamicsTolerances& tol);
+        
+        //! A method returning the tolerances deciding when the fluid forces acting on a body are recomputed.
+        FluidDynamicsTolerances getFluidDynamicsTolerances();
+        
+        //! A method that sets up sleeping of the dynamic bodies and multibodies which stay at rest.
+        /*!
+         \param settings a structure holding the sleeping settings
+         */
+        void setSleepingSettings(const SleepingSettings& settings);
+        
+        //! A method returning the settings of sleeping of the dynamic bodies.
+        SleepingSettings getSleepingSettings();
+        
         //! A method that sets the display mode of dynamical rigid bodies.
         /*!
          \param m a flag that defines the display style of dynamical bodies
@@ -275,6 +338,18 @@ namespace sf
         //! A method returning the usage of the CPU by the physics computation in percent.
         Scalar getCpuUsage();
         
+        //! A method that enables measuring the time spent in each phase of the simulation step.
+        /*!
+         \param enabled a flag specifying if the profiling is enabled
+         */
+        void setTickProfiling(bool enabled);
+        
+        //! A method returning the time spent in each phase of the simulation step, accumulated since the last reset.
+        TickProfile getTickProfile();
+        
+        //! A method that clears the accumulated tick profile.
+        void ResetTickProfile();
+        
         //! A method returning the current number of steps per second used.
         Scalar getStepsPerSecond();
         
@@ -305,6 +380,13 @@ namespace sf
          */
         Robot* getRobot(const std::string& name);
         
+        //! A method returning a handle of a robotic system, which can be used for fast access by index.
+        /*!
+         \param name a name of the robot
+         \return a handle (index) of the robot or -1 if not found
+         */
+        int getRobotId(const std::string& name);
+        
         //! A method returning an entity by index.
         /*!
          \param index an id of the entity
@@ -319,6 +401,13 @@ namespace sf
          */
         Entity* getEntity(const std::string& name);
         
+        //! A method returning a handle of an entity, which can be used for fast access by index.
+        /*!
+         \param name a name of the entity
+         \return a handle (index) of the entity or -1 if not found
+         */
+        int getEntityId(const std::string& name);
+        
         //! A method returning a joint by index.
         /*!
          \param index an id of the joint
@@ -333,6 +422,13 @@ namespace sf
          */
         Joint* getJoint(const std::string& name);
         
+        //! A method returning a handle of a joint, which can be used for fast access by index.
+        /*!
+         \param name a name of the joint
+         \return a handle (index) of the joint or -1 if not found
+         */
+        int getJointId(const std::string& name);
+        
         //! A method returning a contact by index.
         /*!
          \param index an id of the contact
@@ -347,6 +443,13 @@ namespace sf
          */
         Contact* getContact(const std::string& name);
         
+        //! A method returning a handle of a contact, which can be used for fast access by index.
+        /*!
+         \param name a name of the contact
+         \return a handle (index) of the contact or -1 if not found
+         */
+        int getContactId(const std::string& name);
+        
         //! A method returning a contavt by entity pair.
         /*!
          \param entA a pointer to the first entity
@@ -369,6 +472,13 @@ namespace sf
          */
         Actuator* getActuator(const std::string& name);
         
+        //! A method returning a handle of an actuator, which can be used for fast access by index.
+        /*!
+         \param name a name of the actuator
+         \return a handle (index) of the actuator or -1 if not found
+         */
+        int getActuatorId(const std::string& name);
+        
         //! A method returning a sensor by index.
         /*!
          \param index an id of the sensor
@@ -383,6 +493,13 @@ namespace sf
          */
         Sensor* getSensor(const std::string& name);
         
+        //! A method returning a handle of a sensor, which can be used for fast access by index.
+        /*!
+         \param name a name of the sensor
+         \return a handle (index) of the sensor or -1 if not found
+         */
+        int getSensorId(const std::string& name);
+        
         //! A method returning a communication device by index.
         /*!
          \param index an id of the communication device
@@ -397,9 +514,19 @@ namespace sf
          */
         Comm* getComm(const std::string& name);
         
+        //! A method returning a handle of a communication device, which can be used for fast access by index.
+        /*!
+         \param name a name of the communication device
+         \return a handle (index) of the communication device or -1 if not found
+         */
+        int getCommId(const std::string& name);
+        
         //! A method returning a pointer to the NED object.
         NED* getNED();
         
+        //! A method returning a pointer to the acoustic network connecting the modems of this world.
+        AcousticNetwork* getAcousticNetwork();
+        
         //! A method returning a pointer to the ocean object.
         Ocean* getOcean();
         
@@ -424,6 +551,12 @@ namespace sf
         //! A method returning a pointer to the name manager.
         NameManager* getNameManager();
         
+        //! A method returning a pointer to the recorder.
+        Recorder* getRecorder();
+        
+        //! A method returning a pointer to the shared memory transport.
+        SharedMemoryTransport* getSharedMemoryTransport();
+        
         //! A method returning a pointer to the trackball view.
         OpenGLTrackball* getTrackball();
         
@@ -436,6 +569,9 @@ namespace sf
         //! A method returning a pointer to the Bullet dynamics world.
         btMultiBodyDynamicsWorld* getDynamicsWorld();
         
+        //! A static method returning the simulation world bound to the calling thread (defaults to the world of the running application).
+        static SimulationManager* getCurrent();
+        
         //------ Aliases created to shorten the code needed to build the scenario ------
         
         //! A method that creates a new material.
@@ -491,14 +627,26 @@ namespace sf
         void RenderBulletDebug();
         void InitializeSolver();
         void InitializeScenario();
+        void UpdateLinkKinematics();
+        void UpdateFluidCandidates();
+        void RebuildSensorSchedule();
+        void UpdateSensors(Scalar now, Scalar timeStep);
+        void ProfileTick(uint64_t& phase);
+        void ApplySleepingSettings();
+        
+        static thread_local SimulationManager* current;
         
         SolverType solver;
         CollisionFilteringType collisionFilter;
         Scalar sps;
         Scalar realtimeFactor;
         Scalar cpuUsage;
-        unsigned int fdPrescaler;
-        unsigned int fdCounter;
+        FluidDynamicsTolerances fdTolerances;
+        SleepingSettings slpSettings;
+        std::vector<btCollisionObject*> fluidCandidates;
+        int fluidCandidatesWorldSize;
+        int fluidCandidatesProxyId;
+        unsigned int fluidCandidatesGeneration;
         SDL_mutex* simSettingsMutex;
         SDL_mutex* simInfoMutex;
         SDL_mutex* simHydroMutex;
@@ -506,6 +654,9 @@ namespace sf
         Scalar simulationTime;
         uint64_t currentTime;
         uint64_t physicsTime;
+        bool tickProfiling;
+        TickProfile tickProfile;
+        uint64_t tickProfileMark;
         uint64_t ssus;
         bool icUseGravity;
         Scalar icTimeStep;
@@ -518,13 +669,27 @@ namespace sf
         bool simulationFresh;
         
         NameManager* nameManager;
+        std::unordered_map<std::string, unsigned int> robotIds;
+        std::unordered_map<std::string, unsigned int> entityIds;
+        std::unordered_map<std::string, unsigned int> jointIds;
+        std::unordered_map<std::string, unsigned int> contactIds;
+        std::unordered_map<std::string, unsigned int> actuatorIds;
+        std::unordered_map<std::string, unsigned int> sensorIds;
+        std::unordered_map<std::string, unsigned int> commIds;
         std::vector<Robot*> robots;
         std::vector<Entity*> entities;
         std::vector<Joint*> joints;
         std::vector<Sensor*> sensors;
+        std::vector<size_t> tickSensors;
+        std::vector<size_t> dueSensors;
+        std::priority_queue<std::pair<Scalar, size_t>, std::vector<std::pair<Scalar, size_t>>, std::greater<std::pair<Scalar, size_t>>> sensorSchedule;
+        std::atomic<bool> sensorScheduleValid; //Cleared by sensors changing their rate from any thread
         std::vector<Actuator*> actuators;
         std::vector<Comm*> comms;
+        AcousticNetwork* acousticNetwork;
         std::vector<Contact*> contacts;
+        Recorder* recorder;
+        SharedMemoryTransport* shmTransport;
         std::vector<Collision> collisions;
         NED* ned;
         Ocean* ocean;
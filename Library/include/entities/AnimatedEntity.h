@@ -137,7 +137,10 @@ namespace sf
         void Update(Scalar dt);
         
         //! A method returning the elements that should be rendered.
-        std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        void Render(DrawingQueue& queue);
         
         //! A method returning the type of the entity.
         EntityType getType() const;
@@ -50,7 +50,7 @@ namespace sf
     //! An enum defining how the body is displayed.
     enum class DisplayMode {GRAPHICAL, PHYSICAL};
     
-    struct Renderable;
+    class DrawingQueue;
     class SimulationManager;
     
     //! An abstract class representing a simulation entity.
@@ -82,7 +82,10 @@ namespace sf
         virtual EntityType getType() const = 0;
         
         //! A method implementing rendering of the entity.
-        virtual std::vector<Renderable> Render() = 0;
+        /*!
+         \param queue the drawing queue to fill
+         */
+        virtual void Render(DrawingQueue& queue) = 0;
         
         //! A method used to add the entity to the simulation.
         /*!
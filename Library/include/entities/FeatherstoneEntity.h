@@ -175,6 +175,18 @@ namespace sf
          */
         void DriveJoint(unsigned int index, Scalar forceTorque);
         
+        //! A method that sets up sleeping of the multibody.
+        /*!
+         \param settings a structure holding the sleeping settings
+         */
+        void SetSleepingProperties(const SleepingSettings& settings);
+        
+        //! A method that wakes up the multibody if it is sleeping.
+        void WakeUp();
+        
+        //! A method informing if the multibody is sleeping.
+        bool isSleeping() const;
+        
         //! A method to apply gravity to the multibody.
         /*!
          \param g the gravity acceleration vector
@@ -198,6 +210,9 @@ namespace sf
          */
         void AddLinkTorque(unsigned int index, const Vector3& tau);
         
+        //! A method computing velocities of all links in a single pass and caching them until the state changes.
+        void UpdateLinkKinematics();
+        
         //! A method used to compute accelerations of the links.
         /*!
          \param dt a step time of the simulation [s]
@@ -369,7 +384,10 @@ namespace sf
         void AddToSimulation(SimulationManager* sm, const Transform& origin);
         
         //! A method implementing the rendering of the multibody.
-        std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        void Render(DrawingQueue& queue);
         
         //! A method returning the extents of the body axis alligned bounding box.
         /*!
@@ -382,6 +400,8 @@ namespace sf
         EntityType getType() const;
         
     private:
+        void InvalidateLinkKinematics();
+        
         btMultiBody* multiBody;
         std::vector<FeatherstoneLink> links;
         std::vector<FeatherstoneJoint> joints;
@@ -54,7 +54,10 @@ namespace sf
         void AddToSimulation(SimulationManager* sm);
         
         //! A method implementing the rendering of the force field.
-        virtual std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        virtual void Render(DrawingQueue& queue);
         
         //! A method returning the extents of the force field axis alligned bounding box.
         /*!
@@ -66,6 +69,16 @@ namespace sf
         //! A method returning the pair caching object for the force field.
         btPairCachingGhostObject* getGhost();
         
+        //! A method updating the registry of dynamic bodies overlapping the force field.
+        /*!
+         \param candidates a list of all dynamic collision objects in the world
+         \param generation a number changed every time the list of candidates is rebuilt
+         */
+        void UpdateMembers(const std::vector<btCollisionObject*>& candidates, unsigned int generation);
+        
+        //! A method returning the dynamic bodies overlapping the force field.
+        const std::vector<btCollisionObject*>& getMembers() const;
+        
         //! A method returning the type of the force field.
         virtual ForcefieldType getForcefieldType() = 0;
         
@@ -74,6 +87,11 @@ namespace sf
         
     protected:
         btPairCachingGhostObject* ghost;
+        
+    private:
+        std::vector<btCollisionObject*> members;
+        std::vector<char> memberFlags;
+        unsigned int membersGeneration;
     };
 }
 
@@ -61,7 +61,10 @@ namespace sf
         virtual void AddToSimulation(SimulationManager* sm, const Transform& origin) = 0;
         
         //! A method returning the elements that should be rendered.
-        virtual std::vector<Renderable> Render() = 0;
+        /*!
+         \param queue the drawing queue to fill
+         */
+        virtual void Render(DrawingQueue& queue) = 0;
 
         //! A method returning the type of the entity.
         virtual EntityType getType() const = 0;
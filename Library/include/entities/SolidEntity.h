@@ -47,11 +47,67 @@ namespace sf
      AERODYNAMIC -> aerodynamics
     */
     enum class BodyPhysicsType {SURFACE, FLOATING, SUBMERGED, AERODYNAMIC};
+    //! An enum defining how the hydrodynamic forces acting on the body are computed.
+    /*!
+     GEOMETRY -> forces integrated over the faces of the physics mesh
+     LUMPED -> forces computed from constant damping coefficients and the restoring force (Fossen-style model)
+    */
+    enum class HydrodynamicsModel {GEOMETRY, LUMPED};
     
     struct HydrodynamicsSettings;
     class Ocean;
     class Atmosphere;
     
+    //! A structure holding the tolerances deciding when the fluid forces acting on a body have to be recomputed.
+    struct FluidDynamicsTolerances
+    {
+        Scalar linearVelocity; //Change of the body velocity relative to the fluid [m/s]
+        Scalar angularVelocity; //Change of the body angular velocity [rad/s]
+        Scalar submergence; //Change of the submerged fraction of the body height [-]
+        Scalar orientation; //Change of the body orientation [rad]
+        Scalar maxAge; //Maximum time for which the forces can be reused [s]
+    };
+    
+    //! A structure holding the statistics of the fluid forces computation of a body.
+    struct FluidDynamicsStatistics
+    {
+        uint64_t computed; //Number of steps in which the forces were recomputed
+        uint64_t reused; //Number of steps in which the previous forces were reused
+    };
+    
+    //! A structure holding the settings of body sleeping (deactivation of bodies which stay at rest).
+    struct SleepingSettings
+    {
+        bool enabled; //Flag enabling sleeping of the bodies
+        Scalar linearVelocity; //Linear velocity below which the body is considered at rest [m/s]
+        Scalar angularVelocity; //Angular velocity below which the body is considered at rest [rad/s]
+        Scalar settleTime; //Time for which the body has to stay at rest before it falls asleep [s]
+        Scalar fluidVelocity; //Change of the fluid velocity at the body CG which wakes the body up [m/s]
+        Scalar depth; //Change of the fluid surface level above the body CG which wakes the body up [m]
+    };
+    
+    //! A structure caching the depths of the physics mesh vertices, computed once per simulation step.
+    struct VertexDepthCache
+    {
+        Scalar time; //Simulation time at which the depths were computed [s]
+        Transform T_C; //Transform of the mesh used to compute the depths
+        std::vector<glm::vec3> positions; //Positions of the vertices in the world frame, indexed as mesh vertices [m]
+        std::vector<GLfloat> depths; //Depths of the vertices below the fluid surface, indexed as mesh vertices [m]
+        
+        VertexDepthCache() : time(-1) {}
+    };
+    
+    //! A structure holding the coefficients of the lumped-parameter hydrodynamic model (diagonal matrices, in the body CG frame).
+    struct LumpedHydrodynamics
+    {
+        Vector3 linearDampingF; //Linear damping of translation [N s m^-1]
+        Vector3 linearDampingT; //Linear damping of rotation [N m s rad^-1]
+        Vector3 quadraticDampingF; //Quadratic damping of translation [N s^2 m^-2]
+        Vector3 quadraticDampingT; //Quadratic damping of rotation [N m s^2 rad^-2]
+        
+        LumpedHydrodynamics() : linearDampingF(0,0,0), linearDampingT(0,0,0), quadraticDampingF(0,0,0), quadraticDampingT(0,0,0) {}
+    };
+    
     //! An abstract class representing a rigid body.
     class SolidEntity : public MovingEntity
     {
@@ -102,6 +158,31 @@ namespace sf
          */
         virtual void ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean* ocn);
         
+        //! A method that recomputes fluid dynamics only if the state of the body changed more than the tolerances allow.
+        /*!
+         \param settings a structure holding settings of fluid dynamics computation
+         \param ocn a pointer to the ocean entity
+         \param tol a structure holding the recomputation tolerances
+         */
+        void UpdateHydrodynamicForces(HydrodynamicsSettings settings, Ocean* ocn, const FluidDynamicsTolerances& tol);
+        
+        //! A method that computes fluid dynamics using the lumped-parameter model.
+        /*!
+         \param settings a structure holding settings of fluid dynamics computation
+         \param ocn a pointer to the ocean entity
+         */
+        void ComputeHydrodynamicForcesLumped(HydrodynamicsSettings settings, Ocean* ocn);
+        
+        //! A static method that adds the damping coefficients of a mesh to the coefficients of the lumped-parameter model.
+        /*!
+         \param mesh a pointer to the physics mesh data
+         \param T_CG2C a transform from the body CG frame to the mesh frame
+         \param corrector a pointer to the body whose geometry approximation is used to correct the damping forces
+         \param ocn a pointer to the fluid entity
+         \param coeffs a reference to the coefficients to accumulate into
+         */
+        static void AccumulateLumpedHydrodynamics(const Mesh* mesh, const Transform& T_CG2C, SolidEntity* corrector, Ocean* ocn, LumpedHydrodynamics& coeffs);
+        
         //! A method that corrects damping forces based on geometry approximation
         /*!
          \param ocn a pointer to the fluid entity generating forces (currently only Ocean supported)
@@ -131,9 +212,21 @@ namespace sf
          \param _Tdq output of the torque induced by form drag
          \param _Fds output of the damping force resulting from skin friction
          \param _Tds output of the torque induced by skin friction
+         \param cache a reference to the cache of vertex depths of the mesh
+         \param debug a reference to the list of line points used to display the submerged part of the mesh
         */
         static void ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings& settings, const Mesh* mesh, Ocean* liquid, const Transform& T_CG, const Transform& T_C,
-                                                     const Vector3& linearV, const Vector3& angularV, Vector3& _Fb, Vector3& _Tb, Vector3& _Fdl, Vector3& _Tdl, Vector3& _Fdq, Vector3& _Tdq, Vector3& _Fds, Vector3& _Tds, Renderable& debug);
+                                                     const Vector3& linearV, const Vector3& angularV, Vector3& _Fb, Vector3& _Tb, Vector3& _Fdl, Vector3& _Tdl, Vector3& _Fdq, Vector3& _Tdq, Vector3& _Fds, Vector3& _Tds,
+                                                     VertexDepthCache& cache, std::vector<glm::vec3>& debug);
+        
+        //! A static method that computes the depths of all mesh vertices, unless they were already computed in the current simulation step.
+        /*!
+         \param mesh a pointer to the body physics mesh data
+         \param liquid a pointer to the fluid entity
+         \param T_C a transform from the world frame to the physics frame
+         \param cache a reference to the cache of vertex depths to update
+         */
+        static void UpdateVertexDepths(const Mesh* mesh, Ocean* liquid, const Transform& T_C, VertexDepthCache& cache);
         
         //! A static method that computes fluid dynamics when a body is completely submerged.
         /*!
@@ -159,6 +252,13 @@ namespace sf
         */
         virtual void ComputeAerodynamicForces(Atmosphere* atm);
         
+        //! A method that recomputes aerodynamics only if the state of the body changed more than the tolerances allow.
+        /*!
+         \param atm a pointer to the atmosphere entity
+         \param tol a structure holding the recomputation tolerances
+         */
+        void UpdateAerodynamicForces(Atmosphere* atm, const FluidDynamicsTolerances& tol);
+        
         //! A method that corrects damping forces based on geometry shape approximation
         /*!
          \param atm a pointer to the atmosphere object
@@ -181,6 +281,51 @@ namespace sf
         static void ComputeAerodynamicForces(const Mesh* mesh, Atmosphere* atm, const Transform& T_CG, const Transform& T_C,
                                              const Vector3& linearV, const Vector3& angularV, Vector3& _Fda, Vector3& _Tda);
         
+        //! A method that sets the model used to compute the hydrodynamic forces.
+        /*!
+         \param model the hydrodynamic model
+         */
+        void setHydrodynamicsModel(HydrodynamicsModel model);
+        
+        //! A method that sets the coefficients of the lumped-parameter hydrodynamic model, instead of deriving them from the geometry.
+        /*!
+         \param coeffs a structure holding the damping coefficients
+         */
+        void setLumpedHydrodynamics(const LumpedHydrodynamics& coeffs);
+        
+        //! A method that overrides the hydrodynamic added mass and inertia (has to be called before the body is added to the simulation).
+        /*!
+         \param addedMass the diagonal elements of the added mass matrix [kg]
+         \param addedInertia the diagonal elements of the added inertia matrix [kg m^2]
+         */
+        void setAddedMass(const Vector3& addedMass, const Vector3& addedInertia);
+        
+        //! A method that sets up sleeping of the body.
+        /*!
+         \param settings a structure holding the sleeping settings
+         */
+        void SetSleepingProperties(const SleepingSettings& settings);
+        
+        //! A method that wakes up the body if it is sleeping.
+        void WakeUp();
+        
+        //! A method that measures how long the body stayed at rest and lets it fall asleep after the settle time.
+        void UpdateSleeping();
+        
+        //! A method that checks if a sleeping body should stay asleep, waking it up if the ocean around it changed.
+        /*!
+         \param ocn a pointer to the ocean entity
+         \return true if the body is sleeping
+         */
+        bool CheckSleeping(Ocean* ocn);
+        
+        //! A method that checks if a sleeping body should stay asleep, waking it up if the wind around it changed.
+        /*!
+         \param atm a pointer to the atmosphere entity
+         \return true if the body is sleeping
+         */
+        bool CheckSleeping(Atmosphere* atm);
+        
         //! A method which applies given force to the body CG.
         /*!
          \param force a force to be applied to the body, in the world frame
@@ -305,6 +450,12 @@ namespace sf
 		//! A method returning the hydrodynamic added inertia (diagonal elements).
 		Vector3 getAddedInertia() const;
         
+        //! A method returning the model used to compute the hydrodynamic forces.
+        HydrodynamicsModel getHydrodynamicsModel() const;
+        
+        //! A method returning the coefficients of the lumped-parameter hydrodynamic model (derived at the first computation, unless set).
+        LumpedHydrodynamics getLumpedHydrodynamics() const;
+        
         //! A method returning the volume of the body.
         Scalar getVolume() const;
         
@@ -321,6 +472,9 @@ namespace sf
         //! A method that returns a copy of all physics mesh vertices in body origin frame.
         virtual std::vector<Vector3>* getMeshVertices() const;
         
+        //! A method informing if the body is sleeping.
+        bool isSleeping() const;
+        
         //! A method informing if the body is using buoyancy computation.
         bool isBuoyant() const;
         
@@ -332,7 +486,10 @@ namespace sf
         virtual void BuildGraphicalObject();
         
         //! A method returning the elements that should be rendered.
-        virtual std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        virtual void Render(DrawingQueue& queue);
         
         //! A method returning the extents of the body axis alligned bounding box.
         /*!
@@ -341,6 +498,9 @@ namespace sf
          */
         void getAABB(Vector3& min, Vector3& max);
         
+        //! A method returning the statistics of the fluid forces computation.
+        FluidDynamicsStatistics getFluidDynamicsStatistics() const;
+        
         //! A method used to set if the body CG should be rendered.
         void setDisplayCoordSys(bool enabled);
         
@@ -349,6 +509,10 @@ namespace sf
         
     protected:
         BodyFluidPosition CheckBodyFluidPosition(Ocean* ocn);
+        bool IsFluidDynamicsOutdated(const Vector3& fluidVelocity, Scalar submergence, const FluidDynamicsTolerances& tol);
+        Scalar EstimateSubmergence(Ocean* ocn);
+        bool CheckSleeping(const Vector3& fluidVelocity, Scalar depth);
+        virtual void DeriveLumpedHydrodynamics(Ocean* ocn);
         void ComputeFluidDynamicsApprox(GeometryApproxType t);
         void ComputeSphericalApprox();
         void ComputeCylindricalApprox();
@@ -400,15 +564,38 @@ namespace sf
         Vector3 Fda;
         Vector3 Tda;
         
+        //State of the body at the last fluid forces computation
+        bool fdValid;
+        Scalar fdTime;
+        Vector3 fdRelativeVel;
+        Vector3 fdAngularVel;
+        Scalar fdSubmergence;
+        Quaternion fdOrientation;
+        FluidDynamicsStatistics fdStats;
+        VertexDepthCache depthCache;
+        HydrodynamicsModel hydroModel;
+        LumpedHydrodynamics lumped;
+        bool lumpedValid;
+        
+        //Sleeping
+        SleepingSettings slpSettings;
+        bool slpFluidValid;
+        Vector3 slpFluidVel; //Fluid velocity at the body CG when the body fell asleep
+        Scalar slpDepth; //Depth of the body CG when the body fell asleep
+        Scalar slpRestTime; //Time for which the body stayed at rest [s]
+        
         //Motion
         Vector3 filteredLinearVel;
         Vector3 filteredAngularVel;
         Vector3 linearAcc;
         Vector3 angularAcc;
+        Vector3 mbLinearVel; //Multibody link velocities cached once per tick
+        Vector3 mbAngularVel;
+        bool mbVelocityCached;
         
         //Display
         int phyObjectId;
-        Renderable submerged;
+        std::vector<glm::vec3> submerged; //Lines displaying the submerged part of the mesh
         
     private:
         friend class FeatherstoneEntity;
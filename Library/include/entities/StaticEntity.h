@@ -52,7 +52,10 @@ namespace sf
         virtual ~StaticEntity();
         
         //! A method implementing the rendering of the entity.
-        virtual std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        virtual void Render(DrawingQueue& queue);
         
         //! A method used to add the static entity to the simulation.
         /*!
@@ -64,11 +64,14 @@ namespace sf
         virtual void BuildGraphicalPath();
 
         //! A method returning the elements that should be rendered.
-        Renderable Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        void Render(DrawingQueue& queue);
 
     protected:
         std::vector<KeyPoint> points;
-        Renderable path;
+        std::vector<glm::vec3> path; //Points of the graphical path
     };
 }
 
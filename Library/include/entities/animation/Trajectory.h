@@ -57,7 +57,10 @@ namespace sf
         virtual void Interpolate() = 0;
 
         //! A method returning the elements that should be rendered.
-        virtual Renderable Render() = 0;
+        /*!
+         \param queue the drawing queue to fill
+         */
+        virtual void Render(DrawingQueue& queue) = 0;
 
         //! A method returning the current interpolated transform.
         Transform getInterpolatedTransform() const;
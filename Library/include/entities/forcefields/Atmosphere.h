@@ -30,11 +30,13 @@
 #include "core/MaterialManager.h"
 #include "entities/ForcefieldEntity.h"
 #include "graphics/OpenGLDataStructs.h"
+#include "entities/forcefields/VelocityFieldIndex.h"
 
 namespace sf
 {
     class VelocityField;
     class OpenGLAtmosphere;
+    struct FluidDynamicsTolerances;
     struct RenderSettings;
     
     //! A class representing the atmosphere.
@@ -72,6 +74,12 @@ namespace sf
          */
         void SetupSunPosition(Scalar azimuthDeg, Scalar elevationDeg);
         
+        //! A method used to add the atmosphere to the simulation.
+        /*!
+         \param sm a pointer to the simulation manager
+         */
+        void AddToSimulation(SimulationManager* sm);
+        
         //! A method used to add a velocity field to the atmosphere.
         /*!
          \param field a pointer to a velocity field object
@@ -82,9 +90,9 @@ namespace sf
         /*!
          \param world a pointer to the dynamics world
          \param co a pointer to the collision object
-         \param recompute a flag deciding if hydrodynamic forces need to be recomputed
+         \param tol the tolerances deciding if the forces of a body need to be recomputed
          */
-        void ApplyFluidForces(btDynamicsWorld* world, btCollisionObject* co, bool recompute);
+        void ApplyFluidForces(btDynamicsWorld* world, btCollisionObject* co, const FluidDynamicsTolerances& tol);
         
         //! A method returning the position of the sun in the sky.
         /*!
@@ -126,6 +134,7 @@ namespace sf
     private:
         Fluid gas;
         std::vector<VelocityField*> wind;
+        VelocityFieldIndex windIndex;
         OpenGLAtmosphere* glAtmosphere;
     };
 }
@@ -0,0 +1,103 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  Gridded.h
+//  Stonefish
+//
+
+#ifndef __Stonefish_Gridded__
+#define __Stonefish_Gridded__
+
+#include "entities/forcefields/VelocityField.h"
+
+namespace sf
+{
+    //! Gridded velocity field class.
+    /*!
+     Class implements a time-varying velocity field defined on a regular or stretched 3D grid (e.g. output of an ocean model).
+     The velocity is interpolated trilinearly in space and linearly in time. Outside of the grid the velocity is zero,
+     except for the axes defined with a single node, along which the field is constant.
+     */
+    class Gridded : public VelocityField
+    {
+    public:
+        //! A constructor.
+        /*!
+         \param x the coordinates of the grid nodes along the X axis (strictly increasing) [m]
+         \param y the coordinates of the grid nodes along the Y axis (strictly increasing) [m]
+         \param z the coordinates of the grid nodes along the Z axis (strictly increasing) [m]
+         \param t the times of the data slices (strictly increasing) [s]
+         \param velocity the velocities at the grid nodes, ordered by time, z, y and x (fastest) [m/s]
+         \param loop a flag defining if the time series should be repeated
+         */
+        Gridded(const std::vector<Scalar>& x, const std::vector<Scalar>& y, const std::vector<Scalar>& z,
+                const std::vector<Scalar>& t, const std::vector<Vector3>& velocity, bool loop = false);
+        
+        //! A constructor.
+        /*!
+         \param path a path to a text file containing the gridded data
+         \param loop a flag defining if the time series should be repeated
+         */
+        Gridded(const std::string& path, bool loop = false);
+        
+        //! A method returning velocity at a specified point.
+        /*!
+         \param p a point at which the velocity is requested
+         \return velocity [m/s]
+         */
+        Vector3 GetVelocityAtPoint(const Vector3& p);
+        
+        //! A method returning the axis-aligned bounding box of the grid.
+        /*!
+         \param min a reference to a vector that will store the minimum corner [m]
+         \param max a reference to a vector that will store the maximum corner [m]
+         */
+        void getAABB(Vector3& min, Vector3& max);
+        
+        //! A method implementing the rendering of the field.
+        /*!
+         \param queue the drawing queue to fill
+         \param ubo the structure to be filled with the parameters of the field
+         */
+        void Render(DrawingQueue& queue, VelocityFieldUBO& ubo);
+        
+        //! A method informing if the field contains valid data.
+        bool isValid() const;
+    
+    private:
+        struct GridAxis
+        {
+            std::vector<Scalar> nodes;
+            std::vector<unsigned int> lut; //Index of the cell at the beginning of each bin
+            Scalar invBinSize;
+        };
+        
+        bool Setup(const std::vector<Scalar>& x, const std::vector<Scalar>& y, const std::vector<Scalar>& z,
+                   const std::vector<Scalar>& t, const std::vector<Vector3>& velocity);
+        Vector3 Interpolate(size_t slice, const size_t idx[3], const Scalar frac[3]) const;
+        static bool BuildAxis(GridAxis& axis);
+        static bool Locate(const GridAxis& axis, Scalar v, size_t& i, Scalar& frac);
+        
+        GridAxis axes[3];
+        std::vector<Scalar> times;
+        std::vector<Vector3> vel;
+        bool loop;
+    };
+}
+
+#endif
@@ -56,7 +56,11 @@ namespace sf
         Vector3 GetVelocityAtPoint(const Vector3& p);
         
         //! A method implementing the rendering of the jet.
-        std::vector<Renderable> Render(VelocityFieldUBO& ubo);
+        /*!
+         \param queue the drawing queue to fill
+         \param ubo the structure to be filled with the parameters of the field
+         */
+        void Render(DrawingQueue& queue, VelocityFieldUBO& ubo);
         
     private:
         Vector3 c, n;
@@ -30,6 +30,7 @@
 #include "core/MaterialManager.h"
 #include "entities/ForcefieldEntity.h"
 #include "graphics/OpenGLOcean.h"
+#include "entities/forcefields/VelocityFieldIndex.h"
 
 namespace sf
 {
@@ -42,6 +43,7 @@ namespace sf
     
     class VelocityField;
     class Actuator;
+    struct FluidDynamicsTolerances;
     
     //! A class implementing an ocean.
     class Ocean : public ForcefieldEntity
@@ -64,6 +66,12 @@ namespace sf
          */
         void setWaterType(Scalar jerlov);
         
+        //! A method used to add the ocean to the simulation.
+        /*!
+         \param sm a pointer to the simulation manager
+         */
+        void AddToSimulation(SimulationManager* sm);
+        
         //! A method used to add a velocity field to the ocean.
         /*!
          \param field a pointer to a velocity field object
@@ -74,9 +82,9 @@ namespace sf
         /*!
          \param world a pointer to the dynamics world
          \param co a pointer to the collision object
-         \param recompute a flag deciding if hydrodynamic forces need to be recomputed
+         \param tol the tolerances deciding if the forces of a body need to be recomputed
          */
-        void ApplyFluidForces(btDynamicsWorld* world, btCollisionObject* co, bool recompute);
+        void ApplyFluidForces(btDynamicsWorld* world, btCollisionObject* co, const FluidDynamicsTolerances& tol);
         
         //! A method returning the water velocity.
         /*!
@@ -108,6 +116,15 @@ namespace sf
         Scalar GetDepth(const Vector3& point);
         GLfloat GetDepth(const glm::vec3& point);
         
+        //! A method returning the depth of the ocean at multiple points at once.
+        /*!
+         \param points a pointer to an array of measurement points [m]
+         \param n the number of points
+         \param depths a pointer to an array receiving the distances from the points to the surface of fluid [m]
+         */
+        void GetDepth(const Vector3* points, size_t n, Scalar* depths);
+        void GetDepth(const glm::vec3* points, size_t n, GLfloat* depths);
+        
         //! A method to enable all defined currents.
         void EnableCurrents();
         
@@ -139,21 +156,30 @@ namespace sf
         void InitGraphics(SDL_mutex* hydrodynamics);
         
         //! A method implementing the rendering of the force field.
-        std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        void Render(DrawingQueue& queue);
 
         //! A method implementing the rendering of the ocean force field.
-        std::vector<Renderable> Render(const std::vector<Actuator*>& act);
+        /*!
+         \param queue the drawing queue to fill
+         \param act a list of actuators affecting the ocean currents
+         */
+        void Render(DrawingQueue& queue, const std::vector<Actuator*>& act);
         
     private:
         Fluid liquid;
         std::vector<VelocityField*> currents;
+        VelocityFieldIndex currentsIndex;
         OpenGLOcean* glOcean;
+        SDL_mutex* wavesMutex;
         OceanCurrentsUBO glOceanCurrentsUBOData;
         Scalar depth;
         Scalar waterType;
         Scalar oceanState;
         bool currentsEnabled;
-        Renderable wavesDebug;
+        std::vector<glm::vec3> wavesDebug; //Points of the wave surface sampled by the bodies
     };
 }
 
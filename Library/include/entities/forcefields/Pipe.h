@@ -57,8 +57,19 @@ namespace sf
          */
         Vector3 GetVelocityAtPoint(const Vector3& p);
         
+        //! A method returning the axis-aligned bounding box of the pipe.
+        /*!
+         \param min a reference to a vector that will store the minimum corner [m]
+         \param max a reference to a vector that will store the maximum corner [m]
+         */
+        void getAABB(Vector3& min, Vector3& max);
+        
         //! A method implementing the rendering of the pipe.
-        std::vector<Renderable> Render(VelocityFieldUBO& ubo);
+        /*!
+         \param queue the drawing queue to fill
+         \param ubo the structure to be filled with the parameters of the field
+         */
+        void Render(DrawingQueue& queue, VelocityFieldUBO& ubo);
         
     private:
         Vector3 p1, n;
@@ -79,7 +79,10 @@ namespace sf
         void Clear();
         
         //! A method implementing the rendering of the trigger.
-        std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        void Render(DrawingQueue& queue);
         
         //! A method returning the activity status.
         bool isActive();
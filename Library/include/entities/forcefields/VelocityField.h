@@ -48,8 +48,19 @@ namespace sf
          */
         virtual Vector3 GetVelocityAtPoint(const Vector3& p) = 0;
         
+        //! A method returning the axis-aligned bounding box outside of which the velocity is zero.
+        /*!
+         \param min a reference to a vector that will store the minimum corner [m]
+         \param max a reference to a vector that will store the maximum corner [m]
+         */
+        virtual void getAABB(Vector3& min, Vector3& max);
+        
         //! A method implementing the rendering of the velocity field.
-        virtual std::vector<Renderable> Render(VelocityFieldUBO& ubo) = 0;
+        /*!
+         \param queue the drawing queue to fill
+         \param ubo the structure to be filled with the parameters of the field
+         */
+        virtual void Render(DrawingQueue& queue, VelocityFieldUBO& ubo) = 0;
     };
 }
 
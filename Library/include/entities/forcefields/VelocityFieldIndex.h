@@ -0,0 +1,71 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  VelocityFieldIndex.h
+//  Stonefish
+//
+
+#ifndef __Stonefish_VelocityFieldIndex__
+#define __Stonefish_VelocityFieldIndex__
+
+#include "StonefishCommon.h"
+
+namespace sf
+{
+    class VelocityField;
+    
+    //! A class implementing a spatial index of velocity fields.
+    /*!
+     Class sorts the bounded velocity fields into a regular grid of cells spanning their common bounding box,
+     so that only the fields overlapping the cell containing a query point are evaluated.
+     Unbounded fields are evaluated at every point.
+     */
+    class VelocityFieldIndex
+    {
+    public:
+        //! A constructor.
+        VelocityFieldIndex();
+        
+        //! A method used to rebuild the index.
+        /*!
+         \param fields a list of velocity fields to be indexed (not owned by the index)
+         */
+        void Build(const std::vector<VelocityField*>& fields);
+        
+        //! A method returning the sum of the velocities of all fields at a specified point.
+        /*!
+         \param p a point at which the velocity is requested
+         \return velocity [m/s]
+         */
+        Vector3 GetVelocityAtPoint(const Vector3& p) const;
+    
+    private:
+        std::vector<VelocityField*> fields;
+        std::vector<Vector3> fieldMin;
+        std::vector<Vector3> fieldMax;
+        std::vector<unsigned int> unbounded;
+        std::vector<unsigned int> cellStart;
+        std::vector<unsigned int> cellFields;
+        Vector3 gridMin;
+        Vector3 gridMax;
+        Vector3 invCellSize;
+        int dims[3];
+    };
+}
+
+#endif
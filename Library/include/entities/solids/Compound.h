@@ -36,6 +36,7 @@ namespace sf
         SolidEntity* solid;
         Transform origin;
         bool isExternal;
+        VertexDepthCache depthCache;
     } CompoundPart;
     
     //! A class representing a rigid body built of multiple other rigid bodies.
@@ -81,6 +82,12 @@ namespace sf
         */
         void ComputeAerodynamicForces(Atmosphere* atm);
         
+        //! A method that enables computing hydrodynamics on one mesh built by merging all external parts (has to be called before the body is added to the simulation).
+        /*!
+         \param enabled a flag that informs if the merged mesh should be used
+         */
+        void setMergedHydrodynamicMesh(bool enabled);
+        
         //! A method that sets if the internal or the external parts of the body should be displayed.
         /*!
          \param enabled a flag that informs if the internal parts should be displayed
@@ -108,6 +115,9 @@ namespace sf
         //! A method that informs if the internal parts of the body are displayed.
         bool isDisplayingInternalParts();
         
+        //! A method that informs if hydrodynamics is computed on the merged mesh of the external parts.
+        bool isHydrodynamicMeshMerged();
+        
         //! A method that constructs a collision shape for the body.
         btCollisionShape* BuildCollisionShape();
         
@@ -115,14 +125,21 @@ namespace sf
         void BuildGraphicalObject();
         
         //! A method that returns elements that have to be rendered for the body.
-        std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        void Render(DrawingQueue& queue);
         
     private:
         std::vector<CompoundPart> parts; //Parts of the compound solid
         std::vector<size_t> collisionPartId;
         bool displayInternals;
+        bool mergeHydroMesh;
+        Mesh* hydroMesh; //Merged mesh of the external parts, in compound origin frame
         
         void RecalculatePhysicalProperties();
+        void BuildHydrodynamicMesh();
+        void DeriveLumpedHydrodynamics(Ocean* ocn);
     };
 
 }
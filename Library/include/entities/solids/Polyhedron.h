@@ -30,6 +30,18 @@
 
 namespace sf
 {
+    //! An enum defining the predefined quality levels of the physics mesh.
+    enum class MeshQuality {ORIGINAL, HIGH, MEDIUM, LOW};
+    
+    //! A structure defining the decimation of the physics mesh (used for collisions and fluid dynamics).
+    struct MeshDecimation
+    {
+        unsigned int faces; //Target number of faces (0 -> not limited)
+        Scalar error; //Maximum geometric error of a single edge collapse [m] (0 -> not limited)
+        
+        MeshDecimation(MeshQuality quality = MeshQuality::ORIGINAL);
+    };
+    
     //! A class representing a rigid body of any shape described by a polyhedron (mesh with triangle faces).
     class Polyhedron : public SolidEntity
     {
@@ -49,12 +61,13 @@ namespace sf
          \param thickness defines the thickness of the physics geometry walls, if higher than zero the mesh is considered a shell
          \param isBuoyant defines if buoyancy forces should be calculated for the body
          \param approx defines what type of approximation of the body shape should be used in the fluid dynamics computation
+         \param decimation defines how the physics mesh should be simplified
          */
         Polyhedron(std::string uniqueName,
                    std::string graphicsFilename, Scalar graphicsScale, const Transform& graphicsOrigin,
                    std::string physicsFilename, Scalar physicsScale, const Transform& physicsOrigin,
                    std::string material, BodyPhysicsType bpt, std::string look = "", Scalar thickness = Scalar(-1), 
-                   bool isBuoyant = true, GeometryApproxType approx =  GeometryApproxType::AUTO);
+                   bool isBuoyant = true, GeometryApproxType approx =  GeometryApproxType::AUTO, const MeshDecimation& decimation = MeshDecimation());
         
         //! A constructor.
         /*!
@@ -68,10 +81,11 @@ namespace sf
          \param thickness defines the thickness of the model walls, if higher than zero the mesh is considered a shell
          \param isBuoyant defines if buoyancy forces should be calculated for the body
          \param approx defines what type of approximation of the body shape should be used in the fluid dynamics computation
+         \param decimation defines how the physics mesh should be simplified
          */
         Polyhedron(std::string uniqueName, std::string modelFilename, Scalar scale, const Transform& origin,
                    std::string material, BodyPhysicsType bpt, std::string look = "", Scalar thickness = Scalar(-1), 
-                   bool isBuoyant = true, GeometryApproxType approx =  GeometryApproxType::AUTO);
+                   bool isBuoyant = true, GeometryApproxType approx =  GeometryApproxType::AUTO, const MeshDecimation& decimation = MeshDecimation());
         
         //! A destructor.
         ~Polyhedron();
@@ -95,7 +95,10 @@ namespace sf
         ~Obstacle();
         
         //! A method implementing the rendering of the entity.
-        std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        void Render(DrawingQueue& queue);
         
         //! A method that returns the static body type.
         StaticEntityType getStaticType();
@@ -27,6 +27,7 @@
 #define __Stonefish_GLSLShader__
 
 #include <utility>
+#include <map>
 #include "graphics/OpenGLDataStructs.h"
 
 namespace sf
@@ -42,6 +43,19 @@ namespace sf
         GLint location;
     };
     
+    //! A structure representing a pre-resolved handle to a GLSL uniform.
+    struct GLSLUniformHandle
+    {
+        GLint location;
+        ParameterType type;
+
+        GLSLUniformHandle() : location(-1), type(ParameterType::FLOAT) {}
+        GLSLUniformHandle(GLint location, ParameterType type) : location(location), type(type) {}
+
+        //! A method to check if the handle points to an active uniform.
+        bool isValid() const { return location >= 0; }
+    };
+    
     //! A structure containing information about a GLSL attribute.
     struct GLSLAttribute
     {
@@ -236,6 +250,118 @@ namespace sf
          */
         bool SetUniform(std::string name, glm::mat4 x);
 
+        //! A method returning a pre-resolved handle to a GLSL uniform (to be used in the drawing loops).
+        /*!
+         \param name the name of the uniform
+         \return a handle to the uniform (invalid if the uniform was not added)
+         */
+        GLSLUniformHandle GetUniformHandle(const std::string& name) const;
+
+        //! A method used to set a GLSL uniform using a pre-resolved handle.
+        /*!
+         \param handle the handle of the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& handle, bool x);
+
+        //! A method used to set a GLSL uniform using a pre-resolved handle.
+        /*!
+         \param handle the handle of the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& handle, GLfloat x);
+
+        //! A method used to set a GLSL uniform using a pre-resolved handle.
+        /*!
+         \param handle the handle of the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& handle, glm::vec2 x);
+
+        //! A method used to set a GLSL uniform using a pre-resolved handle.
+        /*!
+         \param handle the handle of the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& handle, glm::vec3 x);
+
+        //! A method used to set a GLSL uniform using a pre-resolved handle.
+        /*!
+         \param handle the handle of the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& handle, glm::vec4 x);
+
+        //! A method used to set a GLSL uniform using a pre-resolved handle.
+        /*!
+         \param handle the handle of the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& handle, GLuint x);
+
+        //! A method used to set a GLSL uniform using a pre-resolved handle.
+        /*!
+         \param handle the handle of the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& handle, GLint x);
+
+        //! A method used to set a GLSL uniform using a pre-resolved handle.
+        /*!
+         \param handle the handle of the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& handle, glm::ivec2 x);
+
+        //! A method used to set a GLSL uniform using a pre-resolved handle.
+        /*!
+         \param handle the handle of the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& handle, glm::ivec3 x);
+
+        //! A method used to set a GLSL uniform using a pre-resolved handle.
+        /*!
+         \param handle the handle of the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& handle, glm::ivec4 x);
+
+        //! A method used to set a GLSL uniform using a pre-resolved handle.
+        /*!
+         \param handle the handle of the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& handle, glm::uvec2 x);
+
+        //! A method used to set a GLSL uniform using a pre-resolved handle.
+        /*!
+         \param handle the handle of the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& handle, glm::uvec3 x);
+
+        //! A method used to set a GLSL uniform using a pre-resolved handle.
+        /*!
+         \param handle the handle of the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& handle, glm::uvec4 x);
+
+        //! A method used to set a GLSL uniform using a pre-resolved handle.
+        /*!
+         \param handle the handle of the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& handle, const glm::mat3& x);
+
+        //! A method used to set a GLSL uniform using a pre-resolved handle.
+        /*!
+         \param handle the handle of the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& handle, const glm::mat4& x);
+
         //! A method used to bind a GLSL uniform block.
         /*!
          \param name the name of the uniform block
@@ -279,8 +405,9 @@ namespace sf
         static GLuint LoadShader(GLenum shaderType, const std::string& filename, const std::string& header, GLint* shaderCompiled);
         
     private:
-        bool GetAttribute(std::string name, ParameterType type, GLint& index);
-        bool GetUniform(std::string name, ParameterType type, GLint& location);
+        void Build(const std::vector<GLSLSource>& sources, const std::vector<GLuint>& precompiled);
+        bool GetAttribute(const std::string& name, ParameterType type, GLint& index);
+        bool GetUniform(const std::string& name, ParameterType type, GLint& location);
         
         std::vector<GLSLAttribute> attributes;
         std::vector<GLSLUniform> uniforms;
@@ -289,7 +416,15 @@ namespace sf
         
         static GLuint saqVertexShader;
         static bool verbose;
+        static std::string binaryCachePath;
+        static uint64_t driverHash;
+        static std::map<GLuint, uint64_t> shaderHashes; //Source hashes of compiled shaders
         static GLuint CreateProgram(const std::vector<GLuint>& compiledShaders, unsigned int doNotDeleteNFirstShaders = 0);
+        static std::string PreprocessShader(const std::string& filename, const std::string& header);
+        static GLuint CompileShader(GLenum shaderType, const std::string& source, GLint* shaderCompiled);
+        static uint64_t HashShader(GLenum shaderType, const std::string& source);
+        static GLuint LoadProgramBinary(uint64_t key);
+        static void SaveProgramBinary(GLuint program, uint64_t key);
     };
 }
 
@@ -160,6 +160,9 @@ namespace sf
     private:
         //Precomputation
         void Precompute();
+        uint64_t ComputeCacheKey();
+        bool LoadPrecomputedTextures(const std::string& path, uint64_t key);
+        void SavePrecomputedTextures(const std::string& path, uint64_t key);
         void PrecomputePass(GLuint fbo, GLuint delta_irradiance_texture, GLuint delta_rayleigh_scattering_texture,
                             GLuint delta_mie_scattering_texture, GLuint delta_scattering_density_texture,
                             GLuint delta_multiple_scattering_texture, const glm::dvec3& lambdas, const glm::dmat3& luminance_from_radiance, bool blend);
@@ -28,6 +28,7 @@
 
 #include "graphics/OpenGLDataStructs.h"
 #include "graphics/GLSLShader.h"
+#include "graphics/OpenGLView.h"
 #include "core/NameManager.h"
 #include "graphics/OpenGLPointLight.h"
 #include "graphics/OpenGLSpotLight.h"
@@ -72,11 +73,59 @@ namespace sf
     };
     #pragma pack(0)
 
+    //! A structure holding handles of the per-object and per-look uniforms of a shader.
+    struct ObjectUniforms
+    {
+        GLSLUniformHandle MVP;
+        GLSLUniformHandle M;
+        GLSLUniformHandle N;
+        GLSLUniformHandle cWater;
+        GLSLUniformHandle bWater;
+        GLSLUniformHandle texWaveFFT;
+        GLSLUniformHandle gridSizes;
+        GLSLUniformHandle color;
+        GLSLUniformHandle lightId;
+        GLSLUniformHandle specularStrength;
+        GLSLUniformHandle shininess;
+        GLSLUniformHandle roughness;
+        GLSLUniformHandle metallic;
+        GLSLUniformHandle reflectivity;
+        GLSLUniformHandle enableAlbedoTex;
+        GLSLUniformHandle enableNormalTex;
+
+        ObjectUniforms() {}
+
+        //! A constructor resolving handles from a shader.
+        /*!
+         \param shader a pointer to the shader
+         */
+        ObjectUniforms(const GLSLShader* shader)
+        {
+            MVP = shader->GetUniformHandle("MVP");
+            M = shader->GetUniformHandle("M");
+            N = shader->GetUniformHandle("N");
+            cWater = shader->GetUniformHandle("cWater");
+            bWater = shader->GetUniformHandle("bWater");
+            texWaveFFT = shader->GetUniformHandle("texWaveFFT");
+            gridSizes = shader->GetUniformHandle("gridSizes");
+            color = shader->GetUniformHandle("color");
+            lightId = shader->GetUniformHandle("lightId");
+            specularStrength = shader->GetUniformHandle("specularStrength");
+            shininess = shader->GetUniformHandle("shininess");
+            roughness = shader->GetUniformHandle("roughness");
+            metallic = shader->GetUniformHandle("metallic");
+            reflectivity = shader->GetUniformHandle("reflectivity");
+            enableAlbedoTex = shader->GetUniformHandle("enableAlbedoTex");
+            enableNormalTex = shader->GetUniformHandle("enableNormalTex");
+        }
+    };
+
     //! A structure representing a material shader collection.
     struct MaterialShader
     {
         std::string shadingAlgorithm;
         GLSLShader* shaders[6];
+        ObjectUniforms uniforms[6];
 
         MaterialShader()
         {
@@ -87,7 +136,10 @@ namespace sf
         {
             shadingAlgorithm = obj.shadingAlgorithm;
             for(size_t i=0; i<6; ++i)
+            {
                 shaders[i] = obj.shaders[i];
+                uniforms[i] = obj.uniforms[i];
+            }
         }
     };
 
@@ -215,6 +267,16 @@ namespace sf
          */
         void DrawPrimitives(PrimitiveType type, std::vector<glm::vec3>& vertices, glm::vec4 color, glm::mat4 M = glm::mat4(1.f));
         
+        //! A method to draw primitives.
+        /*!
+         \param type the type of the primitive
+         \param vertices a pointer to the first vertex of the primitives
+         \param count the number of vertices
+         \param color the color to be used when drawing
+         \param M the model matrix
+         */
+        void DrawPrimitives(PrimitiveType type, const glm::vec3* vertices, size_t count, glm::vec4 color, glm::mat4 M = glm::mat4(1.f));
+        
         //! A method to draw an object.
         /*!
          \param objectId the id of the graphical object
@@ -223,6 +285,15 @@ namespace sf
          */
         void DrawObject(int objectId, int lookId, const glm::mat4& M);
 
+        //! A method to draw an object, using a precomputed normal matrix.
+        /*!
+         \param objectId the id of the graphical object
+         \param lookId the id of the graphical material
+         \param M the model matrix
+         \param N the normal matrix (inverse transpose of the model matrix)
+         */
+        void DrawObject(int objectId, int lookId, const glm::mat4& M, const glm::mat3& N);
+
         //! A method to draw the light source.
         /*!
          \param lightId the id of the light
@@ -282,6 +353,15 @@ namespace sf
          \param M the model matrix
          */
         void UseLook(unsigned int lookId, bool texturable, const glm::mat4& M);
+
+        //! A method to use a look, with a precomputed normal matrix.
+        /*!
+         \param lookId an id of the look to use
+         \param texturable a flag determining if the object rendered is texturable
+         \param M the model matrix
+         \param N the normal matrix (inverse transpose of the model matrix)
+         */
+        void UseLook(unsigned int lookId, bool texturable, const glm::mat4& M, const glm::mat3& N);
         
         //! A method returning a pointer to a view.
         /*!
@@ -483,6 +563,15 @@ namespace sf
          */
         static void Refine(Mesh* mesh, GLfloat sizeThreshold);
         
+        //! A method to simplify a mesh by collapsing edges, while preserving its volume and centroid.
+        /*!
+         \param mesh a pointer to a mesh structure
+         \param targetFaces the number of faces to reach (0 means no limit)
+         \param maxError the maximum geometric error of a single collapse [m] (0 means no limit)
+         \return a pointer to a new mesh with welded vertices
+         */
+        static Mesh* Decimate(const Mesh* mesh, size_t targetFaces, GLfloat maxError = 0.f);
+        
         //! A method to compute the axis-aligned bounding box of a mesh.
         /*!
          \param mesh a pointer to a mesh structure
@@ -531,14 +620,22 @@ namespace sf
         GLuint lightsUBO;
         LightsUBO lightsUBOData;
         GLuint viewUBO;
+        ViewUBO viewUBOData;
         
         //Shaders
         std::map<std::string, GLSLShader*> basicShaders;
         std::vector<MaterialShader> materialShaders;
         GLSLShader* lightSourceShader[2];
+        ObjectUniforms lightSourceUniforms[2];
+        GLSLShader* flatShader;
+        GLSLShader* shadowShader;
+        GLSLUniformHandle flatMVP;
+        GLSLUniformHandle flatFC;
+        GLSLUniformHandle shadowMVP;
         
         //Methods
-        void UseStandardLook(const glm::mat4& M);
+        void UseStandardLook(const glm::mat4& M, const glm::mat3& N);
+        void SetObjectUniforms(GLSLShader* shader, const ObjectUniforms& uniforms, const glm::mat4& M, const glm::mat3& N);
     };
 }
 
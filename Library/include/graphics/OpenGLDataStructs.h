@@ -468,15 +468,16 @@ namespace sf
         FORCE_GRAVITY, FORCE_BUOYANCY, FORCE_LINEAR_DRAG, FORCE_QUADRATIC_DRAG
     };
     
-    //! A structure that represents a renderable object.
+    //! A structure that represents a renderable object (plain data, points are stored in the drawing queue).
     struct Renderable
     {
         RenderableType type;
         int lookId;
         int objectId;
-        std::string materialName;
+        int materialId;
         glm::mat4 model;
-        std::vector<glm::vec3> points;
+        unsigned int firstPoint; //Index of the first point in the point arena of the drawing queue
+        unsigned int numPoints;
 		
 		static bool SortByMaterial(const Renderable& r1, const Renderable& r2) 
 		{
@@ -484,6 +485,54 @@ namespace sf
 		}
     };
     
+    //! A class representing a single frame of renderable objects, with their points stored in a shared arena.
+    class DrawingQueue
+    {
+    public:
+        //! A method to add a renderable object to the queue.
+        /*!
+         \param r the renderable object
+         */
+        void Add(const Renderable& r);
+        
+        //! A method that starts a new list of points for a renderable object.
+        /*!
+         \param r the renderable object
+         */
+        void BeginPoints(Renderable& r);
+        
+        //! A method that appends a point to the list of a renderable object (has to be the last list begun).
+        /*!
+         \param r the renderable object
+         \param p the point
+         */
+        void AddPoint(Renderable& r, const glm::vec3& p);
+        
+        //! A method that appends multiple points to the list of a renderable object (has to be the last list begun).
+        /*!
+         \param r the renderable object
+         \param p a vector of points
+         */
+        void AddPoints(Renderable& r, const std::vector<glm::vec3>& p);
+        
+        //! A method that empties the queue, keeping the allocated memory.
+        void Clear();
+        
+        //! A method returning a pointer to the first point of a renderable object.
+        /*!
+         \param r the renderable object
+         \return a pointer to the first point of the list
+         */
+        const glm::vec3* getPoints(const Renderable& r) const;
+        
+        //! A method returning the renderable objects in the queue.
+        std::vector<Renderable>& getRenderables();
+        
+    private:
+        std::vector<Renderable> renderables;
+        std::vector<glm::vec3> points;
+    };
+    
     //! An enum used to designate rendering quality.
     enum class RenderQuality {DISABLED, LOW, MEDIUM, HIGH};
     
@@ -497,6 +546,7 @@ namespace sf
         RenderQuality atmosphere;
         RenderQuality ocean;
         RenderQuality aa;
+        GLfloat viewsBudget; //GPU time per frame available for view updates [ms]
         
         //! A constructor.
         RenderSettings()
@@ -508,6 +558,7 @@ namespace sf
             atmosphere = RenderQuality::MEDIUM;
             ocean = RenderQuality::MEDIUM;
             aa = RenderQuality::MEDIUM;
+            viewsBudget = 12.f;
         }
     };
     
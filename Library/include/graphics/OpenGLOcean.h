@@ -178,6 +178,14 @@ namespace sf
          \return wave height [m]
          */
         virtual GLfloat ComputeWaveHeight(GLfloat x, GLfloat y);
+        
+        //! A method to get wave heights at multiple coordinates.
+        /*!
+         \param points a pointer to an array of points in world frame (z coordinate is ignored) [m]
+         \param n the number of points
+         \param heights a pointer to an array receiving the wave heights [m]
+         */
+        virtual void ComputeWaveHeights(const glm::vec3* points, size_t n, GLfloat* heights);
 
         //! A method returning the id of the wave texture.
         GLuint getWaveTexture();
@@ -27,7 +27,7 @@
 #define __Stonefish_OpenGLPipeline__
 
 #include <SDL2/SDL_thread.h>
-#include <deque>
+#include <atomic>
 #include "StonefishCommon.h"
 #include "graphics/OpenGLDataStructs.h"
 
@@ -57,23 +57,20 @@ namespace sf
          */
         void Render(SimulationManager* sim);
         
-        //! A method to add renderable objects to the rendering queue.
+        //! A method returning the drawing queue filled by the simulation thread.
+        DrawingQueue& getDrawingQueue();
+        
+        //! A method returning the selected objects drawing queue filled by the simulation thread.
+        DrawingQueue& getSelectedDrawingQueue();
+        
+        //! A method that hands the drawing queue built by the simulation thread over to the rendering thread.
         /*!
-         \param r a renderable object
+         Has to be called with the drawing queue mutex locked, to keep the queue consistent with the view and light transforms.
          */
-        void AddToDrawingQueue(const Renderable& r);
-		
-		//! A method to add multiple renderable objects to the rendering queue.
-		/*!
-		 \param r a vector of renderable objects
-		 */
-        void AddToDrawingQueue(const std::vector<Renderable>& r);
-
-        //! A method to add multiple renderable objects to the selected objects rendering queue.
-		/*!
-		 \param r a vector of renderable objects
-		 */
-        void AddToSelectedDrawingQueue(const std::vector<Renderable>& r);
+        void PublishDrawingQueue();
+        
+        //! A method that drops the drawing queue built by the simulation thread, without publishing it.
+        void DiscardDrawingQueue();
 		
         //! A method that draws all normal objects.
         void DrawObjects();
@@ -84,10 +81,10 @@ namespace sf
         //! A method that blits the screen FBO to the main framebuffer.
         void DrawDisplay();
         
-        //! A method that informs if the drawing queue is empty.
+        //! A method that informs if the last published drawing queue was already taken by the rendering thread.
         bool isDrawingQueueEmpty();
         
-        //! A method to get mutex of the drawing queue for thread safeness.
+        //! A method to get mutex synchronising the view and light transforms with the drawing queue.
         SDL_mutex* getDrawingQueueMutex();
         
         //! A method returning a copy of the render settings.
@@ -103,17 +100,20 @@ namespace sf
         OpenGLContent* getContent();
         
     private:
-        void PerformDrawingQueueCopy(SimulationManager* sim);
+        void AcquireDrawingQueue(SimulationManager* sim);
+        void ScheduleViews(std::vector<unsigned int>& update, std::vector<unsigned int>& noUpdate);
         void DrawHelpers();
         
         RenderSettings rSettings;
         HelperSettings hSettings;
-        std::vector<Renderable> drawingQueue;
-        std::vector<Renderable> drawingQueueCopy;
-        std::vector<Renderable> selectedDrawingQueue;
-        std::vector<Renderable> selectedDrawingQueueCopy;
+        //Triple buffering: the simulation thread fills the back queue, the rendering thread draws the front queue
+        DrawingQueue drawingQueue[3];
+        DrawingQueue selectedDrawingQueue[3];
+        std::vector<glm::mat3> drawingQueueNormals; //Normal matrices of the objects in the front queue
+        int backQueue; //Owned by the simulation thread
+        int frontQueue; //Owned by the rendering thread
+        std::atomic<int> readyQueue; //Last published queue index and fresh flag
         SDL_mutex* drawingQueueMutex;
-        std::deque<unsigned int> viewsQueue;
         GLuint screenFBO;
         GLuint screenTex;
         OpenGLContent* content;
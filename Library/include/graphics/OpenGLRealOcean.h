@@ -93,6 +93,14 @@ namespace sf
          \return wave height [m]
          */
         GLfloat ComputeWaveHeight(GLfloat x, GLfloat y);
+        
+        //! A method to get wave heights at multiple coordinates.
+        /*!
+         \param points a pointer to an array of points in world frame (z coordinate is ignored) [m]
+         \param n the number of points
+         \param heights a pointer to an array receiving the wave heights [m]
+         */
+        void ComputeWaveHeights(const glm::vec3* points, size_t n, GLfloat* heights);
 
         //! A method do enable wireframe rendering.
         /*!
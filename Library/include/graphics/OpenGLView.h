@@ -26,6 +26,7 @@
 #ifndef __Stonefish_OpenGLView__
 #define __Stonefish_OpenGLView__
 
+#include <atomic>
 #include "graphics/OpenGLDataStructs.h"
 
 namespace sf
@@ -34,12 +35,16 @@ namespace sf
     enum class ViewType {CAMERA, TRACKBALL, DEPTH_CAMERA, SONAR};
 
     #pragma pack(1)
+    //! A structure representing data of the View UBO (std140 aligned).
     struct ViewUBO
     {
         glm::mat4 VP;
         glm::vec4 frustum[6];
         glm::vec3 eye;
+        GLfloat FC;
+        glm::vec3 dir;
         GLfloat pad;
+        glm::mat4 V;
     };
     #pragma pack(0)
     
@@ -120,6 +125,40 @@ namespace sf
         //! A method saying if the view works in continuous update mode.
         bool isContinuous();
 
+        //! A method that polls the view for a new update request and tracks the request frequency.
+        /*!
+         \param now the current time [us]
+         \return a flag indicating if the view has a pending update
+         */
+        bool PollUpdateRequest(int64_t now);
+        
+        //! A method informing the view that its pending update was rendered.
+        void MarkUpdated();
+        
+        //! A method that starts measuring GPU time of the view update.
+        void BeginGPUTimer();
+        
+        //! A method that stops measuring GPU time of the view update.
+        void EndGPUTimer();
+        
+        //! A method to set the name used when reporting scheduling problems.
+        /*!
+         \param name the name of the view owner (e.g. a sensor)
+         */
+        void setOwnerName(const std::string& name);
+        
+        //! A method returning the time by which the pending update has to be rendered [us].
+        int64_t getUpdateDeadline() const;
+        
+        //! A method returning the estimated GPU time of a single update [us].
+        GLfloat getGPUTime();
+        
+        //! A method returning the measured frequency of update requests [Hz].
+        GLfloat getRequestFrequency() const;
+        
+        //! A method returning the number of update requests that were dropped because the previous one was not rendered in time.
+        unsigned int getMissedDeadlines() const;
+        
         //! A method extracting frustium planes from the view-projection matrix.
         /*!
          \param frustum a pointer to the 6 frustum planes
@@ -136,6 +175,19 @@ namespace sf
         bool enabled;
         bool continuous;
         ViewUBO viewUBOData;
+        
+    private:
+        //Scheduling
+        std::string ownerName;
+        bool updatePending;
+        int64_t lastRequestTime;
+        int64_t requestPeriod;
+        int64_t lastReportTime;
+        std::atomic<unsigned int> missedDeadlines;
+        unsigned int unreportedMisses;
+        GLuint gpuTimeQuery[2];
+        bool gpuTimeQueryIssued;
+        GLfloat gpuTime;
     };
 }
     
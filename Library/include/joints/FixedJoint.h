@@ -67,7 +67,10 @@ namespace sf
         FixedJoint(std::string uniqueName, FeatherstoneEntity* feA, FeatherstoneEntity* feB, int linkIdA, int linkIdB, const Vector3& pivot);
         
         //! A method implementing the rendering of the fixed joint.
-        std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        void Render(DrawingQueue& queue);
         
         //! A method returning the type of the joint.
         JointType getType();
@@ -39,7 +39,7 @@ namespace sf
     //! An enum representing the type of joint.
     typedef enum {JOINT_FIXED, JOINT_REVOLUTE, JOINT_SPHERICAL, JOINT_PRISMATIC, JOINT_CYLINDRICAL} JointType;
     
-    struct Renderable;
+    class DrawingQueue;
     class SimulationManager;
     
     //! An abstract class implementing a general joint.
@@ -73,7 +73,10 @@ namespace sf
         virtual bool SolvePositionIC(Scalar linearTolerance, Scalar angularTolerance);
         
         //! A method implementing the rendering of the joint.
-        virtual std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        virtual void Render(DrawingQueue& queue);
         
         //! A method returning the type of the joint.
         virtual JointType getType() = 0;
@@ -97,6 +100,7 @@ namespace sf
     protected:
         void setConstraint(btTypedConstraint* c);
         void setConstraint(btMultiBodyConstraint* c);
+        void WakeUpBodies();
         
     private:
         std::string name;
@@ -74,7 +74,10 @@ namespace sf
         bool SolvePositionIC(Scalar linearTolerance, Scalar angularTolerance);
         
         //! A method implementing the rendering of the joint.
-        std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        void Render(DrawingQueue& queue);
         
         //! A method to set the damping characteristics of the joint.
         /*!
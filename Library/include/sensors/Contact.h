@@ -63,7 +63,7 @@ namespace sf
         Vector3 slip;
     };
     
-    struct Renderable;
+    class DrawingQueue;
     class Entity;
     
     //! A class implementing a sensor measuring the contact between two entities.
@@ -113,7 +113,10 @@ namespace sf
         void SaveContactDataToOctaveFile(const std::string& path, bool includeTime = true);
         
         //! A method that implements rendering of the contact.
-        std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        void Render(DrawingQueue& queue);
         
         //! A method to set the display style of the contact.
         /*!
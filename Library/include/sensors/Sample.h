@@ -41,6 +41,14 @@ namespace sf
          */
         Sample(unsigned short nDimensions, Scalar* values);
         
+        //! A constructor.
+        /*!
+         \param nDimensions the number of dimensions of the measurement
+         \param values a pointer to the data
+         \param time the simulation time at which the measurement was taken [s]
+         */
+        Sample(unsigned short nDimensions, Scalar* values, Scalar time);
+        
         //! A copy constructor.
         /*!
          \param other a reference to a sample object
@@ -64,7 +72,7 @@ namespace sf
         std::vector<Scalar> getData() const;
         
         //! A method returning the number of dimensions of the measurement.
-        unsigned short getNumOfDimensions();
+        unsigned short getNumOfDimensions() const;
         
         //! A method returning a pointer to the sample data.
         Scalar* getDataPointer();
@@ -83,6 +83,7 @@ namespace sf
     };
     
     class Sample;
+    class Recorder;
     
     //! An abstract class representing a scalar sensor.
     class ScalarSensor : public Sensor
@@ -161,6 +162,13 @@ namespace sf
          */
         SensorChannel getSensorChannelDescription(unsigned int channel);
         
+        //! A method used to stream all generated samples to a recorder.
+        /*!
+         \param rec a pointer to the recorder (NULL to stop streaming)
+         \param streamId the id of the recorder stream
+         */
+        void setRecorder(Recorder* rec, unsigned int streamId);
+        
         //! A method returning the type of scalar sensor.
         virtual ScalarSensorType getScalarSensorType() = 0;
         
@@ -170,7 +178,15 @@ namespace sf
         std::vector<SensorChannel> channels;
         
     private:
+        void PushSample(Sample* sample);
+        
         int historyLen;
+        std::vector<Scalar> rawValues;
+        std::vector<Scalar> lastRawValues;
+        std::vector<Scalar> interpolatedValues;
+        Scalar lastRawTime;
+        Recorder* recorder;
+        unsigned int recorderStream;
     };
 }
     
@@ -35,7 +35,7 @@ namespace sf
     //! An enum defining types of sensors.
     enum class SensorType {JOINT, LINK, VISION, OTHER};
     
-    struct Renderable;
+    class DrawingQueue;
     
     //! An abstract class representing a sensor.
     class Sensor
@@ -55,7 +55,10 @@ namespace sf
         virtual void Reset();
         
         //! A method implementing the rendering of the sensor.
-        virtual std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        virtual void Render(DrawingQueue& queue);
         
         //! A method that updates the sensor readings.
         /*!
@@ -63,6 +66,14 @@ namespace sf
          */
         void Update(Scalar dt);
         
+        //! A method that performs a fixed rate update scheduled by the simulation manager.
+        /*!
+         \param now the current simulation time [s]
+         \param dt a time step of the simulation [s]
+         \return the simulation time when the next update is due [s]
+         */
+        Scalar ScheduledUpdate(Scalar now, Scalar dt);
+        
         //! A method used to mark data as old.
         void MarkDataOld();
         
@@ -78,6 +89,12 @@ namespace sf
         //! A method returning the sampling rate of the sensor.
         Scalar getUpdateFrequency();
         
+        //! A method returning the simulation time when the next fixed rate update is due.
+        Scalar getNextUpdateTime();
+        
+        //! A method informing if the sensor can generate samples at a rate higher than the simulation rate.
+        virtual bool isOversamplingSupported();
+        
         //! A method informing if the sensor is renderable.
         bool isRenderable();
         
@@ -99,13 +116,16 @@ namespace sf
     protected:
         Scalar freq;
         SDL_mutex* updateMutex;
+        std::vector<Scalar> oversampleTimes; //Times of the samples to interpolate in the current update (empty if not oversampling)
         
-        static std::random_device randomDevice;
-        static std::mt19937 randomGenerator;
+        static thread_local std::random_device randomDevice;
+        static thread_local std::mt19937 randomGenerator;
         
     private:
         std::string name;
         Scalar eleapsedTime;
+        Scalar scheduleOrigin;
+        uint64_t scheduleCount;
         bool renderable;
         bool newDataAvailable;
     };
@@ -26,6 +26,7 @@
 #ifndef __Stonefish_VisionSensor__
 #define __Stonefish_VisionSensor__
 
+#include <functional>
 #include "sensors/Sensor.h"
 
 namespace sf
@@ -34,6 +35,22 @@ namespace sf
     enum class VisionSensorType {COLOR_CAMERA, DEPTH_CAMERA, MULTIBEAM2, FLS, SSS, MSIS};
     
     class MovingEntity;
+    class OpenGLView;
+    
+    //! A structure describing a single frame of data produced by a vision sensor.
+    struct VisionSensorFrame
+    {
+        const void* data;
+        unsigned int width;
+        unsigned int height;
+        unsigned int channels;
+        bool floatingPoint; //32-bit floats if true, 8-bit unsigned integers otherwise
+        Scalar timestamp;
+        Transform pose;
+        
+        //! A method returning the size of the frame data in bytes.
+        size_t getDataSize() const { return (size_t)width * height * channels * (floatingPoint ? 4 : 1); }
+    };
     
     //! An abstract class representing a vision sensor.
     class VisionSensor : public Sensor
@@ -74,10 +91,38 @@ namespace sf
         //! A method returning the type of the vision sensor.
         virtual VisionSensorType getVisionSensorType() = 0;
         
+        //! A method returning the number of sensor updates that were not rendered in time.
+        unsigned int getMissedRenderDeadlines();
+        
+        //! A method adding a listener called with every frame produced by the sensor, independently of the new data handler.
+        /*!
+         The listener is called from the rendering thread and the frame data is only valid during the call.
+         \param listener a function receiving the sensor and the frame
+         */
+        void AddFrameListener(std::function<void(VisionSensor*, const VisionSensorFrame&)> listener);
+        
     protected:
         virtual void InitGraphics() = 0;
         
+        //! A method adding a view to the rendering pipeline on behalf of the sensor.
+        /*!
+         \param view a pointer to the view
+         */
+        void RegisterView(OpenGLView* view);
+        
+        //! A method passing a new frame to all frame listeners.
+        /*!
+         \param data a pointer to the frame data
+         \param width the width of the frame [pix]
+         \param height the height of the frame [pix]
+         \param channels the number of channels of each pixel
+         \param floatingPoint a flag indicating if the data is made of 32-bit floats
+         */
+        void PublishFrame(const void* data, unsigned int width, unsigned int height, unsigned int channels, bool floatingPoint);
+        
     private:
+        std::vector<OpenGLView*> views;
+        std::vector<std::function<void(VisionSensor*, const VisionSensorFrame&)>> frameListeners;
         MovingEntity* attach;
         Transform o2s;
     };
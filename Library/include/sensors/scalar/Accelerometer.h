@@ -62,6 +62,9 @@ namespace sf
          */
         void setNoise(Scalar linearAccStdDev, Scalar angularAccStdDev);
         
+        //! A method informing if the sensor can generate samples at a rate higher than the simulation rate.
+        bool isOversamplingSupported();
+        
         //! A method returning the type of the scalar sensor.
         ScalarSensorType getScalarSensorType();
     };
@@ -65,7 +65,10 @@ namespace sf
         void setNoise(Scalar velocityStdDev, Scalar altitudeStdDev);
         
         //! A method resetting the state of the sensor.
-        std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        void Render(DrawingQueue& queue);
         
         //! A method returning the type of the scalar sensor.
         ScalarSensorType getScalarSensorType();
@@ -76,7 +76,10 @@ namespace sf
         void setNoise(Scalar forceStdDev, Scalar torqueStdDev);
         
         //! A method that implements rendering of the sensor.
-        std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        void Render(DrawingQueue& queue);
         
         //! A method returning the current sensor frame in world.
         Transform getSensorFrame();
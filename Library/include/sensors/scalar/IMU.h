@@ -61,6 +61,9 @@ namespace sf
          */
         void setNoise(Scalar angleStdDev, Scalar angularVelocityStdDev);
         
+        //! A method informing if the sensor can generate samples at a rate higher than the simulation rate.
+        bool isOversamplingSupported();
+        
         //! A method returning the type of the scalar sensor.
         ScalarSensorType getScalarSensorType();
     };
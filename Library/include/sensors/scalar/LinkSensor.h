@@ -55,7 +55,10 @@ namespace sf
         virtual void InternalUpdate(Scalar dt) = 0;
         
         //! A method implementing the rendering of the sensor.
-        virtual std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        virtual void Render(DrawingQueue& queue);
       
         //! A method used to attach the sensor to a rigid body.
         /*!
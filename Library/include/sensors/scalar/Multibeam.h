@@ -64,7 +64,10 @@ namespace sf
         void setNoise(Scalar stdDev);
         
         //! A method resetting the state of the sensor.
-        std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        void Render(DrawingQueue& queue);
         
         //! A method returning the type of the scalar sensor.
         ScalarSensorType getScalarSensorType();
@@ -60,6 +60,9 @@ namespace sf
          */
         void setNoise(Scalar pressureStdDev);
         
+        //! A method informing if the sensor can generate samples at a rate higher than the simulation rate.
+        bool isOversamplingSupported();
+        
         //! A method returning the type of the scalar sensor.
         ScalarSensorType getScalarSensorType();
     };
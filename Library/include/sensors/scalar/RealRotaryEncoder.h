@@ -51,6 +51,9 @@ namespace sf
         //! A method that resets the sensor state.
         void Reset();
         
+        //! A method informing if the sensor can generate samples at a rate higher than the simulation rate.
+        bool isOversamplingSupported();
+        
         //! A method returning the type of the scalar sensor.
         ScalarSensorType getScalarSensorType();
         
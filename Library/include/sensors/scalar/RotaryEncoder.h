@@ -66,6 +66,9 @@ namespace sf
         //! A method that resets the sensor.
         virtual void Reset();
         
+        //! A method informing if the sensor can generate samples at a rate higher than the simulation rate.
+        bool isOversamplingSupported();
+        
         //! A method returning the type of the scalar sensor.
         ScalarSensorType getScalarSensorType();
         
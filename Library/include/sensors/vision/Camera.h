@@ -72,7 +72,10 @@ namespace sf
         virtual void UpdateTransform();
         
         //! A method implementing the rendering of the camera dummy.
-        virtual std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        virtual void Render(DrawingQueue& queue);
         
         //! A method to set if the camera image should be displayed in the main window.
         /*!
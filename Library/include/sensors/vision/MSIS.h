@@ -85,7 +85,10 @@ namespace sf
         void InstallNewDataHandler(std::function<void(MSIS*)> callback);
         
         //! A method implementing the rendering of the sonar dummy.
-        std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        void Render(DrawingQueue& queue);
 
         //! A method setting the limits of the sonar head rotation.
         /*!
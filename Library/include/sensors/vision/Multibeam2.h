@@ -105,7 +105,10 @@ namespace sf
         void InstallNewDataHandler(std::function<void(Multibeam2*)> callback);
         
         //! A method implementing the rendering of the multibeam dummy.
-        std::vector<Renderable> Render();
+        /*!
+         \param queue the drawing queue to fill
+         */
+        void Render(DrawingQueue& queue);
         
         //! A method that returns the limits of measured range.
         glm::vec2 getRangeLimits();
@@ -31,13 +31,17 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
+#include <errno.h>
+#include <string>
 #include <ctime>
 #include <chrono>
 
 #ifdef __linux__
     #include <unistd.h>
+    #include <sys/stat.h>
 #elif __APPLE__
     #include <unistd.h>
+    #include <sys/stat.h>
     #include <Carbon/Carbon.h>
 #else //WINDOWS
     #include <windows.h>
@@ -55,6 +59,12 @@ inline int64_t GetTimeInMicroseconds()
     return std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count();
 }
 
+inline int64_t GetTimeInNanoseconds()
+{
+    std::chrono::high_resolution_clock::time_point now = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+}
+
 inline void GetCWD(char* buffer, int length)
 {
 #ifdef _MSC_VER
@@ -74,6 +84,59 @@ inline std::string GetDataPath()
     return SimulationApp::getApp()->getDataPath();
 }
 
+//! Returns the directory used to store cached data (created if needed), or an empty string if caching is not possible.
+inline std::string GetCachePath()
+{
+#ifdef _MSC_VER
+    return "";
+#else
+    std::string path;
+    const char* env = getenv("STONEFISH_CACHE_DIR");
+    if(env != NULL)
+    {
+        if(strlen(env) == 0) //Caching disabled
+            return "";
+        path = std::string(env);
+    }
+    else if((env = getenv("XDG_CACHE_HOME")) != NULL && strlen(env) > 0)
+        path = std::string(env) + "/stonefish";
+    else if((env = getenv("HOME")) != NULL && strlen(env) > 0)
+        path = std::string(env) + "/.cache/stonefish";
+    else
+        return "";
+    
+    if(path.back() != '/')
+        path += "/";
+    
+    //Create all directories in the path
+    for(size_t pos = path.find('/', 1); pos != std::string::npos; pos = path.find('/', pos+1))
+    {
+        std::string dir = path.substr(0, pos);
+        if(mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST)
+            return "";
+    }
+    return path;
+#endif
+}
+
+//! Computes a 64-bit FNV-1a hash of a block of data.
+inline uint64_t HashData(const void* data, size_t length, uint64_t hash = 14695981039346656037ULL)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    for(size_t i=0; i<length; ++i)
+    {
+        hash ^= (uint64_t)bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+//! Computes a 64-bit FNV-1a hash of a string.
+inline uint64_t HashString(const std::string& str, uint64_t hash = 14695981039346656037ULL)
+{
+    return HashData(str.data(), str.size(), hash);
+}
+
 inline const char* GetDataPathPrefix(const char* directory)
 {
     static char dataPathPrefix[PATH_MAX];
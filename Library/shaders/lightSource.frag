@@ -28,9 +28,6 @@ in float logz;
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec4 fragNormal;
 
-uniform vec3 eyePos;
-uniform vec3 viewDir;
-uniform float FC;
 uniform vec3 color;
 uniform ivec2 lightId;
 
@@ -46,6 +43,7 @@ layout (std140) uniform SunSky
 };
 
 #inject "lightingDef.glsl"
+#inject "viewDef.glsl"
 
 //---------------Functions-------------------
 vec3 GetSkyLuminance(vec3 camera, vec3 view_ray, float shadow_length, vec3 sun_direction, out vec3 transmittance);
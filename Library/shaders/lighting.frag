@@ -422,8 +422,6 @@ const vec2 Poisson128[128] = vec2[](
 );
 
 //Inputs
-uniform vec3 eyePos;
-uniform vec3 viewDir;
 
 layout (std140) uniform SunSky
 {
@@ -437,6 +435,7 @@ layout (std140) uniform SunSky
 };
 
 #inject "lightingDef.glsl"
+#inject "viewDef.glsl"
 
 uniform sampler2DArray spotLightsDepthMap;
 uniform sampler2DArrayShadow spotLightsShadowMap;
@@ -23,8 +23,6 @@
 const float sunLightRadius = 0.03;
 
 //Inputs
-uniform vec3 eyePos;
-uniform vec3 viewDir;
 
 layout (std140) uniform SunSky
 {
@@ -38,6 +36,7 @@ layout (std140) uniform SunSky
 };
 
 #inject "lightingDef.glsl"
+#inject "viewDef.glsl"
 
 vec3 ShadingModel(vec3 N, vec3 V, vec3 L, vec3 Lcolor, vec3 albedo);
 
@@ -30,13 +30,13 @@ out float logz;
 uniform mat4 MVP;
 uniform mat4 M;
 uniform mat3 N;
-uniform mat3 MV;
-uniform float FC;
+
+#inject "viewDef.glsl"
 
 void main()
 {
 	normal = normalize(N * n);
-	eyeSpaceNormal = normalize(MV * n);
+	eyeSpaceNormal = normalize(mat3(viewMatrix) * normal);
 	fragPos = M * vec4(vt, 1.0);
 	gl_Position = MVP * vec4(vt, 1.0); 
     gl_Position.z = log2(max(1e-6, 1.0 + gl_Position.w)) * 2.0 * FC - 1.0;
@@ -29,9 +29,6 @@ in float logz;
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec4 fragNormal;
 
-uniform vec3 eyePos;
-uniform vec3 viewDir;
-uniform float FC;
 uniform vec4 color;
 uniform float reflectivity;
 uniform sampler2D texAlbedo;
@@ -51,6 +48,7 @@ layout (std140) uniform SunSky
 };
 
 #inject "lightingDef.glsl"
+#inject "viewDef.glsl"
 
 //---------------Functions-------------------
 vec3 GetSolarLuminance();
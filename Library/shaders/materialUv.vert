@@ -34,8 +34,8 @@ out float logz;
 uniform mat4 MVP;
 uniform mat4 M;
 uniform mat3 N;
-uniform mat3 MV;
-uniform float FC;
+
+#inject "viewDef.glsl"
 
 void main()
 {
@@ -43,7 +43,7 @@ void main()
     vec3 tangent = normalize(N * t);
     vec3 bitangent = cross(normal, tangent);
     TBN = mat3(tangent, bitangent, normal);
-	eyeSpaceNormal = normalize(MV * n);
+	eyeSpaceNormal = normalize(mat3(viewMatrix) * normal);
 	texCoord = uv;
 	fragPos = M * vec4(vt, 1.0);
 	gl_Position = MVP * vec4(vt, 1.0); 
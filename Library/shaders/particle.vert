@@ -10,7 +10,8 @@ out float logz;
 uniform mat4 MV;
 uniform mat4 iMV;
 uniform mat4 P;
-uniform float FC;
+
+#inject "viewDef.glsl"
 
 layout(std140) buffer Positions
 {
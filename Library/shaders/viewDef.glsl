@@ -0,0 +1,10 @@
+layout (std140) uniform View
+{
+    mat4 viewVP;
+    vec4 viewFrustum[6];
+    vec3 eyePos;
+    float FC;
+    vec3 viewDir;
+    float viewPad;
+    mat4 viewMatrix;
+};
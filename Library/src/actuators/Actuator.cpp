@@ -34,14 +34,14 @@ namespace sf
 
 Actuator::Actuator(std::string uniqueName)
 {
-    name = SimulationApp::getApp()->getSimulationManager()->getNameManager()->AddName(uniqueName);
+    name = SimulationManager::getCurrent()->getNameManager()->AddName(uniqueName);
     dm = DisplayMode::GRAPHICAL;
 }
 
 Actuator::~Actuator()
 {
     if(SimulationApp::getApp() != NULL)
-        SimulationApp::getApp()->getSimulationManager()->getNameManager()->RemoveName(name);
+        SimulationManager::getCurrent()->getNameManager()->RemoveName(name);
 }
 
 void Actuator::setDisplayMode(DisplayMode m)
@@ -54,10 +54,8 @@ std::string Actuator::getName()
     return name;
 }
 
-std::vector<Renderable> Actuator::Render()
+void Actuator::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
-    return items;
 }
 
 }
@@ -54,16 +54,12 @@ void LinkActuator::AttachToSolid(SolidEntity* body, const Transform& origin)
     }
 }
 
-std::vector<Renderable> LinkActuator::Render()
+void LinkActuator::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
-
     Renderable item;
     item.type = RenderableType::SENSOR_CS;
     item.model = glMatrixFromTransform(getActuatorFrame());
-    items.push_back(item);
-
-    return items;
+    queue.Add(item);
 }
     
 }
@@ -119,7 +119,7 @@ void Propeller::Update(Scalar dt)
         Vector3 relPos = propTrans.getOrigin() - solidTrans.getOrigin();
         Vector3 velocity = attach->getLinearVelocityInLocalPoint(relPos);
         
-        Atmosphere* atm = SimulationApp::getApp()->getSimulationManager()->getAtmosphere();
+        Atmosphere* atm = SimulationManager::getCurrent()->getAtmosphere();
         
         if(atm->IsInsideFluid(propTrans.getOrigin()))
         {
@@ -143,33 +143,31 @@ void Propeller::Update(Scalar dt)
     }
 }
 
-std::vector<Renderable> Propeller::Render()
+void Propeller::Render(DrawingQueue& queue)
 {
     Transform propTrans = Transform::getIdentity();
     if(attach != NULL)
         propTrans = attach->getOTransform() * o2a;
     else
-        LinkActuator::Render();
+        LinkActuator::Render(queue);
     
     //Rotate propeller
     propTrans *= Transform(Quaternion(0, 0, theta), Vector3(0,0,0));
     
     //Add renderable
-    std::vector<Renderable> items(0);
     Renderable item;
     item.type = RenderableType::SOLID;
-    item.materialName = prop->getMaterial().name;
+    item.materialId = prop->getMaterial().id;
     item.objectId = prop->getGraphicalObject();
     item.lookId = dm == DisplayMode::GRAPHICAL ? prop->getLook() : -1;
 	item.model = glMatrixFromTransform(propTrans);
-    items.push_back(item);
+    queue.Add(item);
     
     item.type = RenderableType::ACTUATOR_LINES;
-    item.points.push_back(glm::vec3(0,0,0));
-    item.points.push_back(glm::vec3(0.1f*thrust,0,0));
-    items.push_back(item);
-    
-    return items;
+    queue.BeginPoints(item);
+    queue.AddPoint(item, glm::vec3(0,0,0));
+    queue.AddPoint(item, glm::vec3(0.1f*thrust,0,0));
+    queue.Add(item);
 }
     
 }
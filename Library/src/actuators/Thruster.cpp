@@ -127,7 +127,7 @@ void Thruster::Update(Scalar dt)
         Vector3 velocity = attach->getLinearVelocityInLocalPoint(relPos);
         
         //Calculate thrust
-        Ocean* ocn = SimulationApp::getApp()->getSimulationManager()->getOcean();
+        Ocean* ocn = SimulationManager::getCurrent()->getOcean();
         if(ocn != nullptr && ocn->IsInsideFluid(thrustTrans.getOrigin()))
         {
             bool backward = (RH && omega < Scalar(0)) || (!RH && omega > Scalar(0));
@@ -165,33 +165,31 @@ void Thruster::Update(Scalar dt)
     }
 }
 
-std::vector<Renderable> Thruster::Render()
+void Thruster::Render(DrawingQueue& queue)
 {
     Transform thrustTrans = Transform::getIdentity();
     if(attach != NULL)
         thrustTrans = attach->getOTransform() * o2a;
     else
-        LinkActuator::Render();
+        LinkActuator::Render(queue);
     
     //Rotate propeller
     thrustTrans *= Transform(Quaternion(0, 0, theta), Vector3(0,0,0));
     
     //Add renderable
-    std::vector<Renderable> items(0);
     Renderable item;
     item.type = RenderableType::SOLID;
-    item.materialName = prop->getMaterial().name;
+    item.materialId = prop->getMaterial().id;
     item.objectId = prop->getGraphicalObject();
     item.lookId = dm == DisplayMode::GRAPHICAL ? prop->getLook() : -1;
 	item.model = glMatrixFromTransform(thrustTrans);
-    items.push_back(item);
+    queue.Add(item);
     
     item.type = RenderableType::ACTUATOR_LINES;
-    item.points.push_back(glm::vec3(0,0,0));
-    item.points.push_back(glm::vec3(0.1f*thrust,0,0));
-    items.push_back(item);
-    
-    return items;
+    queue.BeginPoints(item);
+    queue.AddPoint(item, glm::vec3(0,0,0));
+    queue.AddPoint(item, glm::vec3(0.1f*thrust,0,0));
+    queue.Add(item);
 }
     
 }
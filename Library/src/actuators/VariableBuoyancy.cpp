@@ -40,9 +40,9 @@ VariableBuoyancy::VariableBuoyancy(std::string uniqueName, const std::vector<std
     
     density = Scalar(1000.0);
     Ocean* ocn;
-    if((ocn = SimulationApp::getApp()->getSimulationManager()->getOcean()) != nullptr)
+    if((ocn = SimulationManager::getCurrent()->getOcean()) != nullptr)
         density = ocn->getLiquid().density;
-    gravity = SimulationApp::getApp()->getSimulationManager()->getGravity();
+    gravity = SimulationManager::getCurrent()->getGravity();
     
     for(size_t i=0; i<volumeMeshPaths.size(); ++i)
     {
@@ -122,7 +122,7 @@ void VariableBuoyancy::InterpolateVProps(Scalar volume, Scalar& m, Vector3& cg)
     
 void VariableBuoyancy::Update(Scalar dt)
 {
-    Ocean* ocn = SimulationApp::getApp()->getSimulationManager()->getOcean();
+    Ocean* ocn = SimulationManager::getCurrent()->getOcean();
     if(ocn != nullptr && attach != NULL)
     {
         //Update volume
@@ -143,24 +143,22 @@ void VariableBuoyancy::Update(Scalar dt)
     }
 }
 
-std::vector<Renderable> VariableBuoyancy::Render()
+void VariableBuoyancy::Render(DrawingQueue& queue)
 {
     Transform vbsTrans = Transform::getIdentity();
     if(attach != NULL)
         vbsTrans.setOrigin(attach->getOTransform() * o2a * CG);
     else
-        LinkActuator::Render();
+        LinkActuator::Render(queue);
     
     //Add renderable
-    std::vector<Renderable> items(0);
     Renderable item;
     item.type = RenderableType::ACTUATOR_LINES;
     item.model = glMatrixFromTransform(vbsTrans);
-    item.points.push_back(glm::vec3(0,0,0));
-    item.points.push_back(0.1f * glm::vec3((GLfloat)force.x(), (GLfloat)force.y(), (GLfloat)force.z()));
-    items.push_back(item);
-    
-    return items;
+    queue.BeginPoints(item);
+    queue.AddPoint(item, glm::vec3(0,0,0));
+    queue.AddPoint(item, 0.1f * glm::vec3((GLfloat)force.x(), (GLfloat)force.y(), (GLfloat)force.z()));
+    queue.Add(item);
 }
     
     
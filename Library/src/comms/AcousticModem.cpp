@@ -30,35 +30,54 @@
 #include "core/SimulationManager.h"
 #include "graphics/OpenGLPipeline.h"
 #include "core/Console.h"
+#include <algorithm>
 
 namespace sf
 {
  
+AcousticNetwork::~AcousticNetwork()
+{
+    for(size_t i=0; i<propagating.size(); ++i)
+        delete propagating[i];
+}
+
 //Static
-std::map<uint64_t, AcousticModem*> AcousticModem::nodes; 
+bool AcousticModem::laterArrival(const AcousticDataFrame* msg1, const AcousticDataFrame* msg2)
+{
+    return msg1->arrivalTime > msg2->arrivalTime;
+}
 
-void AcousticModem::addNode(AcousticModem* node)
+//Member
+void AcousticModem::addNode()
 {
-    if(node->getDeviceId() == 0)
+    if(getDeviceId() == 0)
     {
         cError("Modem device ID=0 not allowed!");
         return;
     }
         
-    if(nodes.find(node->getDeviceId()) != nodes.end())
-        cError("Modem node with ID=%d already exists!", node->getDeviceId());
+    if(network->nodes.find(getDeviceId()) != network->nodes.end())
+        cError("Modem node with ID=%d already exists!", getDeviceId());
     else
-        nodes[node->getDeviceId()] = node;
+        network->nodes[getDeviceId()] = this;
 }
 
-void AcousticModem::removeNode(uint64_t deviceId)
+void AcousticModem::removeNode()
 {
-    if(deviceId == 0)
+    if(getDeviceId() == 0)
         return;
         
-    std::map<uint64_t, AcousticModem*>::iterator it = nodes.find(deviceId);
-    if(it != nodes.end())
-        nodes.erase(it);
+    std::map<uint64_t, AcousticModem*>::iterator it = network->nodes.find(getDeviceId());
+    if(it != network->nodes.end() && it->second == this)
+        network->nodes.erase(it);
+    
+    //Drop messages still in flight when the last node is gone
+    if(network->nodes.empty())
+    {
+        for(size_t i=0; i<network->propagating.size(); ++i)
+            delete network->propagating[i];
+        network->propagating.clear();
+    }
 }
 
 AcousticModem* AcousticModem::getNode(uint64_t deviceId)
@@ -66,14 +85,8 @@ AcousticModem* AcousticModem::getNode(uint64_t deviceId)
     if(deviceId == 0)
         return NULL;
     
-    try
-    {
-        return nodes.at(deviceId);
-    }
-    catch(const std::out_of_range& oor)
-    {
-        return NULL;
-    }
+    std::map<uint64_t, AcousticModem*>::iterator it = network->nodes.find(deviceId);
+    return it != network->nodes.end() ? it->second : NULL;
 }   
 
 bool AcousticModem::mutualContact(uint64_t device1Id, uint64_t device2Id)
@@ -95,11 +108,46 @@ bool AcousticModem::mutualContact(uint64_t device1Id, uint64_t device2Id)
     btCollisionWorld::ClosestRayResultCallback closest(pos1, pos2);
     closest.m_collisionFilterGroup = MASK_DYNAMIC;
     closest.m_collisionFilterMask = MASK_STATIC | MASK_DYNAMIC | MASK_ANIMATED_COLLIDING;
-    SimulationApp::getApp()->getSimulationManager()->getDynamicsWorld()->rayTest(pos1, pos2, closest);
+    SimulationManager::getCurrent()->getDynamicsWorld()->rayTest(pos1, pos2, closest);
     return !closest.hasHit();
 }
 
-//Member 
+void AcousticModem::transmit(AcousticDataFrame* msg)
+{
+    //Range, FOV and line of sight are checked once, when the message leaves the source
+    AcousticModem* dest = getNode(msg->destination);
+    if(dest == NULL || !mutualContact(msg->source, msg->destination))
+    {
+        delete msg;
+        return;
+    }
+    
+    //Arrival time based on the position of the receiver at transmission
+    Scalar now = SimulationManager::getCurrent()->getSimulationTime();
+    msg->rxPosition = dest->getDeviceFrame().getOrigin();
+    Scalar distance = (msg->rxPosition - msg->txPosition).length();
+    msg->arrivalTime = now + distance/SOUND_VELOCITY_WATER;
+    msg->travelled += distance;
+    network->propagating.push_back(msg);
+    std::push_heap(network->propagating.begin(), network->propagating.end(), laterArrival);
+}
+
+void AcousticModem::deliverMessages(Scalar now)
+{
+    while(!network->propagating.empty() && network->propagating.front()->arrivalTime <= now)
+    {
+        std::pop_heap(network->propagating.begin(), network->propagating.end(), laterArrival);
+        AcousticDataFrame* msg = network->propagating.back();
+        network->propagating.pop_back();
+        
+        AcousticModem* dest = getNode(msg->destination);
+        if(dest != NULL)
+            dest->MessageReceived(msg);
+        else
+            delete msg;
+    }
+}
+
 AcousticModem::AcousticModem(std::string uniqueName, uint64_t deviceId, 
                              Scalar horizontalFOVDeg, Scalar verticalFOVDeg, Scalar operatingRange) : Comm(uniqueName, deviceId)
 {
@@ -108,12 +156,13 @@ AcousticModem::AcousticModem(std::string uniqueName, uint64_t deviceId,
     range = operatingRange <= Scalar(0) ? Scalar(1000) : operatingRange;
     position = V0();
     frame = std::string("");
-    addNode(this);
+    network = SimulationManager::getCurrent()->getAcousticNetwork();
+    addNode();
 }
 
 AcousticModem::~AcousticModem()
 {
-    removeNode(this->getDeviceId());
+    removeNode();
 }
 
 bool AcousticModem::isReceptionPossible(Vector3 worldDir, Scalar distance)
@@ -142,11 +191,11 @@ CommType AcousticModem::getType()
 
 void AcousticModem::SendMessage(std::string data)
 {    
-    if(!mutualContact(getDeviceId(), getConnectedId()))
+    if(getNode(getConnectedId()) == NULL)
        return;
     
     AcousticDataFrame* msg = new AcousticDataFrame();
-    msg->timeStamp = SimulationApp::getApp()->getSimulationManager()->getSimulationTime();
+    msg->timeStamp = SimulationManager::getCurrent()->getSimulationTime();
     msg->seq = txSeq++;
     msg->source = getDeviceId();
     msg->destination = getConnectedId();
@@ -180,41 +229,15 @@ void AcousticModem::ProcessMessages()
 
 void AcousticModem::InternalUpdate(Scalar dt)
 {
-    //Propagate messages already sent
-    std::map<AcousticDataFrame*, Vector3>::iterator mIt;
-    for(mIt = propagating.begin(); mIt != propagating.end(); )
-    {
-        AcousticModem* dest = getNode(mIt->first->destination);
-        Vector3 dO = dest->getDeviceFrame().getOrigin();
-        Vector3 sO = mIt->second;
-        Vector3 dir = dO - sO;
-        Scalar d = dir.length();
-        
-        if(d <= SOUND_VELOCITY_WATER*dt) //Message reached?
-        {
-            mIt->first->travelled += d;
-            dest->MessageReceived(mIt->first);
-            mIt = propagating.erase(mIt);
-        }
-        else //Advance pulse
-        {
-            dir /= d; //Normalize direction
-            d = SOUND_VELOCITY_WATER * dt;
-            mIt->second += dir * d;
-            mIt->first->travelled += d;
-            ++mIt;
-        }
-    }
+    //Deliver messages which already reached their receivers (shared by all nodes of the world)
+    deliverMessages(SimulationManager::getCurrent()->getSimulationTime());
     
     //Send first message from the tx buffer
     if(txBuffer.size() > 0)
     {
         AcousticDataFrame* msg = (AcousticDataFrame*)txBuffer[0];
-        if(mutualContact(msg->source, msg->destination))
-            propagating[msg] = msg->txPosition;
-        else
-            delete msg;
-            
+        msg->txPosition = getDeviceFrame().getOrigin();
+        transmit(msg);
         txBuffer.pop_front();
     }
 }
@@ -229,28 +252,33 @@ void AcousticModem::UpdatePosition(Vector3 pos, bool absolute, std::string refer
     newDataAvailable = true;
 }
 
-std::vector<Renderable> AcousticModem::Render()
+void AcousticModem::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
-    
     Renderable item;
     item.type = RenderableType::SENSOR_CS;
     item.model = glMatrixFromTransform(getDeviceFrame());
-    items.push_back(item);
+    queue.Add(item);
 
 #ifdef DEBUG
     item.type = RenderableType::SENSOR_POINTS;
     item.model = glm::mat4(1.f);
-    std::map<AcousticDataFrame*, Vector3>::iterator mIt;
-    for(mIt = propagating.begin(); mIt != propagating.end(); ++mIt)
+    queue.BeginPoints(item);
+    Scalar now = SimulationManager::getCurrent()->getSimulationTime();
+    const std::vector<AcousticDataFrame*>& msgs = network->propagating;
+    for(size_t i=0; i<msgs.size(); ++i)
     {
-        Vector3 mPos = mIt->second;
-        item.points.push_back(glm::vec3((GLfloat)mPos.getX(), (GLfloat)mPos.getY(), (GLfloat)mPos.getZ()));
+        if(msgs[i]->source != getDeviceId())
+            continue;
+        
+        //Position of the pulse interpolated along the path
+        Vector3 dir = msgs[i]->rxPosition - msgs[i]->txPosition;
+        Scalar d = dir.length();
+        Scalar left = (msgs[i]->arrivalTime - now) * SOUND_VELOCITY_WATER;
+        Vector3 mPos = d > left ? msgs[i]->rxPosition - dir/d * left : msgs[i]->txPosition;
+        queue.AddPoint(item, glm::vec3((GLfloat)mPos.getX(), (GLfloat)mPos.getY(), (GLfloat)mPos.getZ()));
     }
-    items.push_back(item);
+    queue.Add(item);
 #endif
-
-    return items;
 }
 
 }
\ No newline at end of file
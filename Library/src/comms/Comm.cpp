@@ -36,7 +36,7 @@ namespace sf
 
 Comm::Comm(std::string uniqueName, uint64_t deviceId)
 {
-    name = SimulationApp::getApp()->getSimulationManager()->getNameManager()->AddName(uniqueName);
+    name = SimulationManager::getCurrent()->getNameManager()->AddName(uniqueName);
     id = deviceId;
     cId = 0;
     renderable = false;
@@ -50,7 +50,7 @@ Comm::Comm(std::string uniqueName, uint64_t deviceId)
 Comm::~Comm()
 {
     if(SimulationApp::getApp() != nullptr)
-        SimulationApp::getApp()->getSimulationManager()->getNameManager()->RemoveName(name);
+        SimulationManager::getCurrent()->getNameManager()->RemoveName(name);
     SDL_DestroyMutex(updateMutex);
 }
 
@@ -117,7 +117,7 @@ void Comm::SendMessage(std::string data)
     msg->seq = txSeq++;
     msg->source = id;
     msg->destination = cId;
-    msg->timeStamp = SimulationApp::getApp()->getSimulationManager()->getSimulationTime();
+    msg->timeStamp = SimulationManager::getCurrent()->getSimulationTime();
     msg->data = data;
     txBuffer.push_back(msg);
 }
@@ -169,16 +169,12 @@ void Comm::Update(Scalar dt)
     SDL_UnlockMutex(updateMutex);
 }
 
-std::vector<Renderable> Comm::Render()
+void Comm::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
-    
     Renderable item;
     item.type = RenderableType::SENSOR_CS;
     item.model = glMatrixFromTransform(getDeviceFrame());
-    items.push_back(item);
-    
-    return items;
+    queue.Add(item);
 }
     
 }
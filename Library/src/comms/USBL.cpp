@@ -28,8 +28,8 @@
 namespace sf
 {
     
-std::random_device USBL::randomDevice;
-std::mt19937 USBL::randomGenerator(randomDevice());
+thread_local std::random_device USBL::randomDevice;
+thread_local std::mt19937 USBL::randomGenerator(randomDevice());
     
 USBL::USBL(std::string uniqueName, uint64_t deviceId, Scalar horizontalFOVDeg, Scalar verticalFOVDeg, Scalar operatingRange) 
            : AcousticModem(uniqueName, deviceId, horizontalFOVDeg, verticalFOVDeg, operatingRange)
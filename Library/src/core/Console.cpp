@@ -25,18 +25,51 @@
 
 #include "core/Console.h"
 
+#include <SDL2/SDL_timer.h>
+#include <functional>
+
+#define CONSOLE_QUEUE_SIZE 512 //Number of messages in the ring buffer (power of 2)
+#define CONSOLE_RATE_SLOTS 256 //Number of call site rate counters (power of 2)
+#define CONSOLE_DEFAULT_RATE 1000 //Default maximum number of messages from one call site per second
+#define CONSOLE_DEFAULT_RETENTION 10000 //Default maximum number of retained lines
+#define CONSOLE_WRITER_SLEEP 5 //Sleep time of the writer thread when the queue is empty [ms]
+
 namespace sf
 {
     
 Console::Console()
 {
-    lines = std::vector<ConsoleMessage>(0);
     linesMutex = SDL_CreateMutex();
+    queue = new Slot[CONSOLE_QUEUE_SIZE];
+    for(size_t i=0; i<CONSOLE_QUEUE_SIZE; ++i)
+        queue[i].sequence.store(i, std::memory_order_relaxed);
+    enqueuePos = 0;
+    dequeuePos = 0;
+    rates = new std::atomic<uint64_t>[CONSOLE_RATE_SLOTS];
+    for(size_t i=0; i<CONSOLE_RATE_SLOTS; ++i)
+        rates[i].store(0, std::memory_order_relaxed);
+    minSeverity = 0;
+    rateLimit = CONSOLE_DEFAULT_RATE;
+    dropped = 0;
+    suppressed = 0;
+    droppedReported = 0;
+    suppressedReported = 0;
+    retention = CONSOLE_DEFAULT_RETENTION;
+    
+    running = true;
+    writer = SDL_CreateThread(Console::WriterLoop, "consoleThread", this);
 }
 
 Console::~Console()
 {
+    running = false;
+    SDL_WaitThread(writer, NULL);
+    Drain();
+    fflush(stdout);
+    
     lines.clear();
+    delete [] queue;
+    delete [] rates;
     SDL_DestroyMutex(linesMutex);
 }
     
@@ -47,35 +80,224 @@ SDL_mutex* Console::getLinesMutex()
 
 std::vector<ConsoleMessage> Console::getLines()
 {
-    return lines;
+    SDL_LockMutex(linesMutex);
+    std::vector<ConsoleMessage> copy(lines.begin(), lines.end());
+    SDL_UnlockMutex(linesMutex);
+    return copy;
+}
+
+void Console::setMinimumSeverity(int messageType)
+{
+    minSeverity = messageType;
+}
+
+void Console::setRateLimit(unsigned int messagesPerSecond)
+{
+    rateLimit = messagesPerSecond;
+}
+
+void Console::setRetention(size_t maxLines)
+{
+    SDL_LockMutex(linesMutex);
+    retention = maxLines;
+    while(retention > 0 && lines.size() > retention)
+        lines.pop_front();
+    SDL_UnlockMutex(linesMutex);
+}
+
+int Console::getMinimumSeverity()
+{
+    return minSeverity;
+}
+
+unsigned int Console::getRateLimit()
+{
+    return rateLimit;
+}
+
+size_t Console::getRetention()
+{
+    return retention;
+}
+
+uint64_t Console::getDroppedMessages()
+{
+    return dropped;
+}
+
+uint64_t Console::getSuppressedMessages()
+{
+    return suppressed;
+}
+
+void Console::Print(int messageType, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    Enqueue(messageType, (size_t)format, format, args);
+    va_end(args);
 }
 
 void Console::Print(int messageType, std::string format, ...)
 {
     va_list args;
-    char buffer[4096];
     va_start(args, format);
-    vsnprintf(buffer, sizeof(buffer), format.c_str(), args);
+    Enqueue(messageType, std::hash<std::string>()(format), format.c_str(), args);
     va_end(args);
+}
+
+void Console::Enqueue(int messageType, size_t site, const char* format, va_list args)
+{
+    if(messageType >= 3) //Critical -> written synchronously because the application is aborted afterwards
+    {
+        char buffer[4096];
+        vsnprintf(buffer, sizeof(buffer), format, args);
+        Flush();
+        Output(messageType, buffer);
+        fflush(stdout);
+        ConsoleMessage msg;
+        msg.type = messageType;
+        msg.text = std::string(buffer);
+        AppendMessage(msg);
+        return;
+    }
+    
+    if(messageType < minSeverity || !Admit(site))
+        return;
+    
+    //Claim a slot in the ring (bounded MPMC queue)
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot;
+    while(true)
+    {
+        slot = &queue[pos & (CONSOLE_QUEUE_SIZE - 1)];
+        size_t seq = slot->sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        
+        if(diff == 0)
+        {
+            if(enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if(diff < 0) //Queue full -> never block the caller
+        {
+            ++dropped;
+            return;
+        }
+        else
+            pos = enqueuePos.load(std::memory_order_relaxed);
+    }
+    
+    slot->type = messageType;
+    vsnprintf(slot->text, sizeof(slot->text), format, args);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+}
+
+bool Console::Admit(size_t site)
+{
+    unsigned int limit = rateLimit;
+    if(limit == 0)
+        return true;
+    
+    //Call sites are identified by the address of their format string (or the hash of a dynamic one)
+    size_t key = (site >> 3) * 2654435761u;
+    std::atomic<uint64_t>& rate = rates[(key >> 8) & (CONSOLE_RATE_SLOTS - 1)];
+    uint64_t window = (uint64_t)(SDL_GetTicks()/1000);
+    uint64_t state = rate.load(std::memory_order_relaxed);
+    uint64_t next;
+    
+    do
+    {
+        if((state >> 20) != window) //Start of a new window
+            next = (window << 20) | 1;
+        else if((state & 0xFFFFF) < limit)
+            next = state + 1;
+        else
+        {
+            ++suppressed;
+            return false;
+        }
+    }
+    while(!rate.compare_exchange_weak(state, next, std::memory_order_relaxed));
+    
+    return true;
+}
+
+void Console::Flush()
+{
+    if(!running || writer == NULL)
+        return;
+    
+    while(dequeuePos.load(std::memory_order_acquire) < enqueuePos.load(std::memory_order_acquire))
+        SDL_Delay(1);
+}
+
+bool Console::Drain()
+{
+    bool any = false;
     
+    while(true)
+    {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        Slot* slot = &queue[pos & (CONSOLE_QUEUE_SIZE - 1)];
+        if(slot->sequence.load(std::memory_order_acquire) != pos + 1)
+            break;
+        
+        ConsoleMessage msg;
+        msg.type = slot->type;
+        msg.text = std::string(slot->text);
+        slot->sequence.store(pos + CONSOLE_QUEUE_SIZE, std::memory_order_release);
+        dequeuePos.store(pos + 1, std::memory_order_release);
+        
+        Output(msg.type, msg.text.c_str());
+        AppendMessage(msg);
+        any = true;
+    }
+    
+    //Report lost messages
+    uint64_t nDropped = dropped;
+    uint64_t nSuppressed = suppressed;
+    if(nDropped > droppedReported || nSuppressed > suppressedReported)
+    {
+        char buffer[128];
+        snprintf(buffer, sizeof(buffer), "Console: %lu messages dropped (queue full), %lu suppressed (rate limit).",
+                 (unsigned long)(nDropped - droppedReported), (unsigned long)(nSuppressed - suppressedReported));
+        droppedReported = nDropped;
+        suppressedReported = nSuppressed;
+        
+        ConsoleMessage msg;
+        msg.type = 1;
+        msg.text = std::string(buffer);
+        Output(msg.type, buffer);
+        AppendMessage(msg);
+        any = true;
+    }
+    
+    if(any)
+        fflush(stdout);
+    return any;
+}
+
+void Console::Output(int messageType, const char* text)
+{
 #ifdef COLOR_CONSOLE
     switch(messageType)
     {
         default:
         case 0: //Info
-            printf("[INFO] %s\n", buffer);
+            printf("[INFO] %s\n", text);
             break;
             
         case 1: //Warning
-            printf("\033[33m[WARN] %s\033[0m\n", buffer);
+            printf("\033[33m[WARN] %s\033[0m\n", text);
             break;
             
         case 2: //Error
-            printf("\033[31m[ERROR] %s\033[0m\n", buffer);
+            printf("\033[31m[ERROR] %s\033[0m\n", text);
             break;
             
         case 3: //Critical
-            printf("\033[1;31m[CRITICAL] %s\033[0m\n", buffer);
+            printf("\033[1;31m[CRITICAL] %s\033[0m\n", text);
             break;
     }
 #else
@@ -83,35 +305,30 @@ void Console::Print(int messageType, std::string format, ...)
     {
         default:
         case 0: //Info
-            printf("[INFO] %s\n", buffer);
+            printf("[INFO] %s\n", text);
             break;
             
         case 1: //Warning
-            printf("[WARN] %s\n", buffer);
+            printf("[WARN] %s\n", text);
             break;
             
         case 2: //Error
-            printf("[ERROR] %s\n", buffer);
+            printf("[ERROR] %s\n", text);
             break;
             
         case 3: //Critical
-            printf("[CRITICAL] %s\n", buffer);
+            printf("[CRITICAL] %s\n", text);
             break;
     }
 #endif
-    
-    ConsoleMessage msg;
-    msg.type = messageType;
-    msg.text = std::string(buffer);
-    SDL_LockMutex(linesMutex);
-    lines.push_back(msg);
-    SDL_UnlockMutex(linesMutex);
 }
 
 void Console::AppendMessage(const ConsoleMessage& msg)
 {
     SDL_LockMutex(linesMutex);
     lines.push_back(msg);
+    while(retention > 0 && lines.size() > retention)
+        lines.pop_front();
     SDL_UnlockMutex(linesMutex);
 }
     
@@ -122,4 +339,18 @@ void Console::Clear()
     SDL_UnlockMutex(linesMutex);
 }
 
+//Static
+int Console::WriterLoop(void* data)
+{
+    Console* console = (Console*)data;
+    
+    while(console->running)
+    {
+        if(!console->Drain())
+            SDL_Delay(CONSOLE_WRITER_SLEEP);
+    }
+    
+    return 0;
+}
+
 }
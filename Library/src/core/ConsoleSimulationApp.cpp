@@ -88,6 +88,7 @@ void ConsoleSimulationApp::StopSimulation()
     int status;
     SDL_WaitThread(simulationThread, &status);
     simulationThread = NULL;
+    console->Flush();
 }
 
 //Static
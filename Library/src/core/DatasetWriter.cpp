@@ -0,0 +1,501 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  DatasetWriter.cpp
+//  Stonefish
+//
+
+#include "core/DatasetWriter.h"
+
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include "stb_image_write.h"
+#include "core/Console.h"
+#include "sensors/vision/DepthCamera.h"
+#include "sensors/vision/Multibeam2.h"
+#include "sensors/vision/FLS.h"
+#include "sensors/vision/SSS.h"
+#include "sensors/vision/MSIS.h"
+
+#ifdef _WIN32
+#include <direct.h>
+#define DATASET_MKDIR(path) _mkdir(path)
+#else
+#include <sys/stat.h>
+#define DATASET_MKDIR(path) mkdir(path, 0755)
+#endif
+
+#define DATASET_PNG_COMPRESSION 6 //Compression level of the 16-bit PNG files
+#define DATASET_DEPTH_SCALE 1000.0 //Scale of the 16-bit depth images [1/m]
+
+//Compression function implemented in stb_image_write (not declared in its header)
+unsigned char* stbi_zlib_compress(unsigned char* data, int data_len, int* out_len, int quality);
+
+namespace sf
+{
+
+static std::vector<uint32_t> PNGCrcTable()
+{
+    std::vector<uint32_t> table(256);
+    for(uint32_t i=0; i<256; ++i)
+    {
+        uint32_t c = i;
+        for(int k=0; k<8; ++k)
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        table[i] = c;
+    }
+    return table;
+}
+
+static uint32_t PNGCrc32(const uint8_t* data, size_t len, uint32_t crc = 0)
+{
+    static const std::vector<uint32_t> table = PNGCrcTable();
+    
+    crc = ~crc;
+    for(size_t i=0; i<len; ++i)
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static void PNGWriteChunk(FILE* fp, const char* type, const uint8_t* data, uint32_t len)
+{
+    uint8_t bigEndian[4] = {(uint8_t)(len >> 24), (uint8_t)(len >> 16), (uint8_t)(len >> 8), (uint8_t)len};
+    fwrite(bigEndian, 1, 4, fp);
+    fwrite(type, 1, 4, fp);
+    if(len > 0)
+        fwrite(data, 1, len, fp);
+    
+    uint32_t crc = PNGCrc32(data, len, PNGCrc32((const uint8_t*)type, 4));
+    uint8_t crcBigEndian[4] = {(uint8_t)(crc >> 24), (uint8_t)(crc >> 16), (uint8_t)(crc >> 8), (uint8_t)crc};
+    fwrite(crcBigEndian, 1, 4, fp);
+}
+
+DatasetWriter::Stream::~Stream()
+{
+    SDL_DestroyMutex(mutex);
+}
+
+DatasetWriter::DatasetWriter(const std::string& directory, unsigned int workers, unsigned int buffersPerSensor, DatasetDropPolicy policy)
+{
+    this->directory = directory;
+    nBuffers = buffersPerSensor > 0 ? buffersPerSensor : 1;
+    dropPolicy = policy;
+    pending = 0;
+    running = true;
+    written = 0;
+    dropped = 0;
+    queueMutex = SDL_CreateMutex();
+    queueCond = SDL_CreateCond();
+    idleCond = SDL_CreateCond();
+    
+    unsigned int nWorkers = workers > 0 ? workers : 1;
+    for(unsigned int i=0; i<nWorkers; ++i)
+        this->workers.push_back(SDL_CreateThread(DatasetWriter::WorkerLoop, "datasetThread", this));
+}
+
+DatasetWriter::~DatasetWriter()
+{
+    //Detach from the sensors (listeners keep the streams alive but stop producing jobs)
+    for(size_t i=0; i<streams.size(); ++i)
+    {
+        SDL_LockMutex(streams[i]->mutex);
+        streams[i]->writer = NULL;
+        SDL_UnlockMutex(streams[i]->mutex);
+    }
+    
+    Flush();
+    
+    SDL_LockMutex(queueMutex);
+    running = false;
+    SDL_CondBroadcast(queueCond);
+    SDL_UnlockMutex(queueMutex);
+    
+    for(size_t i=0; i<workers.size(); ++i)
+        SDL_WaitThread(workers[i], NULL);
+    workers.clear();
+    
+    for(size_t i=0; i<streams.size(); ++i)
+    {
+        if(streams[i]->metadata != NULL)
+        {
+            fclose(streams[i]->metadata);
+            streams[i]->metadata = NULL;
+        }
+    }
+    streams.clear();
+    
+    SDL_DestroyCond(idleCond);
+    SDL_DestroyCond(queueCond);
+    SDL_DestroyMutex(queueMutex);
+    
+    cInfo("Dataset writer: %lu frames written, %lu frames dropped.", (unsigned long)written, (unsigned long)dropped);
+}
+
+bool DatasetWriter::AddSensor(VisionSensor* sens, DatasetDepthFormat depthFormat)
+{
+    Camera* cam = dynamic_cast<Camera*>(sens);
+    if(cam == NULL)
+    {
+        cError("Dataset writer: Sensor can not be added to the dataset!");
+        return false;
+    }
+    
+    std::shared_ptr<Stream> s = std::make_shared<Stream>();
+    s->mutex = SDL_CreateMutex();
+    s->writer = this;
+    s->name = sens->getName();
+    s->depthFormat = depthFormat;
+    s->frames = 0;
+    s->metadata = NULL;
+    cam->getResolution(s->width, s->height);
+    
+    std::string format;
+    std::string intrinsics;
+    char buf[256];
+    
+    switch(cam->getVisionSensorType())
+    {
+        case VisionSensorType::COLOR_CAMERA:
+        case VisionSensorType::DEPTH_CAMERA:
+        {
+            //Pinhole model with square pixels
+            Scalar fx = Scalar(s->width)/Scalar(2)/tan(cam->getHorizontalFOV()/Scalar(360)*M_PI);
+            snprintf(buf, sizeof(buf), "#Intrinsics (fx fy cx cy): %1.6lf %1.6lf %1.6lf %1.6lf\n",
+                     fx, fx, Scalar(s->width)/Scalar(2), Scalar(s->height)/Scalar(2));
+            intrinsics = std::string(buf);
+            
+            if(cam->getVisionSensorType() == VisionSensorType::COLOR_CAMERA)
+            {
+                s->channels = 3;
+                s->floatingPoint = false;
+                format = "RGB8 PNG";
+            }
+            else
+            {
+                glm::vec2 range = ((DepthCamera*)cam)->getDepthRange();
+                snprintf(buf, sizeof(buf), "#Depth range: %1.3lf %1.3lf m\n", (double)range.x, (double)range.y);
+                intrinsics += std::string(buf);
+                s->channels = 1;
+                s->floatingPoint = true;
+            }
+        }
+            break;
+        
+        case VisionSensorType::MULTIBEAM2:
+        {
+            Multibeam2* mb = (Multibeam2*)cam;
+            glm::vec2 range = mb->getRangeLimits();
+            snprintf(buf, sizeof(buf), "#Field of view (horizontal vertical): %1.3lf %1.3lf deg\n#Range: %1.3lf %1.3lf m\n",
+                     cam->getHorizontalFOV(), mb->getVerticalFOV(), (double)range.x, (double)range.y);
+            intrinsics = std::string(buf);
+            s->channels = 1;
+            s->floatingPoint = true;
+        }
+            break;
+        
+        case VisionSensorType::FLS:
+        case VisionSensorType::SSS:
+        case VisionSensorType::MSIS:
+        {
+            Scalar rMin, rMax;
+            if(cam->getVisionSensorType() == VisionSensorType::FLS)
+            {
+                rMin = ((FLS*)cam)->getRangeMin();
+                rMax = ((FLS*)cam)->getRangeMax();
+            }
+            else if(cam->getVisionSensorType() == VisionSensorType::SSS)
+            {
+                rMin = ((SSS*)cam)->getRangeMin();
+                rMax = ((SSS*)cam)->getRangeMax();
+            }
+            else
+            {
+                rMin = ((MSIS*)cam)->getRangeMin();
+                rMax = ((MSIS*)cam)->getRangeMax();
+            }
+            snprintf(buf, sizeof(buf), "#Beam width: %1.3lf deg\n#Range: %1.3lf %1.3lf m\n", cam->getHorizontalFOV(), rMin, rMax);
+            intrinsics = std::string(buf);
+            s->channels = 1;
+            s->floatingPoint = false;
+            format = "Mono8 PNG";
+        }
+            break;
+    }
+    
+    if(s->floatingPoint)
+        format = depthFormat == DatasetDepthFormat::FLOAT_PFM ? "Float32 PFM [m]" : "Mono16 PNG [mm]";
+    
+    //Create output directory of the sensor
+    std::string dirName = s->name;
+    for(size_t i=0; i<dirName.size(); ++i)
+        if(dirName[i] == '/')
+            dirName[i] = '_';
+    s->directory = directory + "/" + dirName;
+    DATASET_MKDIR(s->directory.c_str());
+    
+    //Write metadata header
+    std::string metaPath = s->directory + "/metadata.txt";
+    s->metadata = fopen(metaPath.c_str(), "wt");
+    if(s->metadata == NULL)
+    {
+        cError("Dataset writer: File '%s' could not be opened!", metaPath.c_str());
+        return false;
+    }
+    
+    fprintf(s->metadata, "#Frames from %s\n", s->name.c_str());
+    fprintf(s->metadata, "#Resolution: %u x %u\n", s->width, s->height);
+    fprintf(s->metadata, "#Format: %s\n", format.c_str());
+    fprintf(s->metadata, "%s", intrinsics.c_str());
+    fprintf(s->metadata, "#Pose of the sensor frame in the world frame (NED)\n\n");
+    fprintf(s->metadata, "#Frame\tTime\tX\tY\tZ\tQx\tQy\tQz\tQw\tFile\n");
+    fflush(s->metadata);
+    
+    //Preallocate buffers
+    size_t frameSize = (size_t)s->width * s->height * s->channels * (s->floatingPoint ? sizeof(float) : 1);
+    s->buffers = std::vector<std::vector<uint8_t>>(nBuffers, std::vector<uint8_t>(frameSize));
+    for(size_t i=0; i<s->buffers.size(); ++i)
+        s->freeBuffers.push_back(&s->buffers[i]);
+    
+    std::shared_ptr<Stream> listenerStream = s;
+    sens->AddFrameListener([listenerStream](VisionSensor* vs, const VisionSensorFrame& frame)
+    {
+        SDL_LockMutex(listenerStream->mutex);
+        if(listenerStream->writer != NULL)
+            listenerStream->writer->Enqueue(listenerStream.get(), frame);
+        SDL_UnlockMutex(listenerStream->mutex);
+    });
+    
+    streams.push_back(s);
+    return true;
+}
+
+void DatasetWriter::Enqueue(Stream* s, const VisionSensorFrame& frame)
+{
+    uint64_t frameId = s->frames++;
+    if(frame.getDataSize() != s->buffers[0].size())
+    {
+        ++dropped;
+        return;
+    }
+    
+    //Get a free buffer or reuse the buffer of the oldest queued frame
+    std::vector<uint8_t>* buffer = NULL;
+    bool replaced = false;
+    
+    SDL_LockMutex(queueMutex);
+    if(s->freeBuffers.size() > 0)
+    {
+        buffer = s->freeBuffers.back();
+        s->freeBuffers.pop_back();
+    }
+    else if(dropPolicy == DatasetDropPolicy::DROP_OLDEST)
+    {
+        for(std::deque<Job>::iterator it = queue.begin(); it != queue.end(); ++it)
+        {
+            if(it->stream == s)
+            {
+                buffer = it->buffer;
+                replaced = true;
+                queue.erase(it);
+                break;
+            }
+        }
+    }
+    SDL_UnlockMutex(queueMutex);
+    
+    if(buffer == NULL || replaced)
+        ++dropped;
+    if(buffer == NULL) //All buffers are being written
+        return;
+    
+    //Copy outside of the lock (the buffer is owned by this thread now)
+    memcpy(buffer->data(), frame.data, buffer->size());
+    
+    Job job;
+    job.stream = s;
+    job.buffer = buffer;
+    job.frameId = frameId;
+    job.timestamp = frame.timestamp;
+    job.pose = frame.pose;
+    
+    SDL_LockMutex(queueMutex);
+    queue.push_back(job);
+    if(!replaced)
+        ++pending;
+    SDL_CondSignal(queueCond);
+    SDL_UnlockMutex(queueMutex);
+}
+
+void DatasetWriter::Flush()
+{
+    SDL_LockMutex(queueMutex);
+    while(pending > 0)
+        SDL_CondWait(idleCond, queueMutex);
+    SDL_UnlockMutex(queueMutex);
+}
+
+int DatasetWriter::WorkerLoop(void* data)
+{
+    DatasetWriter* dw = (DatasetWriter*)data;
+    
+    SDL_LockMutex(dw->queueMutex);
+    while(true)
+    {
+        while(dw->running && dw->queue.empty())
+            SDL_CondWait(dw->queueCond, dw->queueMutex);
+        
+        if(dw->queue.empty()) //Stopped and nothing left to write
+            break;
+        
+        Job job = dw->queue.front();
+        dw->queue.pop_front();
+        SDL_UnlockMutex(dw->queueMutex);
+        
+        dw->WriteFrame(job);
+        
+        SDL_LockMutex(dw->queueMutex);
+        job.stream->freeBuffers.push_back(job.buffer);
+        if(--dw->pending == 0)
+            SDL_CondBroadcast(dw->idleCond);
+    }
+    SDL_UnlockMutex(dw->queueMutex);
+    return 0;
+}
+
+void DatasetWriter::WriteFrame(const Job& job)
+{
+    Stream* s = job.stream;
+    
+    char id[32];
+    snprintf(id, sizeof(id), "%06lu", (unsigned long)job.frameId);
+    std::string fileName = std::string(id);
+    bool ok;
+    
+    if(!s->floatingPoint)
+    {
+        fileName += ".png";
+        ok = stbi_write_png((s->directory + "/" + fileName).c_str(), (int)s->width, (int)s->height, (int)s->channels,
+                            job.buffer->data(), (int)(s->width * s->channels)) != 0;
+    }
+    else if(s->depthFormat == DatasetDepthFormat::FLOAT_PFM)
+    {
+        fileName += ".pfm";
+        ok = WritePFM(s->directory + "/" + fileName, *job.buffer, s->width, s->height);
+    }
+    else
+    {
+        fileName += ".png";
+        ok = WritePNG16(s->directory + "/" + fileName, *job.buffer, s->width, s->height);
+    }
+    
+    if(!ok)
+    {
+        cError("Dataset writer: Frame '%s/%s' could not be written!", s->directory.c_str(), fileName.c_str());
+        return;
+    }
+    
+    ++written;
+    
+    Vector3 o = job.pose.getOrigin();
+    Quaternion q = job.pose.getRotation();
+    SDL_LockMutex(s->mutex);
+    fprintf(s->metadata, "%lu\t%1.6lf\t%1.6lf\t%1.6lf\t%1.6lf\t%1.6lf\t%1.6lf\t%1.6lf\t%1.6lf\t%s\n",
+            (unsigned long)job.frameId, job.timestamp, o.getX(), o.getY(), o.getZ(), q.getX(), q.getY(), q.getZ(), q.getW(), fileName.c_str());
+    SDL_UnlockMutex(s->mutex);
+}
+
+bool DatasetWriter::WritePNG16(const std::string& path, const std::vector<uint8_t>& data, unsigned int width, unsigned int height)
+{
+    //Convert to big-endian millimetres, each row preceded by filter type 0
+    const float* depth = (const float*)data.data();
+    std::vector<uint8_t> raw(height * (1 + width * 2));
+    uint8_t* ptr = raw.data();
+    
+    for(unsigned int y=0; y<height; ++y)
+    {
+        *ptr++ = 0;
+        for(unsigned int x=0; x<width; ++x)
+        {
+            float d = depth[y * width + x];
+            uint16_t mm = (std::isfinite(d) && d > 0.f) ? (uint16_t)std::min(d * DATASET_DEPTH_SCALE + 0.5, 65535.0) : 0;
+            *ptr++ = (uint8_t)(mm >> 8);
+            *ptr++ = (uint8_t)(mm & 0xFF);
+        }
+    }
+    
+    int zlen;
+    unsigned char* zdata = stbi_zlib_compress(raw.data(), (int)raw.size(), &zlen, DATASET_PNG_COMPRESSION);
+    if(zdata == NULL)
+        return false;
+    
+    FILE* fp = fopen(path.c_str(), "wb");
+    if(fp == NULL)
+    {
+        free(zdata);
+        return false;
+    }
+    
+    const uint8_t signature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+    uint8_t ihdr[13] = {(uint8_t)(width >> 24), (uint8_t)(width >> 16), (uint8_t)(width >> 8), (uint8_t)width,
+                        (uint8_t)(height >> 24), (uint8_t)(height >> 16), (uint8_t)(height >> 8), (uint8_t)height,
+                        16, 0, 0, 0, 0}; //16-bit grayscale, no interlace
+    fwrite(signature, 1, 8, fp);
+    PNGWriteChunk(fp, "IHDR", ihdr, 13);
+    PNGWriteChunk(fp, "IDAT", zdata, (uint32_t)zlen);
+    PNGWriteChunk(fp, "IEND", NULL, 0);
+    free(zdata);
+    
+    bool ok = ferror(fp) == 0;
+    fclose(fp);
+    return ok;
+}
+
+bool DatasetWriter::WritePFM(const std::string& path, const std::vector<uint8_t>& data, unsigned int width, unsigned int height)
+{
+    FILE* fp = fopen(path.c_str(), "wb");
+    if(fp == NULL)
+        return false;
+    
+    //Grayscale, little-endian (negative scale), rows stored from the bottom
+    fprintf(fp, "Pf\n%u %u\n-1.0\n", width, height);
+    const float* values = (const float*)data.data();
+    for(unsigned int y=0; y<height; ++y)
+        fwrite(&values[(height - 1 - y) * width], sizeof(float), width, fp);
+    
+    bool ok = ferror(fp) == 0;
+    fclose(fp);
+    return ok;
+}
+
+uint64_t DatasetWriter::getWrittenFrames()
+{
+    return written;
+}
+
+uint64_t DatasetWriter::getDroppedFrames()
+{
+    return dropped;
+}
+
+std::string DatasetWriter::getDirectory()
+{
+    return directory;
+}
+
+}
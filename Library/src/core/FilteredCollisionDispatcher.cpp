@@ -55,9 +55,9 @@ bool FilteredCollisionDispatcher::needsCollision(const btCollisionObject* body0,
         return false;
     
     if(inclusive)
-        return SimulationApp::getApp()->getSimulationManager()->CheckCollision(ent0, ent1) > -1;
+        return SimulationManager::getCurrent()->CheckCollision(ent0, ent1) > -1;
     else //exclusive
-        return SimulationApp::getApp()->getSimulationManager()->CheckCollision(ent0, ent1) == -1;
+        return SimulationManager::getCurrent()->CheckCollision(ent0, ent1) == -1;
 }
 
 void FilteredCollisionDispatcher::myNearCallback(btBroadphasePair& collisionPair, btCollisionDispatcher& dispatcher, const btDispatcherInfo& dispatchInfo)
@@ -275,6 +275,7 @@ void GraphicalSimulationApp::InitializeSDL()
     GLSLShader::Init();
     
     //Initialize console output
+    console->Flush();
     std::vector<ConsoleMessage> textLines = console->getLines();
     delete console;
     console = new OpenGLConsole();
@@ -625,7 +626,9 @@ void GraphicalSimulationApp::RenderLoop()
     if(displayConsole)
     {
         gui->GenerateBackground();
+        SDL_LockMutex(console->getLinesMutex());
         ((OpenGLConsole*)console)->Render(true);
+        SDL_UnlockMutex(console->getLinesMutex());
     }
     else
     {
@@ -991,11 +994,7 @@ int GraphicalSimulationApp::RunSimulation(void* data)
     {
         sim->AdvanceSimulation();
         if(stdata->app->getGLPipeline()->isDrawingQueueEmpty())
-        {
-            SDL_LockMutex(stdata->drawMutex);
             sim->UpdateDrawingQueue();
-            SDL_UnlockMutex(stdata->drawMutex);
-        }
     }
     
     return 0;
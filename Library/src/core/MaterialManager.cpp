@@ -53,6 +53,7 @@ std::string MaterialManager::CreateMaterial(const std::string& uniqueName, Scala
     //Create and add new material
     Material mat;
     mat.name = materialNameManager.AddName(uniqueName);
+    mat.id = (int)materials.size();
     mat.density = density;
     mat.restitution = restitution;
     materials.push_back(mat);
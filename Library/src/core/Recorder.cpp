@@ -0,0 +1,475 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  Recorder.cpp
+//  Stonefish
+//
+
+#include "core/Recorder.h"
+
+#include <SDL2/SDL_timer.h>
+#include "core/Console.h"
+#include "sensors/ScalarSensor.h"
+#include "actuators/Thruster.h"
+#include "actuators/Propeller.h"
+#include "actuators/Motor.h"
+#include "actuators/Servo.h"
+#include "actuators/VariableBuoyancy.h"
+#include "entities/MovingEntity.h"
+
+#define RECORDER_FLUSH_PERIOD 1000 //Period of flushing incomplete chunks [ms]
+#define RECORDER_WRITER_SLEEP 10 //Sleep time of the writer thread when queues are empty [ms]
+
+namespace sf
+{
+
+Recorder::Recorder(const std::string& path, unsigned int chunkLength, unsigned int queueLength)
+{
+    this->path = path;
+    chunkLen = chunkLength > 0 ? chunkLength : 1;
+    queueLen = queueLength > 1 ? queueLength : 2;
+    file = NULL;
+    fileOffset = 0;
+    writer = NULL;
+    running = false;
+    dropped = 0;
+}
+
+Recorder::~Recorder()
+{
+    Stop();
+    
+    for(size_t i=0; i<streams.size(); ++i)
+    {
+        if(streams[i]->sensor != NULL)
+            streams[i]->sensor->setRecorder(NULL, 0);
+        delete streams[i];
+    }
+    streams.clear();
+}
+
+int Recorder::AddStream(const std::string& name, const std::vector<std::string>& channels, Scalar rate)
+{
+    if(file != NULL)
+    {
+        cError("Recorder: Stream '%s' can not be added after the recording started!", name.c_str());
+        return -1;
+    }
+    
+    Stream* s = new Stream();
+    s->name = name;
+    s->channels = channels;
+    s->rate = rate;
+    s->nextTime = Scalar(0);
+    s->sensor = NULL;
+    s->actuator = NULL;
+    s->entity = NULL;
+    s->queue = std::vector<double>(queueLen * (channels.size() + 1));
+    s->head = 0;
+    s->tail = 0;
+    s->chunk = std::vector<double>(chunkLen * (channels.size() + 1));
+    s->chunkSize = 0;
+    s->lastFlush = 0;
+    streams.push_back(s);
+    return (int)streams.size()-1;
+}
+
+int Recorder::AddSensor(ScalarSensor* sens)
+{
+    if(sens == NULL)
+        return -1;
+    
+    std::vector<std::string> channels;
+    for(unsigned short i=0; i<sens->getNumOfChannels(); ++i)
+        channels.push_back(sens->getSensorChannelDescription(i).name);
+    
+    int id = AddStream(sens->getName(), channels, sens->getUpdateFrequency());
+    if(id > -1)
+    {
+        streams[id]->sensor = sens;
+        sens->setRecorder(this, (unsigned int)id);
+    }
+    return id;
+}
+
+int Recorder::AddActuator(Actuator* act, Scalar frequency)
+{
+    if(act == NULL)
+        return -1;
+    
+    std::vector<std::string> channels;
+    switch(act->getType())
+    {
+        case ActuatorType::THRUSTER:
+        case ActuatorType::PROPELLER:
+            channels = {"Setpoint", "Angular velocity", "Thrust", "Torque"};
+            break;
+        
+        case ActuatorType::MOTOR:
+            channels = {"Torque", "Angle", "Angular velocity"};
+            break;
+        
+        case ActuatorType::SERVO:
+            channels = {"Position", "Velocity", "Effort"};
+            break;
+        
+        case ActuatorType::VBS:
+            channels = {"Flow rate", "Liquid volume", "Force"};
+            break;
+        
+        default:
+            cWarning("Recorder: Actuator '%s' has no state to record!", act->getName().c_str());
+            return -1;
+    }
+    
+    int id = AddStream(act->getName(), channels, frequency);
+    if(id > -1)
+        streams[id]->actuator = act;
+    return id;
+}
+
+int Recorder::AddEntity(MovingEntity* ent, Scalar frequency)
+{
+    if(ent == NULL)
+        return -1;
+    
+    std::vector<std::string> channels = {"X", "Y", "Z", "Roll", "Pitch", "Yaw",
+                                         "Linear velocity X", "Linear velocity Y", "Linear velocity Z",
+                                         "Angular velocity X", "Angular velocity Y", "Angular velocity Z"};
+    int id = AddStream(ent->getName(), channels, frequency);
+    if(id > -1)
+        streams[id]->entity = ent;
+    return id;
+}
+
+void Recorder::WriteString(const std::string& str)
+{
+    uint32_t len = (uint32_t)str.size();
+    Write(&len, sizeof(len));
+    Write(str.data(), len);
+}
+
+void Recorder::Write(const void* data, size_t size)
+{
+    fwrite(data, 1, size, file);
+    fileOffset += size;
+}
+
+bool Recorder::Start()
+{
+    if(file != NULL)
+        return true;
+    
+    file = fopen(path.c_str(), "wb");
+    if(file == NULL)
+    {
+        cError("Recorder: File '%s' could not be opened!", path.c_str());
+        return false;
+    }
+    fileOffset = 0;
+    index.clear();
+    
+    //Write header
+    char magic[8] = RECORDING_FILE_MAGIC;
+    Write(magic, 8);
+    uint32_t nStreams = (uint32_t)streams.size();
+    Write(&nStreams, sizeof(nStreams));
+    
+    for(size_t i=0; i<streams.size(); ++i)
+    {
+        WriteString(streams[i]->name);
+        double rate = streams[i]->rate;
+        Write(&rate, sizeof(rate));
+        uint32_t nChannels = (uint32_t)streams[i]->channels.size();
+        Write(&nChannels, sizeof(nChannels));
+        for(size_t h=0; h<streams[i]->channels.size(); ++h)
+            WriteString(streams[i]->channels[h]);
+    }
+    fflush(file);
+    
+    running = true;
+    writer = SDL_CreateThread(Recorder::WriterLoop, "recorderThread", this);
+    cInfo("Recording %lu streams to: %s", (unsigned long)streams.size(), path.c_str());
+    return true;
+}
+
+void Recorder::Stop()
+{
+    if(file == NULL)
+        return;
+    
+    running = false;
+    SDL_WaitThread(writer, NULL);
+    writer = NULL;
+    
+    //Write remaining data
+    Drain(true);
+    
+    //Write index and footer
+    uint64_t indexOffset = fileOffset;
+    uint32_t magic = RECORDING_INDEX_MAGIC;
+    Write(&magic, sizeof(magic));
+    uint32_t nEntries = (uint32_t)index.size();
+    Write(&nEntries, sizeof(nEntries));
+    for(size_t i=0; i<index.size(); ++i)
+    {
+        Write(&index[i].stream, sizeof(index[i].stream));
+        Write(&index[i].nSamples, sizeof(index[i].nSamples));
+        Write(&index[i].tStart, sizeof(index[i].tStart));
+        Write(&index[i].tEnd, sizeof(index[i].tEnd));
+        Write(&index[i].offset, sizeof(index[i].offset));
+    }
+    Write(&indexOffset, sizeof(indexOffset));
+    char endMagic[8];
+    memcpy(endMagic, RECORDING_END_MAGIC, 8);
+    Write(endMagic, 8);
+    
+    fclose(file);
+    file = NULL;
+    
+    if(dropped > 0)
+        cWarning("Recorder: %lu samples were dropped because the queues were full!", (unsigned long)dropped);
+}
+
+bool Recorder::Push(unsigned int streamId, Scalar time, const Scalar* values)
+{
+    if(!running || streamId >= streams.size())
+        return false;
+    
+    Stream* s = streams[streamId];
+    unsigned int head = s->head.load(std::memory_order_relaxed);
+    unsigned int next = (head + 1) % queueLen;
+    
+    if(next == s->tail.load(std::memory_order_acquire)) //Queue full -> never block the simulation
+    {
+        ++dropped;
+        return false;
+    }
+    
+    size_t rowSize = s->channels.size() + 1;
+    double* row = &s->queue[head * rowSize];
+    row[0] = time;
+    for(size_t i=1; i<rowSize; ++i)
+        row[i] = values[i-1];
+    
+    s->head.store(next, std::memory_order_release);
+    return true;
+}
+
+void Recorder::SampleStream(unsigned int streamId, Scalar time)
+{
+    Stream* s = streams[streamId];
+    Scalar values[12];
+    
+    if(s->actuator != NULL)
+    {
+        switch(s->actuator->getType())
+        {
+            case ActuatorType::THRUSTER:
+            {
+                Thruster* th = (Thruster*)s->actuator;
+                values[0] = th->getSetpoint();
+                values[1] = th->getOmega();
+                values[2] = th->getThrust();
+                values[3] = th->getTorque();
+            }
+                break;
+            
+            case ActuatorType::PROPELLER:
+            {
+                Propeller* prop = (Propeller*)s->actuator;
+                values[0] = prop->getSetpoint();
+                values[1] = prop->getOmega();
+                values[2] = prop->getThrust();
+                values[3] = prop->getTorque();
+            }
+                break;
+            
+            case ActuatorType::MOTOR:
+            {
+                Motor* mot = (Motor*)s->actuator;
+                values[0] = mot->getTorque();
+                values[1] = mot->getAngle();
+                values[2] = mot->getAngularVelocity();
+            }
+                break;
+            
+            case ActuatorType::SERVO:
+            {
+                Servo* srv = (Servo*)s->actuator;
+                values[0] = srv->getPosition();
+                values[1] = srv->getVelocity();
+                values[2] = srv->getEffort();
+            }
+                break;
+            
+            case ActuatorType::VBS:
+            {
+                VariableBuoyancy* vbs = (VariableBuoyancy*)s->actuator;
+                values[0] = vbs->getFlowRate();
+                values[1] = vbs->getLiquidVolume();
+                values[2] = vbs->getForce();
+            }
+                break;
+            
+            default:
+                return;
+        }
+    }
+    else if(s->entity != NULL)
+    {
+        Transform T = s->entity->getOTransform();
+        Vector3 v = s->entity->getLinearVelocity();
+        Vector3 w = s->entity->getAngularVelocity();
+        values[0] = T.getOrigin().getX();
+        values[1] = T.getOrigin().getY();
+        values[2] = T.getOrigin().getZ();
+        T.getBasis().getEulerYPR(values[5], values[4], values[3]);
+        values[6] = v.getX();
+        values[7] = v.getY();
+        values[8] = v.getZ();
+        values[9] = w.getX();
+        values[10] = w.getY();
+        values[11] = w.getZ();
+    }
+    else
+        return;
+    
+    Push(streamId, time, values);
+}
+
+void Recorder::Record(Scalar time)
+{
+    if(!running)
+        return;
+    
+    for(size_t i=0; i<streams.size(); ++i)
+    {
+        Stream* s = streams[i];
+        if(s->sensor != NULL) //Sensors push their samples when generated
+            continue;
+        
+        if(s->rate > Scalar(0))
+        {
+            if(time < s->nextTime)
+                continue;
+            while(s->nextTime <= time)
+                s->nextTime += Scalar(1)/s->rate;
+        }
+        
+        SampleStream((unsigned int)i, time);
+    }
+}
+
+bool Recorder::Drain(bool flush)
+{
+    bool empty = true;
+    uint32_t now = SDL_GetTicks();
+    
+    for(size_t i=0; i<streams.size(); ++i)
+    {
+        Stream* s = streams[i];
+        size_t rowSize = s->channels.size() + 1;
+        unsigned int tail = s->tail.load(std::memory_order_relaxed);
+        
+        while(tail != s->head.load(std::memory_order_acquire))
+        {
+            //Transpose row to columns
+            const double* row = &s->queue[tail * rowSize];
+            for(size_t h=0; h<rowSize; ++h)
+                s->chunk[h * chunkLen + s->chunkSize] = row[h];
+            ++s->chunkSize;
+            
+            tail = (tail + 1) % queueLen;
+            s->tail.store(tail, std::memory_order_release);
+            empty = false;
+            
+            if(s->chunkSize == chunkLen)
+            {
+                WriteChunk((unsigned int)i);
+                s->lastFlush = now;
+            }
+        }
+        
+        //Write incomplete chunks periodically to limit data loss in case of a crash
+        if(s->chunkSize > 0 && (flush || now - s->lastFlush >= RECORDER_FLUSH_PERIOD))
+        {
+            WriteChunk((unsigned int)i);
+            s->lastFlush = now;
+        }
+    }
+    
+    return empty;
+}
+
+void Recorder::WriteChunk(unsigned int streamId)
+{
+    Stream* s = streams[streamId];
+    
+    RecordingIndexEntry entry;
+    entry.stream = streamId;
+    entry.nSamples = s->chunkSize;
+    entry.tStart = s->chunk[0];
+    entry.tEnd = s->chunk[s->chunkSize-1];
+    entry.offset = fileOffset;
+    index.push_back(entry);
+    
+    uint32_t magic = RECORDING_CHUNK_MAGIC;
+    uint32_t nChannels = (uint32_t)s->channels.size();
+    Write(&magic, sizeof(magic));
+    Write(&entry.stream, sizeof(entry.stream));
+    Write(&entry.nSamples, sizeof(entry.nSamples));
+    Write(&nChannels, sizeof(nChannels));
+    Write(&entry.tStart, sizeof(entry.tStart));
+    Write(&entry.tEnd, sizeof(entry.tEnd));
+    for(size_t h=0; h<=s->channels.size(); ++h)
+        Write(&s->chunk[h * chunkLen], sizeof(double) * s->chunkSize);
+    fflush(file);
+    
+    s->chunkSize = 0;
+}
+
+int Recorder::WriterLoop(void* data)
+{
+    Recorder* rec = (Recorder*)data;
+    
+    while(rec->running)
+    {
+        if(rec->Drain(false))
+            SDL_Delay(RECORDER_WRITER_SLEEP);
+    }
+    
+    return 0;
+}
+
+bool Recorder::isRecording()
+{
+    return running;
+}
+
+uint64_t Recorder::getDroppedSamples()
+{
+    return dropped;
+}
+
+std::string Recorder::getPath()
+{
+    return path;
+}
+
+}
@@ -0,0 +1,392 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  RecordingReader.cpp
+//  Stonefish
+//
+
+#include "core/RecordingReader.h"
+
+#include <cstring>
+#include "core/Console.h"
+#include "utils/ScientificFileUtil.h"
+
+#define RECORDING_CHUNK_HEADER_SIZE 32
+#define RECORDING_FOOTER_SIZE 16
+
+namespace sf
+{
+
+RecordingReader::RecordingReader(const std::string& path)
+{
+    valid = false;
+    complete = false;
+    fileSize = 0;
+    dataOffset = 0;
+    
+    file = fopen(path.c_str(), "rb");
+    if(file == NULL)
+    {
+        cError("Recording '%s' could not be opened!", path.c_str());
+        return;
+    }
+    
+    if(!ReadHeader())
+    {
+        cError("Recording '%s' has an invalid header!", path.c_str());
+        return;
+    }
+    
+    valid = true;
+    complete = ReadIndex();
+    if(!complete)
+    {
+        cWarning("Recording '%s' was not closed properly. Rebuilding index...", path.c_str());
+        ScanChunks();
+    }
+}
+
+RecordingReader::~RecordingReader()
+{
+    if(file != NULL)
+        fclose(file);
+}
+
+bool RecordingReader::Seek(uint64_t offset)
+{
+#ifdef _WIN32
+    return _fseeki64(file, (__int64)offset, SEEK_SET) == 0;
+#else
+    return fseeko(file, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+bool RecordingReader::ReadString(std::string& str)
+{
+    uint32_t len;
+    if(fread(&len, sizeof(len), 1, file) != 1)
+        return false;
+    str.resize(len);
+    return len == 0 || fread(&str[0], 1, len, file) == len;
+}
+
+bool RecordingReader::ReadHeader()
+{
+    //Get file size
+#ifdef _WIN32
+    _fseeki64(file, 0, SEEK_END);
+    fileSize = (uint64_t)_ftelli64(file);
+#else
+    fseeko(file, 0, SEEK_END);
+    fileSize = (uint64_t)ftello(file);
+#endif
+    Seek(0);
+    
+    char magic[8];
+    if(fread(magic, 1, 8, file) != 8 || strncmp(magic, RECORDING_FILE_MAGIC, 8) != 0)
+        return false;
+    
+    uint32_t nStreams;
+    if(fread(&nStreams, sizeof(nStreams), 1, file) != 1)
+        return false;
+    
+    for(uint32_t i=0; i<nStreams; ++i)
+    {
+        StreamInfo info;
+        double rate;
+        uint32_t nChannels;
+        
+        if(!ReadString(info.name)
+           || fread(&rate, sizeof(rate), 1, file) != 1
+           || fread(&nChannels, sizeof(nChannels), 1, file) != 1)
+            return false;
+        
+        info.rate = rate;
+        info.channels.resize(nChannels);
+        for(uint32_t h=0; h<nChannels; ++h)
+            if(!ReadString(info.channels[h]))
+                return false;
+        
+        streams.push_back(info);
+    }
+
+#ifdef _WIN32
+    dataOffset = (uint64_t)_ftelli64(file);
+#else
+    dataOffset = (uint64_t)ftello(file);
+#endif
+    return true;
+}
+
+bool RecordingReader::ReadIndex()
+{
+    if(fileSize < dataOffset + RECORDING_FOOTER_SIZE)
+        return false;
+    
+    //Read footer
+    uint64_t indexOffset;
+    char endMagic[8];
+    if(!Seek(fileSize - RECORDING_FOOTER_SIZE)
+       || fread(&indexOffset, sizeof(indexOffset), 1, file) != 1
+       || fread(endMagic, 1, 8, file) != 8
+       || strncmp(endMagic, RECORDING_END_MAGIC, 8) != 0
+       || indexOffset < dataOffset || indexOffset >= fileSize)
+        return false;
+    
+    //Read index
+    uint32_t magic;
+    uint32_t nEntries;
+    if(!Seek(indexOffset)
+       || fread(&magic, sizeof(magic), 1, file) != 1
+       || magic != RECORDING_INDEX_MAGIC
+       || fread(&nEntries, sizeof(nEntries), 1, file) != 1)
+        return false;
+    
+    index.resize(nEntries);
+    for(uint32_t i=0; i<nEntries; ++i)
+    {
+        RecordingIndexEntry& e = index[i];
+        if(fread(&e.stream, sizeof(e.stream), 1, file) != 1
+           || fread(&e.nSamples, sizeof(e.nSamples), 1, file) != 1
+           || fread(&e.tStart, sizeof(e.tStart), 1, file) != 1
+           || fread(&e.tEnd, sizeof(e.tEnd), 1, file) != 1
+           || fread(&e.offset, sizeof(e.offset), 1, file) != 1)
+        {
+            index.clear();
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+void RecordingReader::ScanChunks()
+{
+    index.clear();
+    uint64_t offset = dataOffset;
+    
+    while(offset + RECORDING_CHUNK_HEADER_SIZE <= fileSize && Seek(offset))
+    {
+        RecordingIndexEntry e;
+        uint32_t magic;
+        uint32_t nChannels;
+        
+        if(fread(&magic, sizeof(magic), 1, file) != 1
+           || magic != RECORDING_CHUNK_MAGIC
+           || fread(&e.stream, sizeof(e.stream), 1, file) != 1
+           || fread(&e.nSamples, sizeof(e.nSamples), 1, file) != 1
+           || fread(&nChannels, sizeof(nChannels), 1, file) != 1
+           || fread(&e.tStart, sizeof(e.tStart), 1, file) != 1
+           || fread(&e.tEnd, sizeof(e.tEnd), 1, file) != 1)
+            break;
+        
+        uint64_t chunkSize = RECORDING_CHUNK_HEADER_SIZE + (uint64_t)e.nSamples * (nChannels + 1) * sizeof(double);
+        if(e.stream >= streams.size() || offset + chunkSize > fileSize) //Corrupted or truncated chunk
+            break;
+        
+        e.offset = offset;
+        index.push_back(e);
+        offset += chunkSize;
+    }
+}
+
+bool RecordingReader::ReadStream(unsigned int streamId, Scalar tStart, Scalar tEnd, std::vector<Scalar>& time, std::vector<std::vector<Scalar>>& values)
+{
+    if(!valid || streamId >= streams.size())
+        return false;
+    
+    size_t nChannels = streams[streamId].channels.size();
+    time.clear();
+    values = std::vector<std::vector<Scalar>>(nChannels);
+    std::vector<double> columns;
+    
+    for(size_t i=0; i<index.size(); ++i)
+    {
+        const RecordingIndexEntry& e = index[i];
+        if(e.stream != streamId || e.tEnd < tStart || e.tStart > tEnd)
+            continue;
+        
+        //Read all columns of the chunk
+        columns.resize(e.nSamples * (nChannels + 1));
+        if(!Seek(e.offset + RECORDING_CHUNK_HEADER_SIZE)
+           || fread(columns.data(), sizeof(double), columns.size(), file) != columns.size())
+            return false;
+        
+        for(uint32_t h=0; h<e.nSamples; ++h)
+        {
+            if(columns[h] < tStart || columns[h] > tEnd)
+                continue;
+            
+            time.push_back(columns[h]);
+            for(size_t c=0; c<nChannels; ++c)
+                values[c].push_back(columns[(c + 1) * e.nSamples + h]);
+        }
+    }
+    
+    return true;
+}
+
+bool RecordingReader::SaveStreamToTextFile(unsigned int streamId, const std::string& path, bool includeTime, unsigned int fixedPrecision)
+{
+    std::vector<Scalar> time;
+    std::vector<std::vector<Scalar>> values;
+    if(!ReadStream(streamId, -BT_LARGE_FLOAT, BT_LARGE_FLOAT, time, values) || time.size() == 0)
+        return false;
+    
+    const StreamInfo& info = streams[streamId];
+    cInfo("Saving %s measurements to: %s", info.name.c_str(), path.c_str());
+    
+    FILE* fp = fopen(path.c_str(), "wt");
+    if(fp == NULL)
+    {
+        cError("File could not be opened!");
+        return false;
+    }
+    
+    //Write header
+    Scalar rate = info.rate;
+    if(rate <= Scalar(0.) && time.back() > time.front()) //Recorded every simulation step
+        rate = Scalar(time.size() - 1)/(time.back() - time.front());
+    
+    fprintf(fp, "#Measurements from %s\n", info.name.c_str());
+    fprintf(fp, "#Number of channels: %lu\n", (unsigned long)info.channels.size());
+    fprintf(fp, "#Number of samples: %lu\n", (unsigned long)time.size());
+    fprintf(fp, "#Frequency: %1.3lf Hz\n", rate);
+    fprintf(fp, "#Unit system: SI\n\n");
+    
+    //Write data header
+    if(includeTime)
+        fprintf(fp, "#Time\t");
+    else
+        fprintf(fp, "#");
+    
+    for(unsigned int i = 0; i < info.channels.size(); i++)
+    {
+        fprintf(fp, "%s", info.channels[i].c_str());
+        
+        if(i < info.channels.size() - 1)
+            fprintf(fp, "\t");
+        else
+            fprintf(fp, "\n");
+    }
+    
+    //Write data
+    std::string format = "%1." + std::to_string(fixedPrecision) + "lf";
+    
+    for(unsigned int i = 0; i < time.size(); i++)
+    {
+        if(includeTime)
+        {
+            fprintf(fp, format.c_str(), time[i]);
+            fprintf(fp, "\t");
+        }
+        
+        for(unsigned int h = 0; h < info.channels.size(); h++)
+        {
+            fprintf(fp, format.c_str(), values[h][i]);
+            
+            if(h < info.channels.size() - 1)
+                fprintf(fp, "\t");
+            else
+                fprintf(fp, "\n");
+        }
+    }
+    
+    fclose(fp);
+    return true;
+}
+
+bool RecordingReader::SaveToOctaveFile(const std::string& path, bool includeTime)
+{
+    if(!valid)
+        return false;
+    
+    //build data structure
+    ScientificData data("");
+    
+    for(unsigned int i = 0; i < streams.size(); ++i)
+    {
+        std::vector<Scalar> time;
+        std::vector<std::vector<Scalar>> values;
+        if(!ReadStream(i, -BT_LARGE_FLOAT, BT_LARGE_FLOAT, time, values) || time.size() == 0)
+            continue;
+        
+        ScientificDataItem* it = new ScientificDataItem();
+        it->name = streams[i].name;
+        it->type = DATA_MATRIX;
+        
+        unsigned int offset = includeTime ? 1 : 0;
+        btMatrixXu* matrix = new btMatrixXu((unsigned int)time.size(), (unsigned int)values.size() + offset);
+        it->value = matrix;
+        
+        for(unsigned int h = 0; h < time.size(); ++h)
+        {
+            if(includeTime)
+                matrix->setElem(h, 0, time[h]);
+            
+            for(unsigned int c = 0; c < values.size(); ++c)
+                matrix->setElem(h, c + offset, values[c][h]);
+        }
+        
+        data.addItem(it);
+    }
+    
+    //save data structure to file
+    return SaveOctaveData(path, data);
+}
+
+bool RecordingReader::isValid()
+{
+    return valid;
+}
+
+bool RecordingReader::isComplete()
+{
+    return complete;
+}
+
+unsigned int RecordingReader::getNumOfStreams()
+{
+    return (unsigned int)streams.size();
+}
+
+int RecordingReader::getStreamId(const std::string& name)
+{
+    for(size_t i = 0; i < streams.size(); ++i)
+        if(streams[i].name == name)
+            return (int)i;
+    return -1;
+}
+
+std::string RecordingReader::getStreamName(unsigned int streamId)
+{
+    if(streamId < streams.size())
+        return streams[streamId].name;
+    else
+        return std::string("");
+}
+
+std::vector<std::string> RecordingReader::getChannelNames(unsigned int streamId)
+{
+    if(streamId < streams.size())
+        return streams[streamId].channels;
+    else
+        return std::vector<std::string>(0);
+}
+
+}
@@ -174,12 +174,12 @@ void ResearchConstraintSolver::createMLCPFast(const btContactSolverInfo& infoGlo
         jointNodeArray.reserve(2*m_allConstraintPtrArray.size());
     }
     
-    static btMatrixXu J3;
+    static thread_local btMatrixXu J3;
     {
         BT_PROFILE("J3.resize");
         J3.resize(2*m,8);
     }
-    static btMatrixXu JinvM3;
+    static thread_local btMatrixXu JinvM3;
     {
         BT_PROFILE("JinvM3.resize/setZero");
         
@@ -189,7 +189,7 @@ void ResearchConstraintSolver::createMLCPFast(const btContactSolverInfo& infoGlo
     }
     int cur=0;
     int rowOffset = 0;
-    static btAlignedObjectArray<int> ofs;
+    static thread_local btAlignedObjectArray<int> ofs;
     {
         BT_PROFILE("ofs resize");
         ofs.resize(0);
@@ -449,7 +449,7 @@ void ResearchConstraintSolver::createMLCP(const btContactSolverInfo& infoGlobal)
         }
     }
     
-    static btMatrixXu Minv;
+    static thread_local btMatrixXu Minv;
     Minv.resize(6*numBodies,6*numBodies);
     Minv.setZero();
     for (int i=0;i<numBodies;i++)
@@ -466,7 +466,7 @@ void ResearchConstraintSolver::createMLCP(const btContactSolverInfo& infoGlobal)
                 setElem(Minv,i*6+3+r,i*6+3+c,orgBody? orgBody->getInvInertiaTensorWorld()[r][c] : 0);
     }
     
-    static btMatrixXu J;
+    static thread_local btMatrixXu J;
     J.resize(numConstraintRows,6*numBodies);
     J.setZero();
     
@@ -501,10 +501,10 @@ void ResearchConstraintSolver::createMLCP(const btContactSolverInfo& infoGlobal)
         }
     }
     
-    static btMatrixXu J_transpose;
+    static thread_local btMatrixXu J_transpose;
     J_transpose= J.transpose();
     
-    static btMatrixXu tmp;
+    static thread_local btMatrixXu tmp;
     
     {
         {
@@ -42,7 +42,7 @@ namespace sf
 
 Robot::Robot(std::string uniqueName, bool fixedBase)
 {
-    name = SimulationApp::getApp()->getSimulationManager()->getNameManager()->AddName(uniqueName);
+    name = SimulationManager::getCurrent()->getNameManager()->AddName(uniqueName);
     dynamics = NULL;
     fixed = fixedBase;
 }
@@ -50,7 +50,7 @@ Robot::Robot(std::string uniqueName, bool fixedBase)
 Robot::~Robot()
 {
     if(SimulationApp::getApp() != NULL)
-        SimulationApp::getApp()->getSimulationManager()->getNameManager()->RemoveName(name);
+        SimulationManager::getCurrent()->getNameManager()->RemoveName(name);
 }
 
 std::string Robot::getName()
@@ -87,13 +87,8 @@ void Robot::getFreeLinkPair(const std::string& parentName, const std::string& ch
 
 SolidEntity* Robot::getLink(const std::string& name)
 {
-    for(size_t i=0; i<links.size(); ++i)
-        if(links[i]->getName() == name) return links[i];
-    
-    for(size_t i=0; i<detachedLinks.size(); ++i)
-        if(detachedLinks[i]->getName() == name) return detachedLinks[i];
-    
-    return NULL;
+    std::unordered_map<std::string, SolidEntity*>::const_iterator it = linksByName.find(name);
+    return it != linksByName.end() ? it->second : NULL;
 }
 
 int Robot::getJoint(const std::string& name)
@@ -109,11 +104,8 @@ int Robot::getJoint(const std::string& name)
     
 Actuator* Robot::getActuator(std::string name)
 {
-    for(size_t i=0; i<actuators.size(); ++i)
-        if(actuators[i]->getName() == name)
-            return actuators[i];
-
-    return NULL;
+    std::unordered_map<std::string, Actuator*>::const_iterator it = actuatorsByName.find(name);
+    return it != actuatorsByName.end() ? it->second : NULL;
 }
 
 Actuator* Robot::getActuator(unsigned int index)
@@ -126,11 +118,8 @@ Actuator* Robot::getActuator(unsigned int index)
     
 Sensor* Robot::getSensor(std::string name)
 {
-    for(size_t i=0; i<sensors.size(); ++i)
-        if(sensors[i]->getName() == name)
-            return sensors[i];
-    
-    return NULL;
+    std::unordered_map<std::string, Sensor*>::const_iterator it = sensorsByName.find(name);
+    return it != sensorsByName.end() ? it->second : NULL;
 }
 
 Sensor* Robot::getSensor(unsigned int index)
@@ -143,11 +132,8 @@ Sensor* Robot::getSensor(unsigned int index)
 
 Comm* Robot::getComm(std::string name)
 {
-    for(size_t i=0; i<comms.size(); ++i)
-        if(comms[i]->getName() == name)
-            return comms[i];
-    
-    return NULL;
+    std::unordered_map<std::string, Comm*>::const_iterator it = commsByName.find(name);
+    return it != commsByName.end() ? it->second : NULL;
 }
 
 Comm* Robot::getComm(unsigned int index)
@@ -178,6 +164,9 @@ void Robot::DefineLinks(SolidEntity* baseLink, std::vector<SolidEntity*> otherLi
     
     links.push_back(baseLink);
     detachedLinks = otherLinks;
+    linksByName[baseLink->getName()] = baseLink;
+    for(size_t i=0; i<otherLinks.size(); ++i)
+        linksByName[otherLinks[i]->getName()] = otherLinks[i];
     dynamics = new FeatherstoneEntity(name + "_Dynamics", (unsigned short)detachedLinks.size() + 1, baseLink, fixed);
     dynamics->setSelfCollision(selfCollision);
 }
@@ -327,6 +316,7 @@ void Robot::AddLinkSensor(LinkSensor* s, const std::string& monitoredLinkName, c
     {
         s->AttachToSolid(link, origin);
         sensors.push_back(s);
+        sensorsByName[s->getName()] = s;
     }
     else
         cCritical("Link '%s' doesn't exist. Sensor '%s' cannot be attached!", monitoredLinkName.c_str(), s->getName().c_str());
@@ -339,6 +329,7 @@ void Robot::AddJointSensor(JointSensor* s, const std::string& monitoredJointName
     {
         s->AttachToJoint(dynamics, jointId);
         sensors.push_back(s);
+        sensorsByName[s->getName()] = s;
     }
     else
         cCritical("Joint '%s' doesn't exist. Sensor '%s' cannot be attached!", monitoredJointName.c_str(), s->getName().c_str());
@@ -351,6 +342,7 @@ void Robot::AddVisionSensor(VisionSensor* s, const std::string& attachmentLinkNa
     {
         s->AttachToSolid(link, origin);
         sensors.push_back(s);
+        sensorsByName[s->getName()] = s;
     }
     else
         cCritical("Link '%s' doesn't exist. Sensor '%s' cannot be attached!", attachmentLinkName.c_str(), s->getName().c_str());
@@ -363,6 +355,7 @@ void Robot::AddLinkActuator(LinkActuator* a, const std::string& actuatedLinkName
     {
         a->AttachToSolid(link, origin);
         actuators.push_back(a);
+        actuatorsByName[a->getName()] = a;
     }
     else
         cCritical("Link '%s' doesn't exist. Actuator '%s' cannot be attached!", actuatedLinkName.c_str(), a->getName().c_str());
@@ -375,6 +368,7 @@ void Robot::AddJointActuator(JointActuator* a, const std::string& actuatedJointN
     {
         a->AttachToJoint(dynamics, jointId);
         actuators.push_back(a);
+        actuatorsByName[a->getName()] = a;
     }
     else
         cCritical("Joint '%s' doesn't exist. Actuator '%s' cannot be attached!", actuatedJointName.c_str(), a->getName().c_str());
@@ -387,6 +381,7 @@ void Robot::AddComm(Comm* c, const std::string& attachmentLinkName, const Transf
     {
         c->AttachToSolid(link, origin);
         comms.push_back(c);
+        commsByName[c->getName()] = c;
     }
     else
         cCritical("Link '%s' doesn't exist. Communication device '%s' cannot be attached!", attachmentLinkName.c_str(), c->getName().c_str());
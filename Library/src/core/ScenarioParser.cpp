@@ -43,6 +43,7 @@
 #include "entities/solids/Compound.h"
 #include "entities/forcefields/Uniform.h"
 #include "entities/forcefields/Jet.h"
+#include "entities/forcefields/Gridded.h"
 #include "sensors/scalar/IMU.h"
 #include "sensors/scalar/DVL.h"
 #include "sensors/scalar/GPS.h"
@@ -451,6 +452,25 @@ bool ScenarioParser::ParseEnvironment(XMLElement* element)
                     Vector3 dir = velocity.normalized();
                     ocn->AddVelocityField(new Jet(Vector3(cx, cy, cz), dir, radius, velocity.norm()));
                 }
+                else if(currentTypeStr == "gridded")
+                {
+                    const char* file;
+                    bool loop = false;
+                    
+                    if((item2 = item->FirstChildElement("data")) == nullptr)
+                        return false;
+                    if(item2->QueryStringAttribute("file", &file) != XML_SUCCESS)
+                        return false;
+                    item2->QueryAttribute("loop", &loop);
+                    
+                    Gridded* field = new Gridded(GetFullPath(std::string(file)), loop);
+                    if(!field->isValid())
+                    {
+                        delete field;
+                        return false;
+                    }
+                    ocn->AddVelocityField(field);
+                }
             }
             while((item = item->NextSiblingElement("current")) != nullptr);
         }
@@ -528,6 +548,25 @@ bool ScenarioParser::ParseEnvironment(XMLElement* element)
                     Vector3 dir = velocity.normalized();
                     atm->AddVelocityField(new Jet(Vector3(cx, cy, cz), dir, radius, velocity.norm()));
                 }
+                else if(windTypeStr == "gridded")
+                {
+                    const char* file;
+                    bool loop = false;
+                    
+                    if((item2 = item->FirstChildElement("data")) == nullptr)
+                        return false;
+                    if(item2->QueryStringAttribute("file", &file) != XML_SUCCESS)
+                        return false;
+                    item2->QueryAttribute("loop", &loop);
+                    
+                    Gridded* field = new Gridded(GetFullPath(std::string(file)), loop);
+                    if(!field->isValid())
+                    {
+                        delete field;
+                        return false;
+                    }
+                    atm->AddVelocityField(field);
+                }
             }
             while((item = item->NextSiblingElement("wind")) != nullptr);
         }
@@ -1012,6 +1051,9 @@ bool ScenarioParser::ParseSolid(XMLElement* element, SolidEntity*& solid, std::s
         if((item2 = item->FirstChildElement("compound_transform")) == nullptr || !ParseTransform(item2, partOrigin))
             return false;
         comp = new Compound(solidName, part, partOrigin, ePhyType);
+        bool merged;
+        if(element->QueryAttribute("merged_hydrodynamics", &merged) == XML_SUCCESS)
+            comp->setMergedHydrodynamicMesh(merged);
         
         //Iterate through all external parts
         item = item->NextSiblingElement("external_part");
@@ -1186,6 +1228,7 @@ bool ScenarioParser::ParseSolid(XMLElement* element, SolidEntity*& solid, std::s
             Scalar phyScale;
             Transform phyOrigin;
             Scalar thickness;
+            MeshDecimation decimation;
         
             if((item = element->FirstChildElement("physical")) == nullptr)
                 return false;
@@ -1205,6 +1248,26 @@ bool ScenarioParser::ParseSolid(XMLElement* element, SolidEntity*& solid, std::s
                 thickness = Scalar(-1);
             if((item2 = item->FirstChildElement("origin")) == nullptr || !ParseTransform(item2, phyOrigin))
                 return false;
+            if((item2 = item->FirstChildElement("decimation")) != nullptr)
+            {
+                const char* quality = nullptr;
+                if(item2->QueryStringAttribute("quality", &quality) == XML_SUCCESS)
+                {
+                    std::string qualityStr(quality);
+                    if(qualityStr == "original")
+                        decimation = MeshDecimation(MeshQuality::ORIGINAL);
+                    else if(qualityStr == "high")
+                        decimation = MeshDecimation(MeshQuality::HIGH);
+                    else if(qualityStr == "medium")
+                        decimation = MeshDecimation(MeshQuality::MEDIUM);
+                    else if(qualityStr == "low")
+                        decimation = MeshDecimation(MeshQuality::LOW);
+                    else
+                        return false;
+                }
+                item2->QueryAttribute("faces", &decimation.faces); //Overrides quality level
+                item2->QueryAttribute("error", &decimation.error);
+            }
         
             if((item = element->FirstChildElement("visual")) != nullptr)
             {
@@ -1221,11 +1284,11 @@ bool ScenarioParser::ParseSolid(XMLElement* element, SolidEntity*& solid, std::s
                 if((item = item->NextSiblingElement("origin")) == nullptr || !ParseTransform(item, graOrigin))
                     return false;
           
-                solid = new Polyhedron(solidName, GetFullPath(std::string(graMesh)), graScale, graOrigin, GetFullPath(std::string(phyMesh)), phyScale, phyOrigin, std::string(mat), ePhyType, std::string(look), thickness, buoyant); 
+                solid = new Polyhedron(solidName, GetFullPath(std::string(graMesh)), graScale, graOrigin, GetFullPath(std::string(phyMesh)), phyScale, phyOrigin, std::string(mat), ePhyType, std::string(look), thickness, buoyant, GeometryApproxType::AUTO, decimation); 
             }
             else
             {
-                solid = new Polyhedron(solidName, GetFullPath(std::string(phyMesh)), phyScale, phyOrigin, std::string(mat), ePhyType, std::string(look), thickness, buoyant); 
+                solid = new Polyhedron(solidName, GetFullPath(std::string(phyMesh)), phyScale, phyOrigin, std::string(mat), ePhyType, std::string(look), thickness, buoyant, GeometryApproxType::AUTO, decimation); 
             }
         }
         else
@@ -1243,6 +1306,68 @@ bool ScenarioParser::ParseSolid(XMLElement* element, SolidEntity*& solid, std::s
         }
     }
 
+    //Hydrodynamic model
+    if((item = element->FirstChildElement("hydrodynamics")) != nullptr)
+    {
+        const char* model = nullptr;
+        const char* trans = nullptr;
+        const char* rot = nullptr;
+        Scalar x1, y1, z1, x2, y2, z2;
+        XMLElement* item2;
+        
+        if(item->QueryStringAttribute("model", &model) == XML_SUCCESS)
+        {
+            std::string modelStr(model);
+            if(modelStr == "geometry")
+                solid->setHydrodynamicsModel(HydrodynamicsModel::GEOMETRY);
+            else if(modelStr == "lumped")
+                solid->setHydrodynamicsModel(HydrodynamicsModel::LUMPED);
+            else
+                return false;
+        }
+        
+        if((item2 = item->FirstChildElement("added_mass")) != nullptr)
+        {
+            if(item2->QueryStringAttribute("translation", &trans) != XML_SUCCESS
+               || item2->QueryStringAttribute("rotation", &rot) != XML_SUCCESS
+               || sscanf(trans, "%lf %lf %lf", &x1, &y1, &z1) != 3
+               || sscanf(rot, "%lf %lf %lf", &x2, &y2, &z2) != 3)
+                return false;
+            solid->setAddedMass(Vector3(x1, y1, z1), Vector3(x2, y2, z2));
+        }
+        
+        //Damping coefficients are derived from the geometry unless given
+        LumpedHydrodynamics coeffs;
+        bool damping = false;
+        
+        if((item2 = item->FirstChildElement("linear_damping")) != nullptr)
+        {
+            if(item2->QueryStringAttribute("translation", &trans) != XML_SUCCESS
+               || item2->QueryStringAttribute("rotation", &rot) != XML_SUCCESS
+               || sscanf(trans, "%lf %lf %lf", &x1, &y1, &z1) != 3
+               || sscanf(rot, "%lf %lf %lf", &x2, &y2, &z2) != 3)
+                return false;
+            coeffs.linearDampingF = Vector3(x1, y1, z1);
+            coeffs.linearDampingT = Vector3(x2, y2, z2);
+            damping = true;
+        }
+        
+        if((item2 = item->FirstChildElement("quadratic_damping")) != nullptr)
+        {
+            if(item2->QueryStringAttribute("translation", &trans) != XML_SUCCESS
+               || item2->QueryStringAttribute("rotation", &rot) != XML_SUCCESS
+               || sscanf(trans, "%lf %lf %lf", &x1, &y1, &z1) != 3
+               || sscanf(rot, "%lf %lf %lf", &x2, &y2, &z2) != 3)
+                return false;
+            coeffs.quadraticDampingF = Vector3(x1, y1, z1);
+            coeffs.quadraticDampingT = Vector3(x2, y2, z2);
+            damping = true;
+        }
+        
+        if(damping)
+            solid->setLumpedHydrodynamics(coeffs);
+    }
+    
     //Contact properties (soft contact)
     if(!compoundPart)
     {
@@ -0,0 +1,399 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  SharedMemoryTransport.cpp
+//  Stonefish
+//
+
+#include "core/SharedMemoryTransport.h"
+
+#include <cstring>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "core/Console.h"
+#include "sensors/ScalarSensor.h"
+#include "sensors/Sample.h"
+#include "sensors/vision/Camera.h"
+#include "actuators/Thruster.h"
+#include "actuators/Propeller.h"
+#include "actuators/Servo.h"
+#include "actuators/Motor.h"
+#include "actuators/VariableBuoyancy.h"
+
+#define SHM_ALIGN(x) (((x) + SHM_ALIGNMENT - 1) / SHM_ALIGNMENT * SHM_ALIGNMENT)
+#define SHM_HEADER_SIZE SHM_ALIGN(sizeof(SharedMemoryStreamHeader))
+#define SHM_SLOT_HEADER_SIZE SHM_ALIGN(sizeof(SharedMemorySlot))
+
+namespace sf
+{
+
+SharedMemoryTransport::Segment::~Segment()
+{
+#ifndef _WIN32
+    if(memory != NULL)
+    {
+        munmap(memory, size);
+        shm_unlink(name.c_str());
+    }
+#endif
+}
+
+SharedMemoryTransport::SharedMemoryTransport(const std::string& name, unsigned int slots)
+{
+    this->name = name;
+    nSlots = slots < 2 ? 2 : slots;
+    manifest = nullptr;
+#ifdef _WIN32
+    cError("Shared memory transport is not supported on this platform!");
+#endif
+}
+
+SharedMemoryTransport::~SharedMemoryTransport()
+{
+    //Segments of vision sensors are unmapped when the frame listeners are destroyed
+    segments.clear();
+    manifest = nullptr;
+}
+
+std::string SharedMemoryTransport::getName()
+{
+    return name;
+}
+
+std::shared_ptr<SharedMemoryTransport::Segment> SharedMemoryTransport::CreateSegment(const std::string& objectName, size_t size)
+{
+#ifdef _WIN32
+    return nullptr;
+#else
+    std::string segName = objectName;
+    for(size_t i=0; i<segName.size(); ++i)
+        if(segName[i] == '/')
+            segName[i] = '.';
+    segName = "/" + name + "." + segName;
+    
+    shm_unlink(segName.c_str()); //Remove leftovers of a previous run
+    int fd = shm_open(segName.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
+    if(fd < 0)
+    {
+        cError("Shared memory segment '%s' could not be created!", segName.c_str());
+        return nullptr;
+    }
+    
+    if(ftruncate(fd, (off_t)size) != 0)
+    {
+        cError("Shared memory segment '%s' could not be resized!", segName.c_str());
+        close(fd);
+        shm_unlink(segName.c_str());
+        return nullptr;
+    }
+    
+    void* memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(memory == MAP_FAILED)
+    {
+        cError("Shared memory segment '%s' could not be mapped!", segName.c_str());
+        shm_unlink(segName.c_str());
+        return nullptr;
+    }
+    
+    memset(memory, 0, size);
+    std::shared_ptr<Segment> seg = std::make_shared<Segment>();
+    seg->name = segName;
+    seg->memory = memory;
+    seg->size = size;
+    seg->sensor = NULL;
+    seg->actuator = NULL;
+    seg->frames = 0;
+    seg->lastSeq = 0;
+    seg->lastTime = Scalar(-1);
+    return seg;
+#endif
+}
+
+std::shared_ptr<SharedMemoryTransport::Segment> SharedMemoryTransport::CreateStream(const std::string& objectName, unsigned int width, unsigned int height,
+                                                                                    unsigned int channels, unsigned int bytesPerChannel)
+{
+    size_t slotSize = SHM_SLOT_HEADER_SIZE + SHM_ALIGN((size_t)width * height * channels * bytesPerChannel);
+    std::shared_ptr<Segment> seg = CreateSegment(objectName, SHM_HEADER_SIZE + slotSize * nSlots);
+    if(seg == nullptr)
+        return nullptr;
+    
+    SharedMemoryStreamHeader* header = (SharedMemoryStreamHeader*)seg->memory;
+    header->magic = SHM_STREAM_MAGIC;
+    header->version = SHM_VERSION;
+    header->slots = nSlots;
+    header->slotSize = (uint32_t)slotSize;
+    header->width = width;
+    header->height = height;
+    header->channels = channels;
+    header->bytesPerChannel = bytesPerChannel;
+    header->frames.store(0, std::memory_order_release);
+    
+    std::string format = bytesPerChannel == 1 ? "uint8" : (bytesPerChannel == 4 ? "float32" : "float64");
+    seg->layout = "{\"object\": \"" + objectName + "\", \"segment\": \"" + seg->name + "\", \"width\": " + std::to_string(width)
+                  + ", \"height\": " + std::to_string(height) + ", \"channels\": " + std::to_string(channels) + ", \"format\": \"" + format + "\"";
+    return seg;
+}
+
+bool SharedMemoryTransport::AddSensor(Sensor* sens)
+{
+    if(sens == NULL)
+        return false;
+    
+    std::shared_ptr<Segment> seg = nullptr;
+    
+    if(ScalarSensor* ssens = dynamic_cast<ScalarSensor*>(sens))
+    {
+        unsigned int nChannels = ssens->getNumOfChannels();
+        seg = CreateStream(sens->getName(), nChannels, 1, 1, sizeof(double));
+        if(seg == nullptr)
+            return false;
+        
+        seg->sensor = ssens;
+        seg->layout += ", \"fields\": [";
+        for(unsigned int i=0; i<nChannels; ++i)
+            seg->layout += "\"" + ssens->getSensorChannelDescription(i).name + "\"" + (i < nChannels-1 ? ", " : "");
+        seg->layout += "]}";
+    }
+    else if(Camera* cam = dynamic_cast<Camera*>(sens))
+    {
+        unsigned int width, height;
+        cam->getResolution(width, height);
+        
+        switch(cam->getVisionSensorType())
+        {
+            case VisionSensorType::COLOR_CAMERA:
+                seg = CreateStream(sens->getName(), width, height, 3, 1);
+                break;
+            
+            case VisionSensorType::DEPTH_CAMERA:
+            case VisionSensorType::MULTIBEAM2:
+                seg = CreateStream(sens->getName(), width, height, 1, sizeof(float));
+                break;
+            
+            case VisionSensorType::FLS:
+            case VisionSensorType::SSS:
+            case VisionSensorType::MSIS:
+                seg = CreateStream(sens->getName(), width, height, 1, 1);
+                break;
+        }
+        
+        if(seg == nullptr)
+            return false;
+        
+        seg->layout += "}";
+        
+        //Frames are copied to the ring directly from the sensor buffer, on the thread producing them
+        std::shared_ptr<Segment> frameSeg = seg;
+        cam->AddFrameListener([frameSeg](VisionSensor* vs, const VisionSensorFrame& frame)
+        {
+            WriteFrame(frameSeg.get(), frame.data, frame.getDataSize(), frame.timestamp);
+        });
+    }
+    else
+    {
+        cError("Sensor '%s' can not be published in shared memory!", sens->getName().c_str());
+        return false;
+    }
+    
+    segments.push_back(seg);
+    WriteManifest();
+    return true;
+}
+
+bool SharedMemoryTransport::AddActuator(Actuator* act)
+{
+    if(act == NULL)
+        return false;
+    
+    std::string fields;
+    switch(act->getType())
+    {
+        case ActuatorType::THRUSTER:
+        case ActuatorType::PROPELLER:
+            fields = "\"setpoint\"";
+            break;
+        
+        case ActuatorType::SERVO:
+            fields = "\"mode\", \"value\"";
+            break;
+        
+        case ActuatorType::MOTOR:
+            fields = "\"torque\"";
+            break;
+        
+        case ActuatorType::VBS:
+            fields = "\"flow_rate\"";
+            break;
+        
+        default:
+            cError("Actuator '%s' can not be controlled through shared memory!", act->getName().c_str());
+            return false;
+    }
+    
+    std::shared_ptr<Segment> seg = CreateSegment(act->getName(), SHM_ALIGN(sizeof(SharedMemoryCommand)));
+    if(seg == nullptr)
+        return false;
+    
+    SharedMemoryCommand* cmd = (SharedMemoryCommand*)seg->memory;
+    cmd->magic = SHM_COMMAND_MAGIC;
+    cmd->version = SHM_VERSION;
+    cmd->nValues = act->getType() == ActuatorType::SERVO ? 2 : 1;
+    cmd->seq.store(0, std::memory_order_release);
+    
+    seg->actuator = act;
+    seg->layout = "{\"object\": \"" + act->getName() + "\", \"segment\": \"" + seg->name + "\", \"fields\": [" + fields + "]}";
+    segments.push_back(seg);
+    WriteManifest();
+    return true;
+}
+
+void SharedMemoryTransport::WriteManifest()
+{
+    std::string streams;
+    std::string commands;
+    
+    for(size_t i=0; i<segments.size(); ++i)
+    {
+        std::string& list = segments[i]->actuator != NULL ? commands : streams;
+        list += (list.size() > 0 ? ",\n    " : "\n    ") + segments[i]->layout;
+    }
+    
+    std::string json = "{\n  \"version\": " + std::to_string(SHM_VERSION) + ",\n  \"slots\": " + std::to_string(nSlots)
+                       + ",\n  \"streams\": [" + streams + "\n  ],\n  \"commands\": [" + commands + "\n  ]\n}\n";
+    
+    //Manifest is recreated to fit the new content (readers should map it again when the number of segments changes)
+    manifest = nullptr;
+    manifest = CreateSegment("manifest", json.size() + 1);
+    if(manifest != nullptr)
+        memcpy(manifest->memory, json.c_str(), json.size());
+}
+
+void SharedMemoryTransport::WriteFrame(Segment* seg, const void* data, size_t size, Scalar time)
+{
+    SharedMemoryStreamHeader* header = (SharedMemoryStreamHeader*)seg->memory;
+    if(size > header->slotSize - SHM_SLOT_HEADER_SIZE)
+        return;
+    
+    uint64_t frame = seg->frames++;
+    uint8_t* slotPtr = (uint8_t*)seg->memory + SHM_HEADER_SIZE + (size_t)(frame % header->slots) * header->slotSize;
+    SharedMemorySlot* slot = (SharedMemorySlot*)slotPtr;
+    
+    slot->seq.store(2 * frame + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->timestamp = (double)time;
+    memcpy(slotPtr + SHM_SLOT_HEADER_SIZE, data, size);
+    slot->seq.store(2 * frame + 2, std::memory_order_release);
+    header->frames.store(frame + 1, std::memory_order_release);
+}
+
+void SharedMemoryTransport::ApplyCommand(Actuator* act, const double* values)
+{
+    switch(act->getType())
+    {
+        case ActuatorType::THRUSTER:
+            ((Thruster*)act)->setSetpoint(values[0]);
+            break;
+        
+        case ActuatorType::PROPELLER:
+            ((Propeller*)act)->setSetpoint(values[0]);
+            break;
+        
+        case ActuatorType::SERVO:
+        {
+            Servo* srv = (Servo*)act;
+            switch((int)values[0])
+            {
+                case POSITION_CTRL:
+                    srv->setControlMode(POSITION_CTRL);
+                    srv->setDesiredPosition(values[1]);
+                    break;
+                
+                case VELOCITY_CTRL:
+                    srv->setControlMode(VELOCITY_CTRL);
+                    srv->setDesiredVelocity(values[1]);
+                    break;
+                
+                case TORQUE_CTRL:
+                    srv->setControlMode(TORQUE_CTRL);
+                    srv->setDesiredTorque(values[1]);
+                    break;
+                
+                default:
+                    break;
+            }
+        }
+            break;
+        
+        case ActuatorType::MOTOR:
+            ((Motor*)act)->setIntensity(values[0]);
+            break;
+        
+        case ActuatorType::VBS:
+            ((VariableBuoyancy*)act)->setFlowRate(values[0]);
+            break;
+        
+        default:
+            break;
+    }
+}
+
+void SharedMemoryTransport::Update()
+{
+    std::vector<double> values;
+    
+    for(size_t i=0; i<segments.size(); ++i)
+    {
+        Segment* seg = segments[i].get();
+        
+        if(seg->sensor != NULL) //Publish the newest sample
+        {
+            Sample s = seg->sensor->getLastSample();
+            if(s.getTimestamp() <= seg->lastTime)
+                continue;
+            seg->lastTime = s.getTimestamp();
+            
+            values.resize(s.getNumOfDimensions());
+            for(unsigned short h=0; h<s.getNumOfDimensions(); ++h)
+                values[h] = (double)s.getValue(h);
+            WriteFrame(seg, values.data(), values.size() * sizeof(double), s.getTimestamp());
+        }
+        else if(seg->actuator != NULL) //Apply the newest command
+        {
+            SharedMemoryCommand* cmd = (SharedMemoryCommand*)seg->memory;
+            uint64_t seq = cmd->seq.load(std::memory_order_acquire);
+            if(seq == seg->lastSeq || (seq & 1))
+                continue;
+            
+            double cmdValues[4];
+            memcpy(cmdValues, cmd->values, sizeof(cmdValues));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if(cmd->seq.load(std::memory_order_relaxed) != seq) //Writer was active during the copy
+                continue;
+            
+            seg->lastSeq = seq;
+            ApplyCommand(seg->actuator, cmdValues);
+        }
+    }
+}
+
+}
@@ -42,6 +42,8 @@
 #include "core/ResearchConstraintSolver.h"
 #include "core/Console.h"
 #include "core/NED.h"
+#include "core/Recorder.h"
+#include "core/SharedMemoryTransport.h"
 #include "graphics/OpenGLState.h"
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
@@ -62,6 +64,7 @@
 #include "actuators/Light.h"
 #include "sensors/Sensor.h"
 #include "comms/Comm.h"
+#include "comms/AcousticModem.h"
 #include "sensors/Contact.h"
 #include "sensors/VisionSensor.h"
 
@@ -72,6 +75,8 @@ extern ContactDestroyedCallback gContactDestroyedCallback;
 namespace sf
 {
 
+thread_local SimulationManager* SimulationManager::current = NULL;
+
 SimulationManager::SimulationManager(Scalar stepsPerSecond, SolverType st, CollisionFilteringType cft)
 {
     //Initialize simulation world
@@ -79,11 +84,27 @@ SimulationManager::SimulationManager(Scalar stepsPerSecond, SolverType st, Colli
     cpuUsage = Scalar(0);
     solver = st;
     collisionFilter = cft;
-    fdCounter = 0;
+    fdTolerances.linearVelocity = Scalar(0.01);
+    fdTolerances.angularVelocity = Scalar(0.01);
+    fdTolerances.submergence = Scalar(0.01);
+    fdTolerances.orientation = Scalar(0.5)/Scalar(180) * M_PI;
+    fdTolerances.maxAge = Scalar(0.1);
+    slpSettings.enabled = false;
+    slpSettings.linearVelocity = Scalar(0.01);
+    slpSettings.angularVelocity = Scalar(0.01);
+    slpSettings.settleTime = Scalar(2);
+    slpSettings.fluidVelocity = Scalar(0.01);
+    slpSettings.depth = Scalar(0.01);
+    fluidCandidatesWorldSize = -1;
+    fluidCandidatesProxyId = -1;
+    fluidCandidatesGeneration = 0;
     currentTime = 0;
     physicsTime = 0;
     simulationTime = 0;
     mlcpFallbacks = 0;
+    tickProfiling = false;
+    tickProfileMark = 0;
+    tickProfile = TickProfile();
     dynamicsWorld = NULL;
     dwSolver = NULL;
     dwBroadphase = NULL;
@@ -92,6 +113,9 @@ SimulationManager::SimulationManager(Scalar stepsPerSecond, SolverType st, Colli
     ocean = NULL;
     atmosphere = NULL;
     trackball = NULL;
+    recorder = NULL;
+    shmTransport = NULL;
+    sensorScheduleValid = false;
     sdm = DisplayMode::GRAPHICAL;
     simHydroMutex = SDL_CreateMutex();
     simSettingsMutex = SDL_CreateMutex();
@@ -107,6 +131,7 @@ SimulationManager::SimulationManager(Scalar stepsPerSecond, SolverType st, Colli
     nameManager = new NameManager();
     materialManager = new MaterialManager();
     ned = new NED();
+    acousticNetwork = new AcousticNetwork();
 }
 
 SimulationManager::~SimulationManager()
@@ -119,6 +144,25 @@ SimulationManager::~SimulationManager()
     delete materialManager;
     delete nameManager;
     delete ned;
+    delete acousticNetwork;
+    
+    if(current == this)
+        current = NULL;
+}
+
+void SimulationManager::MakeCurrent()
+{
+    current = this;
+}
+
+SimulationManager* SimulationManager::getCurrent()
+{
+    if(current != NULL)
+        return current;
+    else if(SimulationApp::getApp() != NULL)
+        return SimulationApp::getApp()->getSimulationManager();
+    else
+        return NULL;
 }
 
 bool SimulationManager::LoadSDF(const std::string& path)
@@ -132,6 +176,7 @@ void SimulationManager::AddRobot(Robot* robot, const Transform& worldTransform)
 {
     if(robot != NULL)
     {
+        robotIds[robot->getName()] = (unsigned int)robots.size();
         robots.push_back(robot);
         robot->AddToSimulation(this, worldTransform);
     }
@@ -141,6 +186,7 @@ void SimulationManager::AddEntity(Entity *ent)
 {
     if(ent != NULL)
     {
+        entityIds[ent->getName()] = (unsigned int)entities.size();
         entities.push_back(ent);
         ent->AddToSimulation(this);
     }
@@ -150,6 +196,7 @@ void SimulationManager::AddStaticEntity(StaticEntity* ent, const Transform& orig
 {
     if(ent != NULL)
     {
+        entityIds[ent->getName()] = (unsigned int)entities.size();
         entities.push_back(ent);
         ent->AddToSimulation(this, origin);
     }
@@ -159,6 +206,7 @@ void SimulationManager::AddAnimatedEntity(AnimatedEntity* ent)
 {
     if(ent != NULL)
     {
+        entityIds[ent->getName()] = (unsigned int)entities.size();
         entities.push_back(ent);
         ent->AddToSimulation(this);
     }
@@ -168,6 +216,7 @@ void SimulationManager::AddSolidEntity(SolidEntity* ent, const Transform& origin
 {
     if(ent != NULL)
     {
+        entityIds[ent->getName()] = (unsigned int)entities.size();
         entities.push_back(ent);
         ent->AddToSimulation(this, origin);
     }
@@ -177,6 +226,7 @@ void SimulationManager::AddSolidEntity(SolidEntity* ent, const Transform& origin
  {
      if(ent != NULL)
      {
+         entityIds[ent->getName()] = (unsigned int)entities.size();
          entities.push_back(ent);
          ent->AddToSimulation(this, origin);
      }
@@ -224,19 +274,41 @@ void SimulationManager::EnableAtmosphere()
 void SimulationManager::AddSensor(Sensor* sens)
 {
     if(sens != NULL)
+    {
+        sensorIds[sens->getName()] = (unsigned int)sensors.size();
         sensors.push_back(sens);
+        sensorScheduleValid = false;
+    }
 }
 
 void SimulationManager::AddComm(Comm* comm)
 {
     if(comm != NULL)
+    {
+        commIds[comm->getName()] = (unsigned int)comms.size();
         comms.push_back(comm);
+    }
+}
+
+void SimulationManager::setRecorder(Recorder* rec)
+{
+    if(recorder != NULL)
+        delete recorder;
+    recorder = rec;
+}
+
+void SimulationManager::setSharedMemoryTransport(SharedMemoryTransport* t)
+{
+    if(shmTransport != NULL)
+        delete shmTransport;
+    shmTransport = t;
 }
 
 void SimulationManager::AddJoint(Joint* jnt)
 {
     if(jnt != NULL)
     {
+        jointIds[jnt->getName()] = (unsigned int)joints.size();
         joints.push_back(jnt);
         jnt->AddToSimulation(this);
     }
@@ -245,13 +317,17 @@ void SimulationManager::AddJoint(Joint* jnt)
 void SimulationManager::AddActuator(Actuator *act)
 {
     if(act != NULL)
+    {
+        actuatorIds[act->getName()] = (unsigned int)actuators.size();
         actuators.push_back(act);
+    }
 }
 
 void SimulationManager::AddContact(Contact* cnt)
 {
     if(cnt != NULL)
     {
+        contactIds[cnt->getName()] = (unsigned int)contacts.size();
         contacts.push_back(cnt);
         EnableCollision(cnt->getEntityA(), cnt->getEntityB());
     }
@@ -332,11 +408,14 @@ Contact* SimulationManager::getContact(unsigned int index)
 
 Contact* SimulationManager::getContact(const std::string& name)
 {
-    for(size_t i = 0; i < contacts.size(); ++i)
-        if(contacts[i]->getName() == name)
-            return contacts[i];
-    
-    return NULL;
+    int id = getContactId(name);
+    return id > -1 ? contacts[id] : NULL;
+}
+
+int SimulationManager::getContactId(const std::string& name)
+{
+    std::unordered_map<std::string, unsigned int>::const_iterator it = contactIds.find(name);
+    return it != contactIds.end() ? (int)it->second : -1;
 }
 
 CollisionFilteringType SimulationManager::getCollisionFilter()
@@ -359,11 +438,14 @@ Robot* SimulationManager::getRobot(unsigned int index)
 
 Robot* SimulationManager::getRobot(const std::string& name)
 {
-    for(size_t i = 0; i < robots.size(); ++i)
-        if(robots[i]->getName() == name)
-            return robots[i];
-    
-    return NULL;
+    int id = getRobotId(name);
+    return id > -1 ? robots[id] : NULL;
+}
+
+int SimulationManager::getRobotId(const std::string& name)
+{
+    std::unordered_map<std::string, unsigned int>::const_iterator it = robotIds.find(name);
+    return it != robotIds.end() ? (int)it->second : -1;
 }
 
 Entity* SimulationManager::getEntity(unsigned int index)
@@ -376,11 +458,14 @@ Entity* SimulationManager::getEntity(unsigned int index)
 
 Entity* SimulationManager::getEntity(const std::string& name)
 {
-    for(size_t i = 0; i < entities.size(); ++i)
-        if(entities[i]->getName() == name)
-            return entities[i];
-    
-    return NULL;
+    int id = getEntityId(name);
+    return id > -1 ? entities[id] : NULL;
+}
+
+int SimulationManager::getEntityId(const std::string& name)
+{
+    std::unordered_map<std::string, unsigned int>::const_iterator it = entityIds.find(name);
+    return it != entityIds.end() ? (int)it->second : -1;
 }
 
 Joint* SimulationManager::getJoint(unsigned int index)
@@ -393,11 +478,14 @@ Joint* SimulationManager::getJoint(unsigned int index)
 
 Joint* SimulationManager::getJoint(const std::string& name)
 {
-    for(size_t i = 0; i < joints.size(); ++i)
-        if(joints[i]->getName() == name)
-            return joints[i];
-    
-    return NULL;
+    int id = getJointId(name);
+    return id > -1 ? joints[id] : NULL;
+}
+
+int SimulationManager::getJointId(const std::string& name)
+{
+    std::unordered_map<std::string, unsigned int>::const_iterator it = jointIds.find(name);
+    return it != jointIds.end() ? (int)it->second : -1;
 }
 
 Actuator* SimulationManager::getActuator(unsigned int index)
@@ -410,11 +498,14 @@ Actuator* SimulationManager::getActuator(unsigned int index)
 
 Actuator* SimulationManager::getActuator(const std::string& name)
 {
-    for(size_t i = 0; i < actuators.size(); ++i)
-        if(actuators[i]->getName() == name)
-            return actuators[i];
-    
-    return NULL;
+    int id = getActuatorId(name);
+    return id > -1 ? actuators[id] : NULL;
+}
+
+int SimulationManager::getActuatorId(const std::string& name)
+{
+    std::unordered_map<std::string, unsigned int>::const_iterator it = actuatorIds.find(name);
+    return it != actuatorIds.end() ? (int)it->second : -1;
 }
 
 Sensor* SimulationManager::getSensor(unsigned int index)
@@ -427,11 +518,14 @@ Sensor* SimulationManager::getSensor(unsigned int index)
 
 Sensor* SimulationManager::getSensor(const std::string& name)
 {
-    for(size_t i = 0; i < sensors.size(); ++i)
-        if(sensors[i]->getName() == name)
-            return sensors[i];
-    
-    return NULL;
+    int id = getSensorId(name);
+    return id > -1 ? sensors[id] : NULL;
+}
+
+int SimulationManager::getSensorId(const std::string& name)
+{
+    std::unordered_map<std::string, unsigned int>::const_iterator it = sensorIds.find(name);
+    return it != sensorIds.end() ? (int)it->second : -1;
 }
 
 Comm* SimulationManager::getComm(unsigned int index)
@@ -444,11 +538,14 @@ Comm* SimulationManager::getComm(unsigned int index)
 
 Comm* SimulationManager::getComm(const std::string& name)
 {
-    for(size_t i = 0; i < comms.size(); ++i)
-        if(comms[i]->getName() == name)
-            return comms[i];
-    
-    return NULL;
+    int id = getCommId(name);
+    return id > -1 ? comms[id] : NULL;
+}
+
+int SimulationManager::getCommId(const std::string& name)
+{
+    std::unordered_map<std::string, unsigned int>::const_iterator it = commIds.find(name);
+    return it != commIds.end() ? (int)it->second : -1;
 }
 
 NED* SimulationManager::getNED()
@@ -456,6 +553,11 @@ NED* SimulationManager::getNED()
     return ned;
 }
 
+AcousticNetwork* SimulationManager::getAcousticNetwork()
+{
+    return acousticNetwork;
+}
+
 Ocean* SimulationManager::getOcean()
 {
     return ocean;
@@ -494,6 +596,16 @@ NameManager* SimulationManager::getNameManager()
     return nameManager;
 }
 
+Recorder* SimulationManager::getRecorder()
+{
+    return recorder;
+}
+
+SharedMemoryTransport* SimulationManager::getSharedMemoryTransport()
+{
+    return shmTransport;
+}
+
 OpenGLTrackball* SimulationManager::getTrackball()
 {
     return trackball;
@@ -507,8 +619,6 @@ void SimulationManager::setStepsPerSecond(Scalar steps)
     SDL_LockMutex(simSettingsMutex);
     sps = steps;
     ssus = (uint64_t)(1000000.0/steps);
-    fdPrescaler = (unsigned int)round(sps/Scalar(50));
-    fdPrescaler = fdPrescaler == 0 ? 1 : fdPrescaler;
     SDL_UnlockMutex(simSettingsMutex);
 }
 
@@ -540,6 +650,52 @@ Scalar SimulationManager::getCpuUsage()
     return cpu;
 }
 
+void SimulationManager::setTickProfiling(bool enabled)
+{
+    tickProfiling = enabled;
+}
+
+TickProfile SimulationManager::getTickProfile()
+{
+    return tickProfile;
+}
+
+void SimulationManager::ResetTickProfile()
+{
+    tickProfile = TickProfile();
+}
+
+void SimulationManager::UpdateFluidCandidates()
+{
+    //Rebuild only when objects were added to or removed from the world
+    //(every object added to the world gets a new broadphase proxy id, so an exchange of objects is detected too)
+    int lastProxyId = ((btDbvtBroadphase*)dwBroadphase)->m_gid;
+    if(dynamicsWorld->getNumCollisionObjects() == fluidCandidatesWorldSize && lastProxyId == fluidCandidatesProxyId)
+        return;
+    
+    fluidCandidates.clear();
+    const btCollisionObjectArray& objects = dynamicsWorld->getCollisionObjectArray();
+    for(int i=0; i<objects.size(); ++i)
+    {
+        btBroadphaseProxy* proxy = objects[i]->getBroadphaseHandle();
+        if(proxy != NULL && (proxy->m_collisionFilterGroup & MASK_DYNAMIC))
+            fluidCandidates.push_back(objects[i]);
+    }
+    fluidCandidatesWorldSize = dynamicsWorld->getNumCollisionObjects();
+    fluidCandidatesProxyId = lastProxyId;
+    ++fluidCandidatesGeneration;
+}
+
+void SimulationManager::ProfileTick(uint64_t& phase)
+{
+    if(!tickProfiling)
+        return;
+    
+    uint64_t now = (uint64_t)GetTimeInNanoseconds();
+    phase += now - tickProfileMark;
+    tickProfileMark = now;
+}
+
 Scalar SimulationManager::getRealtimeFactor()
 {
     SDL_LockMutex(simInfoMutex);
@@ -586,6 +742,52 @@ void SimulationManager::setICSolverParams(bool useGravity, Scalar timeStep, unsi
     icAngTolerance = angularTolerance > SIMD_EPSILON ? angularTolerance : Scalar(1e-6);
 }
 
+void SimulationManager::setFluidDynamicsTolerances(const FluidDynamicsTolerances& tol)
+{
+    fdTolerances.linearVelocity = btMax(tol.linearVelocity, Scalar(0));
+    fdTolerances.angularVelocity = btMax(tol.angularVelocity, Scalar(0));
+    fdTolerances.submergence = btMax(tol.submergence, Scalar(0));
+    fdTolerances.orientation = btMax(tol.orientation, Scalar(0));
+    fdTolerances.maxAge = btMax(tol.maxAge, Scalar(0));
+}
+
+FluidDynamicsTolerances SimulationManager::getFluidDynamicsTolerances()
+{
+    return fdTolerances;
+}
+
+void SimulationManager::setSleepingSettings(const SleepingSettings& settings)
+{
+    slpSettings.enabled = settings.enabled;
+    slpSettings.linearVelocity = btMax(settings.linearVelocity, Scalar(0));
+    slpSettings.angularVelocity = btMax(settings.angularVelocity, Scalar(0));
+    if(settings.settleTime > Scalar(0))
+        slpSettings.settleTime = settings.settleTime;
+    else
+        cWarning("Settle time of sleeping bodies has to be positive! Keeping %1.3lf s.", slpSettings.settleTime);
+    slpSettings.fluidVelocity = btMax(settings.fluidVelocity, Scalar(0));
+    slpSettings.depth = btMax(settings.depth, Scalar(0));
+    
+    if(!simulationFresh)
+        ApplySleepingSettings();
+}
+
+SleepingSettings SimulationManager::getSleepingSettings()
+{
+    return slpSettings;
+}
+
+void SimulationManager::ApplySleepingSettings()
+{
+    for(size_t i=0; i<entities.size(); ++i)
+    {
+        if(entities[i]->getType() == EntityType::SOLID)
+            ((SolidEntity*)entities[i])->SetSleepingProperties(slpSettings);
+        else if(entities[i]->getType() == EntityType::FEATHERSTONE)
+            ((FeatherstoneEntity*)entities[i])->SetSleepingProperties(slpSettings);
+    }
+}
+
 void SimulationManager::setSolidDisplayMode(DisplayMode m)
 {
     if(sdm == m) 
@@ -702,6 +904,7 @@ void SimulationManager::InitializeSolver()
     dynamicsWorld->getSolverInfo().m_linearSlop = Scalar(0.); //position bias
     
     //Override default callbacks
+    //(Bullet contact callbacks are global, they find their world through the thread binding set in the tick callbacks)
     dynamicsWorld->setWorldUserInfo(this);
     dynamicsWorld->getPairCache()->setInternalGhostPairCallback(new btGhostPairCallback());
     gContactAddedCallback = SimulationManager::CustomMaterialCombinerCallback; //Compute combined friction and restitution
@@ -738,6 +941,7 @@ void SimulationManager::InitializeScenario()
 
 void SimulationManager::RestartScenario()
 {
+    MakeCurrent();
     DestroyScenario();
     InitializeSolver();
     InitializeScenario();
@@ -751,6 +955,8 @@ void SimulationManager::RestartScenario()
 
 void SimulationManager::DestroyScenario()
 {
+    MakeCurrent();
+    
     if(dynamicsWorld != NULL)
     {
         //remove objects from dynamic world
@@ -772,6 +978,10 @@ void SimulationManager::DestroyScenario()
         }
     
         delete dynamicsWorld;
+        fluidCandidates.clear();
+        fluidCandidatesWorldSize = -1;
+        fluidCandidatesProxyId = -1;
+        ++fluidCandidatesGeneration;
         delete dwSolver;
         delete dwBroadphase;
         delete dwDispatcher;
@@ -780,13 +990,27 @@ void SimulationManager::DestroyScenario()
     }
     
     //remove sim manager objects
+    if(recorder != NULL)
+    {
+        delete recorder;
+        recorder = NULL;
+    }
+    
+    if(shmTransport != NULL)
+    {
+        delete shmTransport;
+        shmTransport = NULL;
+    }
+    
     for(size_t i=0; i<robots.size(); ++i)
         delete robots[i];
     robots.clear();
+    robotIds.clear();
     
     for(size_t i=0; i<entities.size(); ++i)
         delete entities[i];
     entities.clear();
+    entityIds.clear();
     
     if(ocean != NULL)
     {
@@ -803,22 +1027,28 @@ void SimulationManager::DestroyScenario()
     for(size_t i=0; i<joints.size(); ++i)
         delete joints[i];
     joints.clear();
+    jointIds.clear();
     
     for(size_t i=0; i<contacts.size(); ++i)
         delete contacts[i];
     contacts.clear();
+    contactIds.clear();
     
     for(size_t i=0; i<sensors.size(); ++i)
         delete sensors[i];
     sensors.clear();
+    sensorIds.clear();
+    sensorScheduleValid = false;
     
     for(size_t i=0; i<comms.size(); ++i)
         delete comms[i];
     comms.clear();
+    commIds.clear();
     
     for(size_t i=0; i<actuators.size(); ++i)
         delete actuators[i];
     actuators.clear();
+    actuatorIds.clear();
     
     if(nameManager != NULL)
         nameManager->ClearNames();
@@ -835,17 +1065,20 @@ void SimulationManager::DestroyScenario()
 
 bool SimulationManager::StartSimulation()
 {
+    MakeCurrent();
     simulationFresh = false;
     currentTime = 0;
     physicsTime = 0;
     simulationTime = 0;
     mlcpFallbacks = 0;
-    fdCounter = 0;
     
     //Solve initial conditions problem
     if(!SolveICProblem())
         return false;
     
+    //Bodies settled when solving initial conditions start awake
+    ApplySleepingSettings();
+    
     //Reset contacts
     for(unsigned int i = 0; i < contacts.size(); i++)
         contacts[i]->ClearHistory();
@@ -853,6 +1086,7 @@ bool SimulationManager::StartSimulation()
     //Reset sensors
     for(unsigned int i = 0; i < sensors.size(); i++)
         sensors[i]->Reset();
+    sensorScheduleValid = false;
     
     return true;
 }
@@ -929,6 +1163,8 @@ void SimulationManager::AdvanceSimulation()
     //Check if initial conditions solved
     if(!icProblemSolved)
         return;
+    
+    MakeCurrent();
         
     //Calculate eleapsed time
     uint64_t timeInMicroseconds = GetTimeInMicroseconds();
@@ -988,6 +1224,28 @@ void SimulationManager::AdvanceSimulation()
     SDL_UnlockMutex(simInfoMutex);
 }
 
+void SimulationManager::StepSimulation()
+{
+    //Check if initial conditions solved
+    if(!icProblemSolved)
+        return;
+    
+    MakeCurrent();
+    
+    //Step simulation
+    SDL_LockMutex(simSettingsMutex);
+    Scalar dt = (Scalar)ssus/Scalar(1000000.0);
+    uint64_t physicsStart = GetTimeInMicroseconds();
+    dynamicsWorld->stepSimulation(dt, 1, dt);
+    uint64_t physicsEnd = GetTimeInMicroseconds();
+    SDL_UnlockMutex(simSettingsMutex);
+    
+    SDL_LockMutex(simInfoMutex);
+    physicsTime = physicsEnd - physicsStart;
+    cpuUsage = Scalar(100);
+    SDL_UnlockMutex(simInfoMutex);
+}
+
 void SimulationManager::SimulationStepCompleted(Scalar timeStep)
 {
 #ifdef DEBUG
@@ -998,52 +1256,63 @@ void SimulationManager::SimulationStepCompleted(Scalar timeStep)
 
 void SimulationManager::UpdateDrawingQueue()
 {
-    //Build new drawing queue
+    //Build new drawing queue (back buffer is owned by this thread, no locking needed)
     OpenGLPipeline* glPipeline = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline();
+    DrawingQueue& queue = glPipeline->getDrawingQueue();
     
     //Solids, manipulators, systems....
     for(size_t i=0; i<entities.size(); ++i)
-        glPipeline->AddToDrawingQueue(entities[i]->Render());
+        entities[i]->Render(queue);
 
     Entity* selected = ((GraphicalSimulationApp*)SimulationApp::getApp())->getSelectedEntity();
     if(selected != NULL)
-        glPipeline->AddToSelectedDrawingQueue(selected->Render());
+        selected->Render(glPipeline->getSelectedDrawingQueue());
 
     //Joints
     for(size_t i=0; i<joints.size(); ++i)
-        glPipeline->AddToDrawingQueue(joints[i]->Render());
+        joints[i]->Render(queue);
         
     //Actuators
     for(size_t i=0; i<actuators.size(); ++i)
-    {
-        glPipeline->AddToDrawingQueue(actuators[i]->Render());
-        if(actuators[i]->getType() == ActuatorType::LIGHT)
-            ((Light*)actuators[i])->UpdateTransform();
-    }
+        actuators[i]->Render(queue);
     
     //Sensors
     for(size_t i=0; i<sensors.size(); ++i)
-    {
-        glPipeline->AddToDrawingQueue(sensors[i]->Render());
-        if(sensors[i]->getType() == SensorType::VISION)
-            ((VisionSensor*)sensors[i])->UpdateTransform();
-    }
+        sensors[i]->Render(queue);
     
     //Comms
     for(size_t i=0; i<comms.size(); ++i)
-        glPipeline->AddToDrawingQueue(comms[i]->Render());
-    
-    //Trackball
-    if(trackball != NULL)
-        trackball->UpdateCenterPos();
+        comms[i]->Render(queue);
     
     //Contacts
     for(size_t i=0; i<contacts.size(); ++i)
-        glPipeline->AddToDrawingQueue(contacts[i]->Render());
+        contacts[i]->Render(queue);
     
     //Ocean currents
     if(ocean != NULL)
-        glPipeline->AddToDrawingQueue(ocean->Render(actuators));
+        ocean->Render(queue, actuators);
+    
+    //Hand over the queue together with the view and light transforms.
+    //Never wait for the rendering thread: if it is busy taking over the previous queue, drop this one.
+    if(SDL_TryLockMutex(glPipeline->getDrawingQueueMutex()) != 0)
+    {
+        glPipeline->DiscardDrawingQueue();
+        return;
+    }
+    
+    for(size_t i=0; i<actuators.size(); ++i)
+        if(actuators[i]->getType() == ActuatorType::LIGHT)
+            ((Light*)actuators[i])->UpdateTransform();
+    
+    for(size_t i=0; i<sensors.size(); ++i)
+        if(sensors[i]->getType() == SensorType::VISION)
+            ((VisionSensor*)sensors[i])->UpdateTransform();
+    
+    if(trackball != NULL)
+        trackball->UpdateCenterPos();
+    
+    glPipeline->PublishDrawingQueue();
+    SDL_UnlockMutex(glPipeline->getDrawingQueueMutex());
 }
 
 Entity* SimulationManager::PickEntity(Vector3 eye, Vector3 ray)
@@ -1100,7 +1369,7 @@ bool SimulationManager::CustomMaterialCombinerCallback(btManifoldPoint& cp,	cons
         return true;
     }
     
-    MaterialManager* mm = SimulationApp::getApp()->getSimulationManager()->getMaterialManager();
+    MaterialManager* mm = SimulationManager::getCurrent()->getMaterialManager();
     
     Material mat0;
     Vector3 contactVelocity0;
@@ -1188,7 +1457,7 @@ bool SimulationManager::CustomMaterialCombinerCallback(btManifoldPoint& cp,	cons
     Scalar relAngularVelocity10 = contactAngularVelocity1 - contactAngularVelocity0;
     
     //calculate contact normal force and friction torque
-    Scalar normalForce = cp.m_appliedImpulse * SimulationApp::getApp()->getSimulationManager()->getStepsPerSecond();
+    Scalar normalForce = cp.m_appliedImpulse * SimulationManager::getCurrent()->getStepsPerSecond();
     Scalar T = cp.m_combinedFriction * normalForce * 0.002;
 
     //apply damping torque
@@ -1204,14 +1473,70 @@ bool SimulationManager::CustomMaterialCombinerCallback(btManifoldPoint& cp,	cons
     return true;
 }
 
+void SimulationManager::UpdateLinkKinematics()
+{
+    for(size_t i = 0; i < entities.size(); ++i)
+        if(entities[i]->getType() == EntityType::FEATHERSTONE)
+            ((FeatherstoneEntity*)entities[i])->UpdateLinkKinematics();
+}
+
+void SimulationManager::InvalidateSensorSchedule()
+{
+    sensorScheduleValid = false;
+}
+
+void SimulationManager::RebuildSensorSchedule()
+{
+    tickSensors.clear();
+    sensorSchedule = decltype(sensorSchedule)();
+    
+    for(size_t i = 0; i < sensors.size(); ++i)
+    {
+        if(sensors[i]->getUpdateFrequency() <= Scalar(0)) // Every simulation tick
+            tickSensors.push_back(i);
+        else //Fixed rate
+            sensorSchedule.push(std::make_pair(sensors[i]->getNextUpdateTime(), i));
+    }
+}
+
+void SimulationManager::UpdateSensors(Scalar now, Scalar timeStep)
+{
+    //Mark the schedule valid before rebuilding, so that a rate change during the rebuild triggers another one
+    if(!sensorScheduleValid.exchange(true))
+        RebuildSensorSchedule();
+    
+    for(size_t i = 0; i < tickSensors.size(); ++i)
+        sensors[tickSensors[i]]->Update(timeStep);
+    
+    //Collect all sensors due in this tick (tolerance covers round-off of the accumulated simulation time)
+    Scalar tolerance = timeStep * Scalar(1e-3);
+    dueSensors.clear();
+    while(!sensorSchedule.empty() && sensorSchedule.top().first <= now + tolerance)
+    {
+        dueSensors.push_back(sensorSchedule.top().second);
+        sensorSchedule.pop();
+    }
+    
+    //Sample the batch of due sensors and put them back in the schedule
+    for(size_t i = 0; i < dueSensors.size(); ++i)
+    {
+        Scalar next = sensors[dueSensors[i]]->ScheduledUpdate(now, timeStep);
+        sensorSchedule.push(std::make_pair(next, dueSensors[i]));
+    }
+}
+
 void SimulationManager::SolveICTickCallback(btDynamicsWorld* world, Scalar timeStep)
 {
     SimulationManager* simManager = (SimulationManager*)world->getWorldUserInfo();
+    simManager->MakeCurrent();
     btMultiBodyDynamicsWorld* researchWorld = (btMultiBodyDynamicsWorld*)world;
     
     //Clear all forces to ensure that no summing occurs
     researchWorld->clearForces(); //Includes clearing of multibody forces!
     
+    //Cache multibody link kinematics
+    simManager->UpdateLinkKinematics();
+    
     //Solve for objects settling
     bool objectsSettled = true;
     
@@ -1312,10 +1637,16 @@ void SimulationManager::SolveICTickCallback(btDynamicsWorld* world, Scalar timeS
 void SimulationManager::SimulationTickCallback(btDynamicsWorld* world, Scalar timeStep)
 {
     SimulationManager* simManager = (SimulationManager*)world->getWorldUserInfo();
+    simManager->MakeCurrent();
     btMultiBodyDynamicsWorld* mbDynamicsWorld = (btMultiBodyDynamicsWorld*)world;
+    if(simManager->tickProfiling)
+        simManager->tickProfileMark = (uint64_t)GetTimeInNanoseconds();
         
     //Clear all forces to ensure that no summing occurs
     mbDynamicsWorld->clearForces(); //Includes clearing of multibody forces!
+    
+    //Cache multibody link kinematics (read by actuators, hydrodynamics and contact callbacks)
+    simManager->UpdateLinkKinematics();
         
     //loop through all actuators -> apply forces to bodies (free and connected by joints)
     for(size_t i = 0; i < simManager->actuators.size(); ++i)
@@ -1333,6 +1664,7 @@ void SimulationManager::SimulationTickCallback(btDynamicsWorld* world, Scalar ti
         if(ent->getType() == EntityType::SOLID)
         {
             SolidEntity* solid = (SolidEntity*)ent;
+            solid->UpdateSleeping();
             solid->ApplyGravity(mbDynamicsWorld->getGravity());
         }
         else if(ent->getType() == EntityType::FEATHERSTONE)
@@ -1370,75 +1702,40 @@ void SimulationManager::SimulationTickCallback(btDynamicsWorld* world, Scalar ti
         }
     }
     
-    //Geometry-based forces
-    bool recompute = simManager->fdCounter % simManager->fdPrescaler == 0;
-    ++simManager->fdCounter;
-        
+    simManager->ProfileTick(simManager->tickProfile.forces);
+    
+    //Dynamic bodies that may be inside the fluids
+    if(simManager->atmosphere != NULL || simManager->ocean != NULL)
+        simManager->UpdateFluidCandidates();
+    
     //Aerodynamic forces
     if(simManager->atmosphere != NULL)
     {
-        btBroadphasePairArray& pairArray = simManager->atmosphere->getGhost()->getOverlappingPairCache()->getOverlappingPairArray();
-        int numPairs = pairArray.size();
-        
-        if(numPairs > 0)
-        {    
-            for(int h=0; h<numPairs; ++h)
-            {
-                const btBroadphasePair& pair = pairArray[h];
-                btBroadphasePair* colPair = world->getPairCache()->findPair(pair.m_pProxy0, pair.m_pProxy1);
-                if (!colPair)
-                    continue;
-                    
-                btCollisionObject* co1 = (btCollisionObject*)colPair->m_pProxy0->m_clientObject;
-                btCollisionObject* co2 = (btCollisionObject*)colPair->m_pProxy1->m_clientObject;
-                
-                if(co1 == simManager->atmosphere->getGhost())
-                    simManager->atmosphere->ApplyFluidForces(world, co2, recompute);
-                else if(co2 == simManager->ocean->getGhost())
-                    simManager->atmosphere->ApplyFluidForces(world, co1, recompute);
-            }
-        }
+        simManager->atmosphere->UpdateMembers(simManager->fluidCandidates, simManager->fluidCandidatesGeneration);
+        const std::vector<btCollisionObject*>& members = simManager->atmosphere->getMembers();
+        for(size_t h=0; h<members.size(); ++h)
+            simManager->atmosphere->ApplyFluidForces(world, members[h], simManager->fdTolerances);
     }
     
     //Hydrodynamic forces
     if(simManager->ocean != NULL)
     {
-        if(recompute) SDL_LockMutex(simManager->simHydroMutex);
-        
-        btBroadphasePairArray& pairArray = simManager->ocean->getGhost()->getOverlappingPairCache()->getOverlappingPairArray();
-        int numPairs = pairArray.size();
-        
-        if(numPairs > 0)
-        {   
-            //uint64_t s = GetTimeInMicroseconds();
-            for(int h=0; h<numPairs; ++h)
-            {
-                const btBroadphasePair& pair = pairArray[h];
-                btBroadphasePair* colPair = world->getPairCache()->findPair(pair.m_pProxy0, pair.m_pProxy1);
-                if (!colPair)
-                    continue;
-                    
-                btCollisionObject* co1 = (btCollisionObject*)colPair->m_pProxy0->m_clientObject;
-                btCollisionObject* co2 = (btCollisionObject*)colPair->m_pProxy1->m_clientObject;
-                
-                if(co1 == simManager->ocean->getGhost())
-                    simManager->ocean->ApplyFluidForces(world, co2, recompute);
-                else if(co2 == simManager->ocean->getGhost())
-                    simManager->ocean->ApplyFluidForces(world, co1, recompute);
-            }
-            //uint64_t e = GetTimeInMicroseconds();
-            //if(recompute)
-            //    printf("Hydro compute time: %ld us\n", e-s);
-        }
-        
-        if(recompute) SDL_UnlockMutex(simManager->simHydroMutex);
+        //The wave data mutex is only held while a body samples the waves (see Ocean::ApplyFluidForces)
+        simManager->ocean->UpdateMembers(simManager->fluidCandidates, simManager->fluidCandidatesGeneration);
+        const std::vector<btCollisionObject*>& members = simManager->ocean->getMembers();
+        for(size_t h=0; h<members.size(); ++h)
+            simManager->ocean->ApplyFluidForces(world, members[h], simManager->fdTolerances);
     }
+    
+    simManager->ProfileTick(simManager->tickProfile.fluids);
 }
 
 //Used to measure body motions and calculate controls
 void SimulationManager::SimulationPostTickCallback(btDynamicsWorld *world, Scalar timeStep)
 {
     SimulationManager* simManager = (SimulationManager*)world->getWorldUserInfo();
+    simManager->MakeCurrent();
+    simManager->ProfileTick(simManager->tickProfile.solver);
     
     //Update motion data
     for(size_t i = 0; i < simManager->entities.size(); ++i)
@@ -1453,6 +1750,7 @@ void SimulationManager::SimulationPostTickCallback(btDynamicsWorld *world, Scala
         else if(ent->getType() == EntityType::FEATHERSTONE)
         {
             FeatherstoneEntity* fe = (FeatherstoneEntity*)ent;
+            fe->UpdateLinkKinematics(); //State changed by integration
             fe->UpdateAcceleration(timeStep);
         }
         else if(ent->getType() == EntityType::ANIMATED)
@@ -1462,14 +1760,30 @@ void SimulationManager::SimulationPostTickCallback(btDynamicsWorld *world, Scala
         }
     }
     
-    //Loop through all sensors -> update measurements
-    for(size_t i = 0; i < simManager->sensors.size(); ++i)
-        simManager->sensors[i]->Update(timeStep);
+    simManager->ProfileTick(simManager->tickProfile.kinematics);
+    
+    //Update simulation time (measurements refer to the state at the end of the step)
+    simManager->simulationTime += timeStep;
+    
+    //Update sensors which are due -> update measurements
+    simManager->UpdateSensors(simManager->simulationTime, timeStep);
+    
+    //Stream actuator and body states
+    if(simManager->recorder != NULL)
+        simManager->recorder->Record(simManager->simulationTime);
+    
+    //Publish measurements and apply actuator commands received through shared memory
+    if(simManager->shmTransport != NULL)
+        simManager->shmTransport->Update();
+    
+    simManager->ProfileTick(simManager->tickProfile.sensors);
         
     //Loop through all comms -> update state and measurements
     for(size_t i = 0; i < simManager->comms.size(); ++i)
         simManager->comms[i]->Update(timeStep);
     
+    simManager->ProfileTick(simManager->tickProfile.comms);
+    
     //Loop through contact manifolds -> update contacts
     int numManifolds = world->getDispatcher()->getNumManifolds();
     for(int i=0; i<numManifolds; ++i)
@@ -1483,12 +1797,17 @@ void SimulationManager::SimulationPostTickCallback(btDynamicsWorld *world, Scala
         if(contact != NULL && contactManifold->getNumContacts() > 0)
             contact->AddContactPoint(contactManifold, contact->getEntityA() != entA, timeStep);        
     }
-
-    //Update simulation time
-    simManager->simulationTime += timeStep;
+    
+    simManager->ProfileTick(simManager->tickProfile.contacts);
     
     //Optional method to update some post simulation data (like ROS messages...)
     simManager->SimulationStepCompleted(timeStep);
+    
+    if(simManager->tickProfiling)
+    {
+        simManager->ProfileTick(simManager->tickProfile.callback);
+        ++simManager->tickProfile.ticks;
+    }
 }
 
 //Used to save contact information, including contact forces
@@ -267,30 +267,26 @@ void AnimatedEntity::Update(Scalar dt)
     rigidBody->setAngularVelocity(tr->getInterpolatedAngularVelocity());    
 }
 
-std::vector<Renderable> AnimatedEntity::Render()
+void AnimatedEntity::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
-    
     if(rigidBody != nullptr && isRenderable())
     {
         Renderable item;
         item.type = RenderableType::SOLID_CS;
         item.model = glMatrixFromTransform(getOTransform());
-        items.push_back(item);
+        queue.Add(item);
 
         if(graObjectId >= 0)
         {
             item.type = RenderableType::SOLID;
-            item.materialName = mat.name;
+            item.materialId = mat.id;
             item.objectId = dm == DisplayMode::GRAPHICAL ? graObjectId : phyObjectId;
             item.lookId = dm == DisplayMode::GRAPHICAL ? lookId : -1;
-            items.push_back(item);
+            queue.Add(item);
         }
 
-        items.push_back(tr->Render());
+        tr->Render(queue);
     }
-
-    return items;
 }
 
 }
@@ -34,14 +34,14 @@ namespace sf
 
 Entity::Entity(std::string uniqueName)
 {
-    name = SimulationApp::getApp()->getSimulationManager()->getNameManager()->AddName(uniqueName);
+    name = SimulationManager::getCurrent()->getNameManager()->AddName(uniqueName);
     renderable = true;
 }
 
 Entity::~Entity(void)
 {
     if(SimulationApp::getApp() != NULL)
-        SimulationApp::getApp()->getSimulationManager()->getNameManager()->RemoveName(name);
+        SimulationManager::getCurrent()->getNameManager()->RemoveName(name);
 }
 
 void Entity::setRenderable(bool render)
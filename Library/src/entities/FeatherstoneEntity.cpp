@@ -29,6 +29,8 @@
 #include "core/SimulationManager.h"
 #include "entities/StaticEntity.h"
 
+#define MOTOR_WAKE_TOLERANCE    Scalar(1e-3)
+
 namespace sf
 {
 
@@ -171,6 +173,8 @@ void FeatherstoneEntity::setBaseTransform(const Transform& trans)
         Transform tr = links[i].solid->multibodyCollider->getWorldTransform();
         links[i].solid->multibodyCollider->setWorldTransform(trans * tr);
     }
+    
+    InvalidateLinkKinematics();
 }
 
 void FeatherstoneEntity::setJointIC(unsigned int index, Scalar position, Scalar velocity)
@@ -193,6 +197,8 @@ void FeatherstoneEntity::setJointIC(unsigned int index, Scalar position, Scalar
         default:
             break;
     }
+    
+    InvalidateLinkKinematics();
 }
 
 void FeatherstoneEntity::setJointDamping(unsigned int index, Scalar constantFactor, Scalar viscousFactor)
@@ -300,7 +306,7 @@ void FeatherstoneEntity::setMaxMotorForceTorque(unsigned int index, Scalar maxT)
     if(joints[index].motor == NULL)
         return;
         
-    joints[index].motor->setMaxAppliedImpulse(maxT * Scalar(1)/SimulationApp::getApp()->getSimulationManager()->getStepsPerSecond());
+    joints[index].motor->setMaxAppliedImpulse(maxT * Scalar(1)/SimulationManager::getCurrent()->getStepsPerSecond());
 }
 
 Scalar FeatherstoneEntity::getMotorForceTorque(unsigned int index)
@@ -308,7 +314,7 @@ Scalar FeatherstoneEntity::getMotorForceTorque(unsigned int index)
     if(index >= joints.size() || joints[index].motor == NULL)
         return Scalar(0);
     else
-        return joints[index].motor->getAppliedImpulse(0) * SimulationApp::getApp()->getSimulationManager()->getStepsPerSecond();
+        return joints[index].motor->getAppliedImpulse(0) * SimulationManager::getCurrent()->getStepsPerSecond();
 }
 
 unsigned int FeatherstoneEntity::getJointFeedback(unsigned int index, Vector3& force, Vector3& torque)
@@ -413,7 +419,7 @@ void FeatherstoneEntity::AddLink(SolidEntity *solid, const Transform& transform)
         //Add link
         links.push_back(FeatherstoneLink(solid, transform));
         //Build collider
-        links.back().solid->BuildMultibodyLinkCollider(multiBody, (int)(links.size() - 1), SimulationApp::getApp()->getSimulationManager()->getDynamicsWorld());
+        links.back().solid->BuildMultibodyLinkCollider(multiBody, (int)(links.size() - 1), SimulationManager::getCurrent()->getDynamicsWorld());
         
         if(links.size() > 1) //If not base link
         {
@@ -556,11 +562,11 @@ void FeatherstoneEntity::AddJointMotor(unsigned int index, Scalar maxForceTorque
     
     if(joints[index].motor != NULL)
     {
-        joints[index].motor->setMaxAppliedImpulse(maxForceTorque * Scalar(1)/SimulationApp::getApp()->getSimulationManager()->getStepsPerSecond());
+        joints[index].motor->setMaxAppliedImpulse(maxForceTorque * Scalar(1)/SimulationManager::getCurrent()->getStepsPerSecond());
     }
     else
     {
-        btMultiBodyJointMotor* jmc = new btMultiBodyJointMotor(multiBody, index, Scalar(0), maxForceTorque * Scalar(1)/SimulationApp::getApp()->getSimulationManager()->getStepsPerSecond());
+        btMultiBodyJointMotor* jmc = new btMultiBodyJointMotor(multiBody, index, Scalar(0), maxForceTorque * Scalar(1)/SimulationManager::getCurrent()->getStepsPerSecond());
         joints[index].motor = jmc;
     }
 }
@@ -576,6 +582,9 @@ void FeatherstoneEntity::MotorPositionSetpoint(unsigned int index, Scalar pos, S
     if(joints[index].lowerLimit < joints[index].upperLimit) //if joint limits exist the desired position has to be restricted to avoid violating constraints!
         pos = pos < joints[index].lowerLimit ? joints[index].lowerLimit : (pos > joints[index].upperLimit ? joints[index].upperLimit : pos);
     
+    if(kp > Scalar(0) && btFabs(pos - multiBody->getJointPos(joints[index].child - 1)) > MOTOR_WAKE_TOLERANCE)
+        WakeUp();
+    
     joints[index].motor->setPositionTarget(pos, kp);
 }
 
@@ -587,6 +596,9 @@ void FeatherstoneEntity::MotorVelocitySetpoint(unsigned int index, Scalar vel, S
     if(joints[index].motor == NULL)
         return;
         
+    if(kd > Scalar(0) && btFabs(vel - multiBody->getJointVel(joints[index].child - 1)) > MOTOR_WAKE_TOLERANCE)
+        WakeUp();
+    
     joints[index].motor->setVelocityTarget(vel, kd);
 }
 
@@ -595,6 +607,9 @@ void FeatherstoneEntity::DriveJoint(unsigned int index, Scalar forceTorque)
     if(index >= joints.size())
         return;
         
+    if(!btFuzzyZero(forceTorque))
+        WakeUp();
+    
     switch (joints[index].type)
     {
         case btMultibodyLink::eRevolute:
@@ -610,35 +625,67 @@ void FeatherstoneEntity::DriveJoint(unsigned int index, Scalar forceTorque)
     }
 }
 
-void FeatherstoneEntity::ApplyGravity(const Vector3& g)
+void FeatherstoneEntity::SetSleepingProperties(const SleepingSettings& settings)
 {
-    bool isSleeping = false;
+    //Squared norm of the generalised velocity, compared to the threshold by Bullet (mixes linear and angular units)
+    multiBody->setCanSleep(settings.enabled);
+    multiBody->setSleepThreshold(settings.linearVelocity * settings.linearVelocity);
+    multiBody->setSleepTimeout(settings.settleTime);
+    multiBody->wakeUp();
     
+    for(size_t i=0; i<links.size(); ++i)
+        links[i].solid->SetSleepingProperties(settings);
+}
+
+bool FeatherstoneEntity::isSleeping() const
+{
     if(multiBody->getBaseCollider() && multiBody->getBaseCollider()->getActivationState() == ISLAND_SLEEPING)
-        isSleeping = true;
+        return true;
     
     for(int i=0; i<multiBody->getNumLinks(); ++i)
     {
         if(multiBody->getLink(i).m_collider && multiBody->getLink(i).m_collider->getActivationState() == ISLAND_SLEEPING)
-        {
-            isSleeping = true;
-            break;
-        }
-    } 
+            return true;
+    }
+    
+    return false;
+}
 
-    if(!isSleeping)
+void FeatherstoneEntity::WakeUp()
+{
+    if(!isSleeping())
+        return;
+    
+    multiBody->wakeUp();
+    
+    if(multiBody->getBaseCollider())
+        multiBody->getBaseCollider()->activate();
+    
+    for(int i=0; i<multiBody->getNumLinks(); ++i)
     {
-        multiBody->addBaseForce(g * links[0].solid->getMass());
+        if(multiBody->getLink(i).m_collider)
+            multiBody->getLink(i).m_collider->activate();
+    }
+}
 
-        for(int i=0; i<multiBody->getNumLinks(); ++i) 
-        {
-            multiBody->addLinkForce(i, g * links[i+1].solid->getMass());
-        }
+void FeatherstoneEntity::ApplyGravity(const Vector3& g)
+{
+    if(isSleeping())
+        return;
+    
+    multiBody->addBaseForce(g * links[0].solid->getMass());
+
+    for(int i=0; i<multiBody->getNumLinks(); ++i) 
+    {
+        multiBody->addLinkForce(i, g * links[i+1].solid->getMass());
     }
 }
 
 void FeatherstoneEntity::ApplyDamping()
 {
+    if(isSleeping())
+        return;
+    
     for(unsigned int i=0; i<joints.size(); ++i)
     {
         if(joints[i].sigDamping >= SIMD_EPSILON || joints[i].velDamping >= SIMD_EPSILON) //If damping factors not equal zero
@@ -659,6 +706,9 @@ void FeatherstoneEntity::AddLinkForce(unsigned int index, const Vector3& F)
     if(index >= links.size())
         return;
     
+    if(!F.fuzzyZero())
+        WakeUp();
+    
     if(index == 0)
         multiBody->addBaseForce(F);
     else
@@ -670,40 +720,76 @@ void FeatherstoneEntity::AddLinkTorque(unsigned int index, const Vector3& tau)
     if(index >= links.size())
         return;
         
+    if(!tau.fuzzyZero())
+        WakeUp();
+    
     if(index == 0)
         multiBody->addBaseTorque(tau);
     else
         multiBody->addLinkTorque(index-1, tau);
 }
 
+void FeatherstoneEntity::UpdateLinkKinematics()
+{
+    //Base velocity
+    Vector3 linVelocity = multiBody->getBaseVel(); //Global
+    Vector3 angVelocity = multiBody->getBaseOmega(); //Global
+    links[0].solid->mbLinearVel = linVelocity;
+    links[0].solid->mbAngularVel = angVelocity;
+    links[0].solid->mbVelocityCached = true;
+    
+    //Accumulate velocity resulting from joints (same recurrence as SolidEntity::getLinearVelocity, but done once for all links)
+    for(int i = 0; i < multiBody->getNumLinks() && i+1 < (int)links.size(); ++i)
+    {
+        const btMultibodyLink& link = multiBody->getLink(i);
+        linVelocity += angVelocity.cross(multiBody->localDirToWorld(i, multiBody->getRVector(i)));
+        
+        if(link.m_jointType == btMultibodyLink::ePrismatic)
+        {
+            Vector3 vel = multiBody->getJointVel(i) * link.getAxisBottom(0); //Local velocity
+            linVelocity += multiBody->localDirToWorld(i, vel);
+        }
+        else if(link.m_jointType == btMultibodyLink::eRevolute)
+        {
+            Vector3 aVel = multiBody->getJointVel(i) * link.getAxisTop(0); //Local angular velocity
+            Vector3 vel = aVel.cross(link.m_dVector); //Local velocity
+            linVelocity += multiBody->localDirToWorld(i, vel);
+            angVelocity += multiBody->localDirToWorld(i, aVel);
+        }
+        
+        links[i+1].solid->mbLinearVel = linVelocity;
+        links[i+1].solid->mbAngularVel = angVelocity;
+        links[i+1].solid->mbVelocityCached = true;
+    }
+}
+
+void FeatherstoneEntity::InvalidateLinkKinematics()
+{
+    for(size_t i = 0; i < links.size(); ++i)
+        links[i].solid->mbVelocityCached = false;
+}
+
 void FeatherstoneEntity::UpdateAcceleration(Scalar dt)
 {
     for(unsigned int i=0; i<links.size(); ++i)
         links[i].solid->UpdateAcceleration(dt);
 }
 
-std::vector<Renderable> FeatherstoneEntity::Render()
+void FeatherstoneEntity::Render(DrawingQueue& queue)
 {	
-    std::vector<Renderable> items(0);
-    
     //Draw base
     if(baseRenderable)
-    {
-        std::vector<Renderable> _base = links[0].solid->Render();
-        items.insert(items.end(), _base.begin(), _base.end());
-    }
+        links[0].solid->Render(queue);
     
     //Draw rest of links
     for(size_t i = 1; i < links.size(); ++i)
-    {
-        std::vector<Renderable> _link = links[i].solid->Render();
-        items.insert(items.end(), _link.begin(), _link.end());
-    }
+        links[i].solid->Render(queue);
     
     //Draw link axes
     Renderable item;
     item.type = RenderableType::MULTIBODY_AXIS;
     item.model = glm::mat4(1.f);
+    queue.BeginPoints(item);
     
     for(size_t i = 1; i < links.size(); ++i)
     {
@@ -722,13 +808,11 @@ std::vector<Renderable> FeatherstoneEntity::Render()
             axisEnd += axisInWorld * Scalar(0.3);
         }
         
-        item.points.push_back(glm::vec3((GLfloat)pivot.x(), (GLfloat)pivot.y(), (GLfloat)pivot.z()));
-        item.points.push_back(glm::vec3((GLfloat)axisEnd.x(), (GLfloat)axisEnd.y(), (GLfloat)axisEnd.z()));
+        queue.AddPoint(item, glm::vec3((GLfloat)pivot.x(), (GLfloat)pivot.y(), (GLfloat)pivot.z()));
+        queue.AddPoint(item, glm::vec3((GLfloat)axisEnd.x(), (GLfloat)axisEnd.y(), (GLfloat)axisEnd.z()));
     }
     
-    items.push_back(item);
-    
-    return items;
+    queue.Add(item);
 }
 
 }
@@ -25,6 +25,7 @@
 
 #include "entities/ForcefieldEntity.h"
 
+#include "LinearMath/btAabbUtil2.h"
 #include "core/SimulationManager.h"
 #include "graphics/OpenGLContent.h"
 
@@ -35,6 +36,7 @@ ForcefieldEntity::ForcefieldEntity(std::string uniqueName) : Entity(uniqueName)
 {
     ghost = new btPairCachingGhostObject();
     ghost->setCollisionFlags(btCollisionObject::CF_NO_CONTACT_RESPONSE);
+    membersGeneration = 0;
 }
 
 ForcefieldEntity::~ForcefieldEntity()
@@ -51,14 +53,51 @@ btPairCachingGhostObject* ForcefieldEntity::getGhost()
     return ghost;
 }
 
+void ForcefieldEntity::UpdateMembers(const std::vector<btCollisionObject*>& candidates, unsigned int generation)
+{
+    Vector3 fieldMin, fieldMax;
+    ghost->getCollisionShape()->getAabb(ghost->getWorldTransform(), fieldMin, fieldMax);
+    
+    //Check which bodies crossed the bounds of the force field since the last update
+    bool changed = generation != membersGeneration || memberFlags.size() != candidates.size();
+    if(changed)
+    {
+        memberFlags.assign(candidates.size(), 0);
+        membersGeneration = generation;
+    }
+    
+    for(size_t i=0; i<candidates.size(); ++i)
+    {
+        const btBroadphaseProxy* proxy = candidates[i]->getBroadphaseHandle();
+        char inside = proxy != NULL && TestAabbAgainstAabb2(proxy->m_aabbMin, proxy->m_aabbMax, fieldMin, fieldMax) ? 1 : 0;
+        if(inside != memberFlags[i])
+        {
+            memberFlags[i] = inside;
+            changed = true;
+        }
+    }
+    
+    if(!changed)
+        return;
+    
+    members.clear();
+    for(size_t i=0; i<candidates.size(); ++i)
+        if(memberFlags[i])
+            members.push_back(candidates[i]);
+}
+
+const std::vector<btCollisionObject*>& ForcefieldEntity::getMembers() const
+{
+    return members;
+}
+
 void ForcefieldEntity::AddToSimulation(SimulationManager* sm)
 {
     sm->getDynamicsWorld()->addCollisionObject(ghost, MASK_GHOST, MASK_DYNAMIC);
 }
 
-std::vector<Renderable> ForcefieldEntity::Render()
+void ForcefieldEntity::Render(DrawingQueue& queue)
 {
-    return std::vector<Renderable>(0);
 }
 
 void ForcefieldEntity::getAABB(Vector3& min, Vector3& max)
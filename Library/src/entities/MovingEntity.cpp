@@ -36,7 +36,7 @@ namespace sf
 MovingEntity::MovingEntity(std::string uniqueName, std::string material, std::string look) : Entity(uniqueName)
 {
     rigidBody = nullptr;
-    mat = SimulationApp::getApp()->getSimulationManager()->getMaterialManager()->getMaterial(material);
+    mat = SimulationManager::getCurrent()->getMaterialManager()->getMaterial(material);
     if(SimulationApp::getApp()->hasGraphics())
         lookId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->getLookId(look);
     else
@@ -41,10 +41,10 @@ namespace sf
 
 SolidEntity::SolidEntity(std::string uniqueName, std::string material, BodyPhysicsType bpt, std::string look, Scalar thickness, bool isBuoyant) : MovingEntity(uniqueName, material, look)
 {
-    mat = SimulationApp::getApp()->getSimulationManager()->getMaterialManager()->getMaterial(material);
+    mat = SimulationManager::getCurrent()->getMaterialManager()->getMaterial(material);
     thick = thickness;
     
-    if((bpt == BodyPhysicsType::SUBMERGED || bpt == BodyPhysicsType::FLOATING) && !SimulationApp::getApp()->getSimulationManager()->isOceanEnabled())
+    if((bpt == BodyPhysicsType::SUBMERGED || bpt == BodyPhysicsType::FLOATING) && !SimulationManager::getCurrent()->isOceanEnabled())
         phyType = BodyPhysicsType::SURFACE;
     else
         phyType = bpt;
@@ -83,8 +83,30 @@ SolidEntity::SolidEntity(std::string uniqueName, std::string material, BodyPhysi
     Tdl.setZero();
     Fdq.setZero();
     Tdq.setZero();
+    Fds.setZero();
+    Tds.setZero();
     Fda.setZero();
     Tda.setZero();
+    fdValid = false;
+    fdTime = Scalar(0);
+    fdRelativeVel.setZero();
+    fdAngularVel.setZero();
+    fdSubmergence = Scalar(0);
+    fdOrientation = Quaternion::getIdentity();
+    fdStats.computed = 0;
+    fdStats.reused = 0;
+    hydroModel = HydrodynamicsModel::GEOMETRY;
+    lumpedValid = false;
+    slpSettings.enabled = false;
+    slpSettings.linearVelocity = Scalar(0);
+    slpSettings.angularVelocity = Scalar(0);
+    slpSettings.settleTime = Scalar(0);
+    slpSettings.fluidVelocity = Scalar(0);
+    slpSettings.depth = Scalar(0);
+    slpFluidValid = false;
+    slpFluidVel.setZero();
+    slpDepth = Scalar(0);
+    slpRestTime = Scalar(0);
     filteredLinearVel.setZero();
     filteredAngularVel.setZero();
     linearAcc.setZero();
@@ -92,11 +114,11 @@ SolidEntity::SolidEntity(std::string uniqueName, std::string material, BodyPhysi
     
     //Set pointers
     multibodyCollider = nullptr;
+    mbVelocityCached = false;
     phyMesh = nullptr;
     graObjectId = -1;
     phyObjectId = -1;
     dm = DisplayMode::GRAPHICAL;
-    submerged.type = RenderableType::HYDRO_LINES;
 }
 
 SolidEntity::~SolidEntity()
@@ -205,44 +227,45 @@ void SolidEntity::getAABB(Vector3& min, Vector3& max)
     }
 }
 
-std::vector<Renderable> SolidEntity::Render()
+void SolidEntity::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
-    
     if( (rigidBody != nullptr || multibodyCollider != nullptr)  && isRenderable() )
     {
         Renderable item;
         item.type = RenderableType::SOLID;
-        item.materialName = mat.name;
+        item.materialId = mat.id;
         
         if(dm == DisplayMode::GRAPHICAL && graObjectId >= 0)
         {
             item.objectId = graObjectId;
             item.lookId = lookId;
             item.model = glMatrixFromTransform(getGTransform());
-            items.push_back(item);
+            queue.Add(item);
         }
         else if(dm == DisplayMode::PHYSICAL && phyObjectId >= 0)
         {
             item.objectId = phyObjectId;
             item.lookId = -1;
             item.model = glMatrixFromTransform(getCTransform());
-            items.push_back(item);
+            queue.Add(item);
         }
         
         item.type = RenderableType::SOLID_CS;
         item.model = glMatrixFromTransform(getCGTransform());
-        items.push_back(item);
+        queue.Add(item);
         
         //Hydrodynamics
         Vector3 cbWorld = getCGTransform() * P_CB;
         item.type = RenderableType::HYDRO_CS;
         item.model = glMatrixFromTransform(Transform(Quaternion::getIdentity(), cbWorld));
-        items.push_back(item);
+        queue.Add(item);
 
         //Surface crossing debug
-        //submerged.model = glMatrixFromTransform(sf::I4());
-        //items.push_back(submerged);
+        //item.type = RenderableType::HYDRO_LINES;
+        //item.model = glMatrixFromTransform(sf::I4());
+        //queue.BeginPoints(item);
+        //queue.AddPoints(item, submerged);
+        //queue.Add(item);
 
         //Geometry approximation
         switch(fdApproxType)
@@ -253,48 +276,51 @@ std::vector<Renderable> SolidEntity::Render()
             case  GeometryApproxType::SPHERE:
                 item.type = RenderableType::HYDRO_ELLIPSOID;
                 item.model = glMatrixFromTransform(getHTransform());
-                item.points.push_back(glm::vec3((GLfloat)fdApproxParams[0], (GLfloat)fdApproxParams[0], (GLfloat)fdApproxParams[0]));
-                items.push_back(item);
+                queue.BeginPoints(item);
+                queue.AddPoint(item, glm::vec3((GLfloat)fdApproxParams[0], (GLfloat)fdApproxParams[0], (GLfloat)fdApproxParams[0]));
+                queue.Add(item);
                 break;
                 
             case  GeometryApproxType::CYLINDER:
                 item.type = RenderableType::HYDRO_CYLINDER;
                 item.model = glMatrixFromTransform(getHTransform());
-                item.points.push_back(glm::vec3((GLfloat)fdApproxParams[0], (GLfloat)fdApproxParams[0], (GLfloat)fdApproxParams[1]));
-                items.push_back(item);
+                queue.BeginPoints(item);
+                queue.AddPoint(item, glm::vec3((GLfloat)fdApproxParams[0], (GLfloat)fdApproxParams[0], (GLfloat)fdApproxParams[1]));
+                queue.Add(item);
                 break;
                 
             case  GeometryApproxType::ELLIPSOID:
                 item.type = RenderableType::HYDRO_ELLIPSOID;
                 item.model = glMatrixFromTransform(getHTransform());
-                item.points.push_back(glm::vec3((GLfloat)fdApproxParams[0], (GLfloat)fdApproxParams[1], (GLfloat)fdApproxParams[2]));
-                items.push_back(item);
+                queue.BeginPoints(item);
+                queue.AddPoint(item, glm::vec3((GLfloat)fdApproxParams[0], (GLfloat)fdApproxParams[1], (GLfloat)fdApproxParams[2]));
+                queue.Add(item);
                 break;
         }
 
         //Forces
         Vector3 cg = getCGTransform().getOrigin();
         glm::vec3 cgv((GLfloat)cg.x(), (GLfloat)cg.y(), (GLfloat)cg.z());
-        item.points.clear();
-        item.points.push_back(cgv);
         item.model = glm::mat4(1.f);
         
         item.type = RenderableType::FORCE_BUOYANCY;
-        item.points.push_back(cgv + glm::vec3((GLfloat)Fb.x(), (GLfloat)Fb.y(), (GLfloat)Fb.z())/1000.f);
-        items.push_back(item);
+        queue.BeginPoints(item);
+        queue.AddPoint(item, cgv);
+        queue.AddPoint(item, cgv + glm::vec3((GLfloat)Fb.x(), (GLfloat)Fb.y(), (GLfloat)Fb.z())/1000.f);
+        queue.Add(item);
         
-        item.points.pop_back();
         item.type = RenderableType::FORCE_LINEAR_DRAG;
-        item.points.push_back(cgv + glm::vec3((GLfloat)Fdl.x(), (GLfloat)Fdl.y(), (GLfloat)Fdl.z()));
-        items.push_back(item);
+        queue.BeginPoints(item);
+        queue.AddPoint(item, cgv);
+        queue.AddPoint(item, cgv + glm::vec3((GLfloat)Fdl.x(), (GLfloat)Fdl.y(), (GLfloat)Fdl.z()));
+        queue.Add(item);
         
-        item.points.pop_back();
         item.type = RenderableType::FORCE_QUADRATIC_DRAG;
-        item.points.push_back(cgv + glm::vec3((GLfloat)Fdq.x(), (GLfloat)Fdq.y(), (GLfloat)Fdq.z()));
-        items.push_back(item);
+        queue.BeginPoints(item);
+        queue.AddPoint(item, cgv);
+        queue.AddPoint(item, cgv + glm::vec3((GLfloat)Fdq.x(), (GLfloat)Fdq.y(), (GLfloat)Fdq.z()));
+        queue.Add(item);
     }
-    
-    return items;
 }
     
 Transform SolidEntity::getCG2GTransform() const
@@ -388,6 +414,9 @@ Vector3 SolidEntity::getLinearVelocity() const
     }
     else if(multibodyCollider != nullptr)
     {
+        if(mbVelocityCached)
+            return mbLinearVel;
+        
         //Get multibody and link id
         btMultiBody* multiBody = multibodyCollider->m_multiBody;
         int index = multibodyCollider->m_link;
@@ -439,6 +468,9 @@ Vector3 SolidEntity::getAngularVelocity() const
     }
     else if(multibodyCollider != nullptr)
     {
+        if(mbVelocityCached)
+            return mbAngularVel;
+        
         //Get multibody and link id
         btMultiBody* multiBody = multibodyCollider->m_multiBody;
         int index = multibodyCollider->m_link;
@@ -533,6 +565,35 @@ Vector3 SolidEntity::getAddedInertia() const
     return aI;
 }
 
+void SolidEntity::setAddedMass(const Vector3& addedMass, const Vector3& addedInertia)
+{
+    aMass = addedMass;
+    aI = addedInertia;
+}
+
+void SolidEntity::setHydrodynamicsModel(HydrodynamicsModel model)
+{
+    hydroModel = model;
+    fdValid = false;
+}
+
+HydrodynamicsModel SolidEntity::getHydrodynamicsModel() const
+{
+    return hydroModel;
+}
+
+void SolidEntity::setLumpedHydrodynamics(const LumpedHydrodynamics& coeffs)
+{
+    lumped = coeffs;
+    lumpedValid = true;
+    fdValid = false;
+}
+
+LumpedHydrodynamics SolidEntity::getLumpedHydrodynamics() const
+{
+    return lumped;
+}
+
 Scalar SolidEntity::getAugmentedMass() const
 {
     if(phyType == BodyPhysicsType::SUBMERGED)
@@ -618,7 +679,7 @@ void SolidEntity::ComputeSphericalApprox()
     
     Scalar rho = Scalar(1000);
     Ocean* ocn;
-    if((ocn = SimulationApp::getApp()->getSimulationManager()->getOcean()) != nullptr)
+    if((ocn = SimulationManager::getCurrent()->getOcean()) != nullptr)
         rho = ocn->getLiquid().density;
 
     Scalar m = Scalar(2)*M_PI*rho*r*r*r/Scalar(3);
@@ -701,7 +762,7 @@ void SolidEntity::ComputeCylindricalApprox()
     //Added mass and inertia
     Scalar rho = Scalar(1000);
     Ocean* ocn;
-    if((ocn = SimulationApp::getApp()->getSimulationManager()->getOcean()) != nullptr)
+    if((ocn = SimulationManager::getCurrent()->getOcean()) != nullptr)
         rho = ocn->getLiquid().density;
 
     Scalar m1 = rho*M_PI*fdApproxParams[0]*fdApproxParams[0]; //Parallel to axis
@@ -911,7 +972,7 @@ void SolidEntity::ComputeEllipsoidalApprox()
     //Compute added mass
     Scalar rho = Scalar(1000);
     Ocean* ocn;
-    if((ocn = SimulationApp::getApp()->getSimulationManager()->getOcean()) != nullptr)
+    if((ocn = SimulationManager::getCurrent()->getOcean()) != nullptr)
         rho = ocn->getLiquid().density;
 
     Scalar r12 = (fdApproxParams[1] + fdApproxParams[2])/Scalar(2);
@@ -1098,14 +1159,131 @@ void SolidEntity::UpdateAcceleration(Scalar dt)
 
 void SolidEntity::ApplyGravity(const Vector3& g)
 {
-    if(rigidBody != nullptr)
+    if(rigidBody != nullptr && !isSleeping())
     {
         rigidBody->applyCentralForce(g * mass);
     }
 }
 
+void SolidEntity::SetSleepingProperties(const SleepingSettings& settings)
+{
+    slpSettings = settings;
+    slpFluidValid = false;
+    slpRestTime = Scalar(0);
+    
+    if(rigidBody != nullptr)
+    {
+        rigidBody->setSleepingThresholds(settings.linearVelocity, settings.angularVelocity);
+        rigidBody->forceActivationState(settings.enabled ? ACTIVE_TAG : DISABLE_DEACTIVATION);
+        rigidBody->setDeactivationTime(Scalar(0));
+    }
+    else if(multibodyCollider != nullptr)
+    {
+        multibodyCollider->forceActivationState(settings.enabled ? ACTIVE_TAG : DISABLE_DEACTIVATION);
+        multibodyCollider->setDeactivationTime(Scalar(0));
+    }
+}
+
+bool SolidEntity::isSleeping() const
+{
+    if(rigidBody != nullptr)
+        return rigidBody->getActivationState() == ISLAND_SLEEPING;
+    else if(multibodyCollider != nullptr)
+        return multibodyCollider->getActivationState() == ISLAND_SLEEPING;
+    else
+        return false;
+}
+
+void SolidEntity::WakeUp()
+{
+    if(!isSleeping())
+        return;
+    
+    if(rigidBody != nullptr)
+        rigidBody->activate();
+    else if(multibodyCollider != nullptr) //The whole multibody has to wake up
+    {
+        multibodyCollider->m_multiBody->wakeUp();
+        multibodyCollider->activate();
+    }
+    
+    slpFluidValid = false;
+    fdValid = false;
+}
+
+void SolidEntity::UpdateSleeping()
+{
+    //Multibody links use the sleep timeout of the multibody
+    if(rigidBody == nullptr || !slpSettings.enabled || isSleeping())
+    {
+        slpRestTime = Scalar(0);
+        return;
+    }
+    
+    //Bullet accumulates the deactivation time in the steps in which the body is below the thresholds.
+    //It is consumed every step so that only the settle time of this body decides (the global Bullet timeout is never reached).
+    Scalar dt = rigidBody->getDeactivationTime();
+    rigidBody->setDeactivationTime(Scalar(0));
+    
+    if(dt > Scalar(0))
+        slpRestTime += dt;
+    else
+        slpRestTime = Scalar(0);
+    
+    if(slpRestTime > slpSettings.settleTime)
+        rigidBody->setActivationState(WANTS_DEACTIVATION);
+}
+
+bool SolidEntity::CheckSleeping(Ocean* ocn)
+{
+    if(!isSleeping())
+    {
+        slpFluidValid = false;
+        return false;
+    }
+    
+    Vector3 p = getCGTransform().getOrigin();
+    return CheckSleeping(ocn->GetFluidVelocity(p), ocn->GetDepth(p));
+}
+
+bool SolidEntity::CheckSleeping(Atmosphere* atm)
+{
+    if(!isSleeping())
+    {
+        slpFluidValid = false;
+        return false;
+    }
+    
+    return CheckSleeping(atm->GetFluidVelocity(getCGTransform().getOrigin()), Scalar(0));
+}
+
+bool SolidEntity::CheckSleeping(const Vector3& fluidVelocity, Scalar depth)
+{
+    //Remember the state of the fluid when the body fell asleep
+    if(!slpFluidValid)
+    {
+        slpFluidVel = fluidVelocity;
+        slpDepth = depth;
+        slpFluidValid = true;
+        return true;
+    }
+    
+    //Wake up if the current or the waves changed
+    if((fluidVelocity - slpFluidVel).length() > slpSettings.fluidVelocity
+       || btFabs(depth - slpDepth) > slpSettings.depth)
+    {
+        WakeUp();
+        return false;
+    }
+    
+    return true;
+}
+
 void SolidEntity::ApplyCentralForce(const Vector3& force)
 {
+    if(!force.fuzzyZero())
+        WakeUp();
+    
     if(rigidBody != nullptr)
         rigidBody->applyCentralForce(force);
     else if(multibodyCollider != nullptr)
@@ -1122,6 +1300,9 @@ void SolidEntity::ApplyCentralForce(const Vector3& force)
 
 void SolidEntity::ApplyTorque(const Vector3& torque)
 {
+    if(!torque.fuzzyZero())
+        WakeUp();
+    
     if(rigidBody != nullptr)
         rigidBody->applyTorque(torque);
     else if(multibodyCollider != nullptr)
@@ -1142,15 +1323,21 @@ BodyFluidPosition SolidEntity::CheckBodyFluidPosition(Ocean* ocn)
     getAABB(aabbMin, aabbMax);
     Vector3 d = aabbMax-aabbMin;
     
+    Vector3 corners[8];
+    corners[0] = aabbMin;
+    corners[1] = aabbMax;
+    corners[2] = aabbMin + Vector3(d.x(), 0, 0);
+    corners[3] = aabbMin + Vector3(0, d.y(), 0);
+    corners[4] = aabbMin + Vector3(d.x(), d.y(), 0);
+    corners[5] = aabbMin + Vector3(0, 0, d.z());
+    corners[6] = aabbMin + Vector3(d.x(), 0, d.z());
+    corners[7] = aabbMin + Vector3(0, d.y(), d.z());
+    Scalar depths[8];
+    ocn->GetDepth(corners, 8, depths);
+    
     unsigned int submerged = 0;
-    if(ocn->GetDepth(aabbMin) > Scalar(0)) ++submerged;
-    if(ocn->GetDepth(aabbMax) > Scalar(0)) ++submerged;
-    if(ocn->GetDepth(aabbMin + Vector3(d.x(), 0, 0)) > Scalar(0)) ++submerged;
-    if(ocn->GetDepth(aabbMin + Vector3(0, d.y(), 0)) > Scalar(0)) ++submerged;
-    if(ocn->GetDepth(aabbMin + Vector3(d.x(), d.y(), 0)) > Scalar(0)) ++submerged;
-    if(ocn->GetDepth(aabbMin + Vector3(0, 0, d.z())) > Scalar(0)) ++submerged;
-    if(ocn->GetDepth(aabbMin + Vector3(d.x(), 0, d.z())) > Scalar(0)) ++submerged;
-    if(ocn->GetDepth(aabbMin + Vector3(0, d.y(), d.z())) > Scalar(0)) ++submerged;
+    for(unsigned int i=0; i<8; ++i)
+        if(depths[i] > Scalar(0)) ++submerged;
     
     if(submerged == 0)
         return BodyFluidPosition::OUTSIDE;
@@ -1199,7 +1386,8 @@ void SolidEntity::CorrectHydrodynamicForces(Ocean* ocn, Vector3& _Fdl, Vector3&
 }
 
 void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings& settings, const Mesh* mesh, Ocean* ocn, const Transform& T_CG, const Transform& T_C,
-                                            const Vector3& _v, const Vector3& _omega, Vector3& _Fb, Vector3& _Tb, Vector3& _Fdl, Vector3& _Tdl, Vector3& _Fdq, Vector3& _Tdq, Vector3& _Fds, Vector3& _Tds, Renderable& debug)
+                                            const Vector3& _v, const Vector3& _omega, Vector3& _Fb, Vector3& _Tb, Vector3& _Fdl, Vector3& _Tdl, Vector3& _Fdq, Vector3& _Tdq, Vector3& _Fds, Vector3& _Tds,
+                                            VertexDepthCache& cache, std::vector<glm::vec3>& debug)
 {
     if(mesh == nullptr)
     {
@@ -1232,29 +1420,29 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
     glm::vec3 Fds(0.f);
     glm::vec3 Tds(0.f);
     glm::mat4 TCG = glMatrixFromTransform(T_CG);
-    glm::mat4 TC = glMatrixFromTransform(T_C);
     glm::vec3 v = glVectorFromVector(_v);
     glm::vec3 omega = glVectorFromVector(_omega);
    
     //Calculate fluid dynamics forces and torques
     glm::vec3 p = glm::vec3(TCG[3]);
     
+    //Global coordinates and depths of vertices (shared vertices are evaluated once)
+    UpdateVertexDepths(mesh, ocn, T_C, cache);
+    
     //Loop through all faces...
     for(size_t i=0; i<mesh->faces.size(); ++i)
     {
         //Global coordinates
-        glm::vec3 p1gl = mesh->getVertexPos(i, 0);
-        glm::vec3 p2gl = mesh->getVertexPos(i, 1);
-        glm::vec3 p3gl = mesh->getVertexPos(i, 2);
-        glm::vec3 p1 = glm::vec3(TC * glm::vec4(p1gl, 1.f));
-        glm::vec3 p2 = glm::vec3(TC * glm::vec4(p2gl, 1.f));
-        glm::vec3 p3 = glm::vec3(TC * glm::vec4(p3gl, 1.f));
+        const Face& f = mesh->faces[i];
+        glm::vec3 p1 = cache.positions[f.vertexID[0]];
+        glm::vec3 p2 = cache.positions[f.vertexID[1]];
+        glm::vec3 p3 = cache.positions[f.vertexID[2]];
         
         //Check if face underwater
         GLfloat depth[3];
-        depth[0] = ocn->GetDepth(p1);
-        depth[1] = ocn->GetDepth(p2);
-        depth[2] = ocn->GetDepth(p3);
+        depth[0] = cache.depths[f.vertexID[0]];
+        depth[1] = cache.depths[f.vertexID[1]];
+        depth[2] = cache.depths[f.vertexID[2]];
         
         if(depth[0] < 0.f && depth[1] < 0.f && depth[2] < 0.f)
             continue;
@@ -1264,6 +1452,7 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
         glm::vec3 fn;
         glm::vec3 fn1;
         GLfloat A;
+        GLfloat depthc; //Depth of the face centroid (interpolated, cut vertices lie on the surface)
         
         if(depth[0] < 0.f) //Vertex 1 above water
         {
@@ -1272,6 +1461,7 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
                 p1 = p3 + (p1-p3) * (depth[2]/(fabsf(depth[0]) + depth[2]));
                 p2 = p3 + (p2-p3) * (depth[2]/(fabsf(depth[1]) + depth[2]));
                 //p3 without change
+                depthc = depth[2]/3.f;
                 
                 //Calculate
                 glm::vec3 fv1 = p2-p1; //One side of the face (triangle)
@@ -1285,12 +1475,12 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
                 fn1 = fn/len; //Normalised normal (length = 1)
                 A = len/2.f; //Area of the face (triangle)         
 #ifdef DEBUG_HYDRO
-                debug.points.push_back(p1);
-                debug.points.push_back(p2);
-                debug.points.push_back(p2);
-                debug.points.push_back(p3);
-                debug.points.push_back(p3);
-                debug.points.push_back(p1);
+                debug.push_back(p1);
+                debug.push_back(p2);
+                debug.push_back(p2);
+                debug.push_back(p3);
+                debug.push_back(p3);
+                debug.push_back(p1);
 #endif
             }
             else if(depth[2] < 0.f) //Two vertices above water (triangle)
@@ -1298,6 +1488,7 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
                 p1 = p2 + (p1-p2) * (depth[1]/(fabsf(depth[0]) + depth[1]));
                 //p2 without change
                 p3 = p2 + (p3-p2) * (depth[1]/(fabsf(depth[2]) + depth[1]));
+                depthc = depth[1]/3.f;
                 
                 //Calculate
                 glm::vec3 fv1 = p2-p1; //One side of the face (triangle)
@@ -1311,12 +1502,12 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
                 fn1 = fn/len; //Normalised normal (length = 1)
                 A = len/2.f; //Area of the face (triangle)         
 #ifdef DEBUG_HYDRO
-                debug.points.push_back(p1);
-                debug.points.push_back(p2);
-                debug.points.push_back(p2);
-                debug.points.push_back(p3);
-                debug.points.push_back(p3);
-                debug.points.push_back(p1);
+                debug.push_back(p1);
+                debug.push_back(p2);
+                debug.push_back(p2);
+                debug.push_back(p3);
+                debug.push_back(p3);
+                debug.push_back(p1);
 #endif
             }
             else //depth[1] >= 0 && depth[2] >= 0 --> Two vertices under water (quad = two triangles)
@@ -1326,6 +1517,7 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
                 p1 = p2 + (p1-p2) * (depth[1]/(fabsf(depth[0]) + depth[1]));
                 //p2 without change
                 //p3 without change
+                depthc = (depth[1] + depth[2])/4.f;
                 
                 //Calculate
                 glm::vec3 fv1 = p2-p1;
@@ -1342,14 +1534,14 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
                 A = (len + glm::length(glm::cross(fv3, fv4)))/2.f; //Quad
                 fn = fn1 * A;
 #ifdef DEBUG_HYDRO
-                debug.points.push_back(p1);
-                debug.points.push_back(p2);
-                debug.points.push_back(p2);
-                debug.points.push_back(p3);
-                debug.points.push_back(p3);
-                debug.points.push_back(p4);
-                debug.points.push_back(p4);
-                debug.points.push_back(p1);
+                debug.push_back(p1);
+                debug.push_back(p2);
+                debug.push_back(p2);
+                debug.push_back(p3);
+                debug.push_back(p3);
+                debug.push_back(p4);
+                debug.push_back(p4);
+                debug.push_back(p1);
 #endif  
             }
         }
@@ -1360,6 +1552,7 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
                 //p1 without change
                 p2 = p1 + (p2-p1) * (depth[0]/(fabsf(depth[1]) + depth[0]));
                 p3 = p1 + (p3-p1) * (depth[0]/(fabsf(depth[2]) + depth[0]));
+                depthc = depth[0]/3.f;
                 
                 //Calculate
                 glm::vec3 fv1 = p2-p1; //One side of the face (triangle)
@@ -1373,12 +1566,12 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
                 fn1 = fn/len; //Normalised normal (length = 1)
                 A = len/2.f; //Area of the face (triangle)
 #ifdef DEBUG_HYDRO
-                debug.points.push_back(p1);
-                debug.points.push_back(p2);
-                debug.points.push_back(p2);
-                debug.points.push_back(p3);
-                debug.points.push_back(p3);
-                debug.points.push_back(p1);
+                debug.push_back(p1);
+                debug.push_back(p2);
+                debug.push_back(p2);
+                debug.push_back(p3);
+                debug.push_back(p3);
+                debug.push_back(p1);
 #endif                
             }
             else
@@ -1388,6 +1581,7 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
                 //p1 without change
                 p2 = p1 + (p2-p1) * (depth[0]/(fabsf(depth[1]) + depth[0]));
                 //p3 without change
+                depthc = (depth[0] + depth[2])/4.f;
                 
                 //Calculate
                 glm::vec3 fv1 = p2-p1;
@@ -1403,14 +1597,14 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
                 A = (len + glm::length(glm::cross(fv3, fv4)))/2.f; //Quad
                 fn = fn1 * A;
 #ifdef DEBUG_HYDRO
-                debug.points.push_back(p1);
-                debug.points.push_back(p2);
-                debug.points.push_back(p2);
-                debug.points.push_back(p4);
-                debug.points.push_back(p4);
-                debug.points.push_back(p3);
-                debug.points.push_back(p3);
-                debug.points.push_back(p1);
+                debug.push_back(p1);
+                debug.push_back(p2);
+                debug.push_back(p2);
+                debug.push_back(p4);
+                debug.push_back(p4);
+                debug.push_back(p3);
+                debug.push_back(p3);
+                debug.push_back(p1);
 #endif                 
             }
         }
@@ -1421,6 +1615,7 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
             //p1 without change
             //p2 without change
             p3 = p2 + (p3-p2) * (depth[1]/(fabsf(depth[2]) + depth[1]));
+            depthc = (depth[0] + depth[1])/4.f;
                 
             //Calculate
             glm::vec3 fv1 = p2-p1;
@@ -1436,14 +1631,14 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
             A = (len + glm::length(glm::cross(fv3, fv4)))/2.f; //Quad
             fn = fn1 * A;
 #ifdef DEBUG_HYDRO
-            debug.points.push_back(p1);
-            debug.points.push_back(p2);
-            debug.points.push_back(p2);
-            debug.points.push_back(p3);
-            debug.points.push_back(p3);
-            debug.points.push_back(p4);
-            debug.points.push_back(p4);
-            debug.points.push_back(p1);
+            debug.push_back(p1);
+            debug.push_back(p2);
+            debug.push_back(p2);
+            debug.push_back(p3);
+            debug.push_back(p3);
+            debug.push_back(p4);
+            debug.push_back(p4);
+            debug.push_back(p1);
 #endif             
         }
         else //All underwater
@@ -1458,20 +1653,20 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
             fn1 = fn/len; //Normalised normal (length = 1)
             A = len/2.f; //Area of the face (triangle)
             fc = (p1+p2+p3)/3.f; //Face centroid
+            depthc = (depth[0] + depth[1] + depth[2])/3.f;
 #ifdef DEBUG_HYDRO
-            debug.points.push_back(p1);
-            debug.points.push_back(p2);
-            debug.points.push_back(p2);
-            debug.points.push_back(p3);
-            debug.points.push_back(p3);
-            debug.points.push_back(p1);
+            debug.push_back(p1);
+            debug.push_back(p2);
+            debug.push_back(p2);
+            debug.push_back(p3);
+            debug.push_back(p3);
+            debug.push_back(p1);
 #endif             
         }
         
         //Buoyancy force
         if(settings.reallisticBuoyancy)
         {
-            GLfloat depthc = ocn->GetDepth(fc);
             glm::vec3 Fbi = -fn1 * A * depthc; //Buoyancy force per face (based on pressure)        
             
             //Accumulate
@@ -1513,8 +1708,8 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
     //Buoyancy
     if(settings.reallisticBuoyancy)
     {
-        Fb *= ocn->getLiquid().density * SimulationApp::getApp()->getSimulationManager()->getGravity().getZ();
-        Tb *= ocn->getLiquid().density * SimulationApp::getApp()->getSimulationManager()->getGravity().getZ();
+        Fb *= ocn->getLiquid().density * SimulationManager::getCurrent()->getGravity().getZ();
+        Tb *= ocn->getLiquid().density * SimulationManager::getCurrent()->getGravity().getZ();
         _Fb = Vector3(Fb.x, Fb.y, Fb.z);
         _Tb = Vector3(Tb.x, Tb.y, Tb.z);
     }
@@ -1531,6 +1726,27 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
     }
 }
 
+void SolidEntity::UpdateVertexDepths(const Mesh* mesh, Ocean* ocn, const Transform& T_C, VertexDepthCache& cache)
+{
+    size_t nv = mesh->getNumOfVertices();
+    Scalar now = SimulationManager::getCurrent()->getSimulationTime();
+    
+    //Depths valid for the current step and pose
+    if(cache.time == now && cache.T_C == T_C && cache.depths.size() == nv)
+        return;
+    
+    //Transform every vertex once and query the wave field in a single batch
+    glm::mat4 TC = glMatrixFromTransform(T_C);
+    cache.positions.resize(nv);
+    cache.depths.resize(nv);
+    for(size_t i=0; i<nv; ++i)
+        cache.positions[i] = glm::vec3(TC * glm::vec4(mesh->getVertexPos(i), 1.f));
+    ocn->GetDepth(cache.positions.data(), nv, cache.depths.data());
+    
+    cache.time = now;
+    cache.T_C = T_C;
+}
+
 void SolidEntity::ComputeHydrodynamicForcesSubmerged(const Mesh* mesh, Ocean* ocn, const Transform& T_CG, const Transform& T_C,
                                               const Vector3& _v, const Vector3& _omega, Vector3& _Fdl, Vector3& _Tdl, Vector3& _Fdq, Vector3& _Tdq, Vector3& _Fds, Vector3& _Tds)
 {
@@ -1621,8 +1837,14 @@ void SolidEntity::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocea
 {
     if(phyType != BodyPhysicsType::FLOATING && phyType != BodyPhysicsType::SUBMERGED) return;
     
+    if(hydroModel == HydrodynamicsModel::LUMPED)
+    {
+        ComputeHydrodynamicForcesLumped(settings, ocn);
+        return;
+    }
+    
 #ifdef DEBUG
-    submerged.points.clear();
+    submerged.clear();
 #endif
     
     BodyFluidPosition bf = CheckBodyFluidPosition(ocn);
@@ -1651,7 +1873,7 @@ void SolidEntity::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocea
         //Compute buoyancy based on CB position
         if(isBuoyant())
         {
-            Fb = -volume*ocn->getLiquid().density * SimulationApp::getApp()->getSimulationManager()->getGravity();
+            Fb = -volume*ocn->getLiquid().density * SimulationManager::getCurrent()->getGravity();
             Tb = (getCGTransform() * P_CB - getCGTransform().getOrigin()).cross(Fb);
         }
         
@@ -1661,13 +1883,224 @@ void SolidEntity::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocea
     else //CROSSING_FLUID_SURFACE
     {
         if(!isBuoyant()) settings.reallisticBuoyancy = false;
-        ComputeHydrodynamicForcesSurface(settings, getPhysicsMesh(), ocn, getCGTransform(), getCTransform(), v, omega, Fb, Tb, Fdl, Tdl, Fdq, Tdq, Fds, Tds, submerged);
+        ComputeHydrodynamicForcesSurface(settings, getPhysicsMesh(), ocn, getCGTransform(), getCTransform(), v, omega, Fb, Tb, Fdl, Tdl, Fdq, Tdq, Fds, Tds, depthCache, submerged);
     }
     
     if(settings.dampingForces)
         CorrectHydrodynamicForces(ocn, Fdl, Tdl, Fdq, Tdq, Fds, Tds);
 }
 
+void SolidEntity::ComputeHydrodynamicForcesLumped(HydrodynamicsSettings settings, Ocean* ocn)
+{
+    if(phyType != BodyPhysicsType::FLOATING && phyType != BodyPhysicsType::SUBMERGED) return;
+    
+    BodyFluidPosition bf = CheckBodyFluidPosition(ocn);
+    
+    //Skin friction is included in the quadratic damping
+    Fds.setZero();
+    Tds.setZero();
+    
+    //If completely outside fluid just set all torques and forces to 0
+    if(bf == BodyFluidPosition::OUTSIDE)
+    {
+        Fb.setZero();
+        Tb.setZero();
+        Fdl.setZero();
+        Tdl.setZero();
+        Fdq.setZero();
+        Tdq.setZero();
+        return;
+    }
+    
+    Scalar submergence = bf == BodyFluidPosition::INSIDE ? Scalar(1) : EstimateSubmergence(ocn);
+    Transform T_CG = getCGTransform();
+    Matrix3 R = T_CG.getBasis();
+    
+    //Restoring force (buoyancy acting in the CB, scaled by the submerged fraction of the body)
+    if(isBuoyant())
+    {
+        Fb = -volume*submergence*ocn->getLiquid().density * SimulationManager::getCurrent()->getGravity();
+        Tb = (R * P_CB).cross(Fb);
+    }
+    else
+    {
+        Fb.setZero();
+        Tb.setZero();
+    }
+    
+    if(!settings.dampingForces)
+    {
+        Fdl.setZero();
+        Tdl.setZero();
+        Fdq.setZero();
+        Tdq.setZero();
+        return;
+    }
+    
+    if(!lumpedValid)
+        DeriveLumpedHydrodynamics(ocn);
+    
+    //Damping computed in the CG frame, based on the velocity relative to the fluid at the CG
+    Vector3 v = R.transpose() * (getLinearVelocity() - ocn->GetFluidVelocity(T_CG.getOrigin()));
+    Vector3 omega = R.transpose() * getAngularVelocity();
+    
+    Fdl = R * (-submergence * lumped.linearDampingF * v);
+    Tdl = R * (-submergence * lumped.linearDampingT * omega);
+    Fdq = R * (-submergence * lumped.quadraticDampingF * v.absolute() * v);
+    Tdq = R * (-submergence * lumped.quadraticDampingT * omega.absolute() * omega);
+}
+
+void SolidEntity::DeriveLumpedHydrodynamics(Ocean* ocn)
+{
+    lumped = LumpedHydrodynamics();
+    AccumulateLumpedHydrodynamics(getPhysicsMesh(), T_CG2C, this, ocn, lumped);
+    lumpedValid = true;
+    
+    cInfo("Lumped hydrodynamics of '%s' derived: linear damping %1.3lf, %1.3lf, %1.3lf, %1.3lf, %1.3lf, %1.3lf; quadratic damping %1.3lf, %1.3lf, %1.3lf, %1.3lf, %1.3lf, %1.3lf",
+          getName().c_str(),
+          lumped.linearDampingF.x(), lumped.linearDampingF.y(), lumped.linearDampingF.z(),
+          lumped.linearDampingT.x(), lumped.linearDampingT.y(), lumped.linearDampingT.z(),
+          lumped.quadraticDampingF.x(), lumped.quadraticDampingF.y(), lumped.quadraticDampingF.z(),
+          lumped.quadraticDampingT.x(), lumped.quadraticDampingT.y(), lumped.quadraticDampingT.z());
+}
+
+void SolidEntity::AccumulateLumpedHydrodynamics(const Mesh* mesh, const Transform& T_CG2C, SolidEntity* corrector, Ocean* ocn, LumpedHydrodynamics& coeffs)
+{
+    if(mesh == nullptr) return;
+    
+    //Forces induced by a unit velocity along each degree of freedom, with the fluid at rest (computed in the CG frame)
+    glm::vec3 Fl[6], Tl[6], Fq[6], Tq[6], Fs[6], Ts[6];
+    for(unsigned int k=0; k<6; ++k)
+        Fl[k] = Tl[k] = Fq[k] = Tq[k] = Fs[k] = Ts[k] = glm::vec3(0.f);
+    glm::mat4 TC = glMatrixFromTransform(T_CG2C);
+    
+    //Loop through all faces...
+    for(size_t i=0; i<mesh->faces.size(); ++i)
+    {
+        glm::vec3 p1 = glm::vec3(TC * glm::vec4(mesh->getVertexPos(i, 0), 1.f));
+        glm::vec3 p2 = glm::vec3(TC * glm::vec4(mesh->getVertexPos(i, 1), 1.f));
+        glm::vec3 p3 = glm::vec3(TC * glm::vec4(mesh->getVertexPos(i, 2), 1.f));
+        
+        //Face properties
+        glm::vec3 fn = glm::cross(p2-p1, p3-p1); //Normal of the face (length != 1)
+        GLfloat len = glm::length2(fn);
+        if(len < 1e-12f) continue;
+        len = glm::sqrt(len);
+        glm::vec3 fn1 = fn/len; //Normalised normal (length = 1)
+        GLfloat A = len/2.f; //Area of the face (triangle)
+        glm::vec3 fc = (p1+p2+p3)/3.f; //Face centroid
+        
+        for(unsigned int k=0; k<6; ++k)
+        {
+            glm::vec3 e(0.f);
+            e[k % 3] = 1.f;
+            glm::vec3 vc = k < 3 ? -e : -glm::cross(e, fc); //Fluid velocity relative to the face
+            glm::vec3 vn = glm::dot(vc, fn1) * fn1; //Normal velocity
+            glm::vec3 vt = vc - vn; //Tangent velocity
+            
+            if(glm::dot(fn1, vn) < -1e-12f)
+            {
+                glm::vec3 linear = vn * A; //Low velocity limit of the linear drag
+                glm::vec3 quadratic = vn * glm::length(vn) * A;
+                
+                Fl[k] += linear;
+                Tl[k] += glm::cross(fc, linear);
+                Fq[k] += quadratic;
+                Tq[k] += glm::cross(fc, quadratic);
+            }
+            
+            glm::vec3 skin = vt * glm::length(vt) * A;
+            Fs[k] += skin;
+            Ts[k] += glm::cross(fc, skin);
+        }
+    }
+    
+    //Damping coefficients are the opposites of the force components along the degrees of freedom
+    for(unsigned int k=0; k<6; ++k)
+    {
+        Vector3 Fdl(Fl[k].x, Fl[k].y, Fl[k].z);
+        Vector3 Tdl(Tl[k].x, Tl[k].y, Tl[k].z);
+        Vector3 Fdq(Fq[k].x, Fq[k].y, Fq[k].z);
+        Vector3 Tdq(Tq[k].x, Tq[k].y, Tq[k].z);
+        Vector3 Fds(Fs[k].x, Fs[k].y, Fs[k].z);
+        Vector3 Tds(Ts[k].x, Ts[k].y, Ts[k].z);
+        corrector->CorrectHydrodynamicForces(ocn, Fdl, Tdl, Fdq, Tdq, Fds, Tds);
+        
+        if(k < 3)
+        {
+            coeffs.linearDampingF[k] -= Fdl[k];
+            coeffs.quadraticDampingF[k] -= Fdq[k] + Fds[k];
+        }
+        else
+        {
+            coeffs.linearDampingT[k-3] -= Tdl[k-3];
+            coeffs.quadraticDampingT[k-3] -= Tdq[k-3] + Tds[k-3];
+        }
+    }
+}
+
+Scalar SolidEntity::EstimateSubmergence(Ocean* ocn)
+{
+    //Estimate the submerged fraction of the body height
+    Vector3 aabbMin, aabbMax;
+    getAABB(aabbMin, aabbMax);
+    Scalar height = aabbMax.getZ() - aabbMin.getZ();
+    Vector3 bottom = getCGTransform().getOrigin();
+    bottom.setZ(aabbMax.getZ());
+    Scalar submergence = height > Scalar(0) ? ocn->GetDepth(bottom)/height : Scalar(1);
+    return submergence < Scalar(0) ? Scalar(0) : (submergence > Scalar(1) ? Scalar(1) : submergence);
+}
+
+bool SolidEntity::IsFluidDynamicsOutdated(const Vector3& fluidVelocity, Scalar submergence, const FluidDynamicsTolerances& tol)
+{
+    Scalar now = SimulationManager::getCurrent()->getSimulationTime();
+    Vector3 relativeVel = getLinearVelocity() - fluidVelocity;
+    Vector3 angularVel = getAngularVelocity();
+    Quaternion orientation = getCGTransform().getRotation();
+    
+    if(fdValid
+       && now >= fdTime && now - fdTime < tol.maxAge
+       && (relativeVel - fdRelativeVel).length() <= tol.linearVelocity
+       && (angularVel - fdAngularVel).length() <= tol.angularVelocity
+       && btFabs(submergence - fdSubmergence) <= tol.submergence
+       && btFabs(orientation.angleShortestPath(fdOrientation)) <= tol.orientation)
+    {
+        ++fdStats.reused;
+        return false;
+    }
+    
+    fdValid = true;
+    fdTime = now;
+    fdRelativeVel = relativeVel;
+    fdAngularVel = angularVel;
+    fdSubmergence = submergence;
+    fdOrientation = orientation;
+    ++fdStats.computed;
+    return true;
+}
+
+void SolidEntity::UpdateHydrodynamicForces(HydrodynamicsSettings settings, Ocean* ocn, const FluidDynamicsTolerances& tol)
+{
+    if(phyType != BodyPhysicsType::FLOATING && phyType != BodyPhysicsType::SUBMERGED) return;
+    
+    Scalar submergence = EstimateSubmergence(ocn);
+    if(IsFluidDynamicsOutdated(ocn->GetFluidVelocity(getCGTransform().getOrigin()), submergence, tol))
+        ComputeHydrodynamicForces(settings, ocn);
+}
+
+void SolidEntity::UpdateAerodynamicForces(Atmosphere* atm, const FluidDynamicsTolerances& tol)
+{
+    if(phyType != BodyPhysicsType::AERODYNAMIC) return;
+    
+    if(IsFluidDynamicsOutdated(atm->GetFluidVelocity(getCGTransform().getOrigin()), Scalar(0), tol))
+        ComputeAerodynamicForces(atm);
+}
+
+FluidDynamicsStatistics SolidEntity::getFluidDynamicsStatistics() const
+{
+    return fdStats;
+}
+
 void SolidEntity::ComputeAerodynamicForces(Atmosphere* atm)
 {
     if(phyType != BodyPhysicsType::AERODYNAMIC) return;
@@ -35,7 +35,7 @@ namespace sf
 
 StaticEntity::StaticEntity(std::string uniqueName, std::string material, std::string look) : Entity(uniqueName)
 {
-    mat = SimulationApp::getApp()->getSimulationManager()->getMaterialManager()->getMaterial(material);
+    mat = SimulationManager::getCurrent()->getMaterialManager()->getMaterial(material);
     if(SimulationApp::getApp()->hasGraphics())
         lookId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->getLookId(look);
     else
@@ -98,10 +98,8 @@ void StaticEntity::setDisplayMode(DisplayMode m)
     dm = m;
 }
 
-std::vector<Renderable> StaticEntity::Render()
+void StaticEntity::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
-    
     if(rigidBody != NULL && phyObjectId >= 0 && isRenderable())
     {
         Transform trans;
@@ -109,14 +107,12 @@ std::vector<Renderable> StaticEntity::Render()
         
         Renderable item;
         item.type = RenderableType::SOLID;
-        item.materialName = mat.name;
+        item.materialId = mat.id;
         item.objectId = phyObjectId;
         item.lookId = dm == DisplayMode::GRAPHICAL ? lookId : -1;
         item.model = glMatrixFromTransform(trans);
-        items.push_back(item);
+        queue.Add(item);
     }
-    
-    return items;
 }
 
 void StaticEntity::BuildGraphicalObject()
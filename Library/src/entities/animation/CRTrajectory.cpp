@@ -97,7 +97,7 @@ void CRTrajectory::BuildGraphicalPath()
         PWLTrajectory::BuildGraphicalPath();
     else
     {
-        path.points.clear();
+        path.clear();
         for(size_t i=0; i<points.size()-1; ++i)
         {
             Vector3 P1 = points[i].T.getOrigin();
@@ -135,9 +135,9 @@ void CRTrajectory::BuildGraphicalPath()
 
             Scalar dt = (t2-t1)/Scalar(100.0);
             for(Scalar t=t1; t<t2; t+=dt)
-                path.points.push_back(glVectorFromVector(catmullRom(P0, P1, P2, P3, t0, t1, t2, t3, t)));    
+                path.push_back(glVectorFromVector(catmullRom(P0, P1, P2, P3, t0, t1, t2, t3, t)));    
         }
-        path.points.push_back(glVectorFromVector(points.back().T.getOrigin()));
+        path.push_back(glVectorFromVector(points.back().T.getOrigin()));
     }
 }
 
@@ -31,8 +31,6 @@ namespace sf
 
 PWLTrajectory::PWLTrajectory(PlaybackMode playback) : Trajectory(playback)
 {
-    path.type = RenderableType::PATH_LINE_STRIP;
-    path.model = glm::mat4(1.f);    
     AddKeyPoint(Scalar(0), I4());
 }
 
@@ -97,14 +95,19 @@ void PWLTrajectory::Interpolate()
 
 void PWLTrajectory::BuildGraphicalPath()
 {
-    path.points.clear();
+    path.clear();
     for(size_t i=0; i<points.size(); ++i)
-        path.points.push_back(glVectorFromVector(points[i].T.getOrigin()));
+        path.push_back(glVectorFromVector(points[i].T.getOrigin()));
 }
 
-Renderable PWLTrajectory::Render()
+void PWLTrajectory::Render(DrawingQueue& queue)
 {
-    return path;
+    Renderable item;
+    item.type = RenderableType::PATH_LINE_STRIP;
+    item.model = glm::mat4(1.f);
+    queue.BeginPoints(item);
+    queue.AddPoints(item, path);
+    queue.Add(item);
 }
 
 }
\ No newline at end of file
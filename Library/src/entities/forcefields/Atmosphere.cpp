@@ -56,6 +56,14 @@ Atmosphere::~Atmosphere()
     
     if(glAtmosphere != NULL) 
         delete glAtmosphere;
+    
+    delete ghost->getCollisionShape();
+    delete ghost;
+}
+
+void Atmosphere::AddToSimulation(SimulationManager* sm)
+{
+    //The ghost is not added to the dynamics world, bodies inside the atmosphere are found by the simulation manager
 }
     
 OpenGLAtmosphere* Atmosphere::getOpenGLAtmosphere()
@@ -108,6 +116,7 @@ void Atmosphere::SetupSunPosition(Scalar azimuthDeg, Scalar elevationDeg)
 void Atmosphere::AddVelocityField(VelocityField* field)
 {
     wind.push_back(field);
+    windIndex.Build(wind);
 }
     
 void Atmosphere::GetSunPosition(Scalar &azimuthDeg, Scalar &elevationDeg)
@@ -125,10 +134,7 @@ void Atmosphere::GetSunPosition(Scalar &azimuthDeg, Scalar &elevationDeg)
 
 Vector3 Atmosphere::GetFluidVelocity(const Vector3& point) const
 {
-    Vector3 fv(0,0,0);
-    for(size_t i=0; i<wind.size(); ++i)
-        fv += wind[i]->GetVelocityAtPoint(point);
-    return fv;    
+    return windIndex.GetVelocityAtPoint(point);
 }
 
 glm::vec3 Atmosphere::GetFluidVelocity(const glm::vec3& point) const
@@ -141,7 +147,7 @@ bool Atmosphere::IsInsideFluid(const Vector3& point) const
     return true;
 }
 
-void Atmosphere::ApplyFluidForces(btDynamicsWorld* world, btCollisionObject* co, bool recompute)
+void Atmosphere::ApplyFluidForces(btDynamicsWorld* world, btCollisionObject* co, const FluidDynamicsTolerances& tol)
 {
     Entity* ent;
     btRigidBody* rb = btRigidBody::upcast(co);
@@ -166,10 +172,11 @@ void Atmosphere::ApplyFluidForces(btDynamicsWorld* world, btCollisionObject* co,
     
     if(ent->getType() == EntityType::SOLID)
     {
-        if(recompute)
-        {
-            ((SolidEntity*)ent)->ComputeAerodynamicForces(this);
-        }
+        //Sleeping bodies are skipped until the wind around them changes
+        if(((SolidEntity*)ent)->CheckSleeping(this))
+            return;
+        
+        ((SolidEntity*)ent)->UpdateAerodynamicForces(this, tol);
         
         ((SolidEntity*)ent)->ApplyAerodynamicForces();
     }
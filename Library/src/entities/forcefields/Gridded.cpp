@@ -0,0 +1,319 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  Gridded.cpp
+//  Stonefish
+//
+
+#include "entities/forcefields/Gridded.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "core/Console.h"
+#include "core/SimulationManager.h"
+
+#define MAX_AXIS_BINS       4096
+#define MAX_RENDERED_NODES  1000
+
+namespace sf
+{
+
+Gridded::Gridded(const std::vector<Scalar>& x, const std::vector<Scalar>& y, const std::vector<Scalar>& z,
+                 const std::vector<Scalar>& t, const std::vector<Vector3>& velocity, bool loop)
+{
+    this->loop = loop;
+    if(!Setup(x, y, z, t, velocity))
+        cError("Gridded velocity field could not be created!");
+}
+
+Gridded::Gridded(const std::string& path, bool loop)
+{
+    this->loop = loop;
+    
+    FILE* file = fopen(path.c_str(), "rb");
+    if(file == NULL)
+    {
+        cError("Failed to open velocity field file: %s", path.c_str());
+        return;
+    }
+    
+    //Read all numbers (comments start with '#')
+    std::vector<Scalar> data;
+    char line[4096];
+    while(fgets(line, 4096, file))
+    {
+        char* comment = strchr(line, '#');
+        if(comment != NULL)
+            *comment = '\0';
+        
+        char* start = line;
+        char* end;
+        while(true)
+        {
+            Scalar value = strtod(start, &end);
+            if(end == start)
+                break;
+            data.push_back(value);
+            start = end;
+        }
+    }
+    fclose(file);
+    
+    //Parse: dimensions, node coordinates, times, velocities
+    if(data.size() < 4)
+    {
+        cError("Velocity field file '%s' is missing the grid dimensions!", path.c_str());
+        return;
+    }
+    
+    size_t n[4];
+    for(int a=0; a<4; ++a)
+        n[a] = data[a] >= Scalar(1) ? (size_t)data[a] : 0;
+    
+    size_t nNodes = n[0] * n[1] * n[2] * n[3];
+    size_t expected = 4 + n[0] + n[1] + n[2] + n[3] + nNodes * 3;
+    if(nNodes == 0 || data.size() != expected)
+    {
+        cError("Velocity field file '%s' contains %lu numbers while %lu were expected!", path.c_str(), (unsigned long)data.size(), (unsigned long)expected);
+        return;
+    }
+    
+    std::vector<Scalar> coords[4];
+    size_t offset = 4;
+    for(int a=0; a<4; ++a)
+    {
+        coords[a].assign(data.begin() + offset, data.begin() + offset + n[a]);
+        offset += n[a];
+    }
+    
+    std::vector<Vector3> velocity(nNodes);
+    for(size_t i=0; i<nNodes; ++i, offset += 3)
+        velocity[i] = Vector3(data[offset], data[offset+1], data[offset+2]);
+    
+    if(Setup(coords[0], coords[1], coords[2], coords[3], velocity))
+        cInfo("Loaded gridded velocity field from: %s (%lux%lux%lu nodes, %lu time slices)", path.c_str(),
+              (unsigned long)n[0], (unsigned long)n[1], (unsigned long)n[2], (unsigned long)n[3]);
+    else
+        cError("Velocity field file '%s' contains invalid data!", path.c_str());
+}
+
+bool Gridded::Setup(const std::vector<Scalar>& x, const std::vector<Scalar>& y, const std::vector<Scalar>& z,
+                    const std::vector<Scalar>& t, const std::vector<Vector3>& velocity)
+{
+    axes[0].nodes = x;
+    axes[1].nodes = y;
+    axes[2].nodes = z;
+    times = t;
+    
+    bool valid = times.size() > 0 && velocity.size() == x.size() * y.size() * z.size() * t.size();
+    for(size_t i=1; i<times.size(); ++i)
+        if(times[i] <= times[i-1])
+            valid = false;
+    for(int a=0; a<3; ++a)
+        if(!BuildAxis(axes[a]))
+            valid = false;
+    
+    if(valid)
+        vel = velocity;
+    else
+    {
+        for(int a=0; a<3; ++a)
+        {
+            axes[a].nodes.clear();
+            axes[a].lut.clear();
+        }
+        times.clear();
+        vel.clear();
+    }
+    return valid;
+}
+
+bool Gridded::BuildAxis(GridAxis& axis)
+{
+    size_t n = axis.nodes.size();
+    axis.lut.clear();
+    axis.invBinSize = Scalar(0);
+    
+    if(n == 0)
+        return false;
+    if(n == 1)
+        return true;
+    
+    Scalar minSpacing = BT_LARGE_FLOAT;
+    for(size_t i=1; i<n; ++i)
+    {
+        Scalar d = axis.nodes[i] - axis.nodes[i-1];
+        if(d <= Scalar(0))
+            return false;
+        minSpacing = btMin(minSpacing, d);
+    }
+    
+    //Bins not larger than the smallest cell (if possible), so that locating a cell takes a bounded number of steps
+    Scalar range = axis.nodes.back() - axis.nodes.front();
+    size_t nBins = (size_t)std::ceil(range/minSpacing);
+    nBins = nBins < n-1 ? n-1 : (nBins > MAX_AXIS_BINS ? MAX_AXIS_BINS : nBins);
+    axis.invBinSize = Scalar(nBins)/range;
+    axis.lut.resize(nBins);
+    
+    size_t i = 0;
+    for(size_t b=0; b<nBins; ++b)
+    {
+        Scalar binStart = axis.nodes.front() + Scalar(b)/axis.invBinSize;
+        while(i < n-2 && axis.nodes[i+1] <= binStart)
+            ++i;
+        axis.lut[b] = (unsigned int)i;
+    }
+    return true;
+}
+
+bool Gridded::Locate(const GridAxis& axis, Scalar v, size_t& i, Scalar& frac)
+{
+    size_t n = axis.nodes.size();
+    if(n == 1)
+    {
+        i = 0;
+        frac = Scalar(0);
+        return true;
+    }
+    
+    if(v < axis.nodes.front() || v > axis.nodes.back())
+        return false;
+    
+    size_t b = (size_t)((v - axis.nodes.front()) * axis.invBinSize);
+    i = axis.lut[b < axis.lut.size() ? b : axis.lut.size()-1];
+    while(i < n-2 && axis.nodes[i+1] <= v)
+        ++i;
+    frac = (v - axis.nodes[i])/(axis.nodes[i+1] - axis.nodes[i]);
+    return true;
+}
+
+Vector3 Gridded::Interpolate(size_t slice, const size_t idx[3], const Scalar frac[3]) const
+{
+    size_t nx = axes[0].nodes.size();
+    size_t ny = axes[1].nodes.size();
+    size_t nz = axes[2].nodes.size();
+    size_t i1 = nx > 1 ? idx[0]+1 : idx[0];
+    size_t j1 = ny > 1 ? idx[1]+1 : idx[1];
+    size_t k1 = nz > 1 ? idx[2]+1 : idx[2];
+    
+    size_t base = slice * nz;
+    size_t row0 = (base + idx[2]) * ny;
+    size_t row1 = (base + k1) * ny;
+    
+    //Interpolate along X
+    Vector3 v00 = vel[(row0 + idx[1]) * nx + idx[0]].lerp(vel[(row0 + idx[1]) * nx + i1], frac[0]);
+    Vector3 v10 = vel[(row0 + j1) * nx + idx[0]].lerp(vel[(row0 + j1) * nx + i1], frac[0]);
+    Vector3 v01 = vel[(row1 + idx[1]) * nx + idx[0]].lerp(vel[(row1 + idx[1]) * nx + i1], frac[0]);
+    Vector3 v11 = vel[(row1 + j1) * nx + idx[0]].lerp(vel[(row1 + j1) * nx + i1], frac[0]);
+    
+    //Interpolate along Y and Z
+    return v00.lerp(v10, frac[1]).lerp(v01.lerp(v11, frac[1]), frac[2]);
+}
+
+Vector3 Gridded::GetVelocityAtPoint(const Vector3& p)
+{
+    if(vel.size() == 0)
+        return V0();
+    
+    size_t idx[3];
+    Scalar frac[3];
+    for(int a=0; a<3; ++a)
+        if(!Locate(axes[a], p[a], idx[a], frac[a]))
+            return V0();
+    
+    if(times.size() == 1)
+        return Interpolate(0, idx, frac);
+    
+    //Find time slices
+    Scalar t = SimulationManager::getCurrent()->getSimulationTime();
+    if(loop)
+    {
+        Scalar period = times.back() - times.front();
+        t = times.front() + btFmod(t - times.front(), period);
+        if(t < times.front())
+            t += period;
+    }
+    
+    if(t <= times.front())
+        return Interpolate(0, idx, frac);
+    if(t >= times.back())
+        return Interpolate(times.size()-1, idx, frac);
+    
+    size_t slice = std::upper_bound(times.begin(), times.end(), t) - times.begin() - 1;
+    Scalar ft = (t - times[slice])/(times[slice+1] - times[slice]);
+    return Interpolate(slice, idx, frac).lerp(Interpolate(slice+1, idx, frac), ft);
+}
+
+void Gridded::getAABB(Vector3& min, Vector3& max)
+{
+    if(vel.size() == 0)
+    {
+        min.setValue(BT_LARGE_FLOAT, BT_LARGE_FLOAT, BT_LARGE_FLOAT);
+        max.setValue(-BT_LARGE_FLOAT, -BT_LARGE_FLOAT, -BT_LARGE_FLOAT);
+        return;
+    }
+    
+    for(int a=0; a<3; ++a)
+    {
+        min[a] = axes[a].nodes.size() > 1 ? axes[a].nodes.front() : -BT_LARGE_FLOAT;
+        max[a] = axes[a].nodes.size() > 1 ? axes[a].nodes.back() : BT_LARGE_FLOAT;
+    }
+}
+
+bool Gridded::isValid() const
+{
+    return vel.size() > 0;
+}
+
+void Gridded::Render(DrawingQueue& queue, VelocityFieldUBO& ubo)
+{
+    ubo.posR = glm::vec4(0.f);
+    ubo.dirV = glm::vec4(0.f);
+    ubo.params = glm::vec3(0.f);
+    ubo.type = 0;
+    
+    if(vel.size() == 0)
+        return;
+    
+    //Velocity vectors at a subset of nodes
+    size_t nx = axes[0].nodes.size();
+    size_t ny = axes[1].nodes.size();
+    size_t nz = axes[2].nodes.size();
+    size_t stride = (size_t)std::ceil(btPow(Scalar(nx*ny*nz)/Scalar(MAX_RENDERED_NODES), Scalar(1)/Scalar(3)));
+    stride = stride < 1 ? 1 : stride;
+    
+    Renderable arrows;
+    arrows.type = RenderableType::HYDRO_LINES;
+    arrows.model = glm::mat4(1.f);
+    queue.BeginPoints(arrows);
+    
+    for(size_t k=0; k<nz; k+=stride)
+        for(size_t j=0; j<ny; j+=stride)
+            for(size_t i=0; i<nx; i+=stride)
+            {
+                Vector3 p(axes[0].nodes[i], axes[1].nodes[j], axes[2].nodes[k]);
+                Vector3 v = GetVelocityAtPoint(p);
+                queue.AddPoint(arrows, glm::vec3((GLfloat)p.getX(), (GLfloat)p.getY(), (GLfloat)p.getZ()));
+                queue.AddPoint(arrows, glm::vec3((GLfloat)(p.getX() + v.getX()), (GLfloat)(p.getY() + v.getY()), (GLfloat)(p.getZ() + v.getZ())));
+            }
+    
+    queue.Add(arrows);
+}
+
+}
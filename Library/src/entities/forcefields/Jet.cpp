@@ -59,9 +59,8 @@ Vector3 Jet::GetVelocityAtPoint(const Vector3& p)
     return f*vmax;
 }
 
-std::vector<Renderable> Jet::Render(VelocityFieldUBO& ubo)
+void Jet::Render(DrawingQueue& queue, VelocityFieldUBO& ubo)
 {
-    std::vector<Renderable> items(0);
     ubo.posR = glm::vec4((GLfloat)c.getX(), (GLfloat)c.getY(), (GLfloat)c.getZ(), (GLfloat)r);
     ubo.dirV = glm::vec4((GLfloat)n.getX(), (GLfloat)n.getY(), (GLfloat)n.getZ(), (GLfloat)vout);
     ubo.params = glm::vec3(0.f);
@@ -77,20 +76,22 @@ std::vector<Renderable> Jet::Render(VelocityFieldUBO& ubo)
     Renderable orifice;
     orifice.type = RenderableType::HYDRO_LINE_STRIP;
     orifice.model = model;
+    queue.BeginPoints(orifice);
     
     for(unsigned int i=0; i<=12; ++i)
     {
         Scalar alpha = Scalar(i)/Scalar(12) * M_PI * Scalar(2);
         Vector3 v(btCos(alpha)*r, btSin(alpha)*r, 0);
-        orifice.points.push_back(glm::vec3(v.x(), v.y(), v.z()));
+        queue.AddPoint(orifice, glm::vec3(v.x(), v.y(), v.z()));
     }
     
     //Cone
     Renderable cone;
     cone.type = RenderableType::HYDRO_LINES;
     cone.model = orifice.model;
-    cone.points.push_back(glm::vec3(0, 0, 0));
-    cone.points.push_back(glm::vec3(0, 0, vout));
+    queue.BeginPoints(cone);
+    queue.AddPoint(cone, glm::vec3(0, 0, 0));
+    queue.AddPoint(cone, glm::vec3(0, 0, vout));
     
     Scalar r_ = Scalar(1)/Scalar(5)*(Scalar(10)*r + Scalar(5)*r);
     
@@ -99,15 +100,13 @@ std::vector<Renderable> Jet::Render(VelocityFieldUBO& ubo)
         Scalar alpha = Scalar(i)/Scalar(12) * M_PI * Scalar(2);
         Vector3 v1(btCos(alpha)*r, btSin(alpha)*r, 0);
         Vector3 v2(v1.x()*r_/r, v1.y()*r_/r, Scalar(10)*r);
-        cone.points.push_back(glm::vec3(v1.x(), v1.y(), v1.z()));
-        cone.points.push_back(glm::vec3(v2.x(), v2.y(), v2.z()));
+        queue.AddPoint(cone, glm::vec3(v1.x(), v1.y(), v1.z()));
+        queue.AddPoint(cone, glm::vec3(v2.x(), v2.y(), v2.z()));
     }
     
     //Build
-    items.push_back(orifice);
-    items.push_back(cone);
-
-    return items;
+    queue.Add(orifice);
+    queue.Add(cone);
 }
 
 }
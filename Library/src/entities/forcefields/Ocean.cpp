@@ -35,6 +35,8 @@
 #include "core/SimulationApp.h"
 #include "core/SimulationManager.h"
 
+#define DEPTH_QUERY_CHUNK   64
+
 namespace sf
 {
 
@@ -53,10 +55,9 @@ Ocean::Ocean(std::string uniqueName, Scalar waves, Fluid l) : ForcefieldEntity(u
     currentsEnabled = false;
     
     liquid = l;
-    wavesDebug.type = RenderableType::HYDRO_POINTS;
-    wavesDebug.model = glm::mat4(1.f);
     waterType = Scalar(0.0);
     glOcean = NULL;
+    wavesMutex = NULL;
 }
 
 Ocean::~Ocean()
@@ -70,6 +71,14 @@ Ocean::~Ocean()
     
     if(glOcean != NULL)
         delete glOcean;
+    
+    delete ghost->getCollisionShape();
+    delete ghost;
+}
+
+void Ocean::AddToSimulation(SimulationManager* sm)
+{
+    //The ghost is not added to the dynamics world, bodies inside the ocean are found by the simulation manager
 }
 
 bool Ocean::hasWaves() const
@@ -109,6 +118,7 @@ void Ocean::setWaterType(Scalar jerlov)
 void Ocean::AddVelocityField(VelocityField* field)
 {
     currents.push_back(field);
+    currentsIndex.Build(currents);
 }
 
 bool Ocean::IsInsideFluid(const Vector3& point)
@@ -123,7 +133,7 @@ float Ocean::GetDepth(const glm::vec3& point)
         GLfloat waveHeight = glOcean->ComputeWaveHeight(point.x, point.y);
         glm::vec3 wavePoint(point.x, point.y, waveHeight);
 #ifdef DEBUG_HYDRO
-        wavesDebug.points.push_back(wavePoint);
+        wavesDebug.push_back(wavePoint);
 #endif
         return point.z - waveHeight;
     }
@@ -131,7 +141,7 @@ float Ocean::GetDepth(const glm::vec3& point)
     {
         glm::vec3 wavePoint(point.x, point.y, 0.f);
 #ifdef DEBUG_HYDRO  
-        wavesDebug.points.push_back(wavePoint);
+        wavesDebug.push_back(wavePoint);
 #endif
         return point.z;
     }
@@ -142,9 +152,51 @@ Scalar Ocean::GetDepth(const Vector3& point)
     return Scalar(GetDepth(glm::vec3((GLfloat)point.getX(), (GLfloat)point.getY(), (GLfloat)point.getZ())));
 }
 
+void Ocean::GetDepth(const glm::vec3* points, size_t n, GLfloat* depths)
+{
+    if(hasWaves()) //Geometric waves
+    {
+        glOcean->ComputeWaveHeights(points, n, depths);
+        for(size_t i=0; i<n; ++i)
+        {
+#ifdef DEBUG_HYDRO
+            wavesDebug.push_back(glm::vec3(points[i].x, points[i].y, depths[i]));
+#endif
+            depths[i] = points[i].z - depths[i];
+        }
+    }
+    else //Flat surface
+    {
+        for(size_t i=0; i<n; ++i)
+        {
+#ifdef DEBUG_HYDRO
+            wavesDebug.push_back(glm::vec3(points[i].x, points[i].y, 0.f));
+#endif
+            depths[i] = points[i].z;
+        }
+    }
+}
+
+void Ocean::GetDepth(const Vector3* points, size_t n, Scalar* depths)
+{
+    //Convert to float precision in chunks, to avoid allocation
+    glm::vec3 p[DEPTH_QUERY_CHUNK];
+    GLfloat d[DEPTH_QUERY_CHUNK];
+    
+    for(size_t i=0; i<n; i+=DEPTH_QUERY_CHUNK)
+    {
+        size_t m = std::min(n-i, (size_t)DEPTH_QUERY_CHUNK);
+        for(size_t h=0; h<m; ++h)
+            p[h] = glm::vec3((GLfloat)points[i+h].getX(), (GLfloat)points[i+h].getY(), (GLfloat)points[i+h].getZ());
+        GetDepth(p, m, d);
+        for(size_t h=0; h<m; ++h)
+            depths[i+h] = Scalar(d[h]);
+    }
+}
+
 Scalar Ocean::GetPressure(const Vector3& point)
 {
-    Scalar g = SimulationApp::getApp()->getSimulationManager()->getGravity().getZ();
+    Scalar g = SimulationManager::getCurrent()->getGravity().getZ();
     Scalar d = GetDepth(point);
     Scalar pressure = d > Scalar(0) ? d*liquid.density*g : Scalar(0);
     return pressure;
@@ -153,12 +205,7 @@ Scalar Ocean::GetPressure(const Vector3& point)
 Vector3 Ocean::GetFluidVelocity(const Vector3& point) const
 {
     if(currentsEnabled)
-    {
-        Vector3 fv = V0();
-        for(size_t i=0; i<currents.size(); ++i)
-            fv += currents[i]->GetVelocityAtPoint(point);
-        return fv;
-    }
+        return currentsIndex.GetVelocityAtPoint(point);
     else
         return V0();
 }
@@ -184,7 +231,7 @@ void Ocean::UpdateCurrentsData()
         glOcean->UpdateOceanCurrentsData(glOceanCurrentsUBOData);
 }
 
-void Ocean::ApplyFluidForces(btDynamicsWorld* world, btCollisionObject* co, bool recompute)
+void Ocean::ApplyFluidForces(btDynamicsWorld* world, btCollisionObject* co, const FluidDynamicsTolerances& tol)
 {
     Entity* ent;
     btRigidBody* rb = btRigidBody::upcast(co);
@@ -211,53 +258,66 @@ void Ocean::ApplyFluidForces(btDynamicsWorld* world, btCollisionObject* co, bool
     
     if(ent->getType() == EntityType::SOLID)
     {
-        if(recompute)
+        SolidEntity* solid = (SolidEntity*)ent;
+        
+        //Wave data is refreshed by the renderer -> lock only while it is sampled
+        if(wavesMutex != NULL) SDL_LockMutex(wavesMutex);
+        
+        //Sleeping bodies are skipped until the ocean around them changes
+        bool sleeping = solid->CheckSleeping(this);
+        if(!sleeping)
         {
             settings.dampingForces = true;
             settings.reallisticBuoyancy = true;
-            ((SolidEntity*)ent)->ComputeHydrodynamicForces(settings, this);
+            solid->UpdateHydrodynamicForces(settings, this, tol);
         }
         
-        ((SolidEntity*)ent)->ApplyHydrodynamicForces();
+        if(wavesMutex != NULL) SDL_UnlockMutex(wavesMutex);
+        
+        if(!sleeping)
+            solid->ApplyHydrodynamicForces();
     }
 }
 
 void Ocean::InitGraphics(SDL_mutex* hydrodynamics)
 {
     if(oceanState > 0.0)
+    {
         glOcean = new OpenGLRealOcean(depth, oceanState, hydrodynamics);
+        wavesMutex = hydrodynamics;
+    }
     else
         glOcean = new OpenGLFlatOcean(depth);
     setWaterType(0.2);
 }
 
-std::vector<Renderable> Ocean::Render()
+void Ocean::Render(DrawingQueue& queue)
 {
     std::vector<Actuator*> act;
-    return Render(act);
+    Render(queue, act);
 }
 
-std::vector<Renderable> Ocean::Render(const std::vector<Actuator*>& act)
+void Ocean::Render(DrawingQueue& queue, const std::vector<Actuator*>& act)
 {
-    std::vector<Renderable> items(0);
-    
     //Update currents data
     glOceanCurrentsUBOData.gravity = glm::vec3(0.f,0.f,9.81f);
     glOceanCurrentsUBOData.numCurrents = 0;
 
     if(currentsEnabled)
     {
+        VelocityFieldUBO overflow; //Fields exceeding the capacity of the uniform buffer are not rendered in the water
         for(size_t i=0; i<currents.size(); ++i)
         {
-            std::vector<Renderable> citems = currents[i]->Render(glOceanCurrentsUBOData.currents[glOceanCurrentsUBOData.numCurrents]);
-            items.insert(items.end(), citems.begin(), citems.end());
-            ++glOceanCurrentsUBOData.numCurrents;
+            bool fits = (GLint)glOceanCurrentsUBOData.numCurrents < MAX_OCEAN_CURRENTS;
+            currents[i]->Render(queue, fits ? glOceanCurrentsUBOData.currents[glOceanCurrentsUBOData.numCurrents] : overflow);
+            if(fits)
+                ++glOceanCurrentsUBOData.numCurrents;
         }
     }
     
     for(size_t i=0; i<act.size(); ++i)
     {
-        if(act[i]->getType() == ActuatorType::THRUSTER)
+        if(act[i]->getType() == ActuatorType::THRUSTER && (GLint)glOceanCurrentsUBOData.numCurrents < MAX_OCEAN_CURRENTS)
         {
             Thruster* th = (Thruster*)act[i];
             Transform thFrame = th->getActuatorFrame();
@@ -278,13 +338,16 @@ std::vector<Renderable> Ocean::Render(const std::vector<Actuator*>& act)
         }
     }
 
-    if(wavesDebug.points.size() > 0)
+    if(wavesDebug.size() > 0)
     {
-        items.push_back(wavesDebug);
-        wavesDebug.points.clear();
+        Renderable item;
+        item.type = RenderableType::HYDRO_POINTS;
+        item.model = glm::mat4(1.f);
+        queue.BeginPoints(item);
+        queue.AddPoints(item, wavesDebug);
+        queue.Add(item);
+        wavesDebug.clear();
     }
-
-    return items;
 }
 
 }
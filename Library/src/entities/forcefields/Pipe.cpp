@@ -62,9 +62,16 @@ Vector3 Pipe::GetVelocityAtPoint(const Vector3& p)
     return f*v;
 }
 
-std::vector<Renderable> Pipe::Render(VelocityFieldUBO& ubo)
+void Pipe::getAABB(Vector3& min, Vector3& max)
+{
+    Vector3 p2 = p1 + n*l;
+    Scalar r = btMax(r1, r2);
+    min = Vector3(btMin(p1.getX(), p2.getX()), btMin(p1.getY(), p2.getY()), btMin(p1.getZ(), p2.getZ())) - Vector3(r,r,r);
+    max = Vector3(btMax(p1.getX(), p2.getX()), btMax(p1.getY(), p2.getY()), btMax(p1.getZ(), p2.getZ())) + Vector3(r,r,r);
+}
+
+void Pipe::Render(DrawingQueue& queue, VelocityFieldUBO& ubo)
 {
-    std::vector<Renderable> items(0);
     ubo.posR = glm::vec4((GLfloat)p1.getX(), (GLfloat)p1.getY(), (GLfloat)p1.getZ(), (GLfloat)r1);
     ubo.dirV = glm::vec4((GLfloat)n.getX(), (GLfloat)n.getY(), (GLfloat)n.getZ(), (GLfloat)vin);
     ubo.params = glm::vec3((GLfloat)l, (GLfloat)r2, (GLfloat)gamma);
@@ -76,40 +83,46 @@ std::vector<Renderable> Pipe::Render(VelocityFieldUBO& ubo)
     glm::vec3 y_ = glm::cross(z_,x_);
     glm::mat4 model(glm::vec4(x_, 0.f), glm::vec4(y_, 0.f), glm::vec4(z_, 0.f), glm::vec4(p1.x(), p1.y(), p1.z(), 1));    
     
-    //Inlet and outlet
+    //Inlet and outlet (closed line strips)
     Renderable inlet;
     inlet.type = RenderableType::HYDRO_LINE_STRIP;
     inlet.model = model;
+    queue.BeginPoints(inlet);
+    for(unsigned int i=0; i<=12; ++i)
+    {
+        Scalar alpha = Scalar(i%12)/Scalar(12) * M_PI * Scalar(2);
+        queue.AddPoint(inlet, glm::vec3(btCos(alpha)*r1, btSin(alpha)*r1, 0));
+    }
+    queue.Add(inlet);
     
     Renderable outlet;
     outlet.type = RenderableType::HYDRO_LINE_STRIP;
     outlet.model = model;
+    queue.BeginPoints(outlet);
+    for(unsigned int i=0; i<=12; ++i)
+    {
+        Scalar alpha = Scalar(i%12)/Scalar(12) * M_PI * Scalar(2);
+        queue.AddPoint(outlet, glm::vec3(btCos(alpha)*r2, btSin(alpha)*r2, l));
+    }
+    queue.Add(outlet);
 
     //Pipe
     Renderable pipe;
     pipe.type = RenderableType::HYDRO_LINES;
     pipe.model = model;
-    pipe.points.push_back(glm::vec3(0, 0, 0));
-    pipe.points.push_back(glm::vec3(0, 0, l));
+    queue.BeginPoints(pipe);
+    queue.AddPoint(pipe, glm::vec3(0, 0, 0));
+    queue.AddPoint(pipe, glm::vec3(0, 0, l));
     
     for(unsigned int i=0; i<12; ++i)
     {
         Scalar alpha = Scalar(i)/Scalar(12) * M_PI * Scalar(2);
         Vector3 v1(btCos(alpha)*r1, btSin(alpha)*r1, 0);
         Vector3 v2(v1.x()*r2/r1, v1.y()*r2/r1, l);
-        pipe.points.push_back(glm::vec3(v1.x(), v1.y(), v1.z()));
-        inlet.points.push_back(pipe.points.back());
-        pipe.points.push_back(glm::vec3(v2.x(), v2.y(), v2.z()));
-        outlet.points.push_back(pipe.points.back());
+        queue.AddPoint(pipe, glm::vec3(v1.x(), v1.y(), v1.z()));
+        queue.AddPoint(pipe, glm::vec3(v2.x(), v2.y(), v2.z()));
     }
-    
-    inlet.points.push_back(inlet.points.front());
-    outlet.points.push_back(outlet.points.front());
-    
-    items.push_back(inlet);
-    items.push_back(outlet);
-    items.push_back(pipe);
-    return items;
+    queue.Add(pipe);
 }
 
 }
@@ -41,13 +41,25 @@ Vector3 Stream::GetVelocityAtPoint(const Vector3& p)
     return Vector3(0,0,0);
 }
 
-std::vector<Renderable> Stream::Render(VelocityFieldUBO& ubo)
+void Stream::getAABB(Vector3& min, Vector3& max)
+{
+    min.setValue(BT_LARGE_FLOAT, BT_LARGE_FLOAT, BT_LARGE_FLOAT);
+    max.setValue(-BT_LARGE_FLOAT, -BT_LARGE_FLOAT, -BT_LARGE_FLOAT);
+    
+    for(size_t i=0; i<c.size(); ++i)
+    {
+        Scalar ri = i < r.size() ? r[i] : Scalar(0);
+        min.setMin(c[i] - Vector3(ri,ri,ri));
+        max.setMax(c[i] + Vector3(ri,ri,ri));
+    }
+}
+
+void Stream::Render(DrawingQueue& queue, VelocityFieldUBO& ubo)
 {
     ubo.posR = glm::vec4(0.f);
     ubo.dirV = glm::vec4(0.f);
     ubo.params = glm::vec3(0.f);
     ubo.type = 0;
-    return std::vector<Renderable>(0);
 }
     
 }
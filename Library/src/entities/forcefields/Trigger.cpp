@@ -154,10 +154,8 @@ bool Trigger::isActive()
     return active;
 }
 
-std::vector<Renderable> Trigger::Render()
+void Trigger::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
-    
     if(objectId >= 0 && isRenderable())
     {
         Transform trans = ghost->getWorldTransform();
@@ -166,10 +164,8 @@ std::vector<Renderable> Trigger::Render()
         item.objectId = objectId;
         item.lookId = lookId;
         item.model = glMatrixFromTransform(trans);
-        items.push_back(item);
+        queue.Add(item);
     }
-    
-    return items;
 }
 
 }
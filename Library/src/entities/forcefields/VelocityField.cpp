@@ -36,4 +36,11 @@ VelocityField::~VelocityField()
 {
 }
 
+void VelocityField::getAABB(Vector3& min, Vector3& max)
+{
+    //Unbounded by default
+    min.setValue(-BT_LARGE_FLOAT, -BT_LARGE_FLOAT, -BT_LARGE_FLOAT);
+    max.setValue(BT_LARGE_FLOAT, BT_LARGE_FLOAT, BT_LARGE_FLOAT);
+}
+
 }
@@ -0,0 +1,172 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  VelocityFieldIndex.cpp
+//  Stonefish
+//
+
+#include "entities/forcefields/VelocityFieldIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include "entities/forcefields/VelocityField.h"
+
+#define MAX_CELLS_PER_AXIS  64
+#define MAX_CELLS           32768
+
+namespace sf
+{
+
+VelocityFieldIndex::VelocityFieldIndex()
+{
+    gridMin = gridMax = V0();
+    invCellSize = V0();
+    dims[0] = dims[1] = dims[2] = 0;
+}
+
+void VelocityFieldIndex::Build(const std::vector<VelocityField*>& fields_)
+{
+    fields = fields_;
+    fieldMin.resize(fields.size());
+    fieldMax.resize(fields.size());
+    unbounded.clear();
+    cellStart.clear();
+    cellFields.clear();
+    dims[0] = dims[1] = dims[2] = 0;
+    
+    //Classify fields
+    std::vector<unsigned int> bounded;
+    gridMin.setValue(BT_LARGE_FLOAT, BT_LARGE_FLOAT, BT_LARGE_FLOAT);
+    gridMax.setValue(-BT_LARGE_FLOAT, -BT_LARGE_FLOAT, -BT_LARGE_FLOAT);
+    Vector3 meanSize = V0();
+    
+    for(size_t i=0; i<fields.size(); ++i)
+    {
+        fields[i]->getAABB(fieldMin[i], fieldMax[i]);
+        
+        bool isUnbounded = false;
+        for(int a=0; a<3; ++a)
+            if(fieldMin[i][a] <= -BT_LARGE_FLOAT || fieldMax[i][a] >= BT_LARGE_FLOAT)
+                isUnbounded = true;
+        
+        if(isUnbounded)
+            unbounded.push_back((unsigned int)i);
+        else if(fieldMin[i].getX() <= fieldMax[i].getX() && fieldMin[i].getY() <= fieldMax[i].getY() && fieldMin[i].getZ() <= fieldMax[i].getZ()) //Skip empty fields
+        {
+            bounded.push_back((unsigned int)i);
+            gridMin.setMin(fieldMin[i]);
+            gridMax.setMax(fieldMax[i]);
+            meanSize += fieldMax[i] - fieldMin[i];
+        }
+    }
+    
+    if(bounded.size() == 0)
+        return;
+    
+    //Choose cells of the size of an average field
+    meanSize /= Scalar(bounded.size());
+    Vector3 extent = gridMax - gridMin;
+    for(int a=0; a<3; ++a)
+    {
+        dims[a] = meanSize[a] > SIMD_EPSILON ? (int)std::ceil(extent[a]/meanSize[a]) : 1;
+        dims[a] = dims[a] < 1 ? 1 : (dims[a] > MAX_CELLS_PER_AXIS ? MAX_CELLS_PER_AXIS : dims[a]);
+    }
+    while(dims[0] * dims[1] * dims[2] > MAX_CELLS)
+    {
+        int a = dims[0] >= dims[1] ? (dims[0] >= dims[2] ? 0 : 2) : (dims[1] >= dims[2] ? 1 : 2);
+        dims[a] = (dims[a] + 1)/2;
+    }
+    for(int a=0; a<3; ++a)
+        invCellSize[a] = extent[a] > SIMD_EPSILON ? Scalar(dims[a])/extent[a] : Scalar(0);
+    
+    //Count fields per cell and fill cells (compressed storage)
+    size_t nCells = (size_t)dims[0] * dims[1] * dims[2];
+    std::vector<int> range(bounded.size() * 6);
+    std::vector<unsigned int> count(nCells, 0);
+    
+    for(size_t b=0; b<bounded.size(); ++b)
+    {
+        unsigned int i = bounded[b];
+        for(int a=0; a<3; ++a)
+        {
+            int lo = (int)std::floor((fieldMin[i][a] - gridMin[a]) * invCellSize[a]);
+            int hi = (int)std::floor((fieldMax[i][a] - gridMin[a]) * invCellSize[a]);
+            range[b*6 + a*2] = lo < 0 ? 0 : (lo >= dims[a] ? dims[a]-1 : lo);
+            range[b*6 + a*2 + 1] = hi < 0 ? 0 : (hi >= dims[a] ? dims[a]-1 : hi);
+        }
+        
+        for(int z=range[b*6+4]; z<=range[b*6+5]; ++z)
+            for(int y=range[b*6+2]; y<=range[b*6+3]; ++y)
+                for(int x=range[b*6]; x<=range[b*6+1]; ++x)
+                    ++count[((size_t)z * dims[1] + y) * dims[0] + x];
+    }
+    
+    cellStart.resize(nCells + 1);
+    cellStart[0] = 0;
+    for(size_t c=0; c<nCells; ++c)
+        cellStart[c+1] = cellStart[c] + count[c];
+    cellFields.resize(cellStart[nCells]);
+    std::fill(count.begin(), count.end(), 0);
+    
+    for(size_t b=0; b<bounded.size(); ++b)
+        for(int z=range[b*6+4]; z<=range[b*6+5]; ++z)
+            for(int y=range[b*6+2]; y<=range[b*6+3]; ++y)
+                for(int x=range[b*6]; x<=range[b*6+1]; ++x)
+                {
+                    size_t c = ((size_t)z * dims[1] + y) * dims[0] + x;
+                    cellFields[cellStart[c] + count[c]++] = bounded[b];
+                }
+}
+
+Vector3 VelocityFieldIndex::GetVelocityAtPoint(const Vector3& p) const
+{
+    Vector3 v = V0();
+    
+    for(size_t i=0; i<unbounded.size(); ++i)
+    {
+        unsigned int id = unbounded[i];
+        if(p.getX() >= fieldMin[id].getX() && p.getY() >= fieldMin[id].getY() && p.getZ() >= fieldMin[id].getZ()
+           && p.getX() <= fieldMax[id].getX() && p.getY() <= fieldMax[id].getY() && p.getZ() <= fieldMax[id].getZ())
+            v += fields[id]->GetVelocityAtPoint(p);
+    }
+    
+    if(cellStart.size() == 0
+       || p.getX() < gridMin.getX() || p.getY() < gridMin.getY() || p.getZ() < gridMin.getZ()
+       || p.getX() > gridMax.getX() || p.getY() > gridMax.getY() || p.getZ() > gridMax.getZ())
+        return v;
+    
+    int cell[3];
+    for(int a=0; a<3; ++a)
+    {
+        cell[a] = (int)((p[a] - gridMin[a]) * invCellSize[a]);
+        cell[a] = cell[a] >= dims[a] ? dims[a]-1 : cell[a];
+    }
+    size_t c = ((size_t)cell[2] * dims[1] + cell[1]) * dims[0] + cell[0];
+    
+    for(unsigned int k=cellStart[c]; k<cellStart[c+1]; ++k)
+    {
+        unsigned int id = cellFields[k];
+        if(p.getX() >= fieldMin[id].getX() && p.getY() >= fieldMin[id].getY() && p.getZ() >= fieldMin[id].getZ()
+           && p.getX() <= fieldMax[id].getX() && p.getY() <= fieldMax[id].getY() && p.getZ() <= fieldMax[id].getZ())
+            v += fields[id]->GetVelocityAtPoint(p);
+    }
+    
+    return v;
+}
+
+}
@@ -27,7 +27,12 @@
 
 #include "core/SimulationApp.h"
 #include "core/SimulationManager.h"
+#include "core/Console.h"
+#include "graphics/OpenGLContent.h"
 #include "utils/GeometryFileUtil.h"
+#include <algorithm>
+
+#define HYDRO_MESH_VOLUME_TOLERANCE 1e-3 //Allowed relative difference between the volume of the merged mesh and the parts
 
 namespace sf
 {
@@ -41,6 +46,8 @@ Compound::Compound(std::string uniqueName, SolidEntity* firstExternalPart, const
     mass = 0;
     Ipri = Vector3(0,0,0);
     displayInternals = false;
+    mergeHydroMesh = false;
+    hydroMesh = NULL;
     
     AddExternalPart(firstExternalPart, origin);
 }
@@ -50,6 +57,14 @@ Compound::~Compound()
     for(unsigned int i=0; i<parts.size(); ++i)
         delete parts[i].solid;
     parts.clear();
+    
+    if(hydroMesh != NULL)
+        delete hydroMesh;
+}
+
+void Compound::setMergedHydrodynamicMesh(bool enabled)
+{
+    mergeHydroMesh = enabled;
 }
 
 void Compound::setDisplayInternalParts(bool enabled)
@@ -62,6 +77,11 @@ bool Compound::isDisplayingInternalParts()
     return displayInternals;
 }
 
+bool Compound::isHydrodynamicMeshMerged()
+{
+    return hydroMesh != NULL;
+}
+
 Scalar Compound::getAugmentedMass() const
 {
     return mass + aMass.x();
@@ -250,8 +270,187 @@ void Compound::RecalculatePhysicalProperties()
     Ipri = compoundPriInertia;
 }
 
+//Generalized winding number of a closed mesh around a point (1 inside, 0 outside)
+static double WindingNumber(const Mesh* mesh, const glm::vec3& p)
+{
+    double w = 0.0;
+    for(size_t i=0; i<mesh->faces.size(); ++i)
+    {
+        glm::dvec3 a = glm::dvec3(mesh->getVertexPos(i, 0) - p);
+        glm::dvec3 b = glm::dvec3(mesh->getVertexPos(i, 1) - p);
+        glm::dvec3 c = glm::dvec3(mesh->getVertexPos(i, 2) - p);
+        double la = glm::length(a);
+        double lb = glm::length(b);
+        double lc = glm::length(c);
+        double num = glm::dot(a, glm::cross(b, c));
+        double den = la*lb*lc + glm::dot(a, b)*lc + glm::dot(b, c)*la + glm::dot(c, a)*lb;
+        w += 2.0 * atan2(num, den); //Solid angle of the triangle
+    }
+    return w/(4.0 * M_PI);
+}
+
+//Volume enclosed by a mesh (divergence theorem)
+static double MeshVolume(const Mesh* mesh)
+{
+    double v6 = 0.0;
+    for(size_t i=0; i<mesh->faces.size(); ++i)
+    {
+        glm::dvec3 a = glm::dvec3(mesh->getVertexPos(i, 0));
+        glm::dvec3 b = glm::dvec3(mesh->getVertexPos(i, 1));
+        glm::dvec3 c = glm::dvec3(mesh->getVertexPos(i, 2));
+        v6 += glm::dot(a, glm::cross(b, c));
+    }
+    return v6/6.0;
+}
+
+//Check if every edge of a mesh is shared by exactly two faces
+static bool IsClosedMesh(const Mesh* mesh)
+{
+    std::vector<uint64_t> edges;
+    edges.reserve(mesh->faces.size() * 3);
+    for(size_t i=0; i<mesh->faces.size(); ++i)
+        for(unsigned short h=0; h<3; ++h)
+        {
+            uint64_t a = mesh->faces[i].vertexID[h];
+            uint64_t b = mesh->faces[i].vertexID[(h+1)%3];
+            edges.push_back(a < b ? (a << 32) | b : (b << 32) | a);
+        }
+    std::sort(edges.begin(), edges.end());
+    
+    for(size_t i=0; i<edges.size(); i+=2)
+        if(i+1 >= edges.size() || edges[i] != edges[i+1] || (i+2 < edges.size() && edges[i+2] == edges[i]))
+            return false;
+    return !edges.empty();
+}
+
+void Compound::BuildHydrodynamicMesh()
+{
+    if(hydroMesh != NULL)
+    {
+        delete hydroMesh;
+        hydroMesh = NULL;
+    }
+    
+    //Collect external parts (buoyancy of the merged mesh is computed for all of them)
+    std::vector<size_t> ext;
+    for(size_t i=0; i<parts.size(); ++i)
+    {
+        if(!parts[i].isExternal)
+            continue;
+        
+        if(parts[i].solid->getPhysicsMesh() == NULL || !parts[i].solid->isBuoyant())
+        {
+            cWarning("Hydrodynamic mesh of compound '%s' not merged! Part '%s' has no physics mesh or is not buoyant.", getName().c_str(), parts[i].solid->getName().c_str());
+            return;
+        }
+        ext.push_back(i);
+    }
+    
+    //Transform all parts to the compound origin frame
+    PlainMesh joined;
+    std::vector<size_t> vOffset(ext.size());
+    std::vector<Transform> T_C_part(ext.size());
+    std::vector<glm::vec3> aabbMin(ext.size());
+    std::vector<glm::vec3> aabbMax(ext.size());
+    glm::vec3 bbMin(BT_LARGE_FLOAT);
+    glm::vec3 bbMax(-BT_LARGE_FLOAT);
+    
+    for(size_t k=0; k<ext.size(); ++k)
+    {
+        const Mesh* mesh = parts[ext[k]].solid->getPhysicsMesh();
+        T_C_part[k] = parts[ext[k]].origin * parts[ext[k]].solid->getO2CTransform();
+        glm::mat4 T = glMatrixFromTransform(T_C_part[k]);
+        vOffset[k] = joined.vertices.size();
+        aabbMin[k] = glm::vec3(BT_LARGE_FLOAT);
+        aabbMax[k] = glm::vec3(-BT_LARGE_FLOAT);
+        
+        for(size_t h=0; h<mesh->getNumOfVertices(); ++h)
+        {
+            glm::vec3 pos = mesh->getVertexPos(h);
+            aabbMin[k] = glm::min(aabbMin[k], pos);
+            aabbMax[k] = glm::max(aabbMax[k], pos);
+            
+            Vertex vt;
+            vt.pos = glm::vec3(T * glm::vec4(pos, 1.f));
+            vt.normal = glm::vec3(0.f);
+            joined.vertices.push_back(vt);
+            bbMin = glm::min(bbMin, vt.pos);
+            bbMax = glm::max(bbMax, vt.pos);
+        }
+    }
+    
+    //Drop faces touching or lying inside other parts (a point slightly in front of the face is inside another part)
+    GLfloat eps = glm::length(bbMax - bbMin) * 1e-4f;
+    size_t nDropped = 0;
+    
+    for(size_t k=0; k<ext.size(); ++k)
+    {
+        const Mesh* mesh = parts[ext[k]].solid->getPhysicsMesh();
+        
+        for(size_t h=0; h<mesh->faces.size(); ++h)
+        {
+            Face f;
+            for(unsigned short v=0; v<3; ++v)
+                f.vertexID[v] = mesh->faces[h].vertexID[v] + (GLuint)vOffset[k];
+            
+            glm::vec3 p1 = joined.vertices[f.vertexID[0]].pos;
+            glm::vec3 p2 = joined.vertices[f.vertexID[1]].pos;
+            glm::vec3 p3 = joined.vertices[f.vertexID[2]].pos;
+            glm::vec3 n = glm::cross(p2-p1, p3-p1);
+            if(glm::length2(n) < 1e-12f) continue;
+            glm::vec3 probe = (p1+p2+p3)/3.f + glm::normalize(n) * eps;
+            
+            bool interior = false;
+            for(size_t j=0; j<ext.size() && !interior; ++j)
+            {
+                if(j == k) continue;
+                Vector3 pj = T_C_part[j].inverse() * Vector3(probe.x, probe.y, probe.z);
+                glm::vec3 probej((GLfloat)pj.x(), (GLfloat)pj.y(), (GLfloat)pj.z());
+                if(glm::any(glm::lessThan(probej, aabbMin[j])) || glm::any(glm::greaterThan(probej, aabbMax[j])))
+                    continue;
+                interior = WindingNumber(parts[ext[j]].solid->getPhysicsMesh(), probej) > 0.5;
+            }
+            
+            if(interior)
+                ++nDropped;
+            else
+                joined.faces.push_back(f);
+        }
+    }
+    
+    //Weld vertices shared by the parts
+    Mesh* merged = OpenGLContent::Decimate(&joined, 0);
+    
+    //Faces are dropped whole, not clipped -> parts which overlap, instead of touching, leave open seams
+    double partsVolume = 0.0;
+    for(size_t k=0; k<ext.size(); ++k)
+        partsVolume += MeshVolume(parts[ext[k]].solid->getPhysicsMesh());
+    double mergedVolume = MeshVolume(merged);
+    
+    if(!IsClosedMesh(merged) || fabs(mergedVolume - partsVolume) > HYDRO_MESH_VOLUME_TOLERANCE * fabs(partsVolume))
+    {
+        cWarning("Hydrodynamic mesh of compound '%s' not merged! The merged mesh is not closed (%1.6lf/%1.6lf m^3), the parts probably overlap.", 
+                 getName().c_str(), mergedVolume, partsVolume);
+        delete merged;
+        return;
+    }
+    hydroMesh = merged;
+    
+    //Drag correction based on the shape of the whole body (added mass of the parts is kept)
+    Vector3 aMassParts = aMass;
+    Vector3 aIParts = aI;
+    ComputeFluidDynamicsApprox(GeometryApproxType::ELLIPSOID);
+    aMass = aMassParts;
+    aI = aIParts;
+    
+    cInfo("Merged hydrodynamic mesh of compound '%s' has %lu faces (%lu interior faces dropped).", getName().c_str(), (unsigned long)hydroMesh->faces.size(), (unsigned long)nDropped);
+}
+
 btCollisionShape* Compound::BuildCollisionShape()
 {
+    if(mergeHydroMesh)
+        BuildHydrodynamicMesh();
+    
     //Build collision shape from external parts
     btCompoundShape* colShape = new btCompoundShape();
     for(size_t i = 0; i<parts.size(); ++i)
@@ -267,13 +466,35 @@ btCollisionShape* Compound::BuildCollisionShape()
     return colShape;
 }
 
+void Compound::DeriveLumpedHydrodynamics(Ocean* ocn)
+{
+    lumped = LumpedHydrodynamics();
+    
+    if(hydroMesh != NULL) //All external parts in one pass
+        AccumulateLumpedHydrodynamics(hydroMesh, T_CG2O, this, ocn, lumped);
+    else
+    {
+        for(size_t i=0; i<parts.size(); ++i)
+            if(parts[i].isExternal)
+                AccumulateLumpedHydrodynamics(parts[i].solid->getPhysicsMesh(), T_CG2O * parts[i].origin * parts[i].solid->getO2CTransform(), parts[i].solid, ocn, lumped);
+    }
+    
+    lumpedValid = true;
+}
+
 void Compound::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean* ocn)
 {
     if(phyType != BodyPhysicsType::FLOATING && phyType != BodyPhysicsType::SUBMERGED) return;
     
+    if(hydroModel == HydrodynamicsModel::LUMPED)
+    {
+        ComputeHydrodynamicForcesLumped(settings, ocn);
+        return;
+    }
+    
     BodyFluidPosition bf = CheckBodyFluidPosition(ocn);
     
-    submerged.points.clear();
+    submerged.clear();
     
     //If completely outside fluid just set all torques and forces to 0
     if(bf == BodyFluidPosition::OUTSIDE)
@@ -294,7 +515,7 @@ void Compound::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean*
         //Compute buoyancy based on CB position
         if(isBuoyant())
         {
-            Fb = -volume*ocn->getLiquid().density * SimulationApp::getApp()->getSimulationManager()->getGravity();
+            Fb = -volume*ocn->getLiquid().density * SimulationManager::getCurrent()->getGravity();
             Tb = (getCGTransform() * P_CB - getCGTransform().getOrigin()).cross(Fb);
         }
         
@@ -320,19 +541,27 @@ void Compound::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean*
             Vector3 Fdsp(0,0,0);
             Vector3 Tdsp(0,0,0);
             
-            for(size_t i=0; i<parts.size(); ++i) //Go through all parts
-                if(parts[i].isExternal) //Compute drag only for external parts
-                {
-                    Transform T_C_part = getOTransform() * parts[i].origin * parts[i].solid->getO2CTransform();
-                    ComputeHydrodynamicForcesSubmerged(parts[i].solid->getPhysicsMesh(), ocn, getCGTransform(), T_C_part, v, omega, Fdlp, Tdlp, Fdqp, Tdqp, Fdsp, Tdsp);
-                    parts[i].solid->CorrectHydrodynamicForces(ocn, Fdlp, Tdlp, Fdqp, Tdqp, Fdsp, Tdsp);
-                    Fdl += Fdlp;
-                    Tdl += Tdlp;
-                    Fdq += Fdqp;
-                    Tdq += Tdqp;
-                    Fds += Fdsp;
-                    Tds += Tdsp;
-                }
+            if(hydroMesh != NULL) //All external parts in one pass
+            {
+                ComputeHydrodynamicForcesSubmerged(hydroMesh, ocn, getCGTransform(), getOTransform(), v, omega, Fdl, Tdl, Fdq, Tdq, Fds, Tds);
+                CorrectHydrodynamicForces(ocn, Fdl, Tdl, Fdq, Tdq, Fds, Tds);
+            }
+            else
+            {
+                for(size_t i=0; i<parts.size(); ++i) //Go through all parts
+                    if(parts[i].isExternal) //Compute drag only for external parts
+                    {
+                        Transform T_C_part = getOTransform() * parts[i].origin * parts[i].solid->getO2CTransform();
+                        ComputeHydrodynamicForcesSubmerged(parts[i].solid->getPhysicsMesh(), ocn, getCGTransform(), T_C_part, v, omega, Fdlp, Tdlp, Fdqp, Tdqp, Fdsp, Tdsp);
+                        parts[i].solid->CorrectHydrodynamicForces(ocn, Fdlp, Tdlp, Fdqp, Tdqp, Fdsp, Tdsp);
+                        Fdl += Fdlp;
+                        Tdl += Tdlp;
+                        Fdq += Fdqp;
+                        Tdq += Tdqp;
+                        Fds += Fdsp;
+                        Tds += Tdsp;
+                    }
+            }
         }
     }
     else //CROSSING FLUID SURFACE
@@ -371,15 +600,25 @@ void Compound::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean*
             Vector3 Fdsp(0,0,0);
             Vector3 Tdsp(0,0,0);
             
+            if(hydroMesh != NULL) //Buoyancy and drag of all external parts in one pass
+            {
+                ComputeHydrodynamicForcesSurface(settings, hydroMesh, ocn, getCGTransform(), getOTransform(), v, omega, Fb, Tb, Fdl, Tdl, Fdq, Tdq, Fds, Tds, depthCache, submerged);
+                if(settings.dampingForces)
+                    CorrectHydrodynamicForces(ocn, Fdl, Tdl, Fdq, Tdq, Fds, Tds);
+            }
+            
             for(size_t i=0; i<parts.size(); ++i) //Loop through all parts
             {
+                if(parts[i].isExternal && hydroMesh != NULL)
+                    continue;
+                
                 Transform T_C_part = getOTransform() * parts[i].origin * parts[i].solid->getO2CTransform();
                 HydrodynamicsSettings pSettings = settings;
                 pSettings.reallisticBuoyancy &= parts[i].solid->isBuoyant();
                 
                 if(parts[i].isExternal) //Compute buoyancy and drag
                 {
-                    ComputeHydrodynamicForcesSurface(pSettings, parts[i].solid->getPhysicsMesh(), ocn, getCGTransform(), T_C_part, v, omega, Fbp, Tbp, Fdlp, Tdlp, Fdqp, Tdqp, Fdsp, Tdsp, submerged);
+                    ComputeHydrodynamicForcesSurface(pSettings, parts[i].solid->getPhysicsMesh(), ocn, getCGTransform(), T_C_part, v, omega, Fbp, Tbp, Fdlp, Tdlp, Fdqp, Tdqp, Fdsp, Tdsp, parts[i].depthCache, submerged);
                     parts[i].solid->CorrectHydrodynamicForces(ocn, Fdlp, Tdlp, Fdqp, Tdqp, Fdsp, Tdsp);
                     Fb += Fbp;
                     Tb += Tbp;
@@ -393,7 +632,7 @@ void Compound::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean*
                 else if(pSettings.reallisticBuoyancy) //Compute only buoyancy
                 {
                     pSettings.dampingForces = false;
-                    ComputeHydrodynamicForcesSurface(pSettings, parts[i].solid->getPhysicsMesh(), ocn, getCGTransform(), T_C_part, v, omega, Fbp, Tbp, Fdlp, Tdlp, Fdqp, Tdqp, Fdsp, Tdsp, submerged);
+                    ComputeHydrodynamicForcesSurface(pSettings, parts[i].solid->getPhysicsMesh(), ocn, getCGTransform(), T_C_part, v, omega, Fbp, Tbp, Fdlp, Tdlp, Fdqp, Tdqp, Fdsp, Tdsp, parts[i].depthCache, submerged);
                     Fb += Fbp;
                     Tb += Tbp;
                 }
@@ -435,23 +674,21 @@ void Compound::BuildGraphicalObject()
         parts[i].solid->BuildGraphicalObject();
 }
 
-std::vector<Renderable> Compound::Render()
+void Compound::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
-    
     if(isRenderable())
     {
         Renderable item;
         item.type = RenderableType::SOLID_CS;
         item.model = glMatrixFromTransform(getCGTransform());
-        items.push_back(item);
+        queue.Add(item);
         
         Vector3 cbWorld = getCGTransform() * P_CB;
         item.type = RenderableType::HYDRO_CS;
         item.model = glMatrixFromTransform(Transform(Quaternion::getIdentity(), cbWorld));
-        item.points.push_back(glm::vec3(volume, volume, volume));
-        items.push_back(item);
-        item.points.clear();
+        queue.BeginPoints(item);
+        queue.AddPoint(item, glm::vec3(volume, volume, volume));
+        queue.Add(item);
         
         Transform oCompoundTrans = getOTransform();
         
@@ -460,7 +697,7 @@ std::vector<Renderable> Compound::Render()
             if((parts[i].isExternal && !displayInternals) || (!parts[i].isExternal && displayInternals))
             {
                 item.type = RenderableType::SOLID;
-                item.materialName = parts[i].solid->getMaterial().name;
+                item.materialId = parts[i].solid->getMaterial().id;
                 
                 if(dm == DisplayMode::GRAPHICAL)
                 {
@@ -468,7 +705,7 @@ std::vector<Renderable> Compound::Render()
                     item.objectId = parts[i].solid->getGraphicalObject();
                     item.lookId = parts[i].solid->getLook();
                     item.model = glMatrixFromTransform(oTrans);
-                    items.push_back(item);
+                    queue.Add(item);
                 }
                 else if(dm == DisplayMode::PHYSICAL)
                 {
@@ -476,7 +713,7 @@ std::vector<Renderable> Compound::Render()
                     item.objectId = parts[i].solid->getPhysicalObject();
                     item.lookId = -1;
                     item.model = glMatrixFromTransform(oTrans);
-                    items.push_back(item);
+                    queue.Add(item);
                 }
             }
             
@@ -492,49 +729,50 @@ std::vector<Renderable> Compound::Render()
                 
                 case  GeometryApproxType::SPHERE:
                     item.type = RenderableType::HYDRO_ELLIPSOID;
-                    item.points.push_back(glm::vec3((GLfloat)aparams[0], (GLfloat)aparams[0], (GLfloat)aparams[0]));
-                    items.push_back(item);
+                    queue.BeginPoints(item);
+                    queue.AddPoint(item, glm::vec3((GLfloat)aparams[0], (GLfloat)aparams[0], (GLfloat)aparams[0]));
+                    queue.Add(item);
                     break;
                 
                 case  GeometryApproxType::CYLINDER:
                     item.type = RenderableType::HYDRO_CYLINDER;
-                    item.points.push_back(glm::vec3((GLfloat)aparams[0], (GLfloat)aparams[0], (GLfloat)aparams[1]));
-                    items.push_back(item);
+                    queue.BeginPoints(item);
+                    queue.AddPoint(item, glm::vec3((GLfloat)aparams[0], (GLfloat)aparams[0], (GLfloat)aparams[1]));
+                    queue.Add(item);
                     break;
                 
                 case  GeometryApproxType::ELLIPSOID:
                     item.type = RenderableType::HYDRO_ELLIPSOID;
-                    item.points.push_back(glm::vec3((GLfloat)aparams[0], (GLfloat)aparams[1], (GLfloat)aparams[2]));
-                    items.push_back(item);
+                    queue.BeginPoints(item);
+                    queue.AddPoint(item, glm::vec3((GLfloat)aparams[0], (GLfloat)aparams[1], (GLfloat)aparams[2]));
+                    queue.Add(item);
                     break;
             }
-            
-            item.points.clear();
         }
         
         //Forces
         Vector3 cg = getCGTransform().getOrigin();
         glm::vec3 cgv((GLfloat)cg.x(), (GLfloat)cg.y(), (GLfloat)cg.z());
-        item.points.clear();
-        item.points.push_back(cgv);
         item.model = glm::mat4(1.f);
         
         item.type = RenderableType::FORCE_BUOYANCY;
-        item.points.push_back(cgv + glm::vec3((GLfloat)Fb.x(), (GLfloat)Fb.y(), (GLfloat)Fb.z())/1000.f);
-        items.push_back(item);
+        queue.BeginPoints(item);
+        queue.AddPoint(item, cgv);
+        queue.AddPoint(item, cgv + glm::vec3((GLfloat)Fb.x(), (GLfloat)Fb.y(), (GLfloat)Fb.z())/1000.f);
+        queue.Add(item);
         
-        item.points.pop_back();
         item.type = RenderableType::FORCE_LINEAR_DRAG;
-        item.points.push_back(cgv + glm::vec3((GLfloat)Fdl.x(), (GLfloat)Fdl.y(), (GLfloat)Fdl.z()));
-        items.push_back(item);
+        queue.BeginPoints(item);
+        queue.AddPoint(item, cgv);
+        queue.AddPoint(item, cgv + glm::vec3((GLfloat)Fdl.x(), (GLfloat)Fdl.y(), (GLfloat)Fdl.z()));
+        queue.Add(item);
         
-        item.points.pop_back();
         item.type = RenderableType::FORCE_QUADRATIC_DRAG;
-        item.points.push_back(cgv + glm::vec3((GLfloat)Fdq.x(), (GLfloat)Fdq.y(), (GLfloat)Fdq.z()));
-        items.push_back(item);
+        queue.BeginPoints(item);
+        queue.AddPoint(item, cgv);
+        queue.AddPoint(item, cgv + glm::vec3((GLfloat)Fdq.x(), (GLfloat)Fdq.y(), (GLfloat)Fdq.z()));
+        queue.Add(item);
     }
-        
-    return items;
 }
 
 }
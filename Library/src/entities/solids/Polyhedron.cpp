@@ -30,14 +30,42 @@
 #include "utils/SystemUtil.hpp"
 #include "utils/GeometryFileUtil.h"
 
+#define MESH_FACES_HIGH     2000
+#define MESH_FACES_MEDIUM   500
+#define MESH_FACES_LOW      150
+
 namespace sf
 {
 
+MeshDecimation::MeshDecimation(MeshQuality quality)
+{
+    error = Scalar(0);
+    
+    switch(quality)
+    {
+        case MeshQuality::HIGH:
+            faces = MESH_FACES_HIGH;
+            break;
+            
+        case MeshQuality::MEDIUM:
+            faces = MESH_FACES_MEDIUM;
+            break;
+            
+        case MeshQuality::LOW:
+            faces = MESH_FACES_LOW;
+            break;
+            
+        default:
+            faces = 0;
+            break;
+    }
+}
+
 Polyhedron::Polyhedron(std::string uniqueName,
                        std::string graphicsFilename, Scalar graphicsScale, const Transform& graphicsOrigin,
                        std::string physicsFilename, Scalar physicsScale, const Transform& physicsOrigin,
                        std::string material, BodyPhysicsType bpt, std::string look, Scalar thickness,
-                       bool isBuoyant, GeometryApproxType approx)
+                       bool isBuoyant, GeometryApproxType approx, const MeshDecimation& decimation)
                         : SolidEntity(uniqueName, material, bpt, look, thickness, isBuoyant)
 {
     //1.Load geometry from file
@@ -55,7 +83,16 @@ Polyhedron::Polyhedron(std::string uniqueName,
         T_O2C = T_O2G;
     }
     
-    OpenGLContent::Refine(phyMesh, 3.f);
+    if(decimation.faces > 0 || decimation.error > Scalar(0))
+    {
+        //Simplify to a fixed face budget (the graphics mesh is never modified)
+        Mesh* decimated = OpenGLContent::Decimate(phyMesh, decimation.faces, (GLfloat)decimation.error);
+        if(phyMesh != graMesh)
+            delete phyMesh;
+        phyMesh = decimated;
+    }
+    else
+        OpenGLContent::Refine(phyMesh, 3.f);
     
     //2. Compute physical properties
     Vector3 CG;
@@ -76,8 +113,8 @@ Polyhedron::Polyhedron(std::string uniqueName,
     
 Polyhedron::Polyhedron(std::string uniqueName,
                        std::string modelFilename, Scalar scale, const Transform& origin,
-                       std::string material, BodyPhysicsType bpt, std::string look, Scalar thickness, bool isBuoyant, GeometryApproxType approx)
-    : Polyhedron(uniqueName, modelFilename, scale, origin, "", scale, origin, material, bpt, look, thickness, isBuoyant, approx)
+                       std::string material, BodyPhysicsType bpt, std::string look, Scalar thickness, bool isBuoyant, GeometryApproxType approx, const MeshDecimation& decimation)
+    : Polyhedron(uniqueName, modelFilename, scale, origin, "", scale, origin, material, bpt, look, thickness, isBuoyant, approx, decimation)
 {
 }
 
@@ -139,33 +139,29 @@ void Obstacle::BuildGraphicalObject()
     phyObjectId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->BuildObject(phyMesh);
 }
 
-std::vector<Renderable> Obstacle::Render()
+void Obstacle::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
-	
     if(rigidBody != NULL && isRenderable())
     {
         Renderable item;
         item.type = RenderableType::SOLID;
-        item.materialName = mat.name;
+        item.materialId = mat.id;
         
         if(dm == DisplayMode::GRAPHICAL && graObjectId >= 0)
         { 
             item.objectId = graObjectId;
             item.lookId = lookId;
             item.model = glMatrixFromTransform(getTransform());
-            items.push_back(item);
+            queue.Add(item);
         }
         else if(dm == DisplayMode::PHYSICAL && phyObjectId >= 0)
         {
             item.objectId = phyObjectId;
             item.lookId = -1;
             item.model = glMatrixFromTransform(getTransform());
-            items.push_back(item);
+            queue.Add(item);
         }
     }
-	
-	return items;
 }
 
 }
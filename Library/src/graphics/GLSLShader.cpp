@@ -35,64 +35,104 @@ namespace sf
 
 GLuint GLSLShader::saqVertexShader = 0;
 bool GLSLShader::verbose = true;
+std::string GLSLShader::binaryCachePath = "";
+uint64_t GLSLShader::driverHash = 0;
+std::map<GLuint, uint64_t> GLSLShader::shaderHashes;
+
+//Program binary cache
+constexpr char PROGRAM_CACHE_MAGIC[8] = {'S','F','P','R','O','G','B','N'};
+constexpr uint32_t PROGRAM_CACHE_VERSION = 1;
 
 GLSLShader::GLSLShader(const std::vector<GLSLSource>& sources, const std::vector<GLuint>& precompiled)
 {
-    valid = false;
-    program = 0;
-
-    if(sources.size() > 0)
-    {
-        valid = true;
-        
-        std::vector<GLuint> shaders = precompiled;
-        GLint compiled = 0;
-
-        for(size_t i=0; i<sources.size(); ++i)
-        {
-            GLuint shader = LoadShader(sources[i].type, sources[i].filename, sources[i].header, &compiled);
-            if(compiled == 0)
-            {
-                valid = false;
-                break;
-            }
-            shaders.push_back(shader);
-        }
-
-        if(valid)
-        {
-            program = CreateProgram(shaders, precompiled.size());
-            if(program == 0)
-                valid = false;
-        }
-    }
+    Build(sources, precompiled);
 }
 
 GLSLShader::GLSLShader(const std::vector<GLuint>& precompiled)
 {
-    program = CreateProgram(precompiled, precompiled.size());
-    if(program == 0)
-        valid = false;
-    else 
-        valid = true;
+    Build(std::vector<GLSLSource>(0), precompiled);
 }
 
 GLSLShader::GLSLShader(std::string fragment, std::string vertex)
 {
-    valid = false;
-    GLint compiled = 0;
-    GLuint vs;
-    GLuint fs;
-    std::string emptyHeader = "";
-    
+    std::vector<GLSLSource> sources;
     if(vertex == "")
-        vs = saqVertexShader;
+    {
+        sources.push_back(GLSLSource(GL_FRAGMENT_SHADER, fragment));
+        Build(sources, {saqVertexShader});
+    }
     else
-        vs = LoadShader(GL_VERTEX_SHADER, vertex, emptyHeader, &compiled);
+    {
+        sources.push_back(GLSLSource(GL_VERTEX_SHADER, vertex));
+        sources.push_back(GLSLSource(GL_FRAGMENT_SHADER, fragment));
+        Build(sources, std::vector<GLuint>(0));
+    }
+}
+
+void GLSLShader::Build(const std::vector<GLSLSource>& sources, const std::vector<GLuint>& precompiled)
+{
+    valid = false;
+    program = 0;
+
+    if(sources.size() == 0 && precompiled.size() == 0)
+        return;
+
+    //Preprocess sources and compute the cache key of the program
+    std::vector<std::string> processed(sources.size());
+    uint64_t key = driverHash;
+    bool cacheable = binaryCachePath != "";
     
-    fs = LoadShader(GL_FRAGMENT_SHADER, fragment, emptyHeader, &compiled);
-    program = CreateProgram({vs, fs}, vs == saqVertexShader ? 1 : 0);
+    for(size_t i=0; i<precompiled.size(); ++i)
+    {
+        std::map<GLuint, uint64_t>::const_iterator it = shaderHashes.find(precompiled[i]);
+        if(it == shaderHashes.end())
+            cacheable = false;
+        else
+            key = HashData(&it->second, sizeof(it->second), key);
+    }
+    
+    for(size_t i=0; i<sources.size(); ++i)
+    {
+        processed[i] = PreprocessShader(sources[i].filename, sources[i].header);
+        uint64_t shaderHash = HashShader(sources[i].type, processed[i]);
+        key = HashData(&shaderHash, sizeof(shaderHash), key);
+    }
+    
+    //Try to load the program binary
+    if(cacheable)
+    {
+        program = LoadProgramBinary(key);
+        if(program != 0)
+        {
+            valid = true;
+            return;
+        }
+    }
+
+    //Compile and link from source
     valid = true;
+    std::vector<GLuint> shaders = precompiled;
+    GLint compiled = 0;
+
+    for(size_t i=0; i<sources.size(); ++i)
+    {
+        GLuint shader = CompileShader(sources[i].type, processed[i], &compiled);
+        if(compiled == 0)
+        {
+            valid = false;
+            break;
+        }
+        shaders.push_back(shader);
+    }
+
+    if(valid)
+    {
+        program = CreateProgram(shaders, precompiled.size());
+        if(program == 0)
+            valid = false;
+        else if(cacheable)
+            SaveProgramBinary(program, key);
+    }
 }
     
 GLSLShader::~GLSLShader()
@@ -336,7 +376,210 @@ bool GLSLShader::SetUniform(std::string name, glm::mat4 x)
     return success;
 }
 
-bool GLSLShader::GetUniform(std::string name, ParameterType type, GLint& location)
+GLSLUniformHandle GLSLShader::GetUniformHandle(const std::string& name) const
+{
+    for(size_t i=0; i<uniforms.size(); ++i)
+        if(uniforms[i].name == name)
+            return GLSLUniformHandle(uniforms[i].location, uniforms[i].type);
+    return GLSLUniformHandle();
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& handle, bool x)
+{
+#ifdef DEBUG
+    if(handle.type != BOOLEAN)
+    {
+        cError("Uniform handle type mismatch!");
+        return;
+    }
+#endif
+    if(handle.location >= 0)
+        glUniform1i(handle.location, (GLint)x);
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& handle, GLfloat x)
+{
+#ifdef DEBUG
+    if(handle.type != FLOAT)
+    {
+        cError("Uniform handle type mismatch!");
+        return;
+    }
+#endif
+    if(handle.location >= 0)
+        glUniform1f(handle.location, x);
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& handle, glm::vec2 x)
+{
+#ifdef DEBUG
+    if(handle.type != VEC2)
+    {
+        cError("Uniform handle type mismatch!");
+        return;
+    }
+#endif
+    if(handle.location >= 0)
+        glUniform2fv(handle.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& handle, glm::vec3 x)
+{
+#ifdef DEBUG
+    if(handle.type != VEC3)
+    {
+        cError("Uniform handle type mismatch!");
+        return;
+    }
+#endif
+    if(handle.location >= 0)
+        glUniform3fv(handle.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& handle, glm::vec4 x)
+{
+#ifdef DEBUG
+    if(handle.type != VEC4)
+    {
+        cError("Uniform handle type mismatch!");
+        return;
+    }
+#endif
+    if(handle.location >= 0)
+        glUniform4fv(handle.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& handle, GLuint x)
+{
+#ifdef DEBUG
+    if(handle.type != UINT)
+    {
+        cError("Uniform handle type mismatch!");
+        return;
+    }
+#endif
+    if(handle.location >= 0)
+        glUniform1ui(handle.location, x);
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& handle, GLint x)
+{
+#ifdef DEBUG
+    if(handle.type != INT)
+    {
+        cError("Uniform handle type mismatch!");
+        return;
+    }
+#endif
+    if(handle.location >= 0)
+        glUniform1i(handle.location, x);
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& handle, glm::ivec2 x)
+{
+#ifdef DEBUG
+    if(handle.type != IVEC2)
+    {
+        cError("Uniform handle type mismatch!");
+        return;
+    }
+#endif
+    if(handle.location >= 0)
+        glUniform2iv(handle.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& handle, glm::ivec3 x)
+{
+#ifdef DEBUG
+    if(handle.type != IVEC3)
+    {
+        cError("Uniform handle type mismatch!");
+        return;
+    }
+#endif
+    if(handle.location >= 0)
+        glUniform3iv(handle.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& handle, glm::ivec4 x)
+{
+#ifdef DEBUG
+    if(handle.type != IVEC4)
+    {
+        cError("Uniform handle type mismatch!");
+        return;
+    }
+#endif
+    if(handle.location >= 0)
+        glUniform4iv(handle.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& handle, glm::uvec2 x)
+{
+#ifdef DEBUG
+    if(handle.type != UVEC2)
+    {
+        cError("Uniform handle type mismatch!");
+        return;
+    }
+#endif
+    if(handle.location >= 0)
+        glUniform2uiv(handle.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& handle, glm::uvec3 x)
+{
+#ifdef DEBUG
+    if(handle.type != UVEC3)
+    {
+        cError("Uniform handle type mismatch!");
+        return;
+    }
+#endif
+    if(handle.location >= 0)
+        glUniform3uiv(handle.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& handle, glm::uvec4 x)
+{
+#ifdef DEBUG
+    if(handle.type != UVEC4)
+    {
+        cError("Uniform handle type mismatch!");
+        return;
+    }
+#endif
+    if(handle.location >= 0)
+        glUniform4uiv(handle.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& handle, const glm::mat3& x)
+{
+#ifdef DEBUG
+    if(handle.type != MAT3)
+    {
+        cError("Uniform handle type mismatch!");
+        return;
+    }
+#endif
+    if(handle.location >= 0)
+        glUniformMatrix3fv(handle.location, 1, GL_FALSE, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& handle, const glm::mat4& x)
+{
+#ifdef DEBUG
+    if(handle.type != MAT4)
+    {
+        cError("Uniform handle type mismatch!");
+        return;
+    }
+#endif
+    if(handle.location >= 0)
+        glUniformMatrix4fv(handle.location, 1, GL_FALSE, glm::value_ptr(x));
+}
+
+bool GLSLShader::GetUniform(const std::string& name, ParameterType type, GLint& location)
 {
     for(unsigned int i = 0; i < uniforms.size(); i++)
         if(uniforms[i].name == name)
@@ -359,7 +602,7 @@ bool GLSLShader::GetUniform(std::string name, ParameterType type, GLint& locatio
     return false;
 }
 
-bool GLSLShader::GetAttribute(std::string name, ParameterType type, GLint& index)
+bool GLSLShader::GetAttribute(const std::string& name, ParameterType type, GLint& index)
 {
     for(unsigned int i = 0; i < attributes.size(); i++)
         if(attributes[i].name == name)
@@ -413,6 +656,22 @@ bool GLSLShader::BindShaderStorageBlock(std::string name, GLuint bindingPoint)
 //// Statics
 bool GLSLShader::Init()
 {
+    //Check if program binaries can be cached
+    GLint nBinaryFormats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &nBinaryFormats);
+    binaryCachePath = nBinaryFormats > 0 ? GetCachePath() : "";
+    if(binaryCachePath != "")
+    {
+        //Binaries are only valid for the same driver
+        const char* vendor = (const char*)glGetString(GL_VENDOR);
+        const char* renderer = (const char*)glGetString(GL_RENDERER);
+        const char* version = (const char*)glGetString(GL_VERSION);
+        driverHash = HashData(&PROGRAM_CACHE_VERSION, sizeof(PROGRAM_CACHE_VERSION));
+        driverHash = HashString(vendor != NULL ? vendor : "", driverHash);
+        driverHash = HashString(renderer != NULL ? renderer : "", driverHash);
+        driverHash = HashString(version != NULL ? version : "", driverHash);
+    }
+
     GLint compiled;
     std::string emptyHeader = "";
     saqVertexShader = LoadShader(GL_VERTEX_SHADER, "saq.vert", emptyHeader, &compiled);
@@ -437,8 +696,12 @@ void GLSLShader::Verbose()
 
 GLuint GLSLShader::LoadShader(GLenum shaderType, const std::string& filename, const std::string& header, GLint *shaderCompiled)
 {
-    GLuint shader = 0;
-    
+    std::string source = PreprocessShader(filename, header);
+    return CompileShader(shaderType, source, shaderCompiled);
+}
+
+std::string GLSLShader::PreprocessShader(const std::string& filename, const std::string& header)
+{
     std::string basePath = GetShaderPath();
     std::string sourcePath = basePath + filename;
     
@@ -487,38 +750,129 @@ GLuint GLSLShader::LoadShader(GLenum shaderType, const std::string& filename, co
         }
     }
     sourceFile.close();
-    
+    return source;
+}
+
+GLuint GLSLShader::CompileShader(GLenum shaderType, const std::string& source, GLint* shaderCompiled)
+{
     const char* shaderSource = source.c_str();
-    
-    if(shaderSource != NULL)
-    {
-        shader = glCreateShader(shaderType);
-        glShaderSource(shader, 1, (const GLchar**)&shaderSource, NULL);
-        glCompileShader(shader);
-        glGetShaderiv(shader, GL_COMPILE_STATUS, shaderCompiled);
-        if(*shaderCompiled == 0)
-            cError("Failed to compile shader: %s", shaderSource);
+    GLuint shader = glCreateShader(shaderType);
+    glShaderSource(shader, 1, (const GLchar**)&shaderSource, NULL);
+    glCompileShader(shader);
+    glGetShaderiv(shader, GL_COMPILE_STATUS, shaderCompiled);
+    if(*shaderCompiled == 0)
+        cError("Failed to compile shader: %s", shaderSource);
 #ifdef DEBUG	
-        GLint infoLogLength = 0;	
-        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLogLength);
-        if(infoLogLength > 0)
-        {
-            std::vector<char> infoLog(infoLogLength+1);
-            glGetShaderInfoLog(shader, infoLogLength, NULL, &infoLog[0]);
-            cWarning("Shader compile log: %s", &infoLog[0]);
-        }
+    GLint infoLogLength = 0;	
+    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLogLength);
+    if(infoLogLength > 0)
+    {
+        std::vector<char> infoLog(infoLogLength+1);
+        glGetShaderInfoLog(shader, infoLogLength, NULL, &infoLog[0]);
+        cWarning("Shader compile log: %s", &infoLog[0]);
+    }
 #endif
+    //Remember source hash to be able to identify programs using this shader
+    shaderHashes[shader] = HashShader(shaderType, source);
+    return shader;
+}
+
+uint64_t GLSLShader::HashShader(GLenum shaderType, const std::string& source)
+{
+    return HashString(source, HashData(&shaderType, sizeof(shaderType)));
+}
+
+GLuint GLSLShader::LoadProgramBinary(uint64_t key)
+{
+    char filename[64];
+    snprintf(filename, 64, "program_%016llx.bin", (unsigned long long)key);
+    std::string path = binaryCachePath + std::string(filename);
+    
+    FILE* file = fopen(path.c_str(), "rb");
+    if(file == NULL)
+        return 0;
+    
+    char magic[8];
+    uint32_t version;
+    uint64_t fileKey;
+    GLenum format;
+    uint32_t length;
+    std::vector<char> binary;
+    bool ok = fread(magic, sizeof(magic), 1, file) == 1
+              && fread(&version, sizeof(version), 1, file) == 1
+              && fread(&fileKey, sizeof(fileKey), 1, file) == 1
+              && fread(&format, sizeof(format), 1, file) == 1
+              && fread(&length, sizeof(length), 1, file) == 1
+              && memcmp(magic, PROGRAM_CACHE_MAGIC, sizeof(magic)) == 0
+              && version == PROGRAM_CACHE_VERSION
+              && fileKey == key
+              && length > 0;
+    if(ok)
+    {
+        binary.resize(length);
+        ok = fread(binary.data(), 1, length, file) == length;
     }
-    else
-        *shaderCompiled = 0;
+    fclose(file);
     
-    return shader;
+    if(!ok)
+        return 0;
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, format, binary.data(), (GLsizei)length);
+    GLint programLinked = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &programLinked);
+    if(programLinked == 0) //Driver rejected the binary (e.g. after an update)
+    {
+        glDeleteProgram(program);
+        remove(path.c_str());
+        return 0;
+    }
+#ifdef DEBUG
+    if(verbose)
+        cInfo("Loaded program binary from: %s", path.c_str());
+#endif
+    return program;
+}
+
+void GLSLShader::SaveProgramBinary(GLuint program, uint64_t key)
+{
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if(length <= 0)
+        return;
+    
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, NULL, &format, binary.data());
+    
+    char filename[64];
+    snprintf(filename, 64, "program_%016llx.bin", (unsigned long long)key);
+    std::string path = binaryCachePath + std::string(filename);
+    std::string tmpPath = path + ".tmp";
+    
+    FILE* file = fopen(tmpPath.c_str(), "wb");
+    if(file == NULL)
+        return;
+    
+    uint32_t len = (uint32_t)length;
+    bool ok = fwrite(PROGRAM_CACHE_MAGIC, sizeof(PROGRAM_CACHE_MAGIC), 1, file) == 1
+              && fwrite(&PROGRAM_CACHE_VERSION, sizeof(PROGRAM_CACHE_VERSION), 1, file) == 1
+              && fwrite(&key, sizeof(key), 1, file) == 1
+              && fwrite(&format, sizeof(format), 1, file) == 1
+              && fwrite(&len, sizeof(len), 1, file) == 1
+              && fwrite(binary.data(), 1, len, file) == len;
+    fclose(file);
+    
+    if(!ok || rename(tmpPath.c_str(), path.c_str()) != 0)
+        remove(tmpPath.c_str());
 }
 
 GLuint GLSLShader::CreateProgram(const std::vector<GLuint>& compiledShaders, unsigned int doNotDeleteNFirstShaders)
 {
     GLint programLinked = 0;
     GLuint program = glCreateProgram();
+    if(binaryCachePath != "")
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     
     for(unsigned int i=0; i<compiledShaders.size(); ++i)
         if(compiledShaders[i] > 0)
@@ -543,7 +897,10 @@ GLuint GLSLShader::CreateProgram(const std::vector<GLuint>& compiledShaders, uns
         {
             glDetachShader(program, compiledShaders[i]);
             if(i > doNotDeleteNFirstShaders-1)
+            {
                 glDeleteShader(compiledShaders[i]);
+                shaderHashes.erase(compiledShaders[i]);
+            }
         }
     }
     
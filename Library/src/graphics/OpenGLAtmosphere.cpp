@@ -195,6 +195,28 @@ constexpr int SCATTERING_TEXTURE_DEPTH = SCATTERING_TEXTURE_R_SIZE;
 constexpr int IRRADIANCE_TEXTURE_WIDTH = 64;
 constexpr int IRRADIANCE_TEXTURE_HEIGHT = 16;
 
+//Precomputed textures cache
+constexpr char ATMOSPHERE_CACHE_MAGIC[8] = {'S','F','A','T','M','C','H','E'};
+constexpr uint32_t ATMOSPHERE_CACHE_VERSION = 1;
+
+struct AtmosphereTextureInfo
+{
+    GLenum target;
+    GLuint width;
+    GLuint height;
+    GLuint depth;
+    GLenum internalFormat;
+    GLenum type;
+    size_t texelSize;
+};
+
+const AtmosphereTextureInfo ATMOSPHERE_TEXTURE_INFO[AtmosphereTextures::TEXTURE_COUNT] =
+{
+    {GL_TEXTURE_2D, TRANSMITTANCE_TEXTURE_WIDTH, TRANSMITTANCE_TEXTURE_HEIGHT, 1, GL_RGBA32F, GL_FLOAT, 4*sizeof(GLfloat)},
+    {GL_TEXTURE_3D, SCATTERING_TEXTURE_WIDTH, SCATTERING_TEXTURE_HEIGHT, SCATTERING_TEXTURE_DEPTH, GL_RGBA16F, GL_HALF_FLOAT, 4*sizeof(GLushort)},
+    {GL_TEXTURE_2D, IRRADIANCE_TEXTURE_WIDTH, IRRADIANCE_TEXTURE_HEIGHT, 1, GL_RGBA32F, GL_FLOAT, 4*sizeof(GLfloat)}
+};
+
 constexpr double MAX_LUMINOUS_EFFICACY = 683.0; //The conversion factor between watts and lumens.
 constexpr double kLambdaR = 680.0;
 constexpr double kLambdaG = 550.0;
@@ -255,7 +277,22 @@ OpenGLAtmosphere::OpenGLAtmosphere(RenderQuality quality, RenderQuality shadow)
             nScatteringOrders = 6;
     }
     
-    Precompute();
+    //Try to load lookup textures from cache before computing them
+    uint64_t cacheKey = ComputeCacheKey();
+    std::string cachePath = GetCachePath();
+    if(cachePath != "")
+    {
+        char cacheFilename[64];
+        snprintf(cacheFilename, 64, "atmosphere_%016llx.bin", (unsigned long long)cacheKey);
+        cachePath += std::string(cacheFilename);
+    }
+    
+    if(cachePath == "" || !LoadPrecomputedTextures(cachePath, cacheKey))
+    {
+        Precompute();
+        if(cachePath != "")
+            SavePrecomputedTextures(cachePath, cacheKey);
+    }
     
     //Set shadow quality
     switch(shadow)
@@ -587,7 +624,7 @@ glm::mat4 OpenGLAtmosphere::BuildCropProjMatrix(ViewFrustum &f)
     //Make sure all relevant shadow casters are included - use object bounding boxes!
     Vector3 aabbMin;
     Vector3 aabbMax;
-    SimulationApp::getApp()->getSimulationManager()->getWorldAABB(aabbMin, aabbMax);
+    SimulationManager::getCurrent()->getWorldAABB(aabbMin, aabbMax);
 
     transf = shad_mv * glm::vec4(aabbMin.x(), aabbMin.y(), aabbMin.z(), 1.f);
     if(transf.z > maxZ) maxZ = transf.z;
@@ -786,6 +823,127 @@ void OpenGLAtmosphere::Precompute()
 #endif
 }
 
+uint64_t OpenGLAtmosphere::ComputeCacheKey()
+{
+    //Quality settings and texture layout
+    uint32_t params[] = {ATMOSPHERE_CACHE_VERSION, nPrecomputedWavelengths, nScatteringOrders,
+                         TRANSMITTANCE_TEXTURE_WIDTH, TRANSMITTANCE_TEXTURE_HEIGHT,
+                         SCATTERING_TEXTURE_R_SIZE, SCATTERING_TEXTURE_MU_SIZE, SCATTERING_TEXTURE_MU_S_SIZE, SCATTERING_TEXTURE_NU_SIZE,
+                         IRRADIANCE_TEXTURE_WIDTH, IRRADIANCE_TEXTURE_HEIGHT};
+    uint64_t key = HashData(params, sizeof(params));
+    key = HashString(STONEFISH_VER, key); //Precomputation code may change between releases
+    
+    //Atmosphere parameters (also computes the white point)
+    key = HashString(EarthsAtmosphere(glm::dvec3(kLambdaR, kLambdaG, kLambdaB)), key);
+    key = HashString(glslDefinitions, key);
+    key = HashString(glslFunctions, key);
+
+    //Precomputation shaders
+    const char* shaderFiles[] = {"atmosphereTransmittance.frag", "atmosphereDirectIrradiance.frag", "atmosphereSingleScattering.frag",
+                                 "atmosphereScatteringDensity.frag", "atmosphereMultipleScattering.frag", "atmosphereIndirectIrradiance.frag",
+                                 "atmosphere.geom"};
+    for(size_t i=0; i<sizeof(shaderFiles)/sizeof(shaderFiles[0]); ++i)
+    {
+        std::ifstream file(GetShaderPath() + std::string(shaderFiles[i]));
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        key = HashString(buffer.str(), key);
+    }
+    return key;
+}
+
+bool OpenGLAtmosphere::LoadPrecomputedTextures(const std::string& path, uint64_t key)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if(file == NULL)
+        return false;
+    
+    //Check header
+    char magic[8];
+    uint32_t version;
+    uint64_t fileKey;
+    if(fread(magic, sizeof(magic), 1, file) != 1 
+       || fread(&version, sizeof(version), 1, file) != 1 
+       || fread(&fileKey, sizeof(fileKey), 1, file) != 1
+       || memcmp(magic, ATMOSPHERE_CACHE_MAGIC, sizeof(magic)) != 0 
+       || version != ATMOSPHERE_CACHE_VERSION 
+       || fileKey != key)
+    {
+        fclose(file);
+        return false;
+    }
+    
+    //Read texture data
+    std::vector<char> data[AtmosphereTextures::TEXTURE_COUNT];
+    for(unsigned short i=0; i<AtmosphereTextures::TEXTURE_COUNT; ++i)
+    {
+        const AtmosphereTextureInfo& info = ATMOSPHERE_TEXTURE_INFO[i];
+        uint64_t size;
+        if(fread(&size, sizeof(size), 1, file) != 1 
+           || size != (uint64_t)info.width * info.height * info.depth * info.texelSize)
+        {
+            fclose(file);
+            return false;
+        }
+        data[i].resize(size);
+        if(fread(data[i].data(), 1, size, file) != size)
+        {
+            fclose(file);
+            return false;
+        }
+    }
+    fclose(file);
+    
+    //Upload textures
+    for(unsigned short i=0; i<AtmosphereTextures::TEXTURE_COUNT; ++i)
+    {
+        const AtmosphereTextureInfo& info = ATMOSPHERE_TEXTURE_INFO[i];
+        if(textures[i] != 0) glDeleteTextures(1, &textures[i]);
+        textures[i] = OpenGLContent::GenerateTexture(info.target, glm::uvec3(info.width, info.height, info.depth),
+                                                     info.internalFormat, GL_RGBA, info.type, data[i].data(), FilteringMode::BILINEAR, false);
+    }
+    cInfo("Loaded precomputed atmosphere from cache.");
+    return true;
+}
+
+void OpenGLAtmosphere::SavePrecomputedTextures(const std::string& path, uint64_t key)
+{
+    //Write to a temporary file first, to never leave a partially written cache
+    std::string tmpPath = path + ".tmp";
+    FILE* file = fopen(tmpPath.c_str(), "wb");
+    if(file == NULL)
+    {
+        cWarning("Failed to write atmosphere cache file: %s", path.c_str());
+        return;
+    }
+    
+    bool ok = fwrite(ATMOSPHERE_CACHE_MAGIC, sizeof(ATMOSPHERE_CACHE_MAGIC), 1, file) == 1
+              && fwrite(&ATMOSPHERE_CACHE_VERSION, sizeof(ATMOSPHERE_CACHE_VERSION), 1, file) == 1
+              && fwrite(&key, sizeof(key), 1, file) == 1;
+    
+    std::vector<char> data;
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    for(unsigned short i=0; ok && i<AtmosphereTextures::TEXTURE_COUNT; ++i)
+    {
+        const AtmosphereTextureInfo& info = ATMOSPHERE_TEXTURE_INFO[i];
+        uint64_t size = (uint64_t)info.width * info.height * info.depth * info.texelSize;
+        data.resize(size);
+        OpenGLState::BindTexture(TEX_BASE, info.target, textures[i]);
+        glGetTexImage(info.target, 0, GL_RGBA, info.type, data.data());
+        ok = fwrite(&size, sizeof(size), 1, file) == 1 
+             && fwrite(data.data(), 1, size, file) == size;
+    }
+    OpenGLState::UnbindTexture(TEX_BASE);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    fclose(file);
+
+    if(!ok || rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        remove(tmpPath.c_str());
+        cWarning("Failed to write atmosphere cache file: %s", path.c_str());
+    }
+}
+
 void OpenGLAtmosphere::PrecomputePass(GLuint fbo, GLuint delta_irradiance_texture, GLuint delta_rayleigh_scattering_texture,
                                       GLuint delta_mie_scattering_texture, GLuint delta_scattering_density_texture,
                                       GLuint delta_multiple_scattering_texture, const glm::dvec3& lambdas, const glm::dmat3& luminance_from_radiance,
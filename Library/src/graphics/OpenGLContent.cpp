@@ -26,6 +26,8 @@
 #include "graphics/OpenGLContent.h"
 
 #include <map>
+#include <array>
+#include <queue>
 #include <algorithm>
 #include "core/Console.h"
 #include "core/SimulationManager.h"
@@ -45,6 +47,7 @@
 #include "stb_image_write.h"
 
 #define clamp(x,min,max)     (x > max ? max : (x < min ? min : x))
+#define DECIMATION_BOUNDARY_WEIGHT  100.0
 
 namespace sf
 {
@@ -60,6 +63,8 @@ OpenGLContent::OpenGLContent()
     cylinder.vao = 0;
     ellipsoid.vao = 0;
     lightSourceShader[0] = lightSourceShader[1] = NULL;
+    flatShader = NULL;
+    shadowShader = NULL;
     eyePos = glm::vec3();
     viewDir = glm::vec3(1.f,0,0);
     viewProjection = glm::mat4();
@@ -186,16 +191,16 @@ OpenGLContent::OpenGLContent()
     glBindBufferRange(GL_UNIFORM_BUFFER, UBO_LIGHTS, lightsUBO, 0, sizeof(LightsUBO));
     memset(&lightsUBOData, 0, sizeof(LightsUBO));
 
-    ViewUBO viewZero;
-    viewZero.eye = glm::vec4(0.f);
-	viewZero.VP = glm::perspectiveFov(1.57f, 800.f, 600.f, 0.1f, 10000.f);
-    OpenGLView::ExtractFrustumFromVP(viewZero.frustum, viewZero.VP);
+    memset(&viewUBOData, 0, sizeof(ViewUBO));
+	viewUBOData.VP = glm::perspectiveFov(1.57f, 800.f, 600.f, 0.1f, 10000.f);
+    viewUBOData.dir = viewDir;
+    viewUBOData.V = glm::mat4(1.f);
+    OpenGLView::ExtractFrustumFromVP(viewUBOData.frustum, viewUBOData.VP);
     glGenBuffers(1, &viewUBO);
     glBindBuffer(GL_UNIFORM_BUFFER, viewUBO);
-    glBufferData(GL_UNIFORM_BUFFER, sizeof(ViewUBO), NULL, GL_STATIC_DRAW);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(ViewUBO), &viewUBOData, GL_DYNAMIC_DRAW);
     glBindBuffer(GL_UNIFORM_BUFFER, 0);
     glBindBufferRange(GL_UNIFORM_BUFFER, UBO_VIEW, viewUBO, 0, sizeof(ViewUBO));
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(ViewUBO), &viewZero);
     
     //Load shaders
     //-----BASIC-----
@@ -228,9 +233,14 @@ OpenGLContent::OpenGLContent()
     basicShaders["flat"] = new GLSLShader("flat.frag", "flat.vert");
     basicShaders["flat"]->AddUniform("MVP", ParameterType::MAT4);
     basicShaders["flat"]->AddUniform("FC", ParameterType::FLOAT);
+    flatShader = basicShaders["flat"];
+    flatMVP = flatShader->GetUniformHandle("MVP");
+    flatFC = flatShader->GetUniformHandle("FC");
 
     basicShaders["shadow"] = new GLSLShader("shadow.frag", "shadow.vert");
     basicShaders["shadow"]->AddUniform("MVP", ParameterType::MAT4);
+    shadowShader = basicShaders["shadow"];
+    shadowMVP = shadowShader->GetUniformHandle("MVP");
     
     //-----MATERIALS-----
     std::vector<std::string> shadingAlgorithms;
@@ -327,10 +337,6 @@ OpenGLContent::OpenGLContent()
             ms.shaders[h]->AddUniform("MVP", ParameterType::MAT4);
             ms.shaders[h]->AddUniform("M", ParameterType::MAT4);
             ms.shaders[h]->AddUniform("N", ParameterType::MAT3);
-            ms.shaders[h]->AddUniform("MV", ParameterType::MAT3);
-            ms.shaders[h]->AddUniform("FC", ParameterType::FLOAT);
-            ms.shaders[h]->AddUniform("eyePos", ParameterType::VEC3);
-            ms.shaders[h]->AddUniform("viewDir", ParameterType::VEC3);
             ms.shaders[h]->AddUniform("color", ParameterType::VEC4);
             ms.shaders[h]->AddUniform("spotLightsDepthMap", ParameterType::INT);
             ms.shaders[h]->AddUniform("spotLightsShadowMap", ParameterType::INT);
@@ -341,6 +347,7 @@ OpenGLContent::OpenGLContent()
             ms.shaders[h]->AddUniform("irradiance_texture", ParameterType::INT);
             ms.shaders[h]->BindUniformBlock("SunSky", UBO_SUNSKY);
             ms.shaders[h]->BindUniformBlock("Lights", UBO_LIGHTS);
+            ms.shaders[h]->BindUniformBlock("View", UBO_VIEW);
 
             ms.shaders[h]->Use();
             ms.shaders[h]->SetUniform("spotLightsShadowMap", TEX_SPOT_SHADOW);
@@ -373,6 +380,10 @@ OpenGLContent::OpenGLContent()
         shader->AddUniform("roughness", ParameterType::FLOAT);
         shader->AddUniform("metallic", ParameterType::FLOAT);
         shader->AddUniform("reflectivity", ParameterType::FLOAT);
+
+        //Resolve handles once all uniforms are known
+        for(size_t h=0; h<materialShaders.size(); ++h)
+            materialShaders[h].uniforms[i] = ObjectUniforms(materialShaders[h].shaders[i]);
     }
 
     glDeleteShader(materialVertex);
@@ -416,10 +427,6 @@ OpenGLContent::OpenGLContent()
         lightSourceShader[i]->AddUniform("MVP", ParameterType::MAT4);
         lightSourceShader[i]->AddUniform("M", ParameterType::MAT4);
         lightSourceShader[i]->AddUniform("N", ParameterType::MAT3);
-        lightSourceShader[i]->AddUniform("MV", ParameterType::MAT3);
-        lightSourceShader[i]->AddUniform("FC", ParameterType::FLOAT);
-        lightSourceShader[i]->AddUniform("eyePos", ParameterType::VEC3);
-        lightSourceShader[i]->AddUniform("viewDir", ParameterType::VEC3);
         lightSourceShader[i]->AddUniform("color", ParameterType::VEC3);
         lightSourceShader[i]->AddUniform("lightId", ParameterType::IVEC2);
         lightSourceShader[i]->AddUniform("spotLightsDepthMap", ParameterType::INT);
@@ -431,6 +438,8 @@ OpenGLContent::OpenGLContent()
         lightSourceShader[i]->AddUniform("irradiance_texture", ParameterType::INT);
         lightSourceShader[i]->BindUniformBlock("SunSky", UBO_SUNSKY);
         lightSourceShader[i]->BindUniformBlock("Lights", UBO_LIGHTS);
+        lightSourceShader[i]->BindUniformBlock("View", UBO_VIEW);
+        lightSourceUniforms[i] = ObjectUniforms(lightSourceShader[i]);
     }
 
     //Set permanent texture units
@@ -552,8 +561,14 @@ void OpenGLContent::SetCurrentView(OpenGLView* v)
     viewProjection = projection * view;
     FC = v->GetLogDepthConstant();
 
+    //All view-level uniforms are uploaded once per view
+    viewUBOData = *v->getViewUBOData();
+    viewUBOData.eye = eyePos;
+    viewUBOData.FC = FC;
+    viewUBOData.dir = viewDir;
+    viewUBOData.V = view;
     glBindBuffer(GL_UNIFORM_BUFFER, viewUBO);
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(ViewUBO), v->getViewUBOData());
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(ViewUBO), &viewUBOData);
     glBindBuffer(GL_UNIFORM_BUFFER, 0);
     glMemoryBarrier(GL_UNIFORM_BARRIER_BIT);
 }
@@ -712,7 +727,12 @@ void OpenGLContent::DrawEllipsoid(glm::mat4 M, glm::vec3 radii, glm::vec4 color)
 
 void OpenGLContent::DrawPrimitives(PrimitiveType type, std::vector<glm::vec3>& vertices, glm::vec4 color, glm::mat4 M)
 {
-    if(vertices.size() == 0)
+    DrawPrimitives(type, vertices.data(), vertices.size(), color, M);
+}
+
+void OpenGLContent::DrawPrimitives(PrimitiveType type, const glm::vec3* vertices, size_t count, glm::vec4 color, glm::mat4 M)
+{
+    if(count == 0)
         return;
 
     GLuint vbo;
@@ -727,7 +747,7 @@ void OpenGLContent::DrawPrimitives(PrimitiveType type, std::vector<glm::vec3>& v
     glDisableVertexAttribArray(1);
     
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3)*vertices.size(), &vertices[0].x, GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3)*count, &vertices[0].x, GL_STATIC_DRAW);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3*sizeof(GLfloat), (void*)0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     
@@ -736,16 +756,16 @@ void OpenGLContent::DrawPrimitives(PrimitiveType type, std::vector<glm::vec3>& v
     switch(type)
     {
         case PrimitiveType::LINES:
-            glDrawArrays(GL_LINES, 0, (GLsizei)vertices.size());
+            glDrawArrays(GL_LINES, 0, (GLsizei)count);
             break;
         
         case PrimitiveType::LINE_STRIP:
-            glDrawArrays(GL_LINE_STRIP, 0, (GLsizei)vertices.size());
+            glDrawArrays(GL_LINE_STRIP, 0, (GLsizei)count);
             break;
             
         case PrimitiveType::POINTS:
         default:
-            glDrawArrays(GL_POINTS, 0, (GLsizei)vertices.size());
+            glDrawArrays(GL_POINTS, 0, (GLsizei)count);
             break;
     }
     OpenGLState::BindVertexArray(0);
@@ -756,6 +776,14 @@ void OpenGLContent::DrawPrimitives(PrimitiveType type, std::vector<glm::vec3>& v
 }
 
 void OpenGLContent::DrawObject(int objectId, int lookId, const glm::mat4& M)
+{
+    if(mode == DrawingMode::FULL || mode == DrawingMode::UNDERWATER)
+        DrawObject(objectId, lookId, M, glm::mat3(glm::transpose(glm::inverse(M))));
+    else
+        DrawObject(objectId, lookId, M, glm::mat3(1.f)); //Normal matrix not used
+}
+
+void OpenGLContent::DrawObject(int objectId, int lookId, const glm::mat4& M, const glm::mat3& N)
 {
     if(objectId < 0 || objectId >= (int)objects.size())
         return;
@@ -772,8 +800,8 @@ void OpenGLContent::DrawObject(int objectId, int lookId, const glm::mat4& M)
 
         case DrawingMode::SHADOW:
         {
-            basicShaders["shadow"]->Use();
-            basicShaders["shadow"]->SetUniform("MVP", viewProjection*M);
+            shadowShader->Use();
+            shadowShader->SetUniform(shadowMVP, viewProjection*M);
             OpenGLState::BindVertexArray(objects[objectId].vao);
             glDrawElements(GL_TRIANGLES, sizeof(Face) * objects[objectId].faceCount, GL_UNSIGNED_INT, 0);
             OpenGLState::BindVertexArray(0);
@@ -782,9 +810,9 @@ void OpenGLContent::DrawObject(int objectId, int lookId, const glm::mat4& M)
         
         case DrawingMode::FLAT:
         {
-            basicShaders["flat"]->Use();
-            basicShaders["flat"]->SetUniform("MVP", viewProjection*M);
-            basicShaders["flat"]->SetUniform("FC", FC);
+            flatShader->Use();
+            flatShader->SetUniform(flatMVP, viewProjection*M);
+            flatShader->SetUniform(flatFC, FC);
             OpenGLState::BindVertexArray(objects[objectId].vao);
             glDrawElements(GL_TRIANGLES, sizeof(Face) * objects[objectId].faceCount, GL_UNSIGNED_INT, 0);
             OpenGLState::BindVertexArray(0);
@@ -794,9 +822,9 @@ void OpenGLContent::DrawObject(int objectId, int lookId, const glm::mat4& M)
         default:
         {
             if(lookId >= 0 && lookId < (int)looks.size())
-                UseLook(lookId, objects[objectId].texturable, M);
+                UseLook(lookId, objects[objectId].texturable, M, N);
             else
-                UseStandardLook(M);
+                UseStandardLook(M, N);
     
             OpenGLState::BindVertexArray(objects[objectId].vao);
             glDrawElements(GL_TRIANGLES, sizeof(Face) * objects[objectId].faceCount, GL_UNSIGNED_INT, 0);
@@ -821,23 +849,21 @@ void OpenGLContent::DrawLightSource(unsigned int lightId)
     GLint type = lights[lightId]->getType() == LightType::POINT_LIGHT ? 0 : 1; 
     GLint id = lights[lightId]->getType() == LightType::POINT_LIGHT ? lightId : lightId - lightsUBOData.numPointLights;
 
-    GLSLShader* shader = mode == DrawingMode::FULL ? lightSourceShader[0] : lightSourceShader[1];
+    size_t shaderId = mode == DrawingMode::FULL ? 0 : 1;
+    GLSLShader* shader = lightSourceShader[shaderId];
+    const ObjectUniforms& uniforms = lightSourceUniforms[shaderId];
     shader->Use();
-    shader->SetUniform("MVP", viewProjection * M);
-    shader->SetUniform("M", M);
-    shader->SetUniform("N", glm::mat3(glm::transpose(glm::inverse(M))));
-    shader->SetUniform("MV", glm::mat3(glm::transpose(glm::inverse(view*M))));
-    shader->SetUniform("FC", FC);
-    shader->SetUniform("eyePos", eyePos);
-    shader->SetUniform("viewDir", viewDir);
-    shader->SetUniform("color", glm::vec3(colorLi) * colorLi.a);
-    shader->SetUniform("lightId", glm::ivec2(type, id));
+    shader->SetUniform(uniforms.MVP, viewProjection * M);
+    shader->SetUniform(uniforms.M, M);
+    shader->SetUniform(uniforms.N, glm::mat3(glm::transpose(glm::inverse(M))));
+    shader->SetUniform(uniforms.color, glm::vec3(colorLi) * colorLi.a);
+    shader->SetUniform(uniforms.lightId, glm::ivec2(type, id));
     
     if(mode == DrawingMode::UNDERWATER)
     {
-        Ocean* ocean = SimulationApp::getApp()->getSimulationManager()->getOcean();
-        shader->SetUniform("cWater", ocean->getOpenGLOcean()->getLightAttenuation());
-        shader->SetUniform("bWater", ocean->getOpenGLOcean()->getLightScattering());
+        Ocean* ocean = SimulationManager::getCurrent()->getOcean();
+        shader->SetUniform(uniforms.cWater, ocean->getOpenGLOcean()->getLightAttenuation());
+        shader->SetUniform(uniforms.bWater, ocean->getOpenGLOcean()->getLightScattering());
     }
 
     OpenGLState::BindVertexArray(objects[objectId].vao);
@@ -869,10 +895,22 @@ void OpenGLContent::SetupLights()
     glBindBuffer(GL_UNIFORM_BUFFER, 0);
 }
 
+void OpenGLContent::SetObjectUniforms(GLSLShader* shader, const ObjectUniforms& uniforms, const glm::mat4& M, const glm::mat3& N)
+{
+    shader->SetUniform(uniforms.MVP, viewProjection*M);
+    shader->SetUniform(uniforms.M, M);
+    shader->SetUniform(uniforms.N, N);
+}
+
 void OpenGLContent::UseLook(unsigned int lookId, bool texturable, const glm::mat4& M)
+{
+    UseLook(lookId, texturable, M, glm::mat3(glm::transpose(glm::inverse(M))));
+}
+
+void OpenGLContent::UseLook(unsigned int lookId, bool texturable, const glm::mat4& M, const glm::mat3& N)
 {	
     bool waves = false;
-    Ocean* ocean = SimulationApp::getApp()->getSimulationManager()->getOcean();
+    Ocean* ocean = SimulationManager::getCurrent()->getOcean();
     if(ocean != NULL && ocean->hasWaves()) waves = true;
     
     Look& l = looks[lookId];
@@ -887,15 +925,11 @@ void OpenGLContent::UseLook(unsigned int lookId, bool texturable, const glm::mat
     currentShaderMode = shaderMode;
 
     size_t shaderId = (currentTexturable ? 3 : 0) + (size_t)currentShaderMode;
-    GLSLShader* shader = materialShaders[l.type == LookType::SIMPLE ? 0 : 1].shaders[shaderId];
+    MaterialShader& ms = materialShaders[l.type == LookType::SIMPLE ? 0 : 1];
+    GLSLShader* shader = ms.shaders[shaderId];
+    const ObjectUniforms& uniforms = ms.uniforms[shaderId];
     shader->Use();
-    shader->SetUniform("MVP", viewProjection*M);
-    shader->SetUniform("M", M);
-    shader->SetUniform("N", glm::mat3(glm::transpose(glm::inverse(M))));
-    shader->SetUniform("MV", glm::mat3(glm::transpose(glm::inverse(view*M))));
-    shader->SetUniform("FC", FC);
-    shader->SetUniform("eyePos", eyePos);
-    shader->SetUniform("viewDir", viewDir);
+    SetObjectUniforms(shader, uniforms, M, N);
 
     if(updateMaterial)
     {
@@ -904,19 +938,19 @@ void OpenGLContent::UseLook(unsigned int lookId, bool texturable, const glm::mat
             default:
             case LookType::SIMPLE: //Blinn-Phong
             {
-                shader->SetUniform("specularStrength", l.params[0]);
-                shader->SetUniform("shininess", l.params[1]);
-                shader->SetUniform("reflectivity", l.reflectivity);
-                shader->SetUniform("color", glm::vec4(l.color, 1.f));
+                shader->SetUniform(uniforms.specularStrength, l.params[0]);
+                shader->SetUniform(uniforms.shininess, l.params[1]);
+                shader->SetUniform(uniforms.reflectivity, l.reflectivity);
+                shader->SetUniform(uniforms.color, glm::vec4(l.color, 1.f));
             }
             break;
             
             case LookType::PHYSICAL: //Cook-Torrance
             {
-                shader->SetUniform("roughness", l.params[0]);
-                shader->SetUniform("metallic", l.params[1]);
-                shader->SetUniform("reflectivity", l.reflectivity);
-                shader->SetUniform("color", glm::vec4(l.color, 1.f));
+                shader->SetUniform(uniforms.roughness, l.params[0]);
+                shader->SetUniform(uniforms.metallic, l.params[1]);
+                shader->SetUniform(uniforms.reflectivity, l.reflectivity);
+                shader->SetUniform(uniforms.color, glm::vec4(l.color, 1.f));
             }
             break;
         }
@@ -925,23 +959,23 @@ void OpenGLContent::UseLook(unsigned int lookId, bool texturable, const glm::mat
         {
             if(l.albedoTexture > 0)
             {
-                shader->SetUniform("enableAlbedoTex", true);
+                shader->SetUniform(uniforms.enableAlbedoTex, true);
                 OpenGLState::BindTexture(TEX_MAT_ALBEDO, GL_TEXTURE_2D, l.albedoTexture);
             }
             else
             {
-                shader->SetUniform("enableAlbedoTex", false);
+                shader->SetUniform(uniforms.enableAlbedoTex, false);
                 OpenGLState::UnbindTexture(TEX_MAT_ALBEDO);
             }
 
             if(l.normalTexture > 0)
             {
-                shader->SetUniform("enableNormalTex", true);
+                shader->SetUniform(uniforms.enableNormalTex, true);
                 OpenGLState::BindTexture(TEX_MAT_NORMAL, GL_TEXTURE_2D, l.normalTexture);
             }
             else
             {
-                shader->SetUniform("enableNormalTex", false);
+                shader->SetUniform(uniforms.enableNormalTex, false);
                 OpenGLState::UnbindTexture(TEX_MAT_NORMAL);
             }
         }
@@ -949,21 +983,21 @@ void OpenGLContent::UseLook(unsigned int lookId, bool texturable, const glm::mat
 
     if(mode == DrawingMode::UNDERWATER)
     {
-        shader->SetUniform("cWater", ocean->getOpenGLOcean()->getLightAttenuation());
-        shader->SetUniform("bWater", ocean->getOpenGLOcean()->getLightScattering());
+        shader->SetUniform(uniforms.cWater, ocean->getOpenGLOcean()->getLightAttenuation());
+        shader->SetUniform(uniforms.bWater, ocean->getOpenGLOcean()->getLightScattering());
         if(waves)
         {
             OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D_ARRAY, ocean->getOpenGLOcean()->getWaveTexture());
-            shader->SetUniform("texWaveFFT", TEX_POSTPROCESS1);
-            shader->SetUniform("gridSizes", ocean->getOpenGLOcean()->getWaveGridSizes());
+            shader->SetUniform(uniforms.texWaveFFT, (GLint)TEX_POSTPROCESS1);
+            shader->SetUniform(uniforms.gridSizes, ocean->getOpenGLOcean()->getWaveGridSizes());
         }
     }
 }
 
-void OpenGLContent::UseStandardLook(const glm::mat4& M)
+void OpenGLContent::UseStandardLook(const glm::mat4& M, const glm::mat3& N)
 {
     bool waves = false;
-    Ocean* ocean = SimulationApp::getApp()->getSimulationManager()->getOcean();
+    Ocean* ocean = SimulationManager::getCurrent()->getOcean();
     if(ocean != NULL && ocean->hasWaves()) waves = true;
     
     int shaderMode = (mode == DrawingMode::UNDERWATER) ? (waves ? 2 : 1) : 0;
@@ -974,34 +1008,29 @@ void OpenGLContent::UseStandardLook(const glm::mat4& M)
     currentShaderMode = shaderMode;
 
     GLSLShader* shader = materialShaders[1].shaders[(size_t)currentShaderMode];
+    const ObjectUniforms& uniforms = materialShaders[1].uniforms[(size_t)currentShaderMode];
     shader->Use();
-    shader->SetUniform("MVP", viewProjection*M);
-    shader->SetUniform("M", M);
-    shader->SetUniform("N", glm::mat3(glm::transpose(glm::inverse(M))));
-    shader->SetUniform("MV", glm::mat3(glm::transpose(glm::inverse(view*M))));
-    shader->SetUniform("FC", FC);
-    shader->SetUniform("eyePos", eyePos);
-    shader->SetUniform("viewDir", viewDir);
+    SetObjectUniforms(shader, uniforms, M, N);
 
     if(updateMaterial)
     {
-        shader->SetUniform("roughness", 0.5f);
-        shader->SetUniform("metallic", 0.f);
-        shader->SetUniform("reflectivity", 0.f);
-        shader->SetUniform("color", glm::vec4(0.5f, 0.5f, 0.5f, 0.f));
+        shader->SetUniform(uniforms.roughness, 0.5f);
+        shader->SetUniform(uniforms.metallic, 0.f);
+        shader->SetUniform(uniforms.reflectivity, 0.f);
+        shader->SetUniform(uniforms.color, glm::vec4(0.5f, 0.5f, 0.5f, 0.f));
         OpenGLState::UnbindTexture(TEX_MAT_ALBEDO);
         OpenGLState::UnbindTexture(TEX_MAT_NORMAL);
     }
 
     if(mode == DrawingMode::UNDERWATER)
     {
-        shader->SetUniform("cWater", ocean->getOpenGLOcean()->getLightAttenuation());
-        shader->SetUniform("bWater", ocean->getOpenGLOcean()->getLightScattering());
+        shader->SetUniform(uniforms.cWater, ocean->getOpenGLOcean()->getLightAttenuation());
+        shader->SetUniform(uniforms.bWater, ocean->getOpenGLOcean()->getLightScattering());
         if(waves)
         {
             OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D_ARRAY, ocean->getOpenGLOcean()->getWaveTexture());
-            shader->SetUniform("texWaveFFT", TEX_POSTPROCESS1);
-            shader->SetUniform("gridSizes", ocean->getOpenGLOcean()->getWaveGridSizes());
+            shader->SetUniform(uniforms.texWaveFFT, (GLint)TEX_POSTPROCESS1);
+            shader->SetUniform(uniforms.gridSizes, ocean->getOpenGLOcean()->getWaveGridSizes());
         }
     }
 }
@@ -2459,13 +2488,13 @@ void OpenGLContent::Refine(Mesh* mesh, GLfloat sizeThreshold)
     while(1)
     {
         std::vector<Face> newFaces;
+        std::map<std::pair<GLuint, GLuint>, GLuint> lookup; //Shared between faces, so that edge midpoints are not duplicated
         
         for(size_t i=0; i<mesh->faces.size(); ++i)
         {
             if(mesh->ComputeFaceArea(i) > sizeThreshold * avgFaceArea)
             {
                 GLuint mid[3];
-                std::map<std::pair<GLuint, GLuint>, GLuint> lookup;
                 
                 for(unsigned int edge = 0; edge<3; ++edge)
                     mid[edge] = vertex4Edge(lookup, mesh, mesh->faces[i].vertexID[edge], mesh->faces[i].vertexID[(edge+1)%3]);
@@ -2513,6 +2542,521 @@ void OpenGLContent::Refine(Mesh* mesh, GLfloat sizeThreshold)
 #endif
 }
     
+//Quadric error of a vertex (sum of squared distances to planes, weighted by face area)
+struct DecimationQuadric
+{
+    glm::dmat3 A;
+    glm::dvec3 b;
+    double c;
+    double w;
+    
+    DecimationQuadric() : A(0.0), b(0.0), c(0.0), w(0.0) {}
+    
+    void AddPlane(const glm::dvec3& n, double d, double weight)
+    {
+        A += weight * glm::outerProduct(n, n);
+        b += weight * d * n;
+        c += weight * d * d;
+        w += weight;
+    }
+    
+    void Add(const DecimationQuadric& q)
+    {
+        A += q.A;
+        b += q.b;
+        c += q.c;
+        w += q.w;
+    }
+    
+    double Evaluate(const glm::dvec3& v) const
+    {
+        return glm::dot(v, A * v) + 2.0 * glm::dot(b, v) + c;
+    }
+};
+
+//Candidate edge collapse
+struct DecimationCollapse
+{
+    double error;
+    GLuint v0;
+    GLuint v1;
+    GLuint stamp0;
+    GLuint stamp1;
+    glm::dvec3 pos;
+    
+    friend bool operator<(const DecimationCollapse& lhs, const DecimationCollapse& rhs)
+    {
+        return lhs.error > rhs.error; //Smallest error on top of the queue
+    }
+};
+
+//State of the mesh during decimation
+struct DecimationMesh
+{
+    std::vector<glm::dvec3> pos;
+    std::vector<DecimationQuadric> quadrics;
+    std::vector<std::vector<GLuint>> vertexFaces;
+    std::vector<GLuint> stamps;
+    std::vector<bool> removedVertices;
+    std::vector<Face> faces;
+    std::vector<bool> removedFaces;
+    bool closed;
+};
+
+static void DecimationNeighbours(const DecimationMesh& m, GLuint v, std::vector<GLuint>& neighbours)
+{
+    neighbours.clear();
+    for(size_t i=0; i<m.vertexFaces[v].size(); ++i)
+    {
+        GLuint f = m.vertexFaces[v][i];
+        if(m.removedFaces[f]) continue;
+        for(unsigned short h=0; h<3; ++h)
+            if(m.faces[f].vertexID[h] != v)
+                neighbours.push_back(m.faces[f].vertexID[h]);
+    }
+    std::sort(neighbours.begin(), neighbours.end());
+    neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+}
+
+static bool DecimationSolve(const DecimationQuadric& q, const glm::dvec3& g, double d, bool constrained, glm::dvec3& v)
+{
+    //Minimise the quadric error, optionally subject to g.v = d (volume preservation), using Lagrange multiplier
+    double M[4][5];
+    unsigned int n = constrained ? 4 : 3;
+    for(unsigned int r=0; r<3; ++r)
+    {
+        for(unsigned int c=0; c<3; ++c)
+            M[r][c] = q.A[c][r];
+        M[r][3] = g[r];
+        M[r][n] = -q.b[r];
+    }
+    M[3][0] = g.x;
+    M[3][1] = g.y;
+    M[3][2] = g.z;
+    M[3][3] = 0.0;
+    M[3][4] = d;
+    
+    double scale = q.A[0][0] + q.A[1][1] + q.A[2][2] + (constrained ? glm::dot(g, g) : 0.0);
+    if(scale <= 0.0)
+        return false;
+    
+    //Gaussian elimination with partial pivoting
+    for(unsigned int c=0; c<n; ++c)
+    {
+        unsigned int p = c;
+        for(unsigned int r=c+1; r<n; ++r)
+            if(fabs(M[r][c]) > fabs(M[p][c]))
+                p = r;
+        if(fabs(M[p][c]) < 1e-9 * scale)
+            return false;
+        if(p != c)
+            for(unsigned int k=0; k<=n; ++k)
+                std::swap(M[c][k], M[p][k]);
+        for(unsigned int r=c+1; r<n; ++r)
+        {
+            double f = M[r][c]/M[c][c];
+            for(unsigned int k=c; k<=n; ++k)
+                M[r][k] -= f * M[c][k];
+        }
+    }
+    
+    double x[4];
+    for(int r=(int)n-1; r>=0; --r)
+    {
+        double s = M[r][n];
+        for(unsigned int k=r+1; k<n; ++k)
+            s -= M[r][k] * x[k];
+        x[r] = s/M[r][r];
+    }
+    
+    v = glm::dvec3(x[0], x[1], x[2]);
+    return true;
+}
+
+static bool DecimationEvaluate(const DecimationMesh& m, GLuint v0, GLuint v1, DecimationCollapse& collapse)
+{
+    const glm::dvec3& p0 = m.pos[v0];
+    const glm::dvec3& p1 = m.pos[v1];
+    DecimationQuadric q = m.quadrics[v0];
+    q.Add(m.quadrics[v1]);
+    
+    //Volume constraint: the sum of signed tetrahedra volumes of the faces around the edge has to stay the same
+    glm::dvec3 g(0.0);
+    double d = 0.0;
+    if(m.closed)
+    {
+        for(unsigned short e=0; e<2; ++e)
+        {
+            GLuint v = e == 0 ? v0 : v1;
+            GLuint o = e == 0 ? v1 : v0;
+            for(size_t i=0; i<m.vertexFaces[v].size(); ++i)
+            {
+                GLuint f = m.vertexFaces[v][i];
+                if(m.removedFaces[f]) continue;
+                const Face& fc = m.faces[f];
+                bool shared = fc.vertexID[0] == o || fc.vertexID[1] == o || fc.vertexID[2] == o;
+                if(shared && e == 1) continue; //Already counted
+                
+                const glm::dvec3& a = m.pos[fc.vertexID[0]];
+                const glm::dvec3& b = m.pos[fc.vertexID[1]];
+                const glm::dvec3& c = m.pos[fc.vertexID[2]];
+                d += glm::dot(a, glm::cross(b, c));
+                
+                if(!shared)
+                {
+                    unsigned short k = fc.vertexID[0] == v ? 0 : (fc.vertexID[1] == v ? 1 : 2);
+                    g += glm::cross(m.pos[fc.vertexID[(k+1)%3]], m.pos[fc.vertexID[(k+2)%3]]);
+                }
+            }
+        }
+    }
+    bool constrained = m.closed && glm::dot(g, g) > 1e-24;
+    
+    //Optimal position, rejected if it runs away from the edge (flat or degenerate neighbourhood)
+    glm::dvec3 mid = (p0 + p1) * 0.5;
+    double len = glm::length(p1 - p0);
+    glm::dvec3 v;
+    if(!DecimationSolve(q, g, d, constrained, v) || glm::length(v - mid) > len)
+    {
+        glm::dvec3 candidates[3] = {mid, p0, p1};
+        double best = -1.0;
+        for(unsigned short i=0; i<3; ++i)
+        {
+            glm::dvec3 c = candidates[i];
+            if(constrained)
+                c += g * ((d - glm::dot(g, c))/glm::dot(g, g));
+            double err = q.Evaluate(c);
+            if(best < 0.0 || err < best)
+            {
+                best = err;
+                v = c;
+            }
+        }
+    }
+    
+    collapse.v0 = v0;
+    collapse.v1 = v1;
+    collapse.stamp0 = m.stamps[v0];
+    collapse.stamp1 = m.stamps[v1];
+    collapse.pos = v;
+    collapse.error = q.w > 0.0 ? sqrt(std::max(q.Evaluate(v), 0.0)/q.w) : 0.0;
+    return true;
+}
+
+static bool DecimationIsValid(const DecimationMesh& m, const DecimationCollapse& collapse, std::vector<GLuint>& n0, std::vector<GLuint>& n1)
+{
+    GLuint v0 = collapse.v0;
+    GLuint v1 = collapse.v1;
+    
+    //Link condition (keeps the mesh manifold)
+    DecimationNeighbours(m, v0, n0);
+    DecimationNeighbours(m, v1, n1);
+    size_t common = 0;
+    for(size_t i=0, j=0; i<n0.size() && j<n1.size();)
+    {
+        if(n0[i] < n1[j]) ++i;
+        else if(n0[i] > n1[j]) ++j;
+        else { ++common; ++i; ++j; }
+    }
+    size_t shared = 0;
+    for(size_t i=0; i<m.vertexFaces[v0].size(); ++i)
+    {
+        const Face& f = m.faces[m.vertexFaces[v0][i]];
+        if(!m.removedFaces[m.vertexFaces[v0][i]] && (f.vertexID[0] == v1 || f.vertexID[1] == v1 || f.vertexID[2] == v1))
+            ++shared;
+    }
+    if(shared == 0 || common != shared)
+        return false;
+    
+    //Faces must not flip or degenerate
+    for(unsigned short e=0; e<2; ++e)
+    {
+        GLuint v = e == 0 ? v0 : v1;
+        GLuint o = e == 0 ? v1 : v0;
+        for(size_t i=0; i<m.vertexFaces[v].size(); ++i)
+        {
+            GLuint f = m.vertexFaces[v][i];
+            if(m.removedFaces[f]) continue;
+            const Face& fc = m.faces[f];
+            if(fc.vertexID[0] == o || fc.vertexID[1] == o || fc.vertexID[2] == o) continue;
+            
+            glm::dvec3 p[3];
+            for(unsigned short h=0; h<3; ++h)
+                p[h] = m.pos[fc.vertexID[h]];
+            glm::dvec3 nOld = glm::cross(p[1]-p[0], p[2]-p[0]);
+            for(unsigned short h=0; h<3; ++h)
+                if(fc.vertexID[h] == v) p[h] = collapse.pos;
+            glm::dvec3 nNew = glm::cross(p[1]-p[0], p[2]-p[0]);
+            
+            double lOld = glm::length(nOld);
+            double lNew = glm::length(nNew);
+            if(lNew < 1e-6 * lOld || glm::dot(nOld, nNew) < 0.2 * lOld * lNew)
+                return false;
+        }
+    }
+    return true;
+}
+
+static void DecimationPushEdges(const DecimationMesh& m, GLuint v, std::vector<GLuint>& neighbours, std::priority_queue<DecimationCollapse>& queue)
+{
+    DecimationNeighbours(m, v, neighbours);
+    for(size_t i=0; i<neighbours.size(); ++i)
+    {
+        DecimationCollapse c;
+        if(DecimationEvaluate(m, v, neighbours[i], c))
+            queue.push(c);
+    }
+}
+
+static void DecimationMassProperties(const DecimationMesh& m, double& volume, glm::dvec3& centroid)
+{
+    volume = 0.0;
+    centroid = glm::dvec3(0.0);
+    for(size_t i=0; i<m.faces.size(); ++i)
+    {
+        if(m.removedFaces[i]) continue;
+        const glm::dvec3& a = m.pos[m.faces[i].vertexID[0]];
+        const glm::dvec3& b = m.pos[m.faces[i].vertexID[1]];
+        const glm::dvec3& c = m.pos[m.faces[i].vertexID[2]];
+        double v6 = glm::dot(a, glm::cross(b, c));
+        volume += v6;
+        centroid += v6 * (a + b + c);
+    }
+    if(fabs(volume) > 0.0)
+        centroid /= 4.0 * volume;
+    volume /= 6.0;
+}
+
+Mesh* OpenGLContent::Decimate(const Mesh* mesh, size_t targetFaces, GLfloat maxError)
+{
+    DecimationMesh m;
+    
+    //1. Weld vertices (meshes are often split at normal/texture seams)
+    size_t nv = mesh->getNumOfVertices();
+    glm::dvec3 bbMin(BT_LARGE_FLOAT), bbMax(-BT_LARGE_FLOAT);
+    for(size_t i=0; i<nv; ++i)
+    {
+        glm::dvec3 p = glm::dvec3(mesh->getVertexPos(i));
+        bbMin = glm::min(bbMin, p);
+        bbMax = glm::max(bbMax, p);
+    }
+    double weldTol = nv > 0 ? std::max(glm::length(bbMax - bbMin) * 1e-6, 1e-9) : 1.0;
+    
+    std::vector<std::array<int64_t, 3>> keys(nv);
+    std::vector<size_t> order(nv);
+    for(size_t i=0; i<nv; ++i)
+    {
+        glm::dvec3 p = glm::dvec3(mesh->getVertexPos(i))/weldTol;
+        keys[i] = {(int64_t)llround(p.x), (int64_t)llround(p.y), (int64_t)llround(p.z)};
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&keys](size_t a, size_t b) { return keys[a] < keys[b]; });
+    
+    std::vector<GLuint> weld(nv);
+    for(size_t i=0; i<nv; ++i)
+    {
+        if(i == 0 || keys[order[i]] != keys[order[i-1]])
+            m.pos.push_back(glm::dvec3(mesh->getVertexPos(order[i])));
+        weld[order[i]] = (GLuint)m.pos.size()-1;
+    }
+    
+    for(size_t i=0; i<mesh->faces.size(); ++i)
+    {
+        Face f;
+        for(unsigned short h=0; h<3; ++h)
+            f.vertexID[h] = weld[mesh->faces[i].vertexID[h]];
+        if(f.vertexID[0] != f.vertexID[1] && f.vertexID[1] != f.vertexID[2] && f.vertexID[2] != f.vertexID[0])
+            m.faces.push_back(f);
+    }
+    
+    size_t nFacesBefore = m.faces.size();
+    m.removedFaces.assign(m.faces.size(), false);
+    m.removedVertices.assign(m.pos.size(), false);
+    m.stamps.assign(m.pos.size(), 0);
+    m.vertexFaces.resize(m.pos.size());
+    m.quadrics.resize(m.pos.size());
+    
+    //2. Find boundary edges
+    std::vector<std::pair<uint64_t, GLuint>> edges;
+    edges.reserve(m.faces.size() * 3);
+    for(size_t i=0; i<m.faces.size(); ++i)
+        for(unsigned short h=0; h<3; ++h)
+        {
+            uint64_t a = m.faces[i].vertexID[h];
+            uint64_t b = m.faces[i].vertexID[(h+1)%3];
+            edges.push_back(std::make_pair(a < b ? (a << 32) | b : (b << 32) | a, (GLuint)i));
+        }
+    std::sort(edges.begin(), edges.end());
+    
+    //3. Initial quadrics (face planes and planes perpendicular to the boundary)
+    for(size_t i=0; i<m.faces.size(); ++i)
+    {
+        const Face& f = m.faces[i];
+        glm::dvec3 n = glm::cross(m.pos[f.vertexID[1]] - m.pos[f.vertexID[0]], m.pos[f.vertexID[2]] - m.pos[f.vertexID[0]]);
+        double area = glm::length(n)/2.0;
+        if(area <= 0.0) 
+            area = 0.0;
+        else 
+            n = glm::normalize(n);
+        
+        DecimationQuadric q;
+        q.AddPlane(n, -glm::dot(n, m.pos[f.vertexID[0]]), area);
+        for(unsigned short h=0; h<3; ++h)
+        {
+            m.quadrics[f.vertexID[h]].Add(q);
+            m.vertexFaces[f.vertexID[h]].push_back((GLuint)i);
+        }
+    }
+    
+    m.closed = true;
+    for(size_t i=0; i<edges.size();)
+    {
+        size_t j = i+1;
+        while(j < edges.size() && edges[j].first == edges[i].first) ++j;
+        if(j - i == 1) //Boundary edge
+        {
+            m.closed = false;
+            GLuint a = (GLuint)(edges[i].first >> 32);
+            GLuint b = (GLuint)(edges[i].first & 0xFFFFFFFF);
+            const Face& f = m.faces[edges[i].second];
+            glm::dvec3 e = m.pos[b] - m.pos[a];
+            glm::dvec3 fn = glm::cross(m.pos[f.vertexID[1]] - m.pos[f.vertexID[0]], m.pos[f.vertexID[2]] - m.pos[f.vertexID[0]]);
+            glm::dvec3 n = glm::cross(e, fn);
+            if(glm::length(n) > 0.0)
+            {
+                n = glm::normalize(n);
+                DecimationQuadric q;
+                q.AddPlane(n, -glm::dot(n, m.pos[a]), DECIMATION_BOUNDARY_WEIGHT * glm::dot(e, e));
+                m.quadrics[a].Add(q);
+                m.quadrics[b].Add(q);
+            }
+        }
+        i = j;
+    }
+    
+    double volume0;
+    glm::dvec3 centroid0;
+    DecimationMassProperties(m, volume0, centroid0);
+    
+    //4. Collapse edges in the order of increasing error
+    std::priority_queue<DecimationCollapse> queue;
+    std::vector<GLuint> n0, n1;
+    for(size_t i=0; i<edges.size(); ++i)
+    {
+        if(i > 0 && edges[i].first == edges[i-1].first) continue;
+        DecimationCollapse c;
+        if(DecimationEvaluate(m, (GLuint)(edges[i].first >> 32), (GLuint)(edges[i].first & 0xFFFFFFFF), c))
+            queue.push(c);
+    }
+    
+    size_t nFaces = m.faces.size();
+    bool limited = targetFaces > 0 || maxError > 0.f;
+    
+    while(limited && !queue.empty() && nFaces > std::max(targetFaces, (size_t)4))
+    {
+        DecimationCollapse c = queue.top();
+        queue.pop();
+        
+        if(m.removedVertices[c.v0] || m.removedVertices[c.v1]
+           || m.stamps[c.v0] != c.stamp0 || m.stamps[c.v1] != c.stamp1)
+            continue; //Outdated
+        
+        if(maxError > 0.f && c.error > (double)maxError)
+            break;
+        
+        if(!DecimationIsValid(m, c, n0, n1))
+            continue;
+        
+        //Collapse v1 into v0
+        m.pos[c.v0] = c.pos;
+        m.quadrics[c.v0].Add(m.quadrics[c.v1]);
+        m.removedVertices[c.v1] = true;
+        
+        for(size_t i=0; i<m.vertexFaces[c.v1].size(); ++i)
+        {
+            GLuint f = m.vertexFaces[c.v1][i];
+            if(m.removedFaces[f]) continue;
+            Face& fc = m.faces[f];
+            if(fc.vertexID[0] == c.v0 || fc.vertexID[1] == c.v0 || fc.vertexID[2] == c.v0)
+            {
+                m.removedFaces[f] = true;
+                --nFaces;
+            }
+            else
+            {
+                for(unsigned short h=0; h<3; ++h)
+                    if(fc.vertexID[h] == c.v1) fc.vertexID[h] = c.v0;
+                m.vertexFaces[c.v0].push_back(f);
+            }
+        }
+        m.vertexFaces[c.v1].clear();
+        
+        std::vector<GLuint>& vf = m.vertexFaces[c.v0];
+        vf.erase(std::remove_if(vf.begin(), vf.end(), [&m](GLuint f) { return m.removedFaces[f]; }), vf.end());
+        
+        //Update the costs of all edges affected by the new position
+        DecimationNeighbours(m, c.v0, n0);
+        ++m.stamps[c.v0];
+        for(size_t i=0; i<n0.size(); ++i)
+            ++m.stamps[n0[i]];
+        std::vector<GLuint> ring = n0;
+        DecimationPushEdges(m, c.v0, n1, queue);
+        for(size_t i=0; i<ring.size(); ++i)
+            DecimationPushEdges(m, ring[i], n1, queue);
+    }
+    
+    //5. Restore volume and centroid lost to numerical drift (closed meshes only)
+    if(m.closed && nFaces < nFacesBefore)
+    {
+        double volume1;
+        glm::dvec3 centroid1;
+        DecimationMassProperties(m, volume1, centroid1);
+        
+        if(volume0 > 0.0 && volume1 > 0.0)
+        {
+            double s = cbrt(volume0/volume1);
+            for(size_t i=0; i<m.pos.size(); ++i)
+                if(!m.removedVertices[i])
+                    m.pos[i] = centroid0 + (m.pos[i] - centroid1) * s;
+        }
+    }
+    
+    //6. Build output mesh
+    PlainMesh* out = new PlainMesh();
+    std::vector<GLuint> remap(m.pos.size(), 0);
+    std::vector<bool> used(m.pos.size(), false);
+    for(size_t i=0; i<m.faces.size(); ++i)
+        if(!m.removedFaces[i])
+            for(unsigned short h=0; h<3; ++h)
+                used[m.faces[i].vertexID[h]] = true;
+    
+    for(size_t i=0; i<m.pos.size(); ++i)
+        if(used[i])
+        {
+            Vertex vt;
+            vt.pos = glm::vec3(m.pos[i]);
+            vt.normal = glm::vec3(0.f);
+            remap[i] = (GLuint)out->vertices.size();
+            out->vertices.push_back(vt);
+        }
+    
+    for(size_t i=0; i<m.faces.size(); ++i)
+        if(!m.removedFaces[i])
+        {
+            Face f;
+            for(unsigned short h=0; h<3; ++h)
+                f.vertexID[h] = remap[m.faces[i].vertexID[h]];
+            out->faces.push_back(f);
+        }
+    
+    SmoothNormals(out);
+    
+#ifdef DEBUG
+    cInfo("Mesh decimated (%lu/%lu).", (unsigned long)nFacesBefore, (unsigned long)out->faces.size());
+#endif
+    return out;
+}
+    
 void OpenGLContent::AABB(Mesh* mesh, glm::vec3& min, glm::vec3& max)
 {
     GLfloat minX=BT_LARGE_FLOAT, maxX=-BT_LARGE_FLOAT;
@@ -170,4 +170,43 @@ glm::vec3 glVectorFromVector(const Vector3& v)
     return glm::vec3((GLfloat)v.getX(), (GLfloat)v.getY(), (GLfloat)v.getZ());
 }
 
+void DrawingQueue::Add(const Renderable& r)
+{
+    renderables.push_back(r);
+}
+
+void DrawingQueue::BeginPoints(Renderable& r)
+{
+    r.firstPoint = (unsigned int)points.size();
+    r.numPoints = 0;
+}
+
+void DrawingQueue::AddPoint(Renderable& r, const glm::vec3& p)
+{
+    points.push_back(p);
+    ++r.numPoints;
+}
+
+void DrawingQueue::AddPoints(Renderable& r, const std::vector<glm::vec3>& p)
+{
+    points.insert(points.end(), p.begin(), p.end());
+    r.numPoints += (unsigned int)p.size();
+}
+
+void DrawingQueue::Clear()
+{
+    renderables.clear();
+    points.clear();
+}
+
+const glm::vec3* DrawingQueue::getPoints(const Renderable& r) const
+{
+    return points.data() + r.firstPoint;
+}
+
+std::vector<Renderable>& DrawingQueue::getRenderables()
+{
+    return renderables;
+}
+
 }
@@ -71,7 +71,7 @@ void OpenGLDebugDrawer::draw3dText(const Vector3& location, const char* textStri
 
 void OpenGLDebugDrawer::reportErrorWarning(const char* warningString)
 {
-    cWarning(warningString);
+    cWarning("%s", warningString);
 }
 
 void OpenGLDebugDrawer::Render()
@@ -332,7 +332,7 @@ void OpenGLFLS::ComputeOutput(std::vector<Renderable>& objects)
             const Object& obj = content->getObject(objects[h].objectId);
             const Look& look = content->getLook(objects[h].lookId);
             glm::mat4 M = objects[h].model;
-            Material mat = SimulationApp::getApp()->getSimulationManager()->getMaterialManager()->getMaterial(objects[h].materialName);
+            Material mat = SimulationManager::getCurrent()->getMaterialManager()->getMaterial(objects[h].materialId);
             bool normalMapping = obj.texturable && (look.normalTexture > 0);
             shader = normalMapping ? sonarInputShader[1] : sonarInputShader[0];
             shader->Use();
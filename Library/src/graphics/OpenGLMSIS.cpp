@@ -315,7 +315,7 @@ void OpenGLMSIS::ComputeOutput(std::vector<Renderable>& objects)
         const Object& obj = content->getObject(objects[i].objectId);
         const Look& look = content->getLook(objects[i].lookId);
         glm::mat4 M = objects[i].model;
-        Material mat = SimulationApp::getApp()->getSimulationManager()->getMaterialManager()->getMaterial(objects[i].materialName);
+        Material mat = SimulationManager::getCurrent()->getMaterialManager()->getMaterial(objects[i].materialId);
         bool normalMapping = obj.texturable && (look.normalTexture > 0);
         shader = normalMapping ? sonarInputShader[1] : sonarInputShader[0];
         shader->Use();
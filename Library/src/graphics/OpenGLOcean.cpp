@@ -374,6 +374,12 @@ GLfloat OpenGLOcean::ComputeWaveHeight(GLfloat x, GLfloat y)
     return 0.f;
 }
 
+void OpenGLOcean::ComputeWaveHeights(const glm::vec3* points, size_t n, GLfloat* heights)
+{
+    for(size_t i=0; i<n; ++i)
+        heights[i] = ComputeWaveHeight(points[i].x, points[i].y);
+}
+
 GLuint OpenGLOcean::getWaveTexture()
 {
     return oceanTextures[3];
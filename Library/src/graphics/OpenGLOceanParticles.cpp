@@ -111,9 +111,6 @@ void OpenGLOceanParticles::Draw(OpenGLCamera* cam, OpenGLOcean* glOcn)
     renderShader->SetUniform("MV", MV);
     renderShader->SetUniform("iMV", glm::inverse(MV));
     renderShader->SetUniform("P", cam->GetProjectionMatrix());
-    renderShader->SetUniform("FC", cam->GetLogDepthConstant());
-    renderShader->SetUniform("eyePos", cam->GetEyePosition());
-    renderShader->SetUniform("viewDir", cam->GetLookingDirection());
     renderShader->SetUniform("cWater", glOcn->getLightAttenuation());
     renderShader->SetUniform("bWater", glOcn->getLightScattering());
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SSBO_PARTICLE_POS, particlePosSSBO);
@@ -165,9 +162,6 @@ void OpenGLOceanParticles::Init()
     renderShader->AddUniform("MV", ParameterType::MAT4);
     renderShader->AddUniform("iMV", ParameterType::MAT4);
     renderShader->AddUniform("P", ParameterType::MAT4);
-    renderShader->AddUniform("FC", ParameterType::FLOAT);
-    renderShader->AddUniform("eyePos", ParameterType::VEC3);
-    renderShader->AddUniform("viewDir", ParameterType::VEC3);
     renderShader->AddUniform("color", ParameterType::VEC4);
     renderShader->AddUniform("texAlbedo", ParameterType::INT);
     renderShader->AddUniform("enableAlbedoTex", ParameterType::BOOLEAN);
@@ -180,6 +174,7 @@ void OpenGLOceanParticles::Init()
     renderShader->AddUniform("irradiance_texture", ParameterType::INT);
     renderShader->BindUniformBlock("SunSky", UBO_SUNSKY);
     renderShader->BindUniformBlock("Lights", UBO_LIGHTS);
+    renderShader->BindUniformBlock("View", UBO_VIEW);
     renderShader->BindShaderStorageBlock("Positions", SSBO_PARTICLE_POS);
 
     renderShader->Use();
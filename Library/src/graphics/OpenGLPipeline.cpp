@@ -45,10 +45,13 @@
 #include "entities/forcefields/Atmosphere.h"
 #include "core/GraphicalSimulationApp.h"
 
+#define DRAWING_QUEUE_INDEX_MASK    0x3
+#define DRAWING_QUEUE_FRESH_BIT     0x4
+
 namespace sf
 {
 
-OpenGLPipeline::OpenGLPipeline(RenderSettings s, HelperSettings h) : rSettings(s), hSettings(h)
+OpenGLPipeline::OpenGLPipeline(RenderSettings s, HelperSettings h) : rSettings(s), hSettings(h), backQueue(0), frontQueue(1), readyQueue(2)
 {
     drawingQueueMutex = SDL_CreateMutex();
     
@@ -122,56 +125,66 @@ OpenGLContent* OpenGLPipeline::getContent()
     return content;
 }
 
-void OpenGLPipeline::AddToDrawingQueue(const Renderable& r)
+DrawingQueue& OpenGLPipeline::getDrawingQueue()
+{
+    return drawingQueue[backQueue];
+}
+
+DrawingQueue& OpenGLPipeline::getSelectedDrawingQueue()
 {
-    drawingQueue.push_back(r);
+    return selectedDrawingQueue[backQueue];
 }
 
-void OpenGLPipeline::AddToDrawingQueue(const std::vector<Renderable>& r)
+void OpenGLPipeline::PublishDrawingQueue()
 {
-    drawingQueue.insert(drawingQueue.end(), r.begin(), r.end());
+    //Swap back queue with the ready one (the rendering thread always takes the latest)
+    backQueue = readyQueue.exchange(backQueue | DRAWING_QUEUE_FRESH_BIT, std::memory_order_acq_rel) & DRAWING_QUEUE_INDEX_MASK;
+    DiscardDrawingQueue(); //Clearing keeps the capacity of the queues
 }
 
-void OpenGLPipeline::AddToSelectedDrawingQueue(const std::vector<Renderable>& r)
+void OpenGLPipeline::DiscardDrawingQueue()
 {
-    selectedDrawingQueue.insert(selectedDrawingQueue.end(), r.begin(), r.end());
+    drawingQueue[backQueue].Clear();
+    selectedDrawingQueue[backQueue].Clear();
 }
 
 bool OpenGLPipeline::isDrawingQueueEmpty()
 {
-    return drawingQueue.empty();
+    return (readyQueue.load(std::memory_order_acquire) & DRAWING_QUEUE_FRESH_BIT) == 0;
 }
     
-void OpenGLPipeline::PerformDrawingQueueCopy(SimulationManager* sim)
+void OpenGLPipeline::AcquireDrawingQueue(SimulationManager* sim)
 {
-    if(!drawingQueue.empty())
-    {
-        drawingQueueCopy.clear();
-        selectedDrawingQueueCopy.clear();
-
-        SDL_LockMutex(drawingQueueMutex);
-        //Double buffering
-        drawingQueueCopy.insert(drawingQueueCopy.end(), drawingQueue.begin(), drawingQueue.end());
-        selectedDrawingQueueCopy.insert(selectedDrawingQueueCopy.end(), selectedDrawingQueue.begin(), selectedDrawingQueue.end());
-
-        //Update vision sensor transforms and copy generated data to ensure consistency
-        glMemoryBarrier(GL_PIXEL_BUFFER_BARRIER_BIT);
-        for(unsigned int i=0; i < content->getViewsCount(); ++i)
-            content->getView(i)->UpdateTransform();
-        //Update light transforms to ensure consistency
-        for(unsigned int i=0; i < content->getLightsCount(); ++i)
-            content->getLight(i)->UpdateTransform();
-        //Update ocean currents for particle systems
-        Ocean* ocean = sim->getOcean();
-        if(ocean != NULL) ocean->UpdateCurrentsData();
+    if(isDrawingQueueEmpty())
+        return;
+    
+    SDL_LockMutex(drawingQueueMutex);
+    //Swap front queue with the ready one
+    frontQueue = readyQueue.exchange(frontQueue, std::memory_order_acq_rel) & DRAWING_QUEUE_INDEX_MASK;
+    
+    //Update vision sensor transforms and copy generated data to ensure consistency
+    glMemoryBarrier(GL_PIXEL_BUFFER_BARRIER_BIT);
+    for(unsigned int i=0; i < content->getViewsCount(); ++i)
+        content->getView(i)->UpdateTransform();
+    //Update light transforms to ensure consistency
+    for(unsigned int i=0; i < content->getLightsCount(); ++i)
+        content->getLight(i)->UpdateTransform();
+    //Update ocean currents for particle systems
+    Ocean* ocean = sim->getOcean();
+    if(ocean != NULL) ocean->UpdateCurrentsData();
+    SDL_UnlockMutex(drawingQueueMutex);
+    
+    std::vector<Renderable>& objects = drawingQueue[frontQueue].getRenderables();
+    
+    //Sort objects by material to reduce uniform/texture switching
+    std::sort(objects.begin(), objects.end(), Renderable::SortByMaterial);
 
-        //Enable update of drawing queue by clearing old queue
-        drawingQueue.clear(); 
-        selectedDrawingQueue.clear();
-        SDL_UnlockMutex(drawingQueueMutex);
-			
-		//Sort objects by material to reduce uniform/texture switching
-        std::sort(drawingQueueCopy.begin(), drawingQueueCopy.end(), Renderable::SortByMaterial);
+    //Precompute normal matrices once for all views
+    drawingQueueNormals.resize(objects.size());
+    for(size_t i=0; i<objects.size(); ++i)
+    {
+        if(objects[i].type == RenderableType::SOLID)
+            drawingQueueNormals[i] = glm::mat3(glm::transpose(glm::inverse(objects[i].model)));
     }
 }
 
@@ -184,10 +197,11 @@ void OpenGLPipeline::DrawDisplay()
 
 void OpenGLPipeline::DrawObjects()
 {
-    for(size_t i=0; i<drawingQueueCopy.size(); ++i)
+    const std::vector<Renderable>& objects = drawingQueue[frontQueue].getRenderables();
+    for(size_t i=0; i<objects.size(); ++i)
     {
-		if(drawingQueueCopy[i].type == RenderableType::SOLID)
-			content->DrawObject(drawingQueueCopy[i].objectId, drawingQueueCopy[i].lookId, drawingQueueCopy[i].model);
+		if(objects[i].type == RenderableType::SOLID)
+			content->DrawObject(objects[i].objectId, objects[i].lookId, objects[i].model, drawingQueueNormals[i]);
     }
 }
 
@@ -199,87 +213,90 @@ void OpenGLPipeline::DrawLights()
     
 void OpenGLPipeline::DrawHelpers()
 {
+    DrawingQueue& queue = drawingQueue[frontQueue];
+    const std::vector<Renderable>& objects = queue.getRenderables();
+    
     //Coordinate systems
     if(hSettings.showCoordSys)
     {
         content->DrawCoordSystem(glm::mat4(1.f), 1.f);
         
-        for(size_t h=0; h<drawingQueueCopy.size(); ++h)
+        for(size_t h=0; h<objects.size(); ++h)
         {
-            if(drawingQueueCopy[h].type == RenderableType::SOLID_CS)
-                content->DrawCoordSystem(drawingQueueCopy[h].model, 0.25f);
+            if(objects[h].type == RenderableType::SOLID_CS)
+                content->DrawCoordSystem(objects[h].model, 0.25f);
         }
     }
     
     //Discrete and multibody joints
     if(hSettings.showJoints)
     {
-        for(size_t h=0; h<drawingQueueCopy.size(); ++h)
+        for(size_t h=0; h<objects.size(); ++h)
         {
-            if(drawingQueueCopy[h].type == RenderableType::MULTIBODY_AXIS)
-                content->DrawPrimitives(PrimitiveType::LINES, drawingQueueCopy[h].points, glm::vec4(1.f,0.5f,1.f,1.f), drawingQueueCopy[h].model);
-            else if(drawingQueueCopy[h].type == RenderableType::JOINT_LINES)
-                content->DrawPrimitives(PrimitiveType::LINES, drawingQueueCopy[h].points, glm::vec4(1.f,0.5f,1.f,1.f), drawingQueueCopy[h].model);
-            else if(drawingQueueCopy[h].type == RenderableType::PATH_LINE_STRIP)
-                content->DrawPrimitives(PrimitiveType::LINE_STRIP, drawingQueueCopy[h].points, glm::vec4(1.f,0.5f,1.f,1.f), drawingQueueCopy[h].model);
+            if(objects[h].type == RenderableType::MULTIBODY_AXIS)
+                content->DrawPrimitives(PrimitiveType::LINES, queue.getPoints(objects[h]), objects[h].numPoints, glm::vec4(1.f,0.5f,1.f,1.f), objects[h].model);
+            else if(objects[h].type == RenderableType::JOINT_LINES)
+                content->DrawPrimitives(PrimitiveType::LINES, queue.getPoints(objects[h]), objects[h].numPoints, glm::vec4(1.f,0.5f,1.f,1.f), objects[h].model);
+            else if(objects[h].type == RenderableType::PATH_LINE_STRIP)
+                content->DrawPrimitives(PrimitiveType::LINE_STRIP, queue.getPoints(objects[h]), objects[h].numPoints, glm::vec4(1.f,0.5f,1.f,1.f), objects[h].model);
         }
     }
     
     //Sensors
     if(hSettings.showSensors)
     {
-        for(size_t h=0; h<drawingQueueCopy.size(); ++h)
+        for(size_t h=0; h<objects.size(); ++h)
         {
-            if(drawingQueueCopy[h].type == RenderableType::SENSOR_CS)
-                content->DrawCoordSystem(drawingQueueCopy[h].model, 0.25f);
-            else if(drawingQueueCopy[h].type == RenderableType::SENSOR_POINTS)
-                content->DrawPrimitives(PrimitiveType::POINTS, drawingQueueCopy[h].points, glm::vec4(1.f,1.f,0,1.f), drawingQueueCopy[h].model);
-            else if(drawingQueueCopy[h].type == RenderableType::SENSOR_LINES)
-                content->DrawPrimitives(PrimitiveType::LINES, drawingQueueCopy[h].points, glm::vec4(1.f,1.f,0,1.f), drawingQueueCopy[h].model);
-            else if(drawingQueueCopy[h].type == RenderableType::SENSOR_LINE_STRIP)
-                content->DrawPrimitives(PrimitiveType::LINE_STRIP, drawingQueueCopy[h].points, glm::vec4(1.f,1.f,0,1.f), drawingQueueCopy[h].model);
+            if(objects[h].type == RenderableType::SENSOR_CS)
+                content->DrawCoordSystem(objects[h].model, 0.25f);
+            else if(objects[h].type == RenderableType::SENSOR_POINTS)
+                content->DrawPrimitives(PrimitiveType::POINTS, queue.getPoints(objects[h]), objects[h].numPoints, glm::vec4(1.f,1.f,0,1.f), objects[h].model);
+            else if(objects[h].type == RenderableType::SENSOR_LINES)
+                content->DrawPrimitives(PrimitiveType::LINES, queue.getPoints(objects[h]), objects[h].numPoints, glm::vec4(1.f,1.f,0,1.f), objects[h].model);
+            else if(objects[h].type == RenderableType::SENSOR_LINE_STRIP)
+                content->DrawPrimitives(PrimitiveType::LINE_STRIP, queue.getPoints(objects[h]), objects[h].numPoints, glm::vec4(1.f,1.f,0,1.f), objects[h].model);
         }
     }
     
     //Actuators
     if(hSettings.showActuators)
     {
-        for(size_t h=0; h<drawingQueueCopy.size(); ++h)
+        for(size_t h=0; h<objects.size(); ++h)
         {
-            if(drawingQueueCopy[h].type == RenderableType::ACTUATOR_LINES)
-                content->DrawPrimitives(PrimitiveType::LINES, drawingQueueCopy[h].points, glm::vec4(1.f,0.5f,0,1.f), drawingQueueCopy[h].model);
+            if(objects[h].type == RenderableType::ACTUATOR_LINES)
+                content->DrawPrimitives(PrimitiveType::LINES, queue.getPoints(objects[h]), objects[h].numPoints, glm::vec4(1.f,0.5f,0,1.f), objects[h].model);
         }
     }
     
     //Fluid dynamics
     if(hSettings.showFluidDynamics)
     {
-        for(size_t h=0; h<drawingQueueCopy.size(); ++h)
+        for(size_t h=0; h<objects.size(); ++h)
         {
-            switch(drawingQueueCopy[h].type)
+            switch(objects[h].type)
             {
                 case RenderableType::HYDRO_CS:
-                    content->DrawEllipsoid(drawingQueueCopy[h].model, glm::vec3(0.005f), glm::vec4(0.3f, 0.7f, 1.f, 1.f));
+                    content->DrawEllipsoid(objects[h].model, glm::vec3(0.005f), glm::vec4(0.3f, 0.7f, 1.f, 1.f));
                     break;
                     
                 case RenderableType::HYDRO_CYLINDER:
-                    content->DrawCylinder(drawingQueueCopy[h].model, drawingQueueCopy[h].points[0], glm::vec4(0.2f, 0.5f, 1.f, 1.f));
+                    content->DrawCylinder(objects[h].model, *queue.getPoints(objects[h]), glm::vec4(0.2f, 0.5f, 1.f, 1.f));
                     break;
                     
                 case RenderableType::HYDRO_ELLIPSOID:
-                    content->DrawEllipsoid(drawingQueueCopy[h].model, drawingQueueCopy[h].points[0], glm::vec4(0.2f, 0.5f, 1.f, 1.f));
+                    content->DrawEllipsoid(objects[h].model, *queue.getPoints(objects[h]), glm::vec4(0.2f, 0.5f, 1.f, 1.f));
                     break;
                     
                 case RenderableType::HYDRO_POINTS:
-                    content->DrawPrimitives(PrimitiveType::POINTS, drawingQueueCopy[h].points, glm::vec4(0.3f, 0.7f, 1.f, 1.f), drawingQueueCopy[h].model);
+                    content->DrawPrimitives(PrimitiveType::POINTS, queue.getPoints(objects[h]), objects[h].numPoints, glm::vec4(0.3f, 0.7f, 1.f, 1.f), objects[h].model);
                     break;
                     
                 case RenderableType::HYDRO_LINES:
-                    content->DrawPrimitives(PrimitiveType::LINES, drawingQueueCopy[h].points, glm::vec4(0.2f, 0.5f, 1.f, 1.f), drawingQueueCopy[h].model);
+                    content->DrawPrimitives(PrimitiveType::LINES, queue.getPoints(objects[h]), objects[h].numPoints, glm::vec4(0.2f, 0.5f, 1.f, 1.f), objects[h].model);
                     break;
                     
                 case RenderableType::HYDRO_LINE_STRIP:
-                    content->DrawPrimitives(PrimitiveType::LINE_STRIP, drawingQueueCopy[h].points, glm::vec4(0.2f, 0.5f, 1.f, 1.f), drawingQueueCopy[h].model);
+                    content->DrawPrimitives(PrimitiveType::LINE_STRIP, queue.getPoints(objects[h]), objects[h].numPoints, glm::vec4(0.2f, 0.5f, 1.f, 1.f), objects[h].model);
                     break;
                     
                 default:
@@ -291,20 +308,20 @@ void OpenGLPipeline::DrawHelpers()
     //Forces
     if(hSettings.showForces)
     {
-        for(size_t h=0; h<drawingQueueCopy.size(); ++h)
+        for(size_t h=0; h<objects.size(); ++h)
         {
-            switch(drawingQueueCopy[h].type)
+            switch(objects[h].type)
             {
                 case RenderableType::FORCE_BUOYANCY:
-                    content->DrawPrimitives(PrimitiveType::LINES, drawingQueueCopy[h].points, glm::vec4(0.f,0.f,1.f,1.f), drawingQueueCopy[h].model);
+                    content->DrawPrimitives(PrimitiveType::LINES, queue.getPoints(objects[h]), objects[h].numPoints, glm::vec4(0.f,0.f,1.f,1.f), objects[h].model);
                     break;
         
                 case RenderableType::FORCE_LINEAR_DRAG:
-                    content->DrawPrimitives(PrimitiveType::LINES, drawingQueueCopy[h].points, glm::vec4(0.f,1.f,1.f,1.f), drawingQueueCopy[h].model);
+                    content->DrawPrimitives(PrimitiveType::LINES, queue.getPoints(objects[h]), objects[h].numPoints, glm::vec4(0.f,1.f,1.f,1.f), objects[h].model);
                     break;
                     
                 case RenderableType::FORCE_QUADRATIC_DRAG:
-                    content->DrawPrimitives(PrimitiveType::LINES, drawingQueueCopy[h].points, glm::vec4(1.f,0.f,1.f,1.f), drawingQueueCopy[h].model);
+                    content->DrawPrimitives(PrimitiveType::LINES, queue.getPoints(objects[h]), objects[h].numPoints, glm::vec4(1.f,0.f,1.f,1.f), objects[h].model);
                     break;
         
                 default:
@@ -322,7 +339,7 @@ void OpenGLPipeline::Render(SimulationManager* sim)
     lastSimTime = now;
 
     //Double-buffering of drawing queue
-    PerformDrawingQueueCopy(sim);
+    AcquireDrawingQueue(sim);
 	
     //Choose rendering mode
     unsigned int renderMode = 0; //Defaults to rendering without ocean
@@ -353,63 +370,25 @@ void OpenGLPipeline::Render(SimulationManager* sim)
     OpenGLState::BindFramebuffer(screenFBO);
     glClear(GL_COLOR_BUFFER_BIT);
 
-    //Update the queue of views needing update
-    unsigned int updateCount = 0;
+    //Schedule view updates
+    std::vector<unsigned int> viewsUpdate;
     std::vector<unsigned int> viewsNoUpdate;
-    for(int i=content->getViewsCount()-1; i >= 0; --i)
-    {
-        OpenGLView* view = content->getView(i);
-        if(view->needsUpdate())
-        {
-            if(view->isContinuous())
-            {
-                viewsQueue.push_front(i);
-                ++updateCount;
-            }
-            else
-            {
-                viewsQueue.push_back(i);
-                viewsNoUpdate.push_back(i);
-            }
-        }
-        else
-        {
-            viewsNoUpdate.push_back(i);
-        }
-    }
-    
-    if(viewsQueue.size() > content->getViewsCount())
-    {
-        updateCount = viewsQueue.size();
-        viewsNoUpdate.clear();
-    }
-    else if(updateCount < (unsigned int)viewsQueue.size())
-    {
-        ++updateCount;
-        viewsNoUpdate.erase(std::find(viewsNoUpdate.begin(), viewsNoUpdate.end(), viewsQueue[updateCount-1]));
-    }
-    /*
-    printf("\nUpdate: %u Queue: ", updateCount);
-    for(size_t i=0; i<viewsQueue.size(); ++i)
-       printf("\t%u", viewsQueue[i]);
-    printf("\nNo-update: %u Queue: ", viewsNoUpdate.size());
-    for(size_t i=0; i<viewsNoUpdate.size(); ++i)
-       printf("\t%u", viewsNoUpdate[i]);
-    */
+    ScheduleViews(viewsUpdate, viewsNoUpdate);
    
     //Loop through all views -> trackballs, cameras, depth cameras...
-    for(unsigned int i=0; i<updateCount; ++i)
+    for(size_t i=0; i<viewsUpdate.size(); ++i)
     {
         OpenGLState::EnableDepthTest();
         OpenGLState::EnableCullFace();
         OpenGLState::DisableBlend();
-        OpenGLView* view = content->getView(viewsQueue[i]);
+        OpenGLView* view = content->getView(viewsUpdate[i]);
+        view->BeginGPUTimer();
             
         if(view->getType() == ViewType::DEPTH_CAMERA)
         {
             OpenGLDepthCamera* camera = static_cast<OpenGLDepthCamera*>(view);
             //Draw objects and compute depth data
-            camera->ComputeOutput(drawingQueueCopy);
+            camera->ComputeOutput(drawingQueue[frontQueue].getRenderables());
             //Draw camera output
             camera->DrawLDR(screenFBO, true);
         }
@@ -417,7 +396,7 @@ void OpenGLPipeline::Render(SimulationManager* sim)
         {
             OpenGLSonar* sonar = static_cast<OpenGLSonar*>(view);
             //Draw objects and compute sonar data
-            sonar->ComputeOutput(drawingQueueCopy);
+            sonar->ComputeOutput(drawingQueue[frontQueue].getRenderables());
             //Draw sonar output
             sonar->DrawLDR(screenFBO, true);
         }
@@ -566,7 +545,7 @@ void OpenGLPipeline::Render(SimulationManager* sim)
                 glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
                 
                 //Overlay selection outline
-                ((OpenGLTrackball*)camera)->DrawSelection(selectedDrawingQueueCopy, screenFBO);
+                ((OpenGLTrackball*)camera)->DrawSelection(selectedDrawingQueue[frontQueue].getRenderables(), screenFBO);
                  
                 //Graphics debugging
                 //if(ocean != NULL)
@@ -598,12 +577,52 @@ void OpenGLPipeline::Render(SimulationManager* sim)
         
             delete [] viewport;
         }
+        
+        view->EndGPUTimer();
+        view->MarkUpdated();
     }
     //Draw views that are displayed but not updated
     for(size_t i=0; i<viewsNoUpdate.size(); ++i)
         content->getView(viewsNoUpdate[i])->DrawLDR(screenFBO, false);
-    //Remove views drawn in this frame
-    viewsQueue.erase(viewsQueue.begin(), viewsQueue.begin() + updateCount);
+}
+
+void OpenGLPipeline::ScheduleViews(std::vector<unsigned int>& update, std::vector<unsigned int>& noUpdate)
+{
+    //Collect update requests
+    int64_t now = GetTimeInMicroseconds();
+    GLfloat budget = rSettings.viewsBudget * 1000.f;
+    std::vector<unsigned int> pending;
+    
+    for(unsigned int i=0; i<content->getViewsCount(); ++i)
+    {
+        OpenGLView* view = content->getView(i);
+        if(!view->PollUpdateRequest(now))
+            noUpdate.push_back(i);
+        else if(view->isContinuous()) //Continuous views are always updated
+        {
+            update.push_back(i);
+            budget -= view->getGPUTime();
+        }
+        else
+            pending.push_back(i);
+    }
+    
+    //Earliest deadline first
+    std::sort(pending.begin(), pending.end(), [this](unsigned int a, unsigned int b)
+              { return content->getView(a)->getUpdateDeadline() < content->getView(b)->getUpdateDeadline(); });
+    
+    //Fit updates in the GPU time budget (the most urgent one is always updated to avoid starvation)
+    for(size_t i=0; i<pending.size(); ++i)
+    {
+        GLfloat cost = content->getView(pending[i])->getGPUTime();
+        if(i == 0 || cost <= budget)
+        {
+            update.push_back(pending[i]);
+            budget -= cost;
+        }
+        else
+            noUpdate.push_back(pending[i]);
+    }
 }
 
 }
@@ -33,6 +33,7 @@
 #include "graphics/OpenGLAtmosphere.h"
 #include "graphics/OpenGLConsole.h"
 #include "utils/SystemUtil.hpp"
+#include <algorithm>
 
 namespace sf
 {
@@ -292,6 +293,52 @@ GLfloat OpenGLRealOcean::ComputeWaveHeight(GLfloat x, GLfloat y)
     return z;
 }
 
+void OpenGLRealOcean::ComputeWaveHeights(const glm::vec3* points, size_t n, GLfloat* heights)
+{
+    //Same interpolation as ComputeInterpolatedWaveData, with constants hoisted out of the loop
+    //and branchless wrapping of texture coordinates, so that the arithmetic can be vectorised
+    const GLint size = (GLint)params.fftSize;
+    const GLfloat sizef = (GLfloat)params.fftSize;
+    const GLfloat halfTexel = 0.5f/sizef;
+    const GLfloat scale[2] = {1.f/params.gridSizes.x, 1.f/params.gridSizes.y};
+    
+    for(size_t k=0; k<n; ++k)
+        heights[k] = 0.f;
+    
+    //Z,X are reversed because the coordinate system used to draw ocean has Z axis pointing up!
+    for(GLuint c=0; c<2; ++c)
+    {
+        for(size_t k=0; k<n; ++k)
+        {
+            GLfloat x = points[k].x * scale[c];
+            GLfloat y = points[k].y * scale[c];
+            
+            //Texture coordinates wrapped to [0,1)
+            GLfloat i0f = (x - halfTexel) - floorf(x - halfTexel);
+            GLfloat j0f = (y - halfTexel) - floorf(y - halfTexel);
+            GLfloat i1f = (x + halfTexel) - floorf(x + halfTexel);
+            GLfloat j1f = (y + halfTexel) - floorf(y + halfTexel);
+            
+            //Pixel coordinates
+            GLint i0 = std::min((GLint)(i0f * sizef), size-1);
+            GLint j0 = std::min((GLint)(j0f * sizef), size-1);
+            GLint i1 = std::min((GLint)(i1f * sizef), size-1);
+            GLint j1 = std::min((GLint)(j1f * sizef), size-1);
+            
+            //Weights
+            GLfloat alpha = i0f * sizef - floorf(i0f * sizef);
+            GLfloat beta = j0f * sizef - floorf(j0f * sizef);
+            
+            //Interpolate
+            GLfloat h = (1.f - alpha)*(1.f - beta)*fftData[(j0 * size + i0) * 4 + c]
+                        + alpha*(1.f - beta)*fftData[(j0 * size + i1) * 4 + c]
+                        + (1.f - alpha)*beta*fftData[(j1 * size + i0) * 4 + c]
+                        + alpha*beta*fftData[(j1 * size + i1) * 4 + c];
+            heights[k] -= h;
+        }
+    }
+}
+
 void OpenGLRealOcean::Simulate(GLfloat dt)
 {
     if(SDL_TryLockMutex(hydroMutex) == 0)
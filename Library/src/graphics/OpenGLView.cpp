@@ -26,6 +26,9 @@
 #include "graphics/OpenGLView.h"
 
 #include "graphics/OpenGLState.h"
+#include "core/Console.h"
+
+#define MISSED_DEADLINES_REPORT_PERIOD 1000000 //[us]
 
 namespace sf
 {
@@ -40,11 +43,27 @@ OpenGLView::OpenGLView(GLint x, GLint y, GLint width, GLint height)
 	continuous = false;
     viewUBOData.VP = glm::mat4(1.f);
     viewUBOData.eye = glm::vec3(0.f);
+    viewUBOData.FC = 0.f;
+    viewUBOData.dir = glm::vec3(1.f,0.f,0.f);
+    viewUBOData.pad = 0.f;
+    viewUBOData.V = glm::mat4(1.f);
     ExtractFrustumFromVP(viewUBOData.frustum, viewUBOData.VP);
+    
+    ownerName = "";
+    updatePending = false;
+    lastRequestTime = -1;
+    requestPeriod = 0;
+    lastReportTime = 0;
+    missedDeadlines = 0;
+    unreportedMisses = 0;
+    glGenQueries(2, gpuTimeQuery);
+    gpuTimeQueryIssued = false;
+    gpuTime = 0.f;
 }
 
 OpenGLView::~OpenGLView()
 {
+    glDeleteQueries(2, gpuTimeQuery);
 }
 
 GLuint OpenGLView::getRenderFBO() const
@@ -72,6 +91,101 @@ bool OpenGLView::isContinuous()
 	return continuous;
 }
 
+void OpenGLView::setOwnerName(const std::string& name)
+{
+    ownerName = name;
+}
+
+bool OpenGLView::PollUpdateRequest(int64_t now)
+{
+    if(!needsUpdate())
+        return updatePending;
+    
+    //Track request period
+    if(lastRequestTime >= 0)
+    {
+        int64_t period = now - lastRequestTime;
+        requestPeriod = requestPeriod == 0 ? period : (requestPeriod * 7 + period)/8;
+    }
+    lastRequestTime = now;
+    
+    //Previous request was not served before the new one arrived
+    if(updatePending)
+    {
+        ++missedDeadlines;
+        ++unreportedMisses;
+        if(now - lastReportTime >= MISSED_DEADLINES_REPORT_PERIOD)
+        {
+            cWarning("View of '%s' missed %u update deadlines (%u in total).", ownerName.empty() ? "unnamed" : ownerName.c_str(),
+                     unreportedMisses, missedDeadlines.load());
+            unreportedMisses = 0;
+            lastReportTime = now;
+        }
+    }
+    
+    updatePending = true;
+    return true;
+}
+
+void OpenGLView::MarkUpdated()
+{
+    updatePending = false;
+}
+
+int64_t OpenGLView::getUpdateDeadline() const
+{
+    return lastRequestTime + requestPeriod;
+}
+
+GLfloat OpenGLView::getRequestFrequency() const
+{
+    return requestPeriod > 0 ? 1e6f/(GLfloat)requestPeriod : 0.f;
+}
+
+unsigned int OpenGLView::getMissedDeadlines() const
+{
+    return missedDeadlines.load();
+}
+
+void OpenGLView::BeginGPUTimer()
+{
+    //Skip measurement if the previous one is still in flight (never stall the pipeline)
+    if(gpuTimeQueryIssued)
+        getGPUTime();
+    if(gpuTimeQueryIssued)
+        return;
+    
+    glQueryCounter(gpuTimeQuery[0], GL_TIMESTAMP);
+}
+
+void OpenGLView::EndGPUTimer()
+{
+    if(gpuTimeQueryIssued)
+        return;
+        
+    glQueryCounter(gpuTimeQuery[1], GL_TIMESTAMP);
+    gpuTimeQueryIssued = true;
+}
+
+GLfloat OpenGLView::getGPUTime()
+{
+    if(gpuTimeQueryIssued)
+    {
+        GLint available = 0;
+        glGetQueryObjectiv(gpuTimeQuery[1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if(available)
+        {
+            GLuint64 t0, t1;
+            glGetQueryObjectui64v(gpuTimeQuery[0], GL_QUERY_RESULT, &t0);
+            glGetQueryObjectui64v(gpuTimeQuery[1], GL_QUERY_RESULT, &t1);
+            GLfloat t = (GLfloat)(t1 - t0)/1000.f;
+            gpuTime = gpuTime == 0.f ? t : 0.8f * gpuTime + 0.2f * t;
+            gpuTimeQueryIssued = false;
+        }
+    }
+    return gpuTime;
+}
+
 void OpenGLView::SetViewport()
 {
     OpenGLState::Viewport(0, 0, viewportWidth, viewportHeight);
@@ -96,6 +96,9 @@ JointType CylindricalJoint::getType()
 
 void CylindricalJoint::ApplyForce(Scalar F)
 {
+    if(F != Scalar(0))
+        WakeUpBodies();
+    
     btRigidBody& bodyA = getConstraint()->getRigidBodyA();
     btRigidBody& bodyB = getConstraint()->getRigidBodyB();
     Vector3 axis = (bodyA.getCenterOfMassTransform().getBasis() * axisInA).normalized();
@@ -106,6 +109,9 @@ void CylindricalJoint::ApplyForce(Scalar F)
 
 void CylindricalJoint::ApplyTorque(Scalar T)
 {
+    if(T != Scalar(0))
+        WakeUpBodies();
+    
     btRigidBody& bodyA = getConstraint()->getRigidBodyA();
     btRigidBody& bodyB = getConstraint()->getRigidBodyB();
     Vector3 axis = (bodyA.getCenterOfMassTransform().getBasis() * axisInA).normalized();
@@ -146,12 +152,12 @@ void CylindricalJoint::ApplyDamping()
     }
 }
 
-std::vector<Renderable> CylindricalJoint::Render()
+void CylindricalJoint::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
     Renderable item;
     item.model = glm::mat4(1.f);
     item.type = RenderableType::JOINT_LINES;
+    queue.BeginPoints(item);
     
     btTypedConstraint* cyli = getConstraint();
     Vector3 A = cyli->getRigidBodyA().getCenterOfMassPosition();
@@ -165,16 +171,15 @@ std::vector<Renderable> CylindricalJoint::Render()
     Vector3 C1 = pivot + e1 * axis;
     Vector3 C2 = pivot + e2 * axis;
     
-    item.points.push_back(glm::vec3(A.getX(), A.getY(), A.getZ()));
-    item.points.push_back(glm::vec3(C1.getX(), C1.getY(), C1.getZ()));
-    item.points.push_back(glm::vec3(B.getX(), B.getY(), B.getZ()));
-    item.points.push_back(glm::vec3(C2.getX(), C2.getY(), C2.getZ()));
+    queue.AddPoint(item, glm::vec3(A.getX(), A.getY(), A.getZ()));
+    queue.AddPoint(item, glm::vec3(C1.getX(), C1.getY(), C1.getZ()));
+    queue.AddPoint(item, glm::vec3(B.getX(), B.getY(), B.getZ()));
+    queue.AddPoint(item, glm::vec3(C2.getX(), C2.getY(), C2.getZ()));
     
-    item.points.push_back(glm::vec3(C1.getX(), C1.getY(), C1.getZ()));
-    item.points.push_back(glm::vec3(C2.getX(), C2.getY(), C2.getZ()));
+    queue.AddPoint(item, glm::vec3(C1.getX(), C1.getY(), C1.getZ()));
+    queue.AddPoint(item, glm::vec3(C2.getX(), C2.getY(), C2.getZ()));
     
-    items.push_back(item);
-    return items;
+    queue.Add(item);
 }
 
 }
@@ -58,7 +58,7 @@ FixedJoint::FixedJoint(std::string uniqueName, SolidEntity* solid, FeatherstoneE
     fixed->setMaxAppliedImpulse(BT_LARGE_FLOAT);
     
     //Disable collision
-    SimulationApp::getApp()->getSimulationManager()->DisableCollision(fe->getLink(linkId+1).solid, solid);
+    SimulationManager::getCurrent()->DisableCollision(fe->getLink(linkId+1).solid, solid);
 }
 
 FixedJoint::FixedJoint(std::string uniqueName, FeatherstoneEntity* feA, FeatherstoneEntity* feB, int linkIdA, int linkIdB, const Vector3& pivot) : Joint(uniqueName, false)
@@ -74,7 +74,7 @@ FixedJoint::FixedJoint(std::string uniqueName, FeatherstoneEntity* feA, Feathers
     fixed->setMaxAppliedImpulse(BT_LARGE_FLOAT);
 
     //Disable collision
-    SimulationApp::getApp()->getSimulationManager()->DisableCollision(feA->getLink(linkIdA+1).solid, feB->getLink(linkIdB+1).solid);
+    SimulationManager::getCurrent()->DisableCollision(feA->getLink(linkIdA+1).solid, feB->getLink(linkIdB+1).solid);
 }
 
 JointType FixedJoint::getType()
@@ -82,22 +82,20 @@ JointType FixedJoint::getType()
     return JOINT_FIXED;
 }
     
-std::vector<Renderable> FixedJoint::Render()
+void FixedJoint::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
     Renderable item;
     item.model = glm::mat4(1.f);
     item.type = RenderableType::JOINT_LINES;
+    queue.BeginPoints(item);
     
     btTypedConstraint* revo = getConstraint();
     Vector3 A = revo->getRigidBodyA().getCenterOfMassPosition();
     Vector3 B = revo->getRigidBodyB().getCenterOfMassPosition();
     
-    item.points.push_back(glm::vec3(A.getX(), A.getY(), A.getZ()));
-    item.points.push_back(glm::vec3(B.getX(), B.getY(), B.getZ()));
-    items.push_back(item);
-    
-    return items;
+    queue.AddPoint(item, glm::vec3(A.getX(), A.getY(), A.getZ()));
+    queue.AddPoint(item, glm::vec3(B.getX(), B.getY(), B.getZ()));
+    queue.Add(item);
 }
 
 }
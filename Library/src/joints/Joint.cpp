@@ -34,7 +34,7 @@ namespace sf
 
 Joint::Joint(std::string uniqueName, bool collideLinkedEntities)
 {
-    name = SimulationApp::getApp()->getSimulationManager()->getNameManager()->AddName(uniqueName);
+    name = SimulationManager::getCurrent()->getNameManager()->AddName(uniqueName);
     collisionEnabled = collideLinkedEntities;
     mbConstraint = NULL;
     constraint = NULL;
@@ -43,7 +43,7 @@ Joint::Joint(std::string uniqueName, bool collideLinkedEntities)
 Joint::~Joint(void)
 {
     if(SimulationApp::getApp() != NULL)
-        SimulationApp::getApp()->getSimulationManager()->getNameManager()->RemoveName(name);
+        SimulationManager::getCurrent()->getNameManager()->RemoveName(name);
 }
 
 bool Joint::isMultibodyJoint()
@@ -71,6 +71,24 @@ void Joint::setConstraint(btMultiBodyConstraint *c)
     mbConstraint = c;
 }
 
+void Joint::WakeUpBodies()
+{
+    if(constraint == NULL)
+        return;
+    
+    //Bullet does not integrate forces applied to sleeping bodies
+    btRigidBody* bodies[2] = {&constraint->getRigidBodyA(), &constraint->getRigidBodyB()};
+    for(unsigned int i=0; i<2; ++i)
+    {
+        if(bodies[i]->isStaticOrKinematicObject())
+            continue;
+        
+        Entity* ent = (Entity*)bodies[i]->getUserPointer();
+        if(ent != NULL && ent->getType() == EntityType::SOLID)
+            ((SolidEntity*)ent)->WakeUp();
+    }
+}
+
 Scalar Joint::getFeedback(unsigned int dof)
 {
     if(dof > 5)
@@ -129,10 +147,8 @@ bool Joint::SolvePositionIC(Scalar linearTolerance, Scalar angularTolerance)
     return true; //Nothing to solve
 }
 
-std::vector<Renderable> Joint::Render()
+void Joint::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
-    return items;
 }
     
 }
@@ -105,6 +105,9 @@ Scalar RevoluteJoint::getAngularVelocity()
 
 void RevoluteJoint::ApplyTorque(Scalar T)
 {
+    if(T != Scalar(0))
+        WakeUpBodies();
+    
     btRigidBody& bodyA = getConstraint()->getRigidBodyA();
     btRigidBody& bodyB = getConstraint()->getRigidBodyB();
     Vector3 axis = (bodyA.getCenterOfMassTransform().getBasis() * axisInA).normalized();
@@ -150,12 +153,12 @@ bool RevoluteJoint::SolvePositionIC(Scalar linearTolerance, Scalar angularTolera
     return false;
 }
 
-std::vector<Renderable> RevoluteJoint::Render()
+void RevoluteJoint::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
     Renderable item;
     item.model = glm::mat4(1.f);
     item.type = RenderableType::JOINT_LINES;
+    queue.BeginPoints(item);
     
     btTypedConstraint* revo = getConstraint();
     Vector3 A = revo->getRigidBodyA().getCenterOfMassPosition();
@@ -169,17 +172,15 @@ std::vector<Renderable> RevoluteJoint::Render()
     Vector3 C1 = pivot + e1 * axis;
     Vector3 C2 = pivot + e2 * axis;
     
-    item.points.push_back(glm::vec3(A.getX(), A.getY(), A.getZ()));
-    item.points.push_back(glm::vec3(C1.getX(), C1.getY(), C1.getZ()));
-    item.points.push_back(glm::vec3(B.getX(), B.getY(), B.getZ()));
-    item.points.push_back(glm::vec3(C2.getX(), C2.getY(), C2.getZ()));
-    
-    item.points.push_back(glm::vec3(C1.getX(), C1.getY(), C1.getZ()));
-    item.points.push_back(glm::vec3(C2.getX(), C2.getY(), C2.getZ()));
+    queue.AddPoint(item, glm::vec3(A.getX(), A.getY(), A.getZ()));
+    queue.AddPoint(item, glm::vec3(C1.getX(), C1.getY(), C1.getZ()));
+    queue.AddPoint(item, glm::vec3(B.getX(), B.getY(), B.getZ()));
+    queue.AddPoint(item, glm::vec3(C2.getX(), C2.getY(), C2.getZ()));
     
-    items.push_back(item);
+    queue.AddPoint(item, glm::vec3(C1.getX(), C1.getY(), C1.getZ()));
+    queue.AddPoint(item, glm::vec3(C2.getX(), C2.getY(), C2.getZ()));
     
-    return items;
+    queue.Add(item);
 }
     
 }
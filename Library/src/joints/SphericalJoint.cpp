@@ -67,6 +67,9 @@ JointType SphericalJoint::getType()
 
 void SphericalJoint::ApplyTorque(Vector3 T)
 {
+    if(!T.fuzzyZero())
+        WakeUpBodies();
+    
     btRigidBody& bodyA = getConstraint()->getRigidBodyA();
     btRigidBody& bodyB = getConstraint()->getRigidBodyB();
     Vector3 torque = T;
@@ -95,25 +98,24 @@ void SphericalJoint::ApplyDamping()
     }
 }
 
-std::vector<Renderable> SphericalJoint::Render()
+void SphericalJoint::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
     Renderable item;
     item.model = glm::mat4(1.f);
     item.type = RenderableType::JOINT_LINES;
+    queue.BeginPoints(item);
     
     btPoint2PointConstraint* p2p = (btPoint2PointConstraint*)getConstraint();
     Vector3 pivot = p2p->getRigidBodyA().getCenterOfMassTransform()(p2p->getPivotInA());
     Vector3 A = p2p->getRigidBodyA().getCenterOfMassPosition();
     Vector3 B = p2p->getRigidBodyB().getCenterOfMassPosition();
     
-    item.points.push_back(glm::vec3(A.getX(), A.getY(), A.getZ()));
-    item.points.push_back(glm::vec3(pivot.getX(), pivot.getY(), pivot.getZ()));
-    item.points.push_back(glm::vec3(B.getX(), B.getY(), B.getZ()));
-    item.points.push_back(glm::vec3(pivot.getX(), pivot.getY(), pivot.getZ()));
+    queue.AddPoint(item, glm::vec3(A.getX(), A.getY(), A.getZ()));
+    queue.AddPoint(item, glm::vec3(pivot.getX(), pivot.getY(), pivot.getZ()));
+    queue.AddPoint(item, glm::vec3(B.getX(), B.getY(), B.getZ()));
+    queue.AddPoint(item, glm::vec3(pivot.getX(), pivot.getY(), pivot.getZ()));
     
-    items.push_back(item);
-    return items;
+    queue.Add(item);
 }
 
 }
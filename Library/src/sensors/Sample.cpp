@@ -36,7 +36,15 @@ Sample::Sample(unsigned short nDimensions, Scalar* values)
     nDim = nDimensions > 0 ? nDimensions : 1;
     data = new Scalar[nDim];
     std::memcpy(data, values, sizeof(Scalar)*nDim);
-    timestamp = SimulationApp::getApp()->getSimulationManager()->getSimulationTime();
+    timestamp = SimulationManager::getCurrent()->getSimulationTime();
+}
+
+Sample::Sample(unsigned short nDimensions, Scalar* values, Scalar time)
+{
+    nDim = nDimensions > 0 ? nDimensions : 1;
+    data = new Scalar[nDim];
+    std::memcpy(data, values, sizeof(Scalar)*nDim);
+    timestamp = time;
 }
 
 Sample::Sample(const Sample& other)
@@ -57,7 +65,7 @@ Scalar Sample::getTimestamp()
     return timestamp;
 }
     
-unsigned short Sample::getNumOfDimensions()
+unsigned short Sample::getNumOfDimensions() const
 {
     return nDim;
 }
@@ -25,11 +25,13 @@
 
 #include "sensors/ScalarSensor.h"
 
+#include <cmath>
 #include "core/SimulationApp.h"
 #include "core/SimulationManager.h"
 #include "core/Console.h"
 #include "utils/ScientificFileUtil.h"
 #include "sensors/Sample.h"
+#include "core/Recorder.h"
 
 namespace sf
 {
@@ -38,6 +40,9 @@ ScalarSensor::ScalarSensor(std::string uniqueName, Scalar frequency, int history
 {
     historyLen = historyLength;
     history = std::deque<Sample*>(0);
+    lastRawTime = Scalar(0);
+    recorder = NULL;
+    recorderStream = 0;
 }
 
 ScalarSensor::~ScalarSensor()
@@ -109,6 +114,56 @@ void ScalarSensor::Reset()
 }
 
 void ScalarSensor::AddSampleToHistory(const Sample& s)
+{
+    if(!isOversamplingSupported())
+    {
+        PushSample(new Sample(s));
+        return;
+    }
+    
+    //Keep raw values of the step in reused buffers
+    unsigned short nDim = s.getNumOfDimensions();
+    Scalar now = SimulationManager::getCurrent()->getSimulationTime();
+    rawValues.resize(nDim);
+    for(unsigned short i=0; i<nDim; ++i)
+        rawValues[i] = s.getValue(i);
+    
+    if(oversampleTimes.size() > 0 && lastRawValues.size() == rawValues.size())
+    {
+        //Interpolate measurements between the previous and the current simulation step
+        std::vector<Scalar>& values = rawValues;
+        std::vector<Scalar>& interpolated = interpolatedValues;
+        interpolated.resize(nDim);
+        
+        for(size_t h=0; h<oversampleTimes.size(); ++h)
+        {
+            Scalar alpha = now > lastRawTime ? (oversampleTimes[h] - lastRawTime)/(now - lastRawTime) : Scalar(1);
+            alpha = alpha < Scalar(0) ? Scalar(0) : (alpha > Scalar(1) ? Scalar(1) : alpha);
+            
+            for(size_t i=0; i<values.size(); ++i)
+            {
+                if(channels[i].type == QUANTITY_ANGLE) //Interpolate along the shortest arc
+                {
+                    Scalar delta = std::remainder(values[i] - lastRawValues[i], Scalar(2)*M_PI);
+                    interpolated[i] = lastRawValues[i] + alpha * delta;
+                    if(btFabs(values[i]) <= M_PI && btFabs(lastRawValues[i]) <= M_PI) //Wrapped angles stay wrapped
+                        interpolated[i] = std::remainder(interpolated[i], Scalar(2)*M_PI);
+                }
+                else
+                    interpolated[i] = lastRawValues[i] + alpha * (values[i] - lastRawValues[i]);
+            }
+            
+            PushSample(new Sample(nDim, interpolated.data(), oversampleTimes[h]));
+        }
+    }
+    else
+        PushSample(new Sample(s));
+    
+    lastRawValues.swap(rawValues);
+    lastRawTime = now;
+}
+
+void ScalarSensor::PushSample(Sample* sample)
 {
     if(historyLen < 0 && history.size() > 0) //No history
     {
@@ -122,8 +177,6 @@ void ScalarSensor::AddSampleToHistory(const Sample& s)
     }
     //else == 0 --> unlimited history
     
-    Sample* sample = new Sample(s);
-    
     for(unsigned int i=0; i<sample->getNumOfDimensions(); ++i)
     {
         Scalar* data = sample->getDataPointer();
@@ -141,6 +194,16 @@ void ScalarSensor::AddSampleToHistory(const Sample& s)
     
     //Add to history
     history.push_back(sample);
+    
+    //Stream to recorder
+    if(recorder != NULL)
+        recorder->Push(recorderStream, sample->getTimestamp(), sample->getDataPointer());
+}
+
+void ScalarSensor::setRecorder(Recorder* rec, unsigned int streamId)
+{
+    recorder = rec;
+    recorderStream = streamId;
 }
 
 void ScalarSensor::ClearHistory()
@@ -170,7 +233,7 @@ void ScalarSensor::SaveMeasurementsToTextFile(const std::string& path, bool incl
     fprintf(fp, "#Number of channels: %ld\n", channels.size());
     fprintf(fp, "#Number of samples: %ld\n", history.size());
     if(freq <= Scalar(0.))
-        fprintf(fp, "#Frequency: %1.3lf Hz\n", SimulationApp::getApp()->getSimulationManager()->getStepsPerSecond());
+        fprintf(fp, "#Frequency: %1.3lf Hz\n", SimulationManager::getCurrent()->getStepsPerSecond());
     else
         fprintf(fp, "#Frequency: %1.3lf Hz\n", freq);
     fprintf(fp, "#Unit system: SI\n\n");
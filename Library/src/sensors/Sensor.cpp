@@ -33,14 +33,16 @@
 namespace sf
 {
 
-std::random_device Sensor::randomDevice;
-std::mt19937 Sensor::randomGenerator(randomDevice());
+thread_local std::random_device Sensor::randomDevice;
+thread_local std::mt19937 Sensor::randomGenerator(randomDevice());
 
 Sensor::Sensor(std::string uniqueName, Scalar frequency)
 {
-    name = SimulationApp::getApp()->getSimulationManager()->getNameManager()->AddName(uniqueName);
-    setUpdateFrequency(frequency);
+    name = SimulationManager::getCurrent()->getNameManager()->AddName(uniqueName);
+    freq = frequency;
     eleapsedTime = Scalar(0);
+    scheduleOrigin = Scalar(0);
+    scheduleCount = 0;
     renderable = false;
     newDataAvailable = false;
     updateMutex = SDL_CreateMutex();
@@ -49,7 +51,7 @@ Sensor::Sensor(std::string uniqueName, Scalar frequency)
 Sensor::~Sensor()
 {
     if(SimulationApp::getApp() != NULL)
-        SimulationApp::getApp()->getSimulationManager()->getNameManager()->RemoveName(name);
+        SimulationManager::getCurrent()->getNameManager()->RemoveName(name);
     SDL_DestroyMutex(updateMutex);
 }
 
@@ -65,7 +67,17 @@ void Sensor::MarkDataOld()
 
 void Sensor::setUpdateFrequency(Scalar f)
 {
+    SDL_LockMutex(updateMutex);
+    //Start a new schedule from the last sample, so that the change does not produce a burst of updates
+    if(freq > Scalar(0))
+        scheduleOrigin += Scalar(scheduleCount)/freq;
+    scheduleCount = 0;
     freq = f;
+    SDL_UnlockMutex(updateMutex);
+    
+    SimulationManager* sm = SimulationManager::getCurrent();
+    if(sm != NULL)
+        sm->InvalidateSensorSchedule();
 }
 
 Scalar Sensor::getUpdateFrequency()
@@ -73,6 +85,15 @@ Scalar Sensor::getUpdateFrequency()
     return freq;
 }
 
+Scalar Sensor::getNextUpdateTime()
+{
+    if(freq <= Scalar(0)) //Updated every simulation tick, no schedule
+        return scheduleOrigin;
+    
+    //Due times are computed from the sample count to avoid accumulating round-off errors
+    return scheduleOrigin + Scalar(scheduleCount + 1)/freq;
+}
+
 bool Sensor::isNewDataAvailable()
 {
     return newDataAvailable;
@@ -88,9 +109,17 @@ bool Sensor::isRenderable()
     return renderable;
 }
 
+bool Sensor::isOversamplingSupported()
+{
+    return false;
+}
+
 void Sensor::Reset()
 {
     eleapsedTime = Scalar(0.);
+    scheduleOrigin = SimulationManager::getCurrent()->getSimulationTime();
+    scheduleCount = 0;
+    oversampleTimes.clear();
     InternalUpdate(1.); //time delta should not affect initial measurement!!!
 }
 
@@ -119,10 +148,52 @@ void Sensor::Update(Scalar dt)
     SDL_UnlockMutex(updateMutex);
 }
 
-std::vector<Renderable> Sensor::Render()
+Scalar Sensor::ScheduledUpdate(Scalar now, Scalar dt)
+{
+    SDL_LockMutex(updateMutex);
+    
+    oversampleTimes.clear();
+    
+    if(freq <= Scalar(0)) //Rate changed to every tick after the schedule was built (rebuilt in the next tick)
+    {
+        InternalUpdate(dt);
+        newDataAvailable = true;
+        SDL_UnlockMutex(updateMutex);
+        return now + dt;
+    }
+    
+    Scalar tolerance = dt * Scalar(1e-3);
+    
+    if(freq * dt > Scalar(1) && isOversamplingSupported())
+    {
+        //Generate all samples due in the last step, interpolated between the two last simulation steps
+        do
+        {
+            oversampleTimes.push_back(getNextUpdateTime());
+            ++scheduleCount;
+        }
+        while(getNextUpdateTime() <= now + tolerance);
+        InternalUpdate(Scalar(oversampleTimes.size())/freq);
+    }
+    else
+    {
+        InternalUpdate(Scalar(1)/freq);
+        
+        //Skip the samples which can not be generated because the sensor rate exceeds the simulation rate
+        do
+            ++scheduleCount;
+        while(getNextUpdateTime() <= now + tolerance);
+    }
+    
+    newDataAvailable = true;
+    Scalar next = getNextUpdateTime();
+    
+    SDL_UnlockMutex(updateMutex);
+    return next;
+}
+
+void Sensor::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
-    return items;
 }
     
 }
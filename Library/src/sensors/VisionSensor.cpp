@@ -25,7 +25,11 @@
 
 #include "sensors/VisionSensor.h"
 
-#include "core/SimulationApp.h"
+#include "core/GraphicalSimulationApp.h"
+#include "core/SimulationManager.h"
+#include "graphics/OpenGLPipeline.h"
+#include "graphics/OpenGLContent.h"
+#include "graphics/OpenGLView.h"
 #include "core/Console.h"
 #include "entities/SolidEntity.h"
 
@@ -53,6 +57,44 @@ Transform VisionSensor::getSensorFrame()
         return o2s;
 }
 
+void VisionSensor::RegisterView(OpenGLView* view)
+{
+    view->setOwnerName(getName());
+    views.push_back(view);
+    ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->AddView(view);
+}
+
+unsigned int VisionSensor::getMissedRenderDeadlines()
+{
+    unsigned int missed = 0;
+    for(size_t i=0; i<views.size(); ++i)
+        missed += views[i]->getMissedDeadlines();
+    return missed;
+}
+
+void VisionSensor::AddFrameListener(std::function<void(VisionSensor*, const VisionSensorFrame&)> listener)
+{
+    frameListeners.push_back(listener);
+}
+
+void VisionSensor::PublishFrame(const void* data, unsigned int width, unsigned int height, unsigned int channels, bool floatingPoint)
+{
+    if(frameListeners.size() == 0)
+        return;
+    
+    VisionSensorFrame frame;
+    frame.data = data;
+    frame.width = width;
+    frame.height = height;
+    frame.channels = channels;
+    frame.floatingPoint = floatingPoint;
+    frame.timestamp = SimulationManager::getCurrent()->getSimulationTime();
+    frame.pose = getSensorFrame();
+    
+    for(size_t i=0; i<frameListeners.size(); ++i)
+        frameListeners[i](this, frame);
+}
+
 SensorType VisionSensor::getType()
 {
     return SensorType::VISION;
@@ -85,6 +85,11 @@ void Accelerometer::setNoise(Scalar linearAccStdDev, Scalar angularAccStdDev)
     channels[5].setStdDev(angularAccStdDev);
 }
 
+bool Accelerometer::isOversamplingSupported()
+{
+    return true;
+}
+
 ScalarSensorType Accelerometer::getScalarSensorType()
 {
     return ScalarSensorType::ACC;
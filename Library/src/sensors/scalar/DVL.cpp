@@ -79,7 +79,7 @@ void DVL::InternalUpdate(Scalar dt)
             btCollisionWorld::ClosestRayResultCallback closest(from_, to_);
             closest.m_collisionFilterGroup = MASK_DYNAMIC;
             closest.m_collisionFilterMask = MASK_STATIC | MASK_DYNAMIC | MASK_ANIMATED_COLLIDING;
-            SimulationApp::getApp()->getSimulationManager()->getDynamicsWorld()->rayTest(from_, to_, closest);
+            SimulationManager::getCurrent()->getDynamicsWorld()->rayTest(from_, to_, closest);
             
             if(closest.hasHit())
             {
@@ -106,10 +106,8 @@ void DVL::InternalUpdate(Scalar dt)
         history.back()->getDataPointer()[3] = Scalar(-1); 
 }
 
-std::vector<Renderable> DVL::Render()
+void DVL::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
-    
     Vector3 dir[4];
     dir[0] = Vector3(0,0,1) * btCos(beamAngle/Scalar(2)) + Vector3(1,0,0) * btSin(beamAngle/Scalar(2));
     dir[1] = Vector3(0,0,1) * btCos(beamAngle/Scalar(2)) - Vector3(1,0,0) * btSin(beamAngle/Scalar(2));
@@ -119,34 +117,33 @@ std::vector<Renderable> DVL::Render()
     Renderable item;
     item.type = RenderableType::SENSOR_LINES;
     item.model = glMatrixFromTransform(getSensorFrame());
+    queue.BeginPoints(item);
     
     if(range[0] > Scalar(0))
     {
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(-dir[0].x()*range[0], -dir[0].y()*range[0], -dir[0].z()*range[0]));
+        queue.AddPoint(item, glm::vec3(0,0,0));
+        queue.AddPoint(item, glm::vec3(-dir[0].x()*range[0], -dir[0].y()*range[0], -dir[0].z()*range[0]));
     }
     
     if(range[1] > Scalar(0))
     {
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(-dir[1].x()*range[1], -dir[1].y()*range[1], -dir[1].z()*range[1]));
+        queue.AddPoint(item, glm::vec3(0,0,0));
+        queue.AddPoint(item, glm::vec3(-dir[1].x()*range[1], -dir[1].y()*range[1], -dir[1].z()*range[1]));
     }
     
     if(range[2] > Scalar(0))
     {
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(-dir[2].x()*range[2], -dir[2].y()*range[2], -dir[2].z()*range[2]));
+        queue.AddPoint(item, glm::vec3(0,0,0));
+        queue.AddPoint(item, glm::vec3(-dir[2].x()*range[2], -dir[2].y()*range[2], -dir[2].z()*range[2]));
     }
     
     if(range[3] > Scalar(0))
     {
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(-dir[3].x()*range[3], -dir[3].y()*range[3], -dir[3].z()*range[3]));
+        queue.AddPoint(item, glm::vec3(0,0,0));
+        queue.AddPoint(item, glm::vec3(-dir[3].x()*range[3], -dir[3].y()*range[3], -dir[3].z()*range[3]));
     }
     
-    items.push_back(item);
-
-    return items;
+    queue.Add(item);
 }
 
 void DVL::setRange(const Vector3& velocityMax, Scalar altitudeMin, Scalar altitudeMax)
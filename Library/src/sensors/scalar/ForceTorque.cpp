@@ -122,16 +122,12 @@ void ForceTorque::setNoise(Scalar forceStdDev, Scalar torqueStdDev)
     channels[5].setStdDev(torqueStdDev);
 }
     
-std::vector<Renderable> ForceTorque::Render()
+void ForceTorque::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
-    
     Renderable item;
     item.type = RenderableType::SENSOR_CS;
     item.model = glMatrixFromTransform(lastFrame);
-    items.push_back(item);
-    
-    return items;
+    queue.Add(item);
 }
 
 ScalarSensorType ForceTorque::getScalarSensorType()
@@ -50,7 +50,7 @@ void GPS::InternalUpdate(Scalar dt)
     Transform gpsTrans = getSensorFrame();
     
     //GPS not updating underwater
-    Ocean* liq = SimulationApp::getApp()->getSimulationManager()->getOcean();
+    Ocean* liq = SimulationManager::getCurrent()->getOcean();
     if(liq != NULL && liq->IsInsideFluid(gpsTrans.getOrigin()))
     {
         Scalar data[4] = {Scalar(0), Scalar(-1), Scalar(0), Scalar(0)};
@@ -72,7 +72,7 @@ void GPS::InternalUpdate(Scalar dt)
         double latitude;
         double longitude;
         double height;
-        SimulationApp::getApp()->getSimulationManager()->getNED()->Ned2Geodetic(gpsPos.x(), gpsPos.y(), 0.0, latitude, longitude, height);
+        SimulationManager::getCurrent()->getNED()->Ned2Geodetic(gpsPos.x(), gpsPos.y(), 0.0, latitude, longitude, height);
         
         //record sample
         Scalar data[4] = {latitude, longitude, gpsPos.x(), gpsPos.y()};
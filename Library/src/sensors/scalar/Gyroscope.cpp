@@ -76,6 +76,11 @@ void Gyroscope::InternalUpdate(Scalar dt)
     AddSampleToHistory(s);
 }
 
+bool Gyroscope::isOversamplingSupported()
+{
+    return true;
+}
+
 ScalarSensorType Gyroscope::getScalarSensorType()
 {
     return ScalarSensorType::GYRO;
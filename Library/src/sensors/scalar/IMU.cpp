@@ -79,6 +79,11 @@ void IMU::setNoise(Scalar angleStdDev, Scalar angularVelocityStdDev)
     channels[5].setStdDev(angularVelocityStdDev);
 }
 
+bool IMU::isOversamplingSupported()
+{
+    return true;
+}
+
 ScalarSensorType IMU::getScalarSensorType()
 {
     return ScalarSensorType::IMU;
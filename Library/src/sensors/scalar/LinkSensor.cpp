@@ -71,16 +71,12 @@ void LinkSensor::AttachToSolid(MovingEntity* solid, const Transform& origin)
     }
 }
 
-std::vector<Renderable> LinkSensor::Render()
+void LinkSensor::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
-
     Renderable item;
     item.type = RenderableType::SENSOR_CS;
     item.model = glMatrixFromTransform(getSensorFrame());
-    items.push_back(item);
-
-    return items;
+    queue.Add(item);
 }
 
 }
@@ -67,7 +67,7 @@ void Multibeam::InternalUpdate(Scalar dt)
         btCollisionWorld::ClosestRayResultCallback closest(from, to);
         closest.m_collisionFilterGroup = MASK_DYNAMIC;
         closest.m_collisionFilterMask = MASK_STATIC | MASK_DYNAMIC | MASK_ANIMATED_COLLIDING;
-        SimulationApp::getApp()->getSimulationManager()->getDynamicsWorld()->rayTest(from, to, closest);
+        SimulationManager::getCurrent()->getDynamicsWorld()->rayTest(from, to, closest);
         
         if(closest.hasHit())
         {
@@ -83,23 +83,21 @@ void Multibeam::InternalUpdate(Scalar dt)
     AddSampleToHistory(s);
 }
 
-std::vector<Renderable> Multibeam::Render()
+void Multibeam::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
-    
     Renderable item;
     item.type = RenderableType::SENSOR_LINES;
     item.model = glMatrixFromTransform(getSensorFrame());
+    queue.BeginPoints(item);
     
     for(unsigned int i=0; i <= angSteps; ++i)
     {
         Vector3 dir = Vector3(1, 0, 0) * btCos(angles[i]) + Vector3(0, 1, 0) * btSin(angles[i]);
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(dir.x() * distances[i], dir.y() * distances[i], dir.z() * distances[i]));
+        queue.AddPoint(item, glm::vec3(0,0,0));
+        queue.AddPoint(item, glm::vec3(dir.x() * distances[i], dir.y() * distances[i], dir.z() * distances[i]));
     }        
     
-    items.push_back(item);
-    return items;
+    queue.Add(item);
 }
 
 void Multibeam::setRange(Scalar rangeMin, Scalar rangeMax)
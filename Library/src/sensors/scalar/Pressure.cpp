@@ -41,7 +41,7 @@ void Pressure::InternalUpdate(Scalar dt)
 {
     Scalar data(0.); //Gauge pressure //data(101325.); //Pa (1 atm)
     
-    Ocean* liq = SimulationApp::getApp()->getSimulationManager()->getOcean();
+    Ocean* liq = SimulationManager::getCurrent()->getOcean();
     if(liq != NULL)
         data += liq->GetPressure(getSensorFrame().getOrigin());
     
@@ -61,6 +61,11 @@ void Pressure::setNoise(Scalar pressureStdDev)
     channels[0].setStdDev(pressureStdDev);
 }
 
+bool Pressure::isOversamplingSupported()
+{
+    return true;
+}
+
 ScalarSensorType Pressure::getScalarSensorType()
 {
     return ScalarSensorType::PRESSURE;
@@ -61,7 +61,7 @@ void Profiler::InternalUpdate(Scalar dt)
     btCollisionWorld::ClosestRayResultCallback closest(from, to);
     closest.m_collisionFilterGroup = MASK_DYNAMIC;
     closest.m_collisionFilterMask = MASK_STATIC | MASK_DYNAMIC | MASK_ANIMATED_COLLIDING;
-    SimulationApp::getApp()->getSimulationManager()->getDynamicsWorld()->rayTest(from, to, closest);
+    SimulationManager::getCurrent()->getDynamicsWorld()->rayTest(from, to, closest);
         
     if(closest.hasHit())
     {
@@ -99,21 +99,18 @@ void Profiler::InternalUpdate(Scalar dt)
     }
 }
 
-std::vector<Renderable> Profiler::Render()
+void Profiler::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
-    
     Scalar currentAngle = currentAngStep/(Scalar)angSteps * angRange - Scalar(0.5) * angRange;
     Vector3 dir = Vector3(1, 0, 0) * btCos(currentAngle) + Vector3(0, 1, 0) * btSin(currentAngle);
     
     Renderable item;
     item.type = RenderableType::SENSOR_LINES;
     item.model = glMatrixFromTransform(getSensorFrame());
-    item.points.push_back(glm::vec3(0,0,0));
-    item.points.push_back(glm::vec3(dir.x()*distance, dir.y()*distance, dir.z()*distance));
-    items.push_back(item);
-
-    return items;
+    queue.BeginPoints(item);
+    queue.AddPoint(item, glm::vec3(0,0,0));
+    queue.AddPoint(item, glm::vec3(dir.x()*distance, dir.y()*distance, dir.z()*distance));
+    queue.Add(item);
 }
 
 void Profiler::setRange(Scalar rangeMin, Scalar rangeMax)
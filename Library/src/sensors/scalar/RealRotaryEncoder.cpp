@@ -96,6 +96,11 @@ void RealRotaryEncoder::InternalUpdate(Scalar dt)
     AddSampleToHistory(s);
 }
 
+bool RealRotaryEncoder::isOversamplingSupported()
+{
+    return false; //Interpolation would break the quantization of readings
+}
+
 ScalarSensorType RealRotaryEncoder::getScalarSensorType()
 {
     return ScalarSensorType::ENCODER;
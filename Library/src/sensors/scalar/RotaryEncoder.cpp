@@ -151,6 +151,11 @@ void RotaryEncoder::Reset()
     ScalarSensor::Reset();
 }
 
+bool RotaryEncoder::isOversamplingSupported()
+{
+    return true;
+}
+
 ScalarSensorType RotaryEncoder::getScalarSensorType()
 {
     return ScalarSensorType::ENCODER;
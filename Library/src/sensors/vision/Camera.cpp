@@ -78,13 +78,12 @@ void Camera::UpdateTransform()
     SetupCamera(eyePosition, direction, cameraUp);
 }
 
-std::vector<Renderable> Camera::Render()
+void Camera::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
-    
     Renderable item;
     item.model = glMatrixFromTransform(getSensorFrame());
     item.type = RenderableType::SENSOR_LINES;
+    queue.BeginPoints(item);
     
     //Create camera dummy
     GLfloat iconSize = 0.5f;
@@ -92,31 +91,30 @@ std::vector<Renderable> Camera::Render()
     GLfloat aspect = (GLfloat)resX/(GLfloat)resY;
     GLfloat y = x/aspect;
     
-    item.points.push_back(glm::vec3(0,0,0));
-    item.points.push_back(glm::vec3(x, -y, iconSize));
-    item.points.push_back(glm::vec3(0,0,0));
-    item.points.push_back(glm::vec3(x,  y, iconSize));
-    item.points.push_back(glm::vec3(0,0,0));
-    item.points.push_back(glm::vec3(-x, -y, iconSize));
-    item.points.push_back(glm::vec3(0,0,0));
-    item.points.push_back(glm::vec3(-x,  y, iconSize));
+    queue.AddPoint(item, glm::vec3(0,0,0));
+    queue.AddPoint(item, glm::vec3(x, -y, iconSize));
+    queue.AddPoint(item, glm::vec3(0,0,0));
+    queue.AddPoint(item, glm::vec3(x,  y, iconSize));
+    queue.AddPoint(item, glm::vec3(0,0,0));
+    queue.AddPoint(item, glm::vec3(-x, -y, iconSize));
+    queue.AddPoint(item, glm::vec3(0,0,0));
+    queue.AddPoint(item, glm::vec3(-x,  y, iconSize));
     
-    item.points.push_back(glm::vec3(x, -y, iconSize));
-    item.points.push_back(glm::vec3(x, y, iconSize));
-    item.points.push_back(glm::vec3(x, y, iconSize));
-    item.points.push_back(glm::vec3(-x, y, iconSize));
-    item.points.push_back(glm::vec3(-x, y, iconSize));
-    item.points.push_back(glm::vec3(-x, -y, iconSize));
-    item.points.push_back(glm::vec3(-x, -y, iconSize));
-    item.points.push_back(glm::vec3(x, -y, iconSize));
+    queue.AddPoint(item, glm::vec3(x, -y, iconSize));
+    queue.AddPoint(item, glm::vec3(x, y, iconSize));
+    queue.AddPoint(item, glm::vec3(x, y, iconSize));
+    queue.AddPoint(item, glm::vec3(-x, y, iconSize));
+    queue.AddPoint(item, glm::vec3(-x, y, iconSize));
+    queue.AddPoint(item, glm::vec3(-x, -y, iconSize));
+    queue.AddPoint(item, glm::vec3(-x, -y, iconSize));
+    queue.AddPoint(item, glm::vec3(x, -y, iconSize));
     
-    item.points.push_back(glm::vec3(-0.5f*x, -y, iconSize));
-    item.points.push_back(glm::vec3(0.f, -1.5f*y, iconSize));
-    item.points.push_back(glm::vec3(0.f, -1.5f*y, iconSize));
-    item.points.push_back(glm::vec3(0.5f*x, -y, iconSize));
+    queue.AddPoint(item, glm::vec3(-0.5f*x, -y, iconSize));
+    queue.AddPoint(item, glm::vec3(0.f, -1.5f*y, iconSize));
+    queue.AddPoint(item, glm::vec3(0.f, -1.5f*y, iconSize));
+    queue.AddPoint(item, glm::vec3(0.5f*x, -y, iconSize));
     
-    items.push_back(item);
-    return items;
+    queue.Add(item);
 }
 
 }
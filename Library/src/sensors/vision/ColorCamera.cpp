@@ -77,7 +77,7 @@ void ColorCamera::InitGraphics()
     UpdateTransform();
     glCamera->UpdateTransform();
     InternalUpdate(0);
-    ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->AddView(glCamera);
+    RegisterView(glCamera);
 }
 
 void ColorCamera::SetupCamera(const Vector3& eye, const Vector3& dir, const Vector3& up)
@@ -95,6 +95,8 @@ void ColorCamera::InstallNewDataHandler(std::function<void(ColorCamera*)> callba
 
 void ColorCamera::NewDataReady(void* data, unsigned int index)
 {
+    PublishFrame(data, resX, resY, 3, false);
+    
     if(newDataCallback != NULL)
     {
         imageData = (GLubyte*)data;
@@ -82,7 +82,7 @@ void DepthCamera::InitGraphics()
     UpdateTransform();
     glCamera->UpdateTransform();
     InternalUpdate(0);
-    ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->AddView(glCamera);
+    RegisterView(glCamera);
 }
 
 void DepthCamera::SetupCamera(const Vector3& eye, const Vector3& dir, const Vector3& up)
@@ -100,6 +100,8 @@ void DepthCamera::InstallNewDataHandler(std::function<void(DepthCamera*)> callba
 
 void DepthCamera::NewDataReady(void* data, unsigned int index)
 {
+    PublishFrame(data, resX, resY, 1, true);
+    
     if(newDataCallback != nullptr)
     {
         imageData = (GLfloat*)data;
@@ -132,7 +132,7 @@ void FLS::InitGraphics()
     UpdateTransform();
     glFLS->UpdateTransform();
     InternalUpdate(0);
-    ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->AddView(glFLS);
+    RegisterView(glFLS);
 
     unsigned int w, h;
     getDisplayResolution(w, h);
@@ -154,6 +154,9 @@ void FLS::InstallNewDataHandler(std::function<void(FLS*)> callback)
 
 void FLS::NewDataReady(void* data, unsigned int index)
 {
+    if(index == 1)
+        PublishFrame(data, resX, resY, 1, false);
+    
     if(newDataCallback != NULL)
     {
         if(index == 0)
@@ -177,13 +180,12 @@ void FLS::InternalUpdate(Scalar dt)
         glFLS->Update();
 }
 
-std::vector<Renderable> FLS::Render()
+void FLS::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
-    
     Renderable item;
     item.model = glMatrixFromTransform(getSensorFrame());
     item.type = RenderableType::SENSOR_LINES;    
+    queue.BeginPoints(item);
     
     //Create sonar dummy
     GLfloat iconSize = 0.5f;
@@ -197,9 +199,9 @@ std::vector<Renderable> FLS::Render()
     {
         GLfloat z = cosf(hAngle) * cosVAngle;
         GLfloat x = sinf(hAngle) * cosVAngle;
-        item.points.push_back(glm::vec3(x, sinVAngle, z));
+        queue.AddPoint(item, glm::vec3(x, sinVAngle, z));
         if(i > 0 && i < div)
-            item.points.push_back(glm::vec3(x, sinVAngle, z));
+            queue.AddPoint(item, glm::vec3(x, sinVAngle, z));
         hAngle += fovStep;
     }
     hAngle = -fovStep*(div/2);
@@ -207,34 +209,33 @@ std::vector<Renderable> FLS::Render()
     {
         GLfloat z = cosf(hAngle) * cosVAngle;
         GLfloat x = sinf(hAngle) * cosVAngle;
-        item.points.push_back(glm::vec3(x, -sinVAngle, z));
+        queue.AddPoint(item, glm::vec3(x, -sinVAngle, z));
         if(i > 0 && i < div)
-            item.points.push_back(glm::vec3(x, -sinVAngle, z));
+            queue.AddPoint(item, glm::vec3(x, -sinVAngle, z));
         hAngle += fovStep;
     }
     //Ends
     hAngle = -fovStep*(div/2);
     GLfloat zs = cosf(hAngle) * cosVAngle;
     GLfloat xs = sinf(hAngle) * cosVAngle;
-    item.points.push_back(glm::vec3(xs, sinVAngle, zs));
-    item.points.push_back(glm::vec3(xs, -sinVAngle, zs));
+    queue.AddPoint(item, glm::vec3(xs, sinVAngle, zs));
+    queue.AddPoint(item, glm::vec3(xs, -sinVAngle, zs));
     hAngle = fovStep*(div/2);
     GLfloat ze = cosf(hAngle) * cosVAngle;
     GLfloat xe = sinf(hAngle) * cosVAngle;
-    item.points.push_back(glm::vec3(xe, sinVAngle, ze));
-    item.points.push_back(glm::vec3(xe, -sinVAngle, ze));
+    queue.AddPoint(item, glm::vec3(xe, sinVAngle, ze));
+    queue.AddPoint(item, glm::vec3(xe, -sinVAngle, ze));
     //Pyramid
-    item.points.push_back(glm::vec3(0,0,0));
-    item.points.push_back(glm::vec3(xs, sinVAngle, zs));
-    item.points.push_back(glm::vec3(0,0,0));
-    item.points.push_back(glm::vec3(xs, -sinVAngle, zs));
-    item.points.push_back(glm::vec3(0,0,0));
-    item.points.push_back(glm::vec3(xe, sinVAngle, ze));
-    item.points.push_back(glm::vec3(0,0,0));
-    item.points.push_back(glm::vec3(xe, -sinVAngle, ze));
-
-    items.push_back(item);
-    return items;
+    queue.AddPoint(item, glm::vec3(0,0,0));
+    queue.AddPoint(item, glm::vec3(xs, sinVAngle, zs));
+    queue.AddPoint(item, glm::vec3(0,0,0));
+    queue.AddPoint(item, glm::vec3(xs, -sinVAngle, zs));
+    queue.AddPoint(item, glm::vec3(0,0,0));
+    queue.AddPoint(item, glm::vec3(xe, sinVAngle, ze));
+    queue.AddPoint(item, glm::vec3(0,0,0));
+    queue.AddPoint(item, glm::vec3(xe, -sinVAngle, ze));
+
+    queue.Add(item);
 }
 
 }
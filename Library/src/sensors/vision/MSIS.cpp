@@ -175,7 +175,7 @@ void MSIS::InitGraphics()
     UpdateTransform();
     glMSIS->UpdateTransform();
     InternalUpdate(0);
-    ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->AddView(glMSIS);
+    RegisterView(glMSIS);
 
     unsigned int w, h;
     getDisplayResolution(w, h);
@@ -197,6 +197,9 @@ void MSIS::InstallNewDataHandler(std::function<void(MSIS*)> callback)
 
 void MSIS::NewDataReady(void* data, unsigned int index)
 {
+    if(index == 1)
+        PublishFrame(data, resX, resY, 1, false);
+    
     if(newDataCallback != NULL)
     {
         if(index == 0)
@@ -240,13 +243,12 @@ void MSIS::InternalUpdate(Scalar dt)
         glMSIS->Update();
 }
 
-std::vector<Renderable> MSIS::Render()
+void MSIS::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
-    
     Renderable item;
     item.model = glMatrixFromTransform(getSensorFrame());
     item.type = RenderableType::SENSOR_LINES;    
+    queue.BeginPoints(item);
     
     //Create sonar dummy
     GLfloat iconSize = 0.5f;
@@ -262,9 +264,9 @@ std::vector<Renderable> MSIS::Render()
     {
         GLfloat z = cosf(hAngle) * cosVAngle;
         GLfloat x = sinf(hAngle) * cosVAngle;
-        item.points.push_back(glm::vec3(x, sinVAngle, z));
+        queue.AddPoint(item, glm::vec3(x, sinVAngle, z));
         if(i > 0 && i < div)
-            item.points.push_back(glm::vec3(x, sinVAngle, z));
+            queue.AddPoint(item, glm::vec3(x, sinVAngle, z));
         hAngle += fovStep;
     }
     hAngle = glm::radians(l1Deg);
@@ -272,9 +274,9 @@ std::vector<Renderable> MSIS::Render()
     {
         GLfloat z = cosf(hAngle) * cosVAngle;
         GLfloat x = sinf(hAngle) * cosVAngle;
-        item.points.push_back(glm::vec3(x, -sinVAngle, z));
+        queue.AddPoint(item, glm::vec3(x, -sinVAngle, z));
         if(i > 0 && i < div)
-            item.points.push_back(glm::vec3(x, -sinVAngle, z));
+            queue.AddPoint(item, glm::vec3(x, -sinVAngle, z));
         hAngle += fovStep;
     }
     
@@ -282,12 +284,12 @@ std::vector<Renderable> MSIS::Render()
     hAngle = currentStep * stepSize;
     GLfloat zc = cosf(hAngle) * cosVAngle;
     GLfloat xc = sinf(hAngle) * cosVAngle;
-    item.points.push_back(glm::vec3(0,0,0));
-    item.points.push_back(glm::vec3(xc, sinVAngle, zc));
-    item.points.push_back(glm::vec3(xc, sinVAngle, zc));
-    item.points.push_back(glm::vec3(xc, -sinVAngle, zc));
-    item.points.push_back(glm::vec3(xc, -sinVAngle, zc));
-    item.points.push_back(glm::vec3(0,0,0));
+    queue.AddPoint(item, glm::vec3(0,0,0));
+    queue.AddPoint(item, glm::vec3(xc, sinVAngle, zc));
+    queue.AddPoint(item, glm::vec3(xc, sinVAngle, zc));
+    queue.AddPoint(item, glm::vec3(xc, -sinVAngle, zc));
+    queue.AddPoint(item, glm::vec3(xc, -sinVAngle, zc));
+    queue.AddPoint(item, glm::vec3(0,0,0));
     
     if(!fullRotation)
     {
@@ -295,26 +297,25 @@ std::vector<Renderable> MSIS::Render()
         hAngle = glm::radians(l1Deg);
         GLfloat zs = cosf(hAngle) * cosVAngle;
         GLfloat xs = sinf(hAngle) * cosVAngle;
-        item.points.push_back(glm::vec3(xs, sinVAngle, zs));
-        item.points.push_back(glm::vec3(xs, -sinVAngle, zs));
+        queue.AddPoint(item, glm::vec3(xs, sinVAngle, zs));
+        queue.AddPoint(item, glm::vec3(xs, -sinVAngle, zs));
         hAngle = glm::radians(l2Deg);
         GLfloat ze = cosf(hAngle) * cosVAngle;
         GLfloat xe = sinf(hAngle) * cosVAngle;
-        item.points.push_back(glm::vec3(xe, sinVAngle, ze));
-        item.points.push_back(glm::vec3(xe, -sinVAngle, ze));
+        queue.AddPoint(item, glm::vec3(xe, sinVAngle, ze));
+        queue.AddPoint(item, glm::vec3(xe, -sinVAngle, ze));
         //Pyramid
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(xs, sinVAngle, zs));
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(xs, -sinVAngle, zs));
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(xe, sinVAngle, ze));
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(xe, -sinVAngle, ze));
+        queue.AddPoint(item, glm::vec3(0,0,0));
+        queue.AddPoint(item, glm::vec3(xs, sinVAngle, zs));
+        queue.AddPoint(item, glm::vec3(0,0,0));
+        queue.AddPoint(item, glm::vec3(xs, -sinVAngle, zs));
+        queue.AddPoint(item, glm::vec3(0,0,0));
+        queue.AddPoint(item, glm::vec3(xe, sinVAngle, ze));
+        queue.AddPoint(item, glm::vec3(0,0,0));
+        queue.AddPoint(item, glm::vec3(xe, -sinVAngle, ze));
     }
 
-    items.push_back(item);
-    return items;
+    queue.Add(item);
 }
 
 }
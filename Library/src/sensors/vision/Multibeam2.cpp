@@ -155,7 +155,7 @@ void Multibeam2::InitGraphics()
     {
         cameras[i].cam->UpdateTransform();
         cameras[i].cam->Update();
-        ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->AddView(cameras[i].cam);
+        RegisterView(cameras[i].cam);
     }
 }
 
@@ -231,18 +231,18 @@ void Multibeam2::NewDataReady(void* data, unsigned int index)
         }
         
         //Call callback
+        PublishFrame(rangeData, resX, resY, 1, true);
         if(newDataCallback != NULL)
             newDataCallback(this);
     }
 }
     
-std::vector<Renderable> Multibeam2::Render()
+void Multibeam2::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
-    
     Renderable item;
     item.model = glMatrixFromTransform(getSensorFrame());
     item.type = RenderableType::SENSOR_LINES;
+    queue.BeginPoints(item);
     
     unsigned int div = (unsigned int)ceil(fovH/5.0);
     GLfloat iconSize = 0.5f;
@@ -264,33 +264,32 @@ std::vector<Renderable> Multibeam2::Render()
         GLfloat x1 = sinf(theta1) * r;
         GLfloat x2 = sinf(theta2) * r;
         
-        item.points.push_back(glm::vec3(x1,y,z1));
-        item.points.push_back(glm::vec3(x2,y,z2));
-        item.points.push_back(glm::vec3(x1,-y,z1));
-        item.points.push_back(glm::vec3(x2,-y,z2));
+        queue.AddPoint(item, glm::vec3(x1,y,z1));
+        queue.AddPoint(item, glm::vec3(x2,y,z2));
+        queue.AddPoint(item, glm::vec3(x1,-y,z1));
+        queue.AddPoint(item, glm::vec3(x2,-y,z2));
         
         if(i == 0) //End 1
         {
-            item.points.push_back(glm::vec3(x1,y,z1));
-            item.points.push_back(glm::vec3(x1,-y,z1));
-            item.points.push_back(glm::vec3(x1,y,z1));
-            item.points.push_back(glm::vec3(0,0,0));
-            item.points.push_back(glm::vec3(x1,-y,z1));
-            item.points.push_back(glm::vec3(0,0,0));
+            queue.AddPoint(item, glm::vec3(x1,y,z1));
+            queue.AddPoint(item, glm::vec3(x1,-y,z1));
+            queue.AddPoint(item, glm::vec3(x1,y,z1));
+            queue.AddPoint(item, glm::vec3(0,0,0));
+            queue.AddPoint(item, glm::vec3(x1,-y,z1));
+            queue.AddPoint(item, glm::vec3(0,0,0));
         }
         else if(i == div-1) //End 2
         {
-            item.points.push_back(glm::vec3(x2,y,z2));
-            item.points.push_back(glm::vec3(x2,-y,z2));
-            item.points.push_back(glm::vec3(x2,y,z2));
-            item.points.push_back(glm::vec3(0,0,0));
-            item.points.push_back(glm::vec3(x2,-y,z2));
-            item.points.push_back(glm::vec3(0,0,0));
+            queue.AddPoint(item, glm::vec3(x2,y,z2));
+            queue.AddPoint(item, glm::vec3(x2,-y,z2));
+            queue.AddPoint(item, glm::vec3(x2,y,z2));
+            queue.AddPoint(item, glm::vec3(0,0,0));
+            queue.AddPoint(item, glm::vec3(x2,-y,z2));
+            queue.AddPoint(item, glm::vec3(0,0,0));
         }
     }
     
-    items.push_back(item);
-    return items;
+    queue.Add(item);
 }
     
 }
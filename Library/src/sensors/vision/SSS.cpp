@@ -133,7 +133,7 @@ void SSS::InitGraphics()
     UpdateTransform();
     glSSS->UpdateTransform();
     InternalUpdate(0);
-    ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->AddView(glSSS);
+    RegisterView(glSSS);
 
     unsigned int w, h;
     getDisplayResolution(w, h);
@@ -155,6 +155,9 @@ void SSS::InstallNewDataHandler(std::function<void(SSS*)> callback)
 
 void SSS::NewDataReady(void* data, unsigned int index)
 {
+    if(index == 1)
+        PublishFrame(data, resX, resY, 1, false);
+    
     if(newDataCallback != NULL)
     {
         if(index == 0)
@@ -178,12 +181,11 @@ void SSS::InternalUpdate(Scalar dt)
         glSSS->Update();
 }
 
-std::vector<Renderable> SSS::Render()
+void SSS::Render(DrawingQueue& queue)
 {
-    std::vector<Renderable> items(0);
-    
     Renderable item;
     item.type = RenderableType::SENSOR_LINES;    
+    queue.BeginPoints(item);
     
     //Create single transducer dummy
     GLfloat iconSize = 0.5f;
@@ -198,9 +200,9 @@ std::vector<Renderable> SSS::Render()
     {
         GLfloat z = cosf(hAngle) * cosVAngle;
         GLfloat x = sinf(hAngle) * cosVAngle;
-        item.points.push_back(glm::vec3(x, sinVAngle, z));
+        queue.AddPoint(item, glm::vec3(x, sinVAngle, z));
         if(i > 0 && i < div)
-            item.points.push_back(glm::vec3(x, sinVAngle, z));
+            queue.AddPoint(item, glm::vec3(x, sinVAngle, z));
         hAngle += fovStep;
     }
     hAngle = -fovStep*(div/2);
@@ -208,31 +210,31 @@ std::vector<Renderable> SSS::Render()
     {
         GLfloat z = cosf(hAngle) * cosVAngle;
         GLfloat x = sinf(hAngle) * cosVAngle;
-        item.points.push_back(glm::vec3(x, -sinVAngle, z));
+        queue.AddPoint(item, glm::vec3(x, -sinVAngle, z));
         if(i > 0 && i < div)
-            item.points.push_back(glm::vec3(x, -sinVAngle, z));
+            queue.AddPoint(item, glm::vec3(x, -sinVAngle, z));
         hAngle += fovStep;
     }
     //Ends
     hAngle = -fovStep*(div/2);
     GLfloat zs = cosf(hAngle) * cosVAngle;
     GLfloat xs = sinf(hAngle) * cosVAngle;
-    item.points.push_back(glm::vec3(xs, sinVAngle, zs));
-    item.points.push_back(glm::vec3(xs, -sinVAngle, zs));
+    queue.AddPoint(item, glm::vec3(xs, sinVAngle, zs));
+    queue.AddPoint(item, glm::vec3(xs, -sinVAngle, zs));
     hAngle = fovStep*(div/2);
     GLfloat ze = cosf(hAngle) * cosVAngle;
     GLfloat xe = sinf(hAngle) * cosVAngle;
-    item.points.push_back(glm::vec3(xe, sinVAngle, ze));
-    item.points.push_back(glm::vec3(xe, -sinVAngle, ze));
+    queue.AddPoint(item, glm::vec3(xe, sinVAngle, ze));
+    queue.AddPoint(item, glm::vec3(xe, -sinVAngle, ze));
     //Pyramid
-    item.points.push_back(glm::vec3(0,0,0));
-    item.points.push_back(glm::vec3(xs, sinVAngle, zs));
-    item.points.push_back(glm::vec3(0,0,0));
-    item.points.push_back(glm::vec3(xs, -sinVAngle, zs));
-    item.points.push_back(glm::vec3(0,0,0));
-    item.points.push_back(glm::vec3(xe, sinVAngle, ze));
-    item.points.push_back(glm::vec3(0,0,0));
-    item.points.push_back(glm::vec3(xe, -sinVAngle, ze));
+    queue.AddPoint(item, glm::vec3(0,0,0));
+    queue.AddPoint(item, glm::vec3(xs, sinVAngle, zs));
+    queue.AddPoint(item, glm::vec3(0,0,0));
+    queue.AddPoint(item, glm::vec3(xs, -sinVAngle, zs));
+    queue.AddPoint(item, glm::vec3(0,0,0));
+    queue.AddPoint(item, glm::vec3(xe, sinVAngle, ze));
+    queue.AddPoint(item, glm::vec3(0,0,0));
+    queue.AddPoint(item, glm::vec3(xe, -sinVAngle, ze));
 
     //Add two transducer dummies
     GLfloat offsetAngle = M_PI_2 - glm::radians(tilt);
@@ -240,11 +242,9 @@ std::vector<Renderable> SSS::Render()
     views[0] = glm::rotate(-offsetAngle, glm::vec3(0.f,1.f,0.f));
     views[1] = glm::rotate(offsetAngle, glm::vec3(0.f,1.f,0.f));
     item.model = glMatrixFromTransform(getSensorFrame()) * views[0];
-    items.push_back(item);
+    queue.Add(item);
     item.model = glMatrixFromTransform(getSensorFrame()) * views[1];
-    items.push_back(item);
-    
-    return items;
+    queue.Add(item);
 }
 
 }
@@ -0,0 +1,319 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  MicroBenchmarkApp.cpp
+//  Stonefish
+//
+
+#include "MicroBenchmarkApp.h"
+
+#include <algorithm>
+#include <core/Console.h>
+#include <entities/SolidEntity.h>
+#include <entities/forcefields/Ocean.h>
+#include <graphics/OpenGLContent.h>
+#include <sensors/Sample.h>
+#include <sensors/scalar/Pressure.h>
+#include <sensors/scalar/DVL.h>
+#include <sensors/scalar/Multibeam.h>
+#include <utils/GeometryFileUtil.h>
+#include <utils/SystemUtil.hpp>
+
+#define MIN_BATCH_TIME      1000000 //[ns]
+#define MIN_SAMPLES         5
+#define NUM_QUERY_POINTS    1024
+#define HISTORY_LENGTH      1000
+
+//Prevents the compiler from optimising away the results of the measured kernels
+static volatile double sink = 0.0;
+
+//Exposes the protected history method of the scalar sensors
+class HistorySensor : public sf::Pressure
+{
+public:
+    HistorySensor() : Pressure("History", sf::Scalar(-1), HISTORY_LENGTH) {}
+    using ScalarSensor::AddSampleToHistory;
+};
+
+static sf::Mesh* CopyMesh(const sf::Mesh* mesh)
+{
+    if(mesh->isTexturable())
+        return new sf::TexturableMesh(*(const sf::TexturableMesh*)mesh);
+    else
+        return new sf::PlainMesh(*(const sf::PlainMesh*)mesh);
+}
+
+MicroBenchmarkApp::MicroBenchmarkApp(const std::string& dataDirPath, MicroBenchmarkManager* sim, const MicroBenchmarkSettings& settings)
+    : ConsoleSimulationApp("Stonefish Microbenchmarks", dataDirPath, sim)
+{
+    this->settings = settings;
+    exitCode = 0;
+}
+
+int MicroBenchmarkApp::getExitCode()
+{
+    return exitCode;
+}
+
+void MicroBenchmarkApp::Run(const std::string& name, const std::function<void()>& kernel)
+{
+    if(settings.filter.size() > 0 && name.find(settings.filter) == std::string::npos)
+        return;
+    
+    //Calibrate the number of calls per sample so that the timer resolution does not matter
+    uint64_t batch = 1;
+    while(true)
+    {
+        int64_t start = sf::GetTimeInNanoseconds();
+        for(uint64_t i=0; i<batch; ++i)
+            kernel();
+        if(sf::GetTimeInNanoseconds() - start >= MIN_BATCH_TIME || batch >= ((uint64_t)1 << 30))
+            break;
+        batch *= 2;
+    }
+    
+    //Measure
+    std::vector<double> samples;
+    int64_t runStart = sf::GetTimeInNanoseconds();
+    while(samples.size() < MIN_SAMPLES || (sf::GetTimeInNanoseconds() - runStart)/1e9 < settings.minTime)
+    {
+        int64_t start = sf::GetTimeInNanoseconds();
+        for(uint64_t i=0; i<batch; ++i)
+            kernel();
+        samples.push_back((double)(sf::GetTimeInNanoseconds() - start)/batch);
+    }
+    
+    MicroBenchmarkResult r;
+    r.name = name;
+    r.iterations = batch * samples.size();
+    double sum = 0.0;
+    for(size_t i=0; i<samples.size(); ++i)
+        sum += samples[i];
+    r.mean = sum/samples.size();
+    std::sort(samples.begin(), samples.end());
+    r.median = samples[samples.size()/2];
+    r.min = samples.front();
+    results.push_back(r);
+    
+    cInfo("%-40s %14.1lf ns/op (median %1.1lf, min %1.1lf, %lu iterations)", name.c_str(), r.mean, r.median, r.min, (unsigned long)r.iterations);
+}
+
+void MicroBenchmarkApp::BenchmarkHydrodynamics()
+{
+    sf::Ocean* ocn = getSimulationManager()->getOcean();
+    const char* hulls[3] = {"hull_hydro", "duct_hydro", "base_link_hydro"};
+    
+    for(unsigned int h=0; h<3; ++h)
+    {
+        sf::Mesh* mesh = sf::LoadOBJ(sf::GetDataPath() + std::string(hulls[h]) + ".obj", 1.0);
+        if(mesh == NULL)
+        {
+            cError("Mesh '%s' could not be loaded!", hulls[h]);
+            exitCode = 2;
+            continue;
+        }
+        
+        sf::Vector3 v(1.0, 0.1, 0.05);
+        sf::Vector3 omega(0.0, 0.0, 0.2);
+        sf::Vector3 Fb, Tb, Fdl, Tdl, Fdq, Tdq, Fds, Tds;
+        
+        //Completely submerged
+        sf::Transform T(sf::Quaternion(0.1, 0.05, 0.0), sf::Vector3(0.0, 0.0, 5.0));
+        Run(std::string("hydro_submerged/") + hulls[h], [&]()
+        {
+            Fdl.setZero(); Tdl.setZero(); Fdq.setZero(); Tdq.setZero(); Fds.setZero(); Tds.setZero();
+            sf::SolidEntity::ComputeHydrodynamicForcesSubmerged(mesh, ocn, T, T, v, omega, Fdl, Tdl, Fdq, Tdq, Fds, Tds);
+            sink = sink + Fdq.x();
+        });
+        
+        //Crossing the surface
+        sf::Transform Ts(sf::Quaternion(0.1, 0.05, 0.0), sf::Vector3(0.0, 0.0, 0.0));
+        sf::HydrodynamicsSettings hs;
+        hs.dampingForces = true;
+        hs.reallisticBuoyancy = true;
+        std::vector<glm::vec3> debug;
+        sf::VertexDepthCache cache;
+        Run(std::string("hydro_surface/") + hulls[h], [&]()
+        {
+            Fb.setZero(); Tb.setZero(); Fdl.setZero(); Tdl.setZero(); Fdq.setZero(); Tdq.setZero(); Fds.setZero(); Tds.setZero();
+            debug.clear();
+            cache.time = sf::Scalar(-1); //Force recomputation of vertex depths
+            sf::SolidEntity::ComputeHydrodynamicForcesSurface(hs, mesh, ocn, Ts, Ts, v, omega, Fb, Tb, Fdl, Tdl, Fdq, Tdq, Fds, Tds, cache, debug);
+            sink = sink + Fb.z();
+        });
+        
+        delete mesh;
+    }
+}
+
+void MicroBenchmarkApp::BenchmarkOcean()
+{
+    sf::Ocean* ocn = getSimulationManager()->getOcean();
+    
+    std::vector<sf::Vector3> points(NUM_QUERY_POINTS);
+    for(size_t i=0; i<points.size(); ++i)
+        points[i] = sf::Vector3(((i * 37) % 101) * 0.5 - 25.0, ((i * 53) % 97) * 0.5 - 25.0, ((i * 11) % 41) * 0.25 - 2.0);
+    
+    size_t p = 0;
+    Run("ocean_get_depth", [&]()
+    {
+        sink = sink + ocn->GetDepth(points[p]);
+        p = (p + 1) % points.size();
+    });
+    
+    std::vector<sf::Scalar> depths(points.size());
+    Run("ocean_get_depth_batch", [&]()
+    {
+        ocn->GetDepth(points.data(), points.size(), depths.data());
+        sink = sink + depths[0];
+    });
+    
+    p = 0;
+    Run("ocean_get_fluid_velocity", [&]()
+    {
+        sink = sink + ocn->GetFluidVelocity(points[p]).x();
+        p = (p + 1) % points.size();
+    });
+}
+
+void MicroBenchmarkApp::BenchmarkSensors()
+{
+    MicroBenchmarkManager* sim = (MicroBenchmarkManager*)getSimulationManager();
+    sf::Scalar dt = sf::Scalar(1)/sim->getStepsPerSecond();
+    
+    sf::DVL* dvl = sim->getDVL();
+    Run("dvl_update", [&]()
+    {
+        dvl->InternalUpdate(dt);
+    });
+    
+    sf::Multibeam* mb = sim->getMultibeam();
+    Run("multibeam_update", [&]()
+    {
+        mb->InternalUpdate(dt);
+    });
+}
+
+void MicroBenchmarkApp::BenchmarkMeshes()
+{
+    std::string dragonPath = sf::GetDataPath() + "dragon.obj";
+    Run("load_obj/dragon", [&]()
+    {
+        sf::Mesh* mesh = sf::LoadOBJ(dragonPath, 1.0);
+        sink = sink + (mesh != NULL ? mesh->faces.size() : 0);
+        delete mesh;
+    });
+    
+    sf::Mesh* hull = sf::LoadOBJ(sf::GetDataPath() + "hull_hydro.obj", 1.0);
+    if(hull == NULL)
+    {
+        cError("Mesh 'hull_hydro' could not be loaded!");
+        exitCode = 2;
+        return;
+    }
+    
+    Run("refine/hull_hydro", [&]()
+    {
+        sf::Mesh* mesh = CopyMesh(hull);
+        sf::OpenGLContent::Refine(mesh, 0.1f);
+        sink = sink + mesh->faces.size();
+        delete mesh;
+    });
+    
+    Run("decimate/hull_hydro", [&]()
+    {
+        sf::Mesh* mesh = sf::OpenGLContent::Decimate(hull, 500);
+        sink = sink + mesh->faces.size();
+        delete mesh;
+    });
+    
+    Run("physical_properties/hull_hydro", [&]()
+    {
+        sf::MeshProperties mp = sf::ComputePhysicalProperties(hull, sf::Scalar(-1), sf::Scalar(1000));
+        sink = sink + mp.mass;
+    });
+    
+    Run("physical_properties_shell/hull_hydro", [&]()
+    {
+        sf::MeshProperties mp = sf::ComputePhysicalProperties(hull, sf::Scalar(0.005), sf::Scalar(1000));
+        sink = sink + mp.mass;
+    });
+    
+    delete hull;
+}
+
+void MicroBenchmarkApp::BenchmarkHistory()
+{
+    HistorySensor sensor;
+    sf::Scalar value = sf::Scalar(101325);
+    Run("scalar_sensor_add_sample_to_history", [&]()
+    {
+        value += sf::Scalar(1);
+        sf::Sample s(1, &value);
+        sensor.AddSampleToHistory(s);
+    });
+}
+
+void MicroBenchmarkApp::Loop()
+{
+    MicroBenchmarkManager* sim = (MicroBenchmarkManager*)getSimulationManager();
+    if(!sim->StartSimulation())
+    {
+        cError("Initial conditions could not be solved!");
+        exitCode = 2;
+        return;
+    }
+    sim->StepSimulation(); //Initialize sensors and caches
+    
+    BenchmarkHydrodynamics();
+    BenchmarkOcean();
+    BenchmarkSensors();
+    BenchmarkMeshes();
+    BenchmarkHistory();
+    
+    if(settings.outputPath.size() > 0)
+    {
+        FILE* fp = fopen(settings.outputPath.c_str(), "wt");
+        if(fp == NULL)
+        {
+            cError("File '%s' could not be opened!", settings.outputPath.c_str());
+            exitCode = 2;
+        }
+        else
+        {
+            WriteJSON(fp);
+            fclose(fp);
+        }
+    }
+    else
+        WriteJSON(stdout);
+}
+
+void MicroBenchmarkApp::WriteJSON(FILE* fp)
+{
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"benchmarks\": [\n");
+    for(size_t i=0; i<results.size(); ++i)
+    {
+        const MicroBenchmarkResult& r = results[i];
+        fprintf(fp, "    {\"name\": \"%s\", \"iterations\": %lu, \"mean_ns\": %1.3lf, \"median_ns\": %1.3lf, \"min_ns\": %1.3lf}%s\n",
+                r.name.c_str(), (unsigned long)r.iterations, r.mean, r.median, r.min, i < results.size()-1 ? "," : "");
+    }
+    fprintf(fp, "  ]\n");
+    fprintf(fp, "}\n");
+}
@@ -0,0 +1,70 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  MicroBenchmarkApp.h
+//  Stonefish
+//
+
+#ifndef __Stonefish__MicroBenchmarkApp__
+#define __Stonefish__MicroBenchmarkApp__
+
+#include <core/ConsoleSimulationApp.h>
+#include <functional>
+#include "MicroBenchmarkManager.h"
+
+struct MicroBenchmarkSettings
+{
+    std::string outputPath;
+    std::string filter; //Only benchmarks whose name contains this string are run
+    double minTime; //Minimum measurement time per benchmark [s]
+};
+
+struct MicroBenchmarkResult
+{
+    std::string name;
+    uint64_t iterations;
+    double mean; //[ns/op]
+    double median; //[ns/op]
+    double min; //[ns/op]
+};
+
+class MicroBenchmarkApp : public sf::ConsoleSimulationApp
+{
+public:
+    MicroBenchmarkApp(const std::string& dataDirPath, MicroBenchmarkManager* sim, const MicroBenchmarkSettings& settings);
+    
+    int getExitCode();
+
+protected:
+    void Loop();
+
+private:
+    void Run(const std::string& name, const std::function<void()>& kernel);
+    void BenchmarkHydrodynamics();
+    void BenchmarkOcean();
+    void BenchmarkSensors();
+    void BenchmarkMeshes();
+    void BenchmarkHistory();
+    void WriteJSON(FILE* fp);
+    
+    MicroBenchmarkSettings settings;
+    std::vector<MicroBenchmarkResult> results;
+    int exitCode;
+};
+
+#endif
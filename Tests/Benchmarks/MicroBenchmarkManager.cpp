@@ -0,0 +1,88 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  MicroBenchmarkManager.cpp
+//  Stonefish
+//
+
+#include "MicroBenchmarkManager.h"
+
+#include <entities/statics/Terrain.h>
+#include <entities/solids/Polyhedron.h>
+#include <entities/forcefields/Ocean.h>
+#include <entities/forcefields/Uniform.h>
+#include <entities/forcefields/Jet.h>
+#include <sensors/scalar/DVL.h>
+#include <sensors/scalar/Multibeam.h>
+#include <utils/SystemUtil.hpp>
+#include <utils/UnitSystem.h>
+
+MicroBenchmarkManager::MicroBenchmarkManager(sf::Scalar stepsPerSecond, unsigned int numOfVelocityFields)
+    : SimulationManager(stepsPerSecond, sf::SolverType::SOLVER_SI, sf::CollisionFilteringType::COLLISION_EXCLUSIVE)
+{
+    nFields = numOfVelocityFields;
+    dvl = NULL;
+    mb = NULL;
+}
+
+void MicroBenchmarkManager::BuildScenario()
+{
+    //Materials
+    CreateMaterial("Rock", sf::UnitSystem::Density(sf::CGS, sf::MKS, 3.0), 0.8);
+    CreateMaterial("Fiberglass", sf::UnitSystem::Density(sf::CGS, sf::MKS, 1.5), 0.3);
+    SetMaterialsInteraction("Rock", "Rock", 0.9, 0.7);
+    SetMaterialsInteraction("Rock", "Fiberglass", 0.6, 0.4);
+    SetMaterialsInteraction("Fiberglass", "Fiberglass", 0.5, 0.2);
+    
+    //Ocean with many velocity fields
+    EnableOcean(0.0);
+    for(unsigned int i=0; i<nFields; ++i)
+    {
+        if(i % 2 == 0)
+            getOcean()->AddVelocityField(new sf::Uniform(sf::Vector3(0.01 * i, 0.0, 0.0)));
+        else
+            getOcean()->AddVelocityField(new sf::Jet(sf::Vector3(i, 0.0, 2.0), sf::VY(), 0.5, 1.0));
+    }
+    getOcean()->EnableCurrents();
+    
+    //Seabed
+    sf::Terrain* seabed = new sf::Terrain("Seabed", sf::GetDataPath() + "terrain.png", 1.0, 1.0, 5.0, "Rock");
+    AddStaticEntity(seabed, sf::Transform(sf::IQ(), sf::Vector3(0,0,15.0)));
+    
+    //Vehicle carrying the acoustic sensors
+    sf::Polyhedron* hull = new sf::Polyhedron("Hull", sf::GetDataPath() + "hull_hydro.obj", 1.0, sf::I4(), "Fiberglass", sf::BodyPhysicsType::SUBMERGED);
+    AddSolidEntity(hull, sf::Transform(sf::IQ(), sf::Vector3(0,0,5.0)));
+    
+    dvl = new sf::DVL("DVL", 30.0);
+    dvl->AttachToSolid(hull, sf::Transform(sf::IQ(), sf::Vector3(0,0,0.5)));
+    AddSensor(dvl);
+    
+    mb = new sf::Multibeam("Multibeam", 120.0, 512);
+    mb->AttachToSolid(hull, sf::Transform(sf::IQ(), sf::Vector3(0,0,0.5)));
+    AddSensor(mb);
+}
+
+sf::DVL* MicroBenchmarkManager::getDVL()
+{
+    return dvl;
+}
+
+sf::Multibeam* MicroBenchmarkManager::getMultibeam()
+{
+    return mb;
+}
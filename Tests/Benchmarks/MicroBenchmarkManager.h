@@ -0,0 +1,49 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  MicroBenchmarkManager.h
+//  Stonefish
+//
+
+#ifndef __Stonefish__MicroBenchmarkManager__
+#define __Stonefish__MicroBenchmarkManager__
+
+#include <core/SimulationManager.h>
+
+namespace sf
+{
+    class DVL;
+    class Multibeam;
+}
+
+class MicroBenchmarkManager : public sf::SimulationManager
+{
+public:
+    MicroBenchmarkManager(sf::Scalar stepsPerSecond, unsigned int numOfVelocityFields);
+    
+    void BuildScenario();
+    sf::DVL* getDVL();
+    sf::Multibeam* getMultibeam();
+
+private:
+    unsigned int nFields;
+    sf::DVL* dvl;
+    sf::Multibeam* mb;
+};
+
+#endif
@@ -0,0 +1,76 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  main.cpp
+//  Benchmarks
+//
+
+#include "MicroBenchmarkApp.h"
+#include "MicroBenchmarkManager.h"
+
+#include <cstdlib>
+#include <cstring>
+
+static void PrintUsage()
+{
+    printf("Usage: stonefish_microbench [options]\n");
+    printf("  --filter <text>      run only the benchmarks whose name contains the text\n");
+    printf("  --min-time <s>       minimum measurement time per benchmark (default 0.5)\n");
+    printf("  --fields <n>         number of velocity fields added to the ocean (default 32)\n");
+    printf("  --data <dir>         data directory containing the test meshes\n");
+    printf("  --output <file>      write the JSON report to a file instead of the standard output\n");
+}
+
+int main(int argc, const char * argv[])
+{
+    MicroBenchmarkSettings s;
+    s.minTime = 0.5;
+    unsigned int fields = 32;
+    std::string dataPath = std::string(DATA_DIR_PATH);
+    
+    for(int i=1; i<argc; ++i)
+    {
+        if(i == argc-1)
+        {
+            PrintUsage();
+            return 2;
+        }
+        
+        if(strcmp(argv[i], "--filter") == 0)
+            s.filter = std::string(argv[++i]);
+        else if(strcmp(argv[i], "--min-time") == 0)
+            s.minTime = atof(argv[++i]);
+        else if(strcmp(argv[i], "--fields") == 0)
+            fields = (unsigned int)atoi(argv[++i]);
+        else if(strcmp(argv[i], "--data") == 0)
+            dataPath = std::string(argv[++i]);
+        else if(strcmp(argv[i], "--output") == 0)
+            s.outputPath = std::string(argv[++i]);
+        else
+        {
+            PrintUsage();
+            return 2;
+        }
+    }
+    
+    MicroBenchmarkManager* simulationManager = new MicroBenchmarkManager(500.0, fields);
+    MicroBenchmarkApp app(dataPath, simulationManager, s);
+    app.Run(false);
+    
+    return app.getExitCode();
+}
@@ -0,0 +1,255 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  BenchmarkApp.cpp
+//  Stonefish
+//
+
+#include "BenchmarkApp.h"
+
+#include <algorithm>
+#include <cstring>
+#include <core/Console.h>
+#include <utils/SystemUtil.hpp>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+static const char* phaseNames[BENCHMARK_NUM_PHASES] = {"forces", "fluids", "solver", "kinematics", "sensors", "comms", "contacts", "callback"};
+
+static uint64_t GetPeakRSS()
+{
+#ifdef _WIN32
+    return 0;
+#else
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef __APPLE__
+    return (uint64_t)usage.ru_maxrss; //Bytes
+#else
+    return (uint64_t)usage.ru_maxrss * 1024; //Kilobytes
+#endif
+#endif
+}
+
+static bool ReadJSONNumber(const std::string& json, const std::string& key, double& value)
+{
+    size_t pos = json.find("\"" + key + "\"");
+    if(pos == std::string::npos)
+        return false;
+    pos = json.find(':', pos);
+    if(pos == std::string::npos)
+        return false;
+    
+    const char* start = json.c_str() + pos + 1;
+    char* end;
+    value = strtod(start, &end);
+    return end != start;
+}
+
+BenchmarkApp::BenchmarkApp(const std::string& dataDirPath, BenchmarkManager* sim, const BenchmarkSettings& settings)
+    : ConsoleSimulationApp("Stonefish Benchmark", dataDirPath, sim)
+{
+    this->settings = settings;
+    exitCode = 0;
+}
+
+int BenchmarkApp::getExitCode()
+{
+    return exitCode;
+}
+
+void BenchmarkApp::Loop()
+{
+    BenchmarkManager* sim = (BenchmarkManager*)getSimulationManager();
+    if(!sim->isLoaded())
+    {
+        cError("Scenario '%s' could not be loaded!", settings.scenarioPath.c_str());
+        exitCode = 2;
+        return;
+    }
+    
+    BenchmarkResult r;
+    memset(&r, 0, sizeof(BenchmarkResult));
+    r.loadTime = sim->getLoadTime();
+    
+    //Reset (destroy and build the scenario again)
+    int64_t start = sf::GetTimeInMicroseconds();
+    sim->RestartScenario();
+    sim->getDynamicsWorld()->synchronizeMotionStates();
+    r.resetTime = (sf::GetTimeInMicroseconds() - start)/1e6;
+    
+    //Initial conditions
+    start = sf::GetTimeInMicroseconds();
+    if(!sim->StartSimulation())
+    {
+        cError("Initial conditions could not be solved!");
+        exitCode = 2;
+        return;
+    }
+    r.icTime = (sf::GetTimeInMicroseconds() - start)/1e6;
+    
+    //Warm up caches and allocators
+    for(unsigned int i=0; i<settings.warmupSteps; ++i)
+        sim->StepSimulation();
+    
+    //Measure free-running steps
+    cInfo("Running %u steps...", settings.steps);
+    std::vector<double> stepTimes(settings.steps);
+    sim->ResetTickProfile();
+    sim->setTickProfiling(true);
+    uint64_t allocStart = GetAllocationCount();
+    int64_t runStart = sf::GetTimeInNanoseconds();
+    
+    for(unsigned int i=0; i<settings.steps; ++i)
+    {
+        int64_t stepStart = sf::GetTimeInNanoseconds();
+        sim->StepSimulation();
+        stepTimes[i] = (sf::GetTimeInNanoseconds() - stepStart)/1e3;
+    }
+    
+    r.totalTime = (sf::GetTimeInNanoseconds() - runStart)/1e9;
+    r.allocations = GetAllocationCount() - allocStart;
+    sim->setTickProfiling(false);
+    r.peakRSS = GetPeakRSS();
+    
+    //Statistics
+    if(settings.steps > 0)
+    {
+        double sum = 0.0;
+        for(size_t i=0; i<stepTimes.size(); ++i)
+            sum += stepTimes[i];
+        r.stepMean = sum/stepTimes.size();
+        r.allocationsPerStep = (double)r.allocations/stepTimes.size();
+        
+        std::sort(stepTimes.begin(), stepTimes.end());
+        r.stepMin = stepTimes.front();
+        r.stepMax = stepTimes.back();
+        r.stepMedian = stepTimes[stepTimes.size()/2];
+        r.stepP95 = stepTimes[std::min(stepTimes.size()-1, (size_t)(stepTimes.size() * 0.95))];
+    }
+    
+    sf::TickProfile prof = sim->getTickProfile();
+    uint64_t phases[BENCHMARK_NUM_PHASES] = {prof.forces, prof.fluids, prof.solver, prof.kinematics, prof.sensors, prof.comms, prof.contacts, prof.callback};
+    for(unsigned int i=0; i<BENCHMARK_NUM_PHASES; ++i)
+        r.phaseMean[i] = prof.ticks > 0 ? phases[i]/1e3/prof.ticks : 0.0;
+    
+    //Report
+    cInfo("Load: %1.3lf s, reset: %1.3lf s, IC: %1.3lf s", r.loadTime, r.resetTime, r.icTime);
+    cInfo("Step: mean %1.2lf us, median %1.2lf us, p95 %1.2lf us, max %1.2lf us", r.stepMean, r.stepMedian, r.stepP95, r.stepMax);
+    for(unsigned int i=0; i<BENCHMARK_NUM_PHASES; ++i)
+        cInfo("  %-10s %10.2lf us", phaseNames[i], r.phaseMean[i]);
+    cInfo("Allocations: %1.1lf per step, peak RSS: %1.1lf MB", r.allocationsPerStep, r.peakRSS/1048576.0);
+    
+    if(settings.outputPath.size() > 0)
+    {
+        FILE* fp = fopen(settings.outputPath.c_str(), "wt");
+        if(fp == NULL)
+        {
+            cError("File '%s' could not be opened!", settings.outputPath.c_str());
+            exitCode = 2;
+        }
+        else
+        {
+            WriteJSON(fp, r);
+            fclose(fp);
+        }
+    }
+    else
+        WriteJSON(stdout, r);
+    
+    if(settings.baselinePath.size() > 0 && !CompareWithBaseline(r))
+        exitCode = 1;
+}
+
+void BenchmarkApp::WriteJSON(FILE* fp, const BenchmarkResult& r)
+{
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"scenario\": \"%s\",\n", settings.scenarioPath.c_str());
+    fprintf(fp, "  \"steps_per_second\": %1.1lf,\n", getSimulationManager()->getStepsPerSecond());
+    fprintf(fp, "  \"steps\": %u,\n", settings.steps);
+    fprintf(fp, "  \"warmup_steps\": %u,\n", settings.warmupSteps);
+    fprintf(fp, "  \"load_s\": %1.6lf,\n", r.loadTime);
+    fprintf(fp, "  \"reset_s\": %1.6lf,\n", r.resetTime);
+    fprintf(fp, "  \"ic_s\": %1.6lf,\n", r.icTime);
+    fprintf(fp, "  \"total_s\": %1.6lf,\n", r.totalTime);
+    fprintf(fp, "  \"step_mean_us\": %1.3lf,\n", r.stepMean);
+    fprintf(fp, "  \"step_median_us\": %1.3lf,\n", r.stepMedian);
+    fprintf(fp, "  \"step_p95_us\": %1.3lf,\n", r.stepP95);
+    fprintf(fp, "  \"step_min_us\": %1.3lf,\n", r.stepMin);
+    fprintf(fp, "  \"step_max_us\": %1.3lf,\n", r.stepMax);
+    fprintf(fp, "  \"phases_mean_us\": {\n");
+    for(unsigned int i=0; i<BENCHMARK_NUM_PHASES; ++i)
+        fprintf(fp, "    \"%s\": %1.3lf%s\n", phaseNames[i], r.phaseMean[i], i < BENCHMARK_NUM_PHASES-1 ? "," : "");
+    fprintf(fp, "  },\n");
+    fprintf(fp, "  \"allocations\": %lu,\n", (unsigned long)r.allocations);
+    fprintf(fp, "  \"allocations_per_step\": %1.3lf,\n", r.allocationsPerStep);
+    fprintf(fp, "  \"peak_rss_bytes\": %lu\n", (unsigned long)r.peakRSS);
+    fprintf(fp, "}\n");
+}
+
+bool BenchmarkApp::CompareWithBaseline(const BenchmarkResult& r)
+{
+    FILE* fp = fopen(settings.baselinePath.c_str(), "rt");
+    if(fp == NULL)
+    {
+        cError("Baseline '%s' could not be opened!", settings.baselinePath.c_str());
+        return false;
+    }
+    
+    std::string json;
+    char buffer[1024];
+    size_t n;
+    while((n = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+        json.append(buffer, n);
+    fclose(fp);
+    
+    //Metrics checked for regressions (phases are checked only if they take a noticeable time)
+    std::vector<std::pair<std::string, double>> metrics;
+    metrics.push_back(std::make_pair("step_mean_us", r.stepMean));
+    metrics.push_back(std::make_pair("step_median_us", r.stepMedian));
+    metrics.push_back(std::make_pair("allocations_per_step", r.allocationsPerStep));
+    for(unsigned int i=0; i<BENCHMARK_NUM_PHASES; ++i)
+        metrics.push_back(std::make_pair(std::string(phaseNames[i]), r.phaseMean[i]));
+    
+    bool ok = true;
+    cInfo("Comparison with baseline '%s' (tolerance %1.1lf%%):", settings.baselinePath.c_str(), settings.tolerance * 100.0);
+    
+    for(size_t i=0; i<metrics.size(); ++i)
+    {
+        double base;
+        if(!ReadJSONNumber(json, metrics[i].first, base))
+            continue;
+        
+        double current = metrics[i].second;
+        double change = base > 0.0 ? (current - base)/base : 0.0;
+        bool significant = i < 3 || base > 0.01 * r.stepMean;
+        bool regression = significant && current > base * (1.0 + settings.tolerance) && current - base > 1e-3;
+        
+        if(regression)
+        {
+            cWarning("  %-22s %12.3lf -> %12.3lf (%+1.1lf%%) REGRESSION", metrics[i].first.c_str(), base, current, change * 100.0);
+            ok = false;
+        }
+        else
+            cInfo("  %-22s %12.3lf -> %12.3lf (%+1.1lf%%)", metrics[i].first.c_str(), base, current, change * 100.0);
+    }
+    
+    return ok;
+}
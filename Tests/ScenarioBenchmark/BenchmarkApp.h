@@ -0,0 +1,79 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  BenchmarkApp.h
+//  Stonefish
+//
+
+#ifndef __Stonefish__BenchmarkApp__
+#define __Stonefish__BenchmarkApp__
+
+#include <core/ConsoleSimulationApp.h>
+#include "BenchmarkManager.h"
+
+#define BENCHMARK_NUM_PHASES 8
+
+struct BenchmarkSettings
+{
+    std::string scenarioPath;
+    std::string outputPath;
+    std::string baselinePath;
+    unsigned int steps;
+    unsigned int warmupSteps;
+    double tolerance; //Allowed relative slowdown with respect to the baseline
+};
+
+struct BenchmarkResult
+{
+    double loadTime; //[s]
+    double resetTime; //[s]
+    double icTime; //[s]
+    double totalTime; //[s]
+    double stepMean; //[us]
+    double stepMedian; //[us]
+    double stepP95; //[us]
+    double stepMin; //[us]
+    double stepMax; //[us]
+    double phaseMean[BENCHMARK_NUM_PHASES]; //[us]
+    double allocationsPerStep;
+    uint64_t allocations;
+    uint64_t peakRSS; //[B]
+};
+
+//Number of heap allocations made by the process (counted in main.cpp)
+uint64_t GetAllocationCount();
+
+class BenchmarkApp : public sf::ConsoleSimulationApp
+{
+public:
+    BenchmarkApp(const std::string& dataDirPath, BenchmarkManager* sim, const BenchmarkSettings& settings);
+    
+    int getExitCode();
+
+protected:
+    void Loop();
+
+private:
+    void WriteJSON(FILE* fp, const BenchmarkResult& r);
+    bool CompareWithBaseline(const BenchmarkResult& r);
+    
+    BenchmarkSettings settings;
+    int exitCode;
+};
+
+#endif
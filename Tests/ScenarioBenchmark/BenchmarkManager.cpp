@@ -0,0 +1,52 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  BenchmarkManager.cpp
+//  Stonefish
+//
+
+#include "BenchmarkManager.h"
+
+#include <core/ScenarioParser.h>
+#include <utils/SystemUtil.hpp>
+
+BenchmarkManager::BenchmarkManager(sf::Scalar stepsPerSecond, const std::string& scenarioPath)
+    : SimulationManager(stepsPerSecond, sf::SolverType::SOLVER_SI, sf::CollisionFilteringType::COLLISION_EXCLUSIVE)
+{
+    this->scenarioPath = scenarioPath;
+    loaded = false;
+    loadTime = 0.0;
+}
+
+void BenchmarkManager::BuildScenario()
+{
+    int64_t start = sf::GetTimeInMicroseconds();
+    sf::ScenarioParser parser(this);
+    loaded = parser.Parse(scenarioPath);
+    loadTime = (sf::GetTimeInMicroseconds() - start)/1e6;
+}
+
+bool BenchmarkManager::isLoaded()
+{
+    return loaded;
+}
+
+double BenchmarkManager::getLoadTime()
+{
+    return loadTime;
+}
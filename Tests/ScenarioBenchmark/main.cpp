@@ -0,0 +1,115 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  main.cpp
+//  ScenarioBenchmark
+//
+
+#include "BenchmarkApp.h"
+#include "BenchmarkManager.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+//Counting of heap allocations (replaces the global allocation functions of the whole process)
+static std::atomic<uint64_t> allocationCount(0);
+
+void* operator new(size_t size)
+{
+    ++allocationCount;
+    void* ptr = malloc(size > 0 ? size : 1);
+    if(ptr == NULL)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+uint64_t GetAllocationCount()
+{
+    return allocationCount;
+}
+
+static void PrintUsage()
+{
+    printf("Usage: stonefish_bench <scenario.scn> [options]\n");
+    printf("  --steps <n>          number of measured steps (default 5000)\n");
+    printf("  --warmup <n>         number of steps run before measuring (default 100)\n");
+    printf("  --rate <Hz>          simulation steps per second (default 500)\n");
+    printf("  --data <dir>         data directory used to resolve scenario resources\n");
+    printf("  --output <file>      write the JSON report to a file instead of the standard output\n");
+    printf("  --baseline <file>    compare with a previous JSON report (exit code 1 on regression)\n");
+    printf("  --tolerance <ratio>  allowed relative slowdown with respect to the baseline (default 0.1)\n");
+}
+
+int main(int argc, const char * argv[])
+{
+    if(argc < 2)
+    {
+        PrintUsage();
+        return 2;
+    }
+    
+    BenchmarkSettings s;
+    s.scenarioPath = std::string(argv[1]);
+    s.steps = 5000;
+    s.warmupSteps = 100;
+    s.tolerance = 0.1;
+    double rate = 500.0;
+    std::string dataPath = std::string(DATA_DIR_PATH);
+    
+    for(int i=2; i<argc; ++i)
+    {
+        if(i == argc-1)
+        {
+            PrintUsage();
+            return 2;
+        }
+        
+        if(strcmp(argv[i], "--steps") == 0)
+            s.steps = (unsigned int)atoi(argv[++i]);
+        else if(strcmp(argv[i], "--warmup") == 0)
+            s.warmupSteps = (unsigned int)atoi(argv[++i]);
+        else if(strcmp(argv[i], "--rate") == 0)
+            rate = atof(argv[++i]);
+        else if(strcmp(argv[i], "--data") == 0)
+            dataPath = std::string(argv[++i]);
+        else if(strcmp(argv[i], "--output") == 0)
+            s.outputPath = std::string(argv[++i]);
+        else if(strcmp(argv[i], "--baseline") == 0)
+            s.baselinePath = std::string(argv[++i]);
+        else if(strcmp(argv[i], "--tolerance") == 0)
+            s.tolerance = atof(argv[++i]);
+        else
+        {
+            PrintUsage();
+            return 2;
+        }
+    }
+    
+    BenchmarkManager* simulationManager = new BenchmarkManager(rate, s.scenarioPath);
+    BenchmarkApp app(dataPath, simulationManager, s);
+    app.Run(false);
+    
+    return app.getExitCode();
+}